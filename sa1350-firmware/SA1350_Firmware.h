@@ -15,6 +15,7 @@
 #include <xdc/std.h>
 #include <xdc/runtime/System.h>
 #include <xdc/runtime/Error.h>
+#include <xdc/runtime/Timestamp.h>
 
 #include <ti/sysbios/BIOS.h>
 #include <ti/sysbios/knl/Task.h>
@@ -22,6 +23,7 @@
 #include <ti/sysbios/knl/Mailbox.h>
 #include <ti/sysbios/knl/Clock.h>
 #include <ti/sysbios/knl/Semaphore.h>
+#include <ti/sysbios/hal/Hwi.h>
 #include <ti/sysbios/gates/GateMutex.h>
 #include <ti/sysbios/gates/GateMutexPri.h>
 
@@ -38,11 +40,14 @@
 #include "Board.h"
 #include "smartrf_settings/smartrf_settings.h"
 #include "splash_image/splash_image.h"
+#include "crc16/crc16.h"
+#include "specpack/specPack.h"
+#include "detector/detector.h"
 
 /***** Global Defines *****/
 
 #define SA1350FW_MAJOR_VERSION	(1U)	/*!< X in X.Y version number format	*/
-#define SA1350FW_MINOR_VERSION	(3U)	/*!< Y in X.Y version number format	*/
+#define SA1350FW_MINOR_VERSION	(15U)	/*!< Y in X.Y version number format	*/
 
 #define RF_TASK_STACK_SIZE		(2048U)	/*!< Stack for RF task				*/
 #define RF_TASK_PRIORITY		(3U)	/*!< Priority for RF task			*/
@@ -56,6 +61,16 @@
 #define UART_TASK_STACK_SIZE	(768U)	/*!< Stack for UART task			*/
 #define UART_TASK_PRIORITY		(2U)	/*!< Priority for UART task			*/
 
+#define MAX_SWEEP_LENGTH		(2048U)	/*!< Allocated size of RSSI array	*/
+#define SWEEP_CONFIG_LENGTH		(19U)	/*!< Payload of SET_SWEEP command	*/
+#define ZERO_SPAN_BLOCK_LENGTH	(245U)	/*!< RSSI samples per zero span block	*/
+#define TRIGGER_MAX_LENGTH		(512U)	/*!< Longest sweep kept for a trigger	*/
+#define TRIGGER_RING_LENGTH		(4U)	/*!< Sweeps in the pre-trigger ring	*/
+#define TRIGGER_PER_POINT		(0x01U)	/*!< Trigger flag, per-point levels	*/
+#define TRIGGER_REARM			(0x02U)	/*!< Trigger flag, re-arm after burst	*/
+#define MULTIBAND_MAX_SEGMENTS	(3U)	/*!< Bands in a multi-band sweep	*/
+#define MULTIBAND_SEGMENT_SIZE	(4U)	/*!< Payload bytes per band segment	*/
+
 /***** Global Structures *****/
 
 /** @brief A type and struct for passing sweep user commands within a Mailbox.
@@ -82,11 +97,98 @@ typedef struct CommandMessage {
         SET_FREQSTEP,           /*!< Set new Freq step value                */
         SET_STEPCOUNT,          /*!< Set new Freq step count value          */
         SET_SPAN,               /*!< Set new span value                     */
+        SET_SWEEP,              /*!< Set complete sweep configuration       */
+        SET_DETECTOR,           /*!< Set detector mode and dwell count      */
+        START_ZERO_SPAN,        /*!< Sample RSSI over time at one frequency */
+        STOP_ZERO_SPAN,         /*!< Return from zero span to the sweep     */
+        ARM_TRIGGER,            /*!< Arm the threshold trigger              */
+        DISARM_TRIGGER,         /*!< Disarm the threshold trigger           */
+        SET_MULTIBAND,          /*!< Sweep segments in several bands        */
 		SEND_SPECTRUM			/*!< Sending spectrum sweep to host			*/
 	} command;					/*!< User command to pass to other task		*/
-	uint8_t payload[4];			/*!< Payload of user command to pass		*/
+	uint8_t payload[SWEEP_CONFIG_LENGTH]; /*!< Payload of user command		*/
 } CommandMessage;
 
+/** @brief A type and struct for one RSSI sweep buffer. The RF task fills one
+ *  buffer while the latest completed sweep is read by the UART and display
+ *  tasks, see lockSweepData(). The values measured so far can be read while
+ *  the buffer is filled, see lockSweepProgress(). In zero span the buffer
+ *  holds a block of RSSI samples over time instead of a sweep.
+ */
+typedef struct SweepBuffer {
+	int8_t   rssi[MAX_SWEEP_LENGTH];	/*!< RSSI values of the sweep		*/
+	uint16_t length;					/*!< Number of valid RSSI values	*/
+	uint16_t count;						/*!< Sweep counter when completed	*/
+	uint8_t  readers;					/*!< Tasks holding this buffer		*/
+	_Bool    isZeroSpan;				/*!< Block of a zero span			*/
+	uint32_t startTick;					/*!< Clock tick of the first sample	*/
+	uint32_t endTick;					/*!< Clock tick of the last sample	*/
+	volatile uint16_t filled;			/*!< RSSI values measured so far	*/
+	volatile uint8_t  pass;				/*!< Changes when filling restarts	*/
+} SweepBuffer;
+
+/** @brief A type and struct for one sweep kept in the trigger ring.
+ */
+typedef struct TriggerSweep {
+	int8_t   rssi[TRIGGER_MAX_LENGTH];	/*!< RSSI values of the sweep		*/
+	uint16_t length;					/*!< Number of valid RSSI values	*/
+	uint32_t tick;						/*!< Clock tick when completed		*/
+} TriggerSweep;
+
+/** @brief A type and struct for the pre-trigger ring. Once the trigger
+ *  fired the ring is frozen and holds the burst, see lockTriggerBurst().
+ */
+typedef struct TriggerBurst {
+	TriggerSweep sweeps[TRIGGER_RING_LENGTH]; /*!< Ring of recent sweeps	*/
+	uint16_t count;						/*!< Burst counter				*/
+	uint8_t  first;						/*!< Ring index of first sweep	*/
+	uint8_t  length;					/*!< Sweeps in the burst		*/
+	uint8_t  trigger;					/*!< Burst index of trigger sweep	*/
+} TriggerBurst;
+
+/** @brief A type and struct for the time taken by one way of switching the
+ *  radio between bands. Times are in clock ticks of Clock_tickPeriod.
+ */
+typedef struct BandSwitchTimes {
+	uint32_t count;						/*!< Band switches				*/
+	uint32_t lastTicks;					/*!< Time of the last switch	*/
+	uint32_t maxTicks;					/*!< Longest switch				*/
+	uint32_t totalTicks;				/*!< Time of all switches		*/
+} BandSwitchTimes;
+
+/** @brief A type and struct for the band switch times, see
+ *  getBandSwitchStats().
+ */
+typedef struct BandSwitchStats {
+	BandSwitchTimes setup;				/*!< Setup run on the open RF handle	*/
+	BandSwitchTimes reopen;				/*!< RF handle closed and opened	*/
+} BandSwitchStats;
+
+/** @brief A type and enum for the performance counters, see perfRecord().
+ *  The order is the order of the #CMD_GETPERFSTATS response.
+ */
+typedef enum PerfCounterId
+{
+	PERF_RF_FS_WAIT = 0,	/*!< Wait for CMD_FS of a step, timestamps	*/
+	PERF_RF_SETTLE_LOOPS,	/*!< Settle waits until the RSSI is valid	*/
+	PERF_RF_RSSI_READ,		/*!< Time of one RF_getRssi(), timestamps	*/
+	PERF_SPECTRUM_BYTES,	/*!< Bytes queued per sendSpectrum()		*/
+	PERF_SPECTRUM_TX_WAIT,	/*!< Wait for TX queue space per sweep		*/
+	PERF_SWEEP_LOCK_WAIT,	/*!< Wait for sweepMutex in lockSweepData()	*/
+	PERF_DISPLAY_REDRAW,	/*!< Time of one LCD frame, timestamps		*/
+	PERF_COUNTER_COUNT		/*!< Number of performance counters			*/
+} PerfCounterId;
+
+/** @brief A type and struct for one performance counter. Times are in
+ *  Timestamp_get32() units, see getPerfFreq().
+ */
+typedef struct PerfCounter {
+	uint32_t count;						/*!< Values recorded			*/
+	uint32_t min;						/*!< Smallest value				*/
+	uint32_t max;						/*!< Largest value				*/
+	uint64_t sum;						/*!< Sum of all values			*/
+} PerfCounter;
+
 /***** Global Variables *****/
 
 /***** Prototypes *****/
@@ -105,10 +207,17 @@ extern inline uint8_t  getRbwTableEntryLength(void);
 extern uint8_t*        getRbwTableEntryData(uint8_t rbwIndex, uint8_t rbwBand);
 extern inline uint16_t getSweepMaxLength(void);
 extern inline uint16_t getSweepLength(void);
-extern inline int8_t*  getSweepData(void);
+extern inline uint16_t getSweepCount(void);
+extern void            getBandSwitchStats(BandSwitchStats *stats);
 extern inline void     getNewSweep(void);
-extern inline IArg     lockSweepData(void);
-extern inline void     unlockSweepData(IArg unlockKey);
+extern _Bool           waitNewSweep(uint32_t timeout);
+extern const SweepBuffer* lockSweepData(void);
+extern void            unlockSweepData(const SweepBuffer *sweep);
+extern const SweepBuffer* lockSweepProgress(uint16_t *sequence);
+extern const TriggerBurst* lockTriggerBurst(void);
+extern void            releaseTriggerBurst(void);
+extern void            setTriggerLevels(uint16_t offset, const uint8_t *levels,
+		uint16_t count);
 extern inline IArg     lockSweepCmd(void);
 extern inline void     unlockSweepCmd(IArg unlockKey);
 
@@ -122,4 +231,9 @@ extern void               unlockButton(void);
 
 extern void UartTask_init(void);
 
+extern void     perfRecord(PerfCounterId id, uint32_t value);
+extern void     getPerfCounter(PerfCounterId id, PerfCounter *counter,
+		_Bool reset);
+extern uint32_t getPerfFreq(void);
+
 #endif /* SA1350_FIRMWARE_H_ */
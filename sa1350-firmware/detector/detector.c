@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file detector.c
+ */
+#include "detector.h"
+
+/***** Local Defines *****/
+
+/** @brief Offset making every int8_t value positive for the average. */
+#define DETECTOR_OFFSET     (128)
+
+/** @brief Table entries of #powerTable, reads further below the peak add
+ *  less than 1/65536 of its power.
+ */
+#define DETECTOR_POWER_DB   (48U)
+
+/***** Variable declarations *****/
+
+/** @brief Power of 0 - 47 dB below the peak, 65536 * 10^(-dB / 10).
+ */
+static const uint32_t powerTable[DETECTOR_POWER_DB] = {
+	65536U, 52057U, 41350U, 32846U, 26090U, 20724U, 16462U, 13076U,
+	10387U,  8250U,  6554U,  5206U,  4135U,  3285U,  2609U,  2072U,
+	 1646U,  1308U,  1039U,   825U,   655U,   521U,   414U,   328U,
+	  261U,   207U,   165U,   131U,   104U,    83U,    66U,    52U,
+	   41U,    33U,    26U,    21U,    16U,    13U,    10U,     8U,
+	    7U,     5U,     4U,     3U,     3U,     2U,     2U,     1U
+};
+
+/***** Function definitions *****/
+
+/** @brief Highest value of the reads.
+ *
+ *  @param samples RSSI reads.
+ *  @param count number of reads, at least 1.
+ *
+ *  @return highest read
+ */
+static int8_t detectorPeak(const int8_t *samples, uint16_t count)
+{
+	int8_t peak = samples[0U];
+	uint16_t index;
+
+	for (index = 1U; index < count; index++)
+	{
+		if (samples[index] > peak)
+		{
+			peak = samples[index];
+		}
+	}
+
+	return peak;
+}
+
+/** @brief Mean of the dBm values, rounded to the nearest dB.
+ *
+ *  @param samples RSSI reads.
+ *  @param count number of reads, at least 1.
+ *
+ *  @return mean read
+ */
+static int8_t detectorAverage(const int8_t *samples, uint16_t count)
+{
+	uint32_t sum = 0U;
+	uint16_t index;
+
+	for (index = 0U; index < count; index++)
+	{
+		sum += (uint32_t)(samples[index] + DETECTOR_OFFSET);
+	}
+
+	return (int8_t)((int16_t)(((2U * sum) + count) / (2U * count))
+			- DETECTOR_OFFSET);
+}
+
+/** @brief Mean power of the reads in dBm, rounded to the nearest dB.
+ *
+ *  Powers are summed relative to the peak read with a table, so no floating
+ *  point or log function is needed.
+ *
+ *  @param samples RSSI reads.
+ *  @param count number of reads, at least 1.
+ *
+ *  @return mean power
+ */
+static int8_t detectorRms(const int8_t *samples, uint16_t count)
+{
+	int8_t peak = detectorPeak(samples, count);
+	uint32_t sum = 0U, mean;
+	uint16_t index;
+	uint8_t belowPeak;
+
+	for (index = 0U; index < count; index++)
+	{
+		belowPeak = (uint8_t)(peak - samples[index]);
+		if (belowPeak < DETECTOR_POWER_DB)
+		{
+			sum += powerTable[belowPeak];
+		}
+	}
+	mean = sum / count;
+
+	/* First dB step whose power is at most 0.5 dB above the mean */
+	for (belowPeak = 0U; belowPeak < (DETECTOR_POWER_DB - 1U); belowPeak++)
+	{
+		if ((mean * 10000U) >= (powerTable[belowPeak] * 8913U))
+		{
+			break;
+		}
+	}
+
+	return (int8_t)(peak - (int8_t)belowPeak);
+}
+
+/** @brief Reduce the RSSI reads of one frequency step.
+ *
+ *  @param mode one of #DETECTOR_SAMPLE, #DETECTOR_PEAK, #DETECTOR_AVERAGE or
+ *  #DETECTOR_RMS, others are treated as #DETECTOR_SAMPLE.
+ *  @param samples RSSI reads in the order they were taken.
+ *  @param count number of reads, 1 - #DETECTOR_MAX_DWELL for a frequency
+ *  step, up to a whole sweep for a bin of detectorDecimate().
+ *
+ *  @return RSSI value for the sweep
+ *
+ *  @par Usage
+ *       @code
+ *       rssiValue = detectorReduce(DETECTOR_PEAK, samples, sampleCount);
+ *       @endcode
+ */
+int8_t detectorReduce(uint8_t mode, const int8_t *samples, uint16_t count)
+{
+	int8_t value;
+
+	switch (mode)
+	{
+		case DETECTOR_PEAK:
+			value = detectorPeak(samples, count);
+			break;
+		case DETECTOR_AVERAGE:
+			value = detectorAverage(samples, count);
+			break;
+		case DETECTOR_RMS:
+			value = detectorRms(samples, count);
+			break;
+		default:
+			value = samples[count - 1U];
+			break;
+	}
+
+	return value;
+}
+
+/** @brief Sweep points per bin for at most binCount bins.
+ *
+ *  @param length number of sweep points.
+ *  @param binCount bins requested by the host, 0 for full resolution.
+ *
+ *  @return points per bin, 1 keeps the sweep as it is
+ *
+ *  @par Usage
+ *       @code
+ *       factor = detectorDecimateFactor(sweep->length, decimationBins);
+ *       @endcode
+ */
+uint16_t detectorDecimateFactor(uint16_t length, uint16_t binCount)
+{
+	uint16_t factor = 1U;
+
+	if ((binCount > 0U) && (binCount < length))
+	{
+		factor = (uint16_t)((length + binCount - 1U) / binCount);
+	}
+
+	return factor;
+}
+
+/** @brief Reduce every factor consecutive sweep points to one bin. The last
+ *  bin holds the remaining points.
+ *
+ *  bins may be the same array as rssi, each bin is written after its points
+ *  are read.
+ *
+ *  @param mode detector mode of the reduction, see detectorReduce().
+ *  @param rssi sweep points.
+ *  @param length number of sweep points.
+ *  @param factor points per bin from detectorDecimateFactor().
+ *  @param bins reduced values, (length + factor - 1) / factor of them.
+ *
+ *  @return number of bins
+ *
+ *  @par Usage
+ *       @code
+ *       binCount = detectorDecimate(DETECTOR_PEAK, sweep->rssi, sweep->length,
+ *               factor, decimatedRssi);
+ *       @endcode
+ */
+uint16_t detectorDecimate(uint8_t mode, const int8_t *rssi,
+		uint16_t length, uint16_t factor, int8_t *bins)
+{
+	uint16_t binCount = 0U, points;
+
+	while (length > 0U)
+	{
+		points = (length < factor) ? length : factor;
+		bins[binCount] = detectorReduce(mode, rssi, points);
+		binCount++;
+		rssi += points;
+		length -= points;
+	}
+
+	return binCount;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file detector.h
+ *
+ *  Reduction of several RSSI reads of one frequency step to the value stored
+ *  in the sweep, and of neighbouring sweep points to the bins sent to the
+ *  host. The module is plain C and compiled by the firmware and the
+ *  simulator.
+ *
+ *  - #DETECTOR_SAMPLE  : Last read, one read per step is the classic sweep
+ *  - #DETECTOR_PEAK    : Highest read, catches short bursts
+ *  - #DETECTOR_AVERAGE : Mean of the dBm values
+ *  - #DETECTOR_RMS     : Mean power in the linear domain, in dBm
+ */
+#ifndef __DETECTOR_H__
+#define __DETECTOR_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DETECTOR_SAMPLE     (0U)    /*!< Last RSSI read of the step			*/
+#define DETECTOR_PEAK       (1U)    /*!< Highest RSSI read of the step		*/
+#define DETECTOR_AVERAGE    (2U)    /*!< Mean of the dBm values				*/
+#define DETECTOR_RMS        (3U)    /*!< Mean of the linear power values	*/
+
+#define DETECTOR_MAX_DWELL  (16U)   /*!< Most RSSI reads per step			*/
+
+extern int8_t detectorReduce(uint8_t mode, const int8_t *samples,
+		uint16_t count);
+extern uint16_t detectorDecimateFactor(uint16_t length, uint16_t binCount);
+extern uint16_t detectorDecimate(uint8_t mode, const int8_t *rssi,
+		uint16_t length, uint16_t factor, int8_t *bins);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DETECTOR_H__ */
@@ -23,12 +23,16 @@
 #define DISP_MIN_RSSI	(-128)	/*!< Minimum RSSI value that can be displayed */
 #define DISP_MAX_RSSI	(-56)	/*!< Maximum RSSI value that can be displayed */
 
-/***** Structures *****/
+#define PLOT_COL_STALE	(0xFFU)	/*!< Column height forcing a redraw			*/
 
-/** @brief Rectangle definition used to clear spectrum sweep after every round.
+/** @brief Shortest time between two frames. Sweeps completed meanwhile are
+ *  not drawn, the LCD could not show them anyway.
  */
-static const Graphics_Rectangle clearSpace = { PLOT_H_ORIGIN, PLOT_V_ORIGIN,
-		PLOT_COL_COUNT, PLOT_ROW_COUNT + PLOT_V_ORIGIN };
+#define DISPLAY_FRAME_TICKS	(100U * (1000U / Clock_tickPeriod))
+
+/** @brief Longest wait for a sweep before checking for parameter changes.
+ */
+#define DISPLAY_IDLE_TICKS	(500U * (1000U / Clock_tickPeriod))
 
 /***** Variable declarations *****/
 
@@ -76,6 +80,11 @@ static Semaphore_Params displayUpdateSemaphoreParams;
  */
 Semaphore_Handle displayUpdateSemaphore;
 
+/** @brief Height in pixels of each plotted column, #PLOT_COL_STALE if the
+ *  column has to be drawn again.
+ */
+static uint8_t plotHeights[PLOT_COL_COUNT];
+
 /***** Function prototypes *****/
 
 static void displayLCDWelcome(Display_Handle hDispLcd,
@@ -85,9 +94,9 @@ static void displaySerialWelcome(Display_Handle hDispSerial);
 static void drawTitle(const Graphics_Context *pTitleContext,
 		Display_Handle hTitleLcd);
 static void drawScale(Display_Handle hScaleLcd);
-static void drawSweep(const Graphics_Context *pSweepContext,
+static uint8_t drawSweep(const Graphics_Context *pSweepContext,
 		uint16_t binRssis);
-static void drawGrid(const Graphics_Context *pGridContext);
+static void drawGrid(const Graphics_Context *pGridContext, uint8_t colIndex);
 static _Bool getDisplayUpdate(void);
 static void openDisplay(void);
 static void DisplaySemaphore_init(void);
@@ -246,35 +255,71 @@ static void drawScale(Display_Handle hScaleLcd)
 }
 
 /** @brief Draw vertical lines corresponding to the RSSI values from one sweep.
+ *  Only columns whose height changed since the last call are drawn again.
  *
  *  @param pSweepContext Grlib drawing context.
  *  @param binRssis number of RSSI values per dispaly bin.
  *
+ *  @return Number of columns drawn, 0 if the LCD needs no flush.
+ *
  *  @par Usage
  *       @code
- *       drawSweep(pDisplayContext, stepSize);
+ *       if (drawSweep(pDisplayContext, stepSize) > 0U){//Flush}
  *       @endcode
  */
-static void drawSweep(const Graphics_Context *pSweepContext, uint16_t binRssis)
+static uint8_t drawSweep(const Graphics_Context *pSweepContext,
+		uint16_t binRssis)
 {
-    uint16_t dispBin, freqBin, freqStartIndex;
+    uint16_t dispBin, freqBin, freqStartIndex, freqBinCount;
+    uint16_t indexStep, indexFrac, indexRest = 0U;
+    uint8_t height, drawnCount = 0U;
     int8_t scale;
-    int8_t *rssiValues = getSweepData();
-    uint16_t rssiLength = getSweepLength();
+    const SweepBuffer *sweep = lockSweepData();
+    const int8_t *rssiValues = sweep->rssi;
+    uint16_t rssiLength = sweep->length;
     int16_t scaleAvg;
 
+    /* Nothing to draw before the first sweep completes */
+    if (rssiLength == 0U)
+    {
+    	unlockSweepData(sweep);
+    	return 0U;
+    }
+
+    /* First value of each bin is dispBin * (rssiLength - 1) / PLOT_COL_COUNT,
+     * stepped as whole and fractional part instead of divided per column */
+    indexStep = (rssiLength - 1U) / PLOT_COL_COUNT;
+    indexFrac = (rssiLength - 1U) % PLOT_COL_COUNT;
+    freqStartIndex = 0U;
+
 	/* Draw the RSSI readings but restricting it to only 96 pixel screen */
 	for (dispBin = 0U; dispBin < PLOT_COL_COUNT; dispBin++)
 	{
+		if (dispBin > 0U)
+		{
+			freqStartIndex += indexStep;
+			indexRest += indexFrac;
+			if (indexRest >= PLOT_COL_COUNT)
+			{
+				freqStartIndex++;
+				indexRest -= PLOT_COL_COUNT;
+			}
+		}
+
 		/* Sum each RSSI value across a display bin */
 		scaleAvg = 0;
-		freqStartIndex = ((dispBin * (rssiLength - 1U)) / PLOT_COL_COUNT);
-		for (freqBin = 0U; freqBin < binRssis; freqBin++)
+		/* Sweep may still be one taken before a span change */
+		freqBinCount = binRssis;
+		if (freqStartIndex + freqBinCount > rssiLength)
+		{
+			freqBinCount = rssiLength - freqStartIndex;
+		}
+		for (freqBin = 0U; freqBin < freqBinCount; freqBin++)
 		{
 			scaleAvg += rssiValues[freqStartIndex + freqBin];
 		}
 		/* Average RSSI value for each display bin */
-		scaleAvg /= binRssis;
+		scaleAvg /= freqBinCount;
 
 		/* Set the scale and restrict it to only 72 pixels */
 		if (scaleAvg < DISP_MIN_RSSI)
@@ -290,32 +335,61 @@ static void drawSweep(const Graphics_Context *pSweepContext, uint16_t binRssis)
 			scale = (int8_t)scaleAvg;
 		}
 
-		if (scale != 0)
+		/* Adjust scale to be relative minimum value for plot */
+		height = (uint8_t)(scale - DISP_MIN_RSSI);
+
+		if (height == plotHeights[dispBin])
 		{
-			/* Adjust scale to be relative minimum value for plot */
-			scale = scale - DISP_MIN_RSSI;
-			/* Draw each line only if RSSI is NOT 0 pixels (not set) */
-			Graphics_drawLineV(pSweepContext,
-					dispBin,
-					PLOT_ROW_COUNT + PLOT_V_ORIGIN - scale,
-					PLOT_ROW_COUNT + PLOT_V_ORIGIN
-			);
+			continue;
 		}
+		plotHeights[dispBin] = height;
+		drawnCount++;
+
+		/* Clear the column above the line, height is below PLOT_ROW_COUNT */
+		Graphics_setForegroundColor(pSweepContext, GRAPHICS_COLOR_WHITE);
+		Graphics_drawLineV(pSweepContext,
+				dispBin,
+				PLOT_V_ORIGIN,
+				PLOT_ROW_COUNT + PLOT_V_ORIGIN - height - 1U
+		);
+		Graphics_setForegroundColor(pSweepContext, GRAPHICS_COLOR_BLACK);
+
+		Graphics_drawLineV(pSweepContext,
+				dispBin,
+				PLOT_ROW_COUNT + PLOT_V_ORIGIN - height,
+				PLOT_ROW_COUNT + PLOT_V_ORIGIN
+		);
+
+		drawGrid(pSweepContext, (uint8_t)dispBin);
 	}
+
+	unlockSweepData(sweep);
+
+	return drawnCount;
 }
 
-/** @brief Draw horizontal gridlines on display at 10dBm increments.
+/** @brief Draw the pixels of the horizontal gridlines at 10dBm increments
+ *  that fall into one plot column.
  *
  *  @param pGridContext Grlib drawing context.
+ *  @param colIndex plot column.
  *
  *  @par Usage
  *       @code
- *       drawGrid(pDisplayContext);
+ *       drawGrid(pDisplayContext, dispBin);
  *       @endcode
  */
-static void drawGrid(const Graphics_Context *pGridContext)
+static void drawGrid(const Graphics_Context *pGridContext, uint8_t colIndex)
 {
-	uint8_t rowIndex, colIndex;
+	uint8_t rowIndex;
+
+	/* Gridlines are GRID_LNE_LENGTH + 1 pixels long, one every GRID_H_GAP */
+	if ((colIndex < GRID_BORDER)
+			|| (colIndex > PLOT_COL_COUNT - GRID_BORDER)
+			|| (((colIndex - GRID_BORDER) % GRID_H_GAP) > GRID_LNE_LENGTH))
+	{
+		return;
+	}
 
 	for (
 			rowIndex = PLOT_V_ORIGIN + GRID_BORDER;
@@ -323,18 +397,7 @@ static void drawGrid(const Graphics_Context *pGridContext)
 			rowIndex += GRID_V_GAP
 	)
 	{
-		for (
-				colIndex = GRID_BORDER;
-				colIndex <= PLOT_COL_COUNT - GRID_BORDER - GRID_LNE_LENGTH;
-				colIndex += GRID_H_GAP
-		)
-		{
-			Graphics_drawLineH(pGridContext,
-					colIndex,
-					colIndex + GRID_LNE_LENGTH,
-					rowIndex
-			);
-		}
+		Graphics_drawPixel(pGridContext, colIndex, rowIndex);
 	}
 }
 
@@ -463,14 +526,25 @@ void DisplayTask_init(void)
  */
 static void displayTaskFxn(UArg dispArg0, UArg dispArg1)
 {
-	uint16_t stepSize = UINT16_MAX, newStepSize;
+	uint16_t stepSize = UINT16_MAX, newStepSize, dispBin;
+	uint32_t frameTicks, elapsedTicks, redrawTime;
 
     openDisplay();
 
     while (1) {
+    	/* Sleep until the RF task completes a sweep */
+    	waitNewSweep(DISPLAY_IDLE_TICKS);
+    	frameTicks = Clock_getTicks();
+    	redrawTime = Timestamp_get32();
+
     	/* Redraw/recalculate scale if SA parameters have changed */
     	if (getDisplayUpdate())
     	{
+    		for (dispBin = 0U; dispBin < PLOT_COL_COUNT; dispBin++)
+    		{
+    			plotHeights[dispBin] = PLOT_COL_STALE;
+    		}
+
     		/* Calculate offset to plot only PLOT_COL_COUNT values to LCD */
     		newStepSize = ceilf((float)getSweepLength() / PLOT_COL_COUNT);
     		if (newStepSize > stepSize)
@@ -482,17 +556,19 @@ static void displayTaskFxn(UArg dispArg0, UArg dispArg1)
     		drawScale(displayLcd);
     	}
 
-    	/* Clear the lines by drawing a box */
-    	Graphics_setForegroundColor(pDisplayContext, GRAPHICS_COLOR_WHITE);
-    	Graphics_fillRectangle(pDisplayContext, &clearSpace);
-    	Graphics_setForegroundColor(pDisplayContext, GRAPHICS_COLOR_BLACK);
-
-    	drawSweep(pDisplayContext, stepSize);
-
-    	drawGrid(pDisplayContext);
-
     	/* Flush this content to display */
-    	Graphics_flushBuffer(pDisplayContext);
+    	if (drawSweep(pDisplayContext, stepSize) > 0U)
+    	{
+    		Graphics_flushBuffer(pDisplayContext);
+    	}
+    	perfRecord(PERF_DISPLAY_REDRAW, Timestamp_get32() - redrawTime);
+
+    	/* Leave the CPU to the RF task until the next frame is due */
+    	elapsedTicks = Clock_getTicks() - frameTicks;
+    	if (elapsedTicks < DISPLAY_FRAME_TICKS)
+    	{
+    		Task_sleep(DISPLAY_FRAME_TICKS - elapsedTicks);
+    	}
     }
 }
 
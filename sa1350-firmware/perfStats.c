@@ -0,0 +1,96 @@
+/*!
+ *  @file perfStats.c
+ *
+ *  Counters of where the firmware spends its time, read by the host with
+ *  #CMD_GETPERFSTATS. Each counter keeps the number, smallest, largest and
+ *  sum of the values recorded, see #PerfCounterId.
+ */
+#include "SA1350_Firmware.h"
+
+
+/***** Variable declarations *****/
+
+/** @brief Performance counters since start-up or their last reset.
+ */
+static PerfCounter perfCounters[PERF_COUNTER_COUNT];
+
+/***** Global function definitions *****/
+
+/** @brief Add a value to a performance counter. Interrupts are only disabled
+ *  for the update, so any task may record.
+ *
+ *  @param id counter to update.
+ *  @param value value to add, times in Timestamp_get32() units.
+ *
+ *  @par Usage
+ *       @code
+ *       perfRecord(PERF_RF_RSSI_READ, Timestamp_get32() - startTime);
+ *       @endcode
+ */
+void perfRecord(PerfCounterId id, uint32_t value)
+{
+	PerfCounter *counter = &perfCounters[id];
+	UInt hwiKey;
+
+	hwiKey = Hwi_disable();
+
+	if ((counter->count == 0U) || (value < counter->min))
+	{
+		counter->min = value;
+	}
+	if (value > counter->max)
+	{
+		counter->max = value;
+	}
+	counter->sum += value;
+	counter->count++;
+
+	Hwi_restore(hwiKey);
+}
+
+/** @brief Copy a performance counter, optionally starting it again.
+ *
+ *  @param id counter to copy.
+ *  @param counter set to the counter values.
+ *  @param reset TRUE to clear the counter after the copy.
+ *
+ *  @par Usage
+ *       @code
+ *       getPerfCounter(PERF_DISPLAY_REDRAW, &counter, FALSE);
+ *       @endcode
+ */
+void getPerfCounter(PerfCounterId id, PerfCounter *counter, _Bool reset)
+{
+	UInt hwiKey;
+
+	hwiKey = Hwi_disable();
+
+	*counter = perfCounters[id];
+	if (reset)
+	{
+		perfCounters[id].count = 0U;
+		perfCounters[id].min = 0U;
+		perfCounters[id].max = 0U;
+		perfCounters[id].sum = 0U;
+	}
+
+	Hwi_restore(hwiKey);
+}
+
+/** @brief Getter function for the frequency of Timestamp_get32().
+ *
+ *  @return timestamp counts per second.
+ *
+ *  @par Usage
+ *       @code
+ *       freq = getPerfFreq();
+ *       @endcode
+ */
+uint32_t getPerfFreq(void)
+{
+	Types_FreqHz freq;
+
+	Timestamp_getFreq(&freq);
+
+	return freq.lo;
+}
@@ -25,7 +25,7 @@
 /***** Local Defines *****/
 
 #define DEFAULT_BAND_900M   (1U)		/*!< (0) 400MHz, (1) 900MHz			*/
-#define MAX_SWEEP_LENGTH    (2048U)		/*!< Allocated size of RSSI array	*/
+#define SWEEP_BUFFER_COUNT  (2U)		/*!< Filled and published sweep		*/
 
 /**  @{ */
 /*!  See \ref SASpan for RF span table */
@@ -80,6 +80,21 @@
 /*! Max number of entries in device-specific rxBW table */
 #define MAX_ITEMS_RBW   (21U)
 
+/**  @{ */
+/*! Receiver settle time before an RSSI reading, see updateRssiSettle() */
+#define RSSI_SETTLE_RX_US		(60U)	/*!< CMD_RX_TEST start to RX running	*/
+#define RSSI_SETTLE_RBW_PERIODS	(8U)	/*!< RX filter periods for RSSI settle	*/
+#define RSSI_READ_RETRIES		(3U)	/*!< Extra settle waits without RSSI	*/
+#define RF_STEP_TIMEOUT	(10U * (1000U / Clock_tickPeriod))	/*!< 10 ms			*/
+/**  @} */
+
+/**  @{ */
+/*! Sweep steps queued in the RF core, see rfTaskFxn() */
+#define RF_STEP_SLOTS		(2U)	/*!< Step being measured and the next one	*/
+#define RF_STEP_NONE		((RF_CmdHandle)-1)	/*!< No step queued			*/
+#define RAT_TICKS_PER_US	(4U)	/*!< RF core timer runs at 4 MHz			*/
+/**  @} */
+
 /**  @{ */
 /** @brief Initial values for available RF bands of the RF sweep.
  *
@@ -107,6 +122,12 @@
 #define IODIV_2440MHZ	(2U)
 /**  @} */
 
+/*! Bands with a prepared radio setup, see switchRadio() */
+#define BAND_COUNT		(3U)
+
+/*! RSSI adjustment for the 2.4GHz band. Value determined empirically.	*/
+#define RSSI_OFFSET_2400	(20)
+
 /*! Repeat count for FAST_DEC_FREQ and FAST_INC_FREQ frequency changes	*/
 #define FAST_CHANGE_COUNT	(6U)
 
@@ -165,6 +186,40 @@ typedef enum ChangeBandArg
 	SET_NEXT_BAND = 0x55	/*!< Change to next RF band						*/
 } ChangeBandArg;
 
+/** @brief A type and struct for the fixed radio settings of an RF band.
+ */
+typedef struct SABandInfo {
+	uint16_t minFreq;			/*!< Minimum frequency allowed in band		*/
+	uint16_t maxFreq;			/*!< Maximum frequency allowed in band		*/
+	uint8_t  loDivider;			/*!< LO divider of the radio setup			*/
+} SABandInfo;
+
+/** @brief A type and struct for one band of a multi-band sweep, see
+ *  cmdSetMultiBand().
+ */
+typedef struct BandSegment {
+	SABand   band;				/*!< Band of the segment					*/
+	uint16_t startFreq;			/*!< Integer value of start frequency		*/
+	uint16_t centerFreq;		/*!< Center frequency of the radio setup	*/
+	uint8_t  spanIndex;			/*!< EasyRF span swept in the segment		*/
+	uint16_t end;				/*!< Sweep index after the last step		*/
+} BandSegment;
+
+/** @brief A type and struct for the synthesizer steps of the sweep. Worked
+ *  out once per configuration by updateSweepPlan(), so that stepping the
+ *  sweep needs no division and no parameter lookups.
+ */
+typedef struct SweepPlan {
+	uint16_t length;		/*!< Number of steps in the sweep				*/
+	uint16_t fractStep;		/*!< Fractional frequency added per step		*/
+	uint32_t wrapLow;		/*!< Lowest fractFreq of the last step of a MHz	*/
+	uint32_t wrapHigh;		/*!< First fractFreq past the last step of a MHz	*/
+	_Bool    isExpert;		/*!< Steps carry into the next MHz on overflow	*/
+	int8_t   rssiOffset;	/*!< Added to every valid RSSI value			*/
+	uint32_t rxEndTime;		/*!< CMD_RX_TEST length of a step, RAT ticks	*/
+	uint16_t segmentEnd;	/*!< Sweep index where the band segment ends	*/
+} SweepPlan;
+
 /***** Variable declarations *****/
 
 /** @brief Task struct for RF Task.
@@ -239,6 +294,109 @@ static Semaphore_Params newSpectrumSemaphoreParams;
  */
 Semaphore_Handle newSpectrumSemaphore;
 
+/** @brief Semaphore struct for the synthesizer lock of a sweep step.
+ */
+static Semaphore_Struct rfStepSemaphoreStruct;
+
+/** @brief Semaphore parameters for the synthesizer lock of a sweep step.
+ */
+static Semaphore_Params rfStepSemaphoreParams;
+
+/** @brief Semaphore handle for the synthesizer lock of a sweep step.
+ */
+static Semaphore_Handle rfStepSemaphore;
+
+/** @brief Clock ticks to wait for a valid RSSI after the synthesizer locked.
+ */
+static uint32_t rssiSettleTicks = 1U;
+
+/** @brief Clock ticks between further RSSI reads of one step, see #CMD_SETDETECTOR.
+ */
+static uint32_t rssiDwellTicks = 1U;
+
+/** @brief Reduction of the RSSI reads of one step, see detector.h.
+ */
+static uint8_t detectorMode = DETECTOR_SAMPLE;
+
+/** @brief RSSI reads per step, 1 - #DETECTOR_MAX_DWELL.
+ */
+static uint8_t detectorDwell = 1U;
+
+/** @brief Zero span active, the RF task samples RSSI at one frequency.
+ */
+static _Bool isZeroSpan = FALSE;
+
+/** @brief Clock ticks between zero span samples, at least 1.
+ */
+static uint32_t zeroSpanTicks = 1U;
+
+/** @brief CMD_RX_TEST running for the whole zero span.
+ */
+static RF_CmdHandle zeroSpanRxCmd;
+
+/** @brief CMD_FS of the queued sweep steps, each chained to its CMD_RX_TEST.
+ */
+static rfc_CMD_FS_t stepFs[RF_STEP_SLOTS];
+
+/** @brief CMD_RX_TEST of the queued sweep steps.
+ */
+static rfc_CMD_RX_TEST_t stepRx[RF_STEP_SLOTS];
+
+/** @brief Command handle of the step queued behind the one being measured,
+ *  #RF_STEP_NONE if there is none.
+ */
+static RF_CmdHandle nextStepCmd = RF_STEP_NONE;
+
+/** @brief States of the threshold trigger, see triggerSweep().
+ */
+typedef enum TriggerState
+{
+	TRIGGER_OFF = 0,	/*!< No sweeps are kept							*/
+	TRIGGER_ARMED,		/*!< Sweeps fill the ring, levels are checked	*/
+	TRIGGER_POST,		/*!< Level crossed, collecting post-trigger sweeps	*/
+	TRIGGER_READY		/*!< Ring frozen until releaseTriggerBurst()	*/
+} TriggerState;
+
+/** @brief Trigger state, changed under #sweepMutex.
+ */
+static TriggerState triggerState = TRIGGER_OFF;
+
+/** @brief Pre-trigger ring, holds the burst while #TRIGGER_READY.
+ */
+static TriggerBurst triggerBurst;
+
+/** @brief Per-point trigger levels in dBm, see setTriggerLevels().
+ */
+static int8_t triggerLevels[TRIGGER_MAX_LENGTH];
+
+/** @brief Global trigger level in dBm.
+ */
+static int8_t triggerLevel = INT8_MAX;
+
+/** @brief Trigger flags, #TRIGGER_PER_POINT and #TRIGGER_REARM.
+ */
+static uint8_t triggerFlags = 0U;
+
+/** @brief Sweeps sent before the trigger sweep.
+ */
+static uint8_t triggerPre = 0U;
+
+/** @brief Sweeps sent after the trigger sweep.
+ */
+static uint8_t triggerPost = 0U;
+
+/** @brief Post-trigger sweeps still to collect.
+ */
+static uint8_t triggerPostLeft = 0U;
+
+/** @brief Ring index written next.
+ */
+static uint8_t triggerHead = 0U;
+
+/** @brief Number of valid sweeps in the ring.
+ */
+static uint8_t triggerFill = 0U;
+
 /** @brief PIN driver handle for the RF switch control.
  */
 static PIN_Handle rfSwPinHandle;
@@ -345,9 +503,58 @@ static SASpan sa1350SpanParams[] = {
 	{ STEP8, NUMSTEPS8, RBW8, SPAN8 }
 };
 
-/** @brief Array for capturing RSSI values from sweep.
+/** @brief Fixed radio settings of #BAND_400M, #BAND_900M and #BAND_2400M.
+ */
+static const SABandInfo bandInfo[BAND_COUNT] = {
+	{ MINFREQ_400, MAXFREQ_400, IODIV_440MHZ },
+	{ MINFREQ_900, MAXFREQ_900, IODIV_915MHZ },
+	{ MINFREQ_2400, MAXFREQ_2400, IODIV_2440MHZ }
+};
+
+/** @brief Radio setup prepared for each band, see prepareBandSetups().
+ */
+static rfc_CMD_PROP_RADIO_DIV_SETUP_t bandSetups[BAND_COUNT];
+
+/** @brief Band of the setup the radio runs with.
+ */
+static SABand radioBand = BAND_UNKNOWN;
+
+/** @brief Time taken by band switches, changed under #sweepMutex.
+ */
+static BandSwitchStats bandSwitchStats = {0};
+
+/** @brief Segments of the multi-band sweep in sweep order.
+ */
+static BandSegment multiBand[MULTIBAND_MAX_SEGMENTS];
+
+/** @brief Segments in #multiBand, 0 for a single band sweep.
+ */
+static uint8_t multiBandCount = 0U;
+
+/** @brief Index into #multiBand of the segment being measured.
+ */
+static uint8_t multiBandSegment = 0U;
+
+/** @brief Buffers for capturing RSSI values from sweeps.
+ */
+static SweepBuffer sweepBuffers[SWEEP_BUFFER_COUNT] = {0};
+
+/** @brief Index of the sweep buffer the RF task is filling. Only changed by
+ *  the RF task.
+ */
+static uint8_t fillBuffer = 0U;
+
+/** @brief Index of the latest completed sweep buffer.
+ */
+static uint8_t readyBuffer = 1U;
+
+/** @brief Number of completed sweeps, wraps around at 16 bits.
+ */
+static volatile uint16_t sweepCount = 0U;
+
+/** @brief Synthesizer steps of the sweep being measured.
  */
-static int8_t rssiArray[MAX_SWEEP_LENGTH] = {0};
+static SweepPlan sweepPlan = {0};
 
 /** @brief Status of the command mode for sweep control.
  *
@@ -375,8 +582,10 @@ static inline uint16_t getSpanFreqStep(void);
 static inline uint16_t getSpanNumSteps(void);
 static inline uint8_t getSpanRBW(void);
 static inline uint16_t getSpan(void);
-static void updateSweepFreq(void);
-static void setNewSweep(void);
+static void updateSweepPlan(void);
+static void updateSweepFreq(rfc_CMD_FS_t *cmdFs);
+static void setNewSweep(uint16_t sweepLength);
+static void restartFill(void);
 static void decreaseFreq(void);
 static void increaseFreq(void);
 static void fastDecreaseFreq(void);
@@ -384,15 +593,20 @@ static void fastIncreaseFreq(void);
 static uint8_t nextSpanDelta(uint8_t nextSpanIndex);
 static uint16_t fracFreqStepIndex(uint16_t fracFreq);
 static void remapFracFreqs(uint8_t nextSpanIndex);
+static void updateRssiSettle(SABand band, uint8_t rbw);
+static void prepareBandSetups(void);
+static void switchRadio(SABand band, uint8_t rxBw, uint16_t centerFreq);
+static void selectSweepRadio(void);
 static void updateRadioRF(void);
 static void decreaseSpan(void);
 static void increaseSpan(void);
 static void updateSpanFreqs(void);
 static void updateExpertSpan(void);
-static void changeSpan(uint8_t index);
+static _Bool changeSpan(uint8_t index);
 static SABand getBand(void);
 static void setBand(SABand band);
 static void nextBand(SABand currBand);
+static _Bool selectBand(ChangeBandArg newBand);
 static void changeBand(ChangeBandArg newBand);
 static _Bool getCommandMode(void);
 static void setCommandMode(_Bool commandMode);
@@ -402,7 +616,23 @@ static void cmdSetRbw(const uint8_t *values);
 static void cmdSetFreqStep(const uint8_t *values);
 static void cmdSetStepCount(const uint8_t *values);
 static void cmdSetSpan(const uint8_t *values);
+static void cmdSetSweep(const uint8_t *values);
+static void cmdSetDetector(const uint8_t *values);
+static void cmdStartZeroSpan(const uint8_t *values);
+static void stopZeroSpan(void);
+static void zeroSpanBlock(void);
+static void cmdArmTrigger(const uint8_t *values);
+static void stopTrigger(void);
+static void cmdSetMultiBand(const uint8_t *values);
+static void stopMultiBand(void);
+static void startSweepSegment(uint8_t segment);
+static void triggerSweep(const int8_t *rssi, uint16_t length);
+static void discardSweep(void);
 static _Bool rfCommand(void);
+static void setStepChain(uint8_t slot, uint16_t frequency, uint16_t fractFreq);
+static RF_CmdHandle postStepChain(uint8_t slot);
+static int8_t readStepRssi(uint8_t slot);
+static void cancelStepChain(void);
 static void updateSweepState(uint16_t *sweepIndex);
 static void rfCallbackFxn(RF_Handle hRf, RF_CmdHandle hRfC, RF_EventMask e);
 static void openRadio(void);
@@ -664,48 +894,144 @@ static inline uint16_t getSpan(void)
 	return sa1350SpanParams[getSpanIndex()].spanSpan;
 }
 
+/** @brief Work out the synthesizer steps of the sweep for the current
+ *  parameters. Called whenever a command may have changed them.
+ *
+ *  @par Usage
+ *       @code
+ *       updateSweepPlan();
+ *       @endcode
+ */
+static void updateSweepPlan(void)
+{
+	const BandSegment *segment;
+	uint16_t freqStep = getFreqStep();
+	uint16_t numSteps = getNumSteps();
+	SABand band = getBand();
+
+	sweepPlan.length = getSweepLength();
+	sweepPlan.segmentEnd = sweepPlan.length;
+	sweepPlan.isExpert = (getSpanIndex() == EXPERTSPANINDEX);
+
+	/* A segment of a multi-band sweep steps through its own EasyRF span */
+	if (multiBandCount > 0U)
+	{
+		segment = &multiBand[multiBandSegment];
+		freqStep = sa1350SpanParams[segment->spanIndex].spanFreqStep;
+		numSteps = sa1350SpanParams[segment->spanIndex].spanNumSteps;
+		band = segment->band;
+		sweepPlan.segmentEnd = segment->end;
+		sweepPlan.isExpert = FALSE;
+	}
+
+	sweepPlan.fractStep = freqStep;
+
+	/* The last step of a MHz is the one with fracFreqStepIndex() equal to
+	 * saNumSteps - 1, i.e. a fractFreq in [wrapLow, wrapHigh) */
+	sweepPlan.wrapLow = (uint32_t)freqStep * (numSteps - 1U);
+	sweepPlan.wrapHigh = sweepPlan.wrapLow + freqStep;
+
+	/* Bands do not overlap, so the sweep or segment is in the 2.4GHz band
+	 * or not */
+	sweepPlan.rssiOffset = (band == BAND_2400M) ? RSSI_OFFSET_2400 : 0;
+
+	/* Room for every settle wait and dwell read of a step. RX only runs this
+	 * long when the RF task is late to cancel it, see rfTaskFxn() */
+	sweepPlan.rxEndTime = ((RSSI_READ_RETRIES + 1U) * rssiSettleTicks
+			+ (detectorDwell - 1U) * rssiDwellTicks + 1U)
+			* Clock_tickPeriod * RAT_TICKS_PER_US;
+}
+
 /** @brief Increment the RF sweep frequency dependent upon RF mode.
+ *
+ *  @param cmdFs CMD_FS to step, #RF_cmdFs or a queued sweep step.
  *
  *  @par Usage
  *       @code
- *       setNewSweep();
+ *       updateSweepFreq(&RF_cmdFs);
  *       @endcode
  */
-static void updateSweepFreq(void)
+static void updateSweepFreq(rfc_CMD_FS_t *cmdFs)
 {
-	if (getSpanIndex() != EXPERTSPANINDEX)
+	uint16_t fractFreq = cmdFs->fractFreq;
+
+	if (!sweepPlan.isExpert)
 	{
 		/* Sweep freq by saNumSteps per MHz in saFreqStep increments		*/
-		if (fracFreqStepIndex(RF_cmdFs.fractFreq) == (getNumSteps() - 1U))
+		if ((fractFreq >= sweepPlan.wrapLow)
+				&& (fractFreq < sweepPlan.wrapHigh))
 		{
-			RF_cmdFs.fractFreq = 0U;
-			RF_cmdFs.frequency++;
+			cmdFs->fractFreq = 0U;
+			cmdFs->frequency++;
 		}
 		else
 		{
-			RF_cmdFs.fractFreq += getFreqStep();
+			cmdFs->fractFreq = fractFreq + sweepPlan.fractStep;
 		}
 	}
 	else
 	{
 		/* Sweep freq in saFreqStep increments with an overflow per MHz		*/
-		RF_cmdFs.fractFreq += getFreqStep();
-		if (RF_cmdFs.fractFreq < getFreqStep() || getFreqStep() == 0)
+		fractFreq += sweepPlan.fractStep;
+		cmdFs->fractFreq = fractFreq;
+		if (fractFreq < sweepPlan.fractStep || sweepPlan.fractStep == 0U)
 		{
-			RF_cmdFs.frequency++;
+			cmdFs->frequency++;
 		}
 	}
 }
 
-/** @brief Setter function for new sweep data request.
+/** @brief Publish the filled sweep buffer and notify waiting tasks.
+ *
+ *  The buffer becomes the latest completed sweep and the RF task continues
+ *  with the previous sweep's buffer once no reader holds it. While a reader
+ *  holds it, the sweep is dropped and its buffer filled again, so the RF task
+ *  never waits for UART or display.
+ *
+ *  @param sweepLength number of RSSI values in the filled buffer.
  *
  *  @par Usage
  *       @code
- *       setNewSweep();
+ *       setNewSweep(*sweepIndex);
  *       @endcode
  */
-static void setNewSweep(void)
+static void setNewSweep(uint16_t sweepLength)
 {
+	IArg mutexKey;
+	uint8_t bufferIndex;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+
+	for (bufferIndex = 0U; bufferIndex < SWEEP_BUFFER_COUNT; bufferIndex++)
+	{
+		if ((bufferIndex != fillBuffer) && (bufferIndex != readyBuffer)
+				&& (sweepBuffers[bufferIndex].readers == 0U))
+		{
+			break;
+		}
+	}
+
+	if ((bufferIndex == SWEEP_BUFFER_COUNT)
+			&& (sweepBuffers[readyBuffer].readers == 0U))
+	{
+		/* Only the previous sweep is free, replace it */
+		bufferIndex = readyBuffer;
+	}
+
+	if (bufferIndex < SWEEP_BUFFER_COUNT)
+	{
+		sweepCount++;
+		sweepBuffers[fillBuffer].length = sweepLength;
+		sweepBuffers[fillBuffer].count = sweepCount;
+		sweepBuffers[fillBuffer].isZeroSpan = isZeroSpan;
+		readyBuffer = fillBuffer;
+		fillBuffer = bufferIndex;
+	}
+
+	restartFill();
+
+	GateMutexPri_leave(sweepMutex, mutexKey);
+
 	/* Notify all pending tasks of new sweep */
 	while(!Semaphore_getCount(newSpectrumSemaphore))
 	{
@@ -716,6 +1042,20 @@ static void setNewSweep(void)
 	Semaphore_pend(newSpectrumSemaphore, BIOS_NO_WAIT);
 }
 
+/** @brief Start filling the sweep buffer from its first value. Readers of
+ *  the progress see the pass change and drop the values they read so far.
+ *
+ *  @par Usage
+ *       @code
+ *       restartFill();
+ *       @endcode
+ */
+static void restartFill(void)
+{
+	sweepBuffers[fillBuffer].filled = 0U;
+	sweepBuffers[fillBuffer].pass++;
+}
+
 /** @brief Decrease center frequency of RF sweep by one step.
  *
  *  @par Usage
@@ -886,65 +1226,209 @@ static void remapFracFreqs(uint8_t nextSpanIndex)
 	setEndFracFreq((uint16_t)newEndIndex * nextFreqSteps);
 }
 
-/** @brief Update RBW, frequency step size, and frequency step count for sweep.
- *         Open connection to radio for the sweep.
+/** @brief Update the RSSI settle time for the RBW the radio runs with.
+ *
+ *  The RSSI is valid once the receiver is running and its channel filter has
+ *  settled, which takes longer for narrower RBWs.
+ *
+ *  @param band band of the radio setup.
+ *  @param rbw rxBw setting of the radio setup.
  *
  *  @par Usage
  *       @code
- *       updateRadioRF(();
+ *       updateRssiSettle(getBand(), getRBW());
  *       @endcode
-**/
-static void updateRadioRF(void)
+ */
+static void updateRssiSettle(SABand band, uint8_t rbw)
+{
+	const SARBW *rbwTable = CC13xxSubGigTableRBW;
+	uint8_t rbwIndex;
+	uint32_t settleUs, dwellUs;
+
+	if (band == BAND_2400M)
+	{
+		rbwTable = CC13xx2_4GTableRBW;
+	}
+
+	/* Unknown settings use the narrowest RBW and so the longest wait */
+	rbwIndex = rbw - rbwTable[0U].rbwSetting;
+	if (rbwIndex >= MAX_ITEMS_RBW)
+	{
+		rbwIndex = 0U;
+	}
+
+	dwellUs = (uint32_t)(
+			(RSSI_SETTLE_RBW_PERIODS * 1000.0) / rbwTable[rbwIndex].rbwRBW);
+	settleUs = RSSI_SETTLE_RX_US + dwellUs;
+
+	/* Round up, Task_sleep() may return up to one tick early */
+	rssiSettleTicks = ((settleUs + Clock_tickPeriod - 1U) / Clock_tickPeriod)
+			+ 1U;
+
+	/* The RSSI follows the input within the same filter periods, so reads
+	 * that far apart are not repeats of the previous one.
+	 */
+	rssiDwellTicks = (dwellUs + Clock_tickPeriod - 1U) / Clock_tickPeriod;
+}
+
+/** @brief Prepare the radio setup of each band from the SmartRF settings.
+ *  The center frequency is set with the band, see setBand().
+ *
+ *  @par Usage
+ *       @code
+ *       prepareBandSetups();
+ *       @endcode
+ */
+static void prepareBandSetups(void)
+{
+	uint8_t bandIndex;
+
+	for (bandIndex = 0U; bandIndex < BAND_COUNT; bandIndex++)
+	{
+		bandSetups[bandIndex] = RF_cmdPropRadioDivSetup;
+		bandSetups[bandIndex].loDivider = bandInfo[bandIndex].loDivider;
+	}
+}
+
+/** @brief Run the radio with the prepared setup of a band.
+ *
+ *  Within sub-1GHz or 2.4GHz the setup is run on the open RF handle, which
+ *  keeps the RF mode and its patches. Only a change between the two needs
+ *  the handle closed and opened again. Both ways of switching bands are
+ *  timed in #bandSwitchStats, see getBandSwitchStats().
+ *
+ *  @param band band of the setup, not #BAND_UNKNOWN.
+ *  @param rxBw RBW setting of the setup.
+ *  @param centerFreq center frequency of the setup in MHz.
+ *
+ *  @par Usage
+ *       @code
+ *       switchRadio(BAND_900M, getRBW(), centerFreq);
+ *       @endcode
+ */
+static void switchRadio(SABand band, uint8_t rxBw, uint16_t centerFreq)
 {
 	ChipType_t easyChipType = ChipInfo_GetChipType();
+	uint32_t switchTicks = Clock_getTicks();
+	_Bool isBandSwitch = (radioBand != BAND_UNKNOWN) && (band != radioBand);
+	BandSwitchTimes *switchTimes;
+	IArg mutexKey;
 
-    /* Configure the radio for Proprietary mode */
-    RF_Params_init(&rfParams);
-	/* Close radio connection */
-    if(rfHandle != (RF_Handle)NULL)
-    {
-    	RF_close(rfHandle);
-    }
+	/* The RF driver runs this setup whenever it powers up the radio */
+	RF_cmdPropRadioDivSetup = bandSetups[band - BAND_400M];
+	RF_cmdPropRadioDivSetup.rxBw = rxBw;
+	RF_cmdPropRadioDivSetup.centerFreq = centerFreq;
 
-    /* Update SA_Params for new span */
-    setFreqStep(getSpanFreqStep());
-    setNumSteps(getSpanNumSteps());
-    setRBW(getSpanRBW());
+	if ((rfHandle != (RF_Handle)NULL)
+			&& ((band == BAND_2400M) == (radioBand == BAND_2400M)))
+	{
+		/* Same RF mode, the RF core only changes LO divider and receiver */
+		RF_control(rfHandle, RF_CTRL_UPDATE_SETUP_CMD, NULL);
+		RF_runCmd(rfHandle, (RF_Op *)&RF_cmdPropRadioDivSetup,
+				RF_PriorityNormal, (RF_Callback)0, (RF_EventMask)0);
+		switchTimes = &bandSwitchStats.setup;
+	}
+	else
+	{
+		/* Configure the radio for Proprietary mode */
+		RF_Params_init(&rfParams);
+		/* Close radio connection */
+		if (rfHandle != (RF_Handle)NULL)
+		{
+			RF_close(rfHandle);
+		}
 
-    RF_cmdPropRadioDivSetup.rxBw = getRBW();
+		/* Select radio command based upon band */
+		if (band != BAND_2400M)
+		{
+			if (easyChipType == CHIP_TYPE_CC1350)
+			{
+				/* Switch RF switch to Sub1G antenna */
+				PIN_setOutputValue(rfSwPinHandle, Board_DIO1_RFSW, 1U);
+			}
 
-    /* Select radio command based upon band */
-    if (getStartFreq() < MINFREQ_2400)
-    {
-        if (easyChipType == CHIP_TYPE_CC1350)
-        {
-    	    /* Switch RF switch to Sub1G antenna */
-            PIN_setOutputValue(rfSwPinHandle, Board_DIO1_RFSW, 1U);
-        }
+			/* Request access to the radio */
+			rfHandle = RF_open(&rfObject, &RF_propSub1,
+					(RF_RadioSetup *)&RF_cmdPropRadioDivSetup, &rfParams);
+		}
+		/* Should never get here unless chip is CC1350 */
+		else if (easyChipType == CHIP_TYPE_CC1350)
+		{
+			/* Switch RF switch to 2.4G antenna */
+			PIN_setOutputValue(rfSwPinHandle, Board_DIO1_RFSW, 0U);
 
-    	/* Request access to the radio */
-    	rfHandle = RF_open(&rfObject, &RF_propSub1,
-    			(RF_RadioSetup *)&RF_cmdPropRadioDivSetup, &rfParams);
-    }
-    /* Should never get here unless chip is CC1350 */
-    else if (easyChipType == CHIP_TYPE_CC1350)
-    {
-        /* Switch RF switch to 2.4G antenna */
-        PIN_setOutputValue(rfSwPinHandle, Board_DIO1_RFSW, 0U);
+			/* Request access to the radio */
+			rfHandle = RF_open(&rfObject, &RF_prop2_4,
+					(RF_RadioSetup *)&RF_cmdPropRadioDivSetup, &rfParams);
+		}
+		else /* Should never get here */
+		{
+			rfHandle = (RF_Handle)NULL;
+		}
 
-    	/* Request access to the radio */
-    	rfHandle = RF_open(&rfObject, &RF_prop2_4,
-    			(RF_RadioSetup *)&RF_cmdPropRadioDivSetup, &rfParams);
-    }
-    else /* Should never get here */
-    {
-    	rfHandle = (RF_Handle)NULL;
-    }
+		if (rfHandle == (RF_Handle)NULL)
+		{
+			System_abort("Error initializing radio\n");
+		}
 
-    if (rfHandle == (RF_Handle)NULL)
-    {
-        System_abort("Error initializing radio\n");
-    }
+		switchTimes = &bandSwitchStats.reopen;
+	}
+
+	radioBand = band;
+
+	if (isBandSwitch)
+	{
+		switchTicks = Clock_getTicks() - switchTicks;
+
+		mutexKey = GateMutexPri_enter(sweepMutex);
+		switchTimes->count++;
+		switchTimes->lastTicks = switchTicks;
+		if (switchTicks > switchTimes->maxTicks)
+		{
+			switchTimes->maxTicks = switchTicks;
+		}
+		switchTimes->totalTicks += switchTicks;
+		GateMutexPri_leave(sweepMutex, mutexKey);
+	}
+}
+
+/** @brief Run the radio with the setup of the single band sweep.
+ *
+ *  @par Usage
+ *       @code
+ *       selectSweepRadio();
+ *       @endcode
+ */
+static void selectSweepRadio(void)
+{
+	SABand band = getBand();
+
+	/* Outside the bands the radio stays in the band it is in */
+	if (band == BAND_UNKNOWN)
+	{
+		band = radioBand;
+	}
+
+	updateRssiSettle(band, getRBW());
+	switchRadio(band, getRBW(), bandSetups[band - BAND_400M].centerFreq);
+}
+
+/** @brief Update RBW, frequency step size, and frequency step count for sweep.
+ *         Run the radio with the setup for the sweep.
+ *
+ *  @par Usage
+ *       @code
+ *       updateRadioRF();
+ *       @endcode
+**/
+static void updateRadioRF(void)
+{
+    /* Update SA_Params for new span */
+    setFreqStep(getSpanFreqStep());
+    setNumSteps(getSpanNumSteps());
+    setRBW(getSpanRBW());
+
+    selectSweepRadio();
 }
 
 /** @brief Decrease span length (zoom in) of RF sweep by one span index.
@@ -1139,13 +1623,17 @@ static void updateExpertSpan(void)
  *
  *  @param index value corresponding to span index.
  *
+ *  @return TRUE when the span index was accepted and the radio updated
+ *
  *  @par Usage
  *       @code
  *       changeSpan(cmdMessage.payload[0]);
  *       @endcode
  */
-static void changeSpan(uint8_t index)
+static _Bool changeSpan(uint8_t index)
 {
+	_Bool isSpanChange = FALSE;
+
 	/* Only update when host requests a band the target can support.        */
     /* This is a workaround for CC1310 to ignore host requests for 2.4GHz.	*/
 	if (((ChipInfo_GetChipType() == CHIP_TYPE_CC1350)
@@ -1174,7 +1662,11 @@ static void changeSpan(uint8_t index)
 
 		/* Adjust rxBw, steps, and numsteps and reprogram PLL.              */
 		updateRadioRF();
+
+		isSpanChange = TRUE;
 	}
+
+	return isSpanChange;
 }
 
 /** @brief Get the current frequency band the RF sweep is within.
@@ -1239,11 +1731,6 @@ static void setBand(SABand band)
 			setEndFreq(ENDFREQ_400);
 			setMinFreq(MINFREQ_400);
 			setMaxFreq(MAXFREQ_400);
-			/* Update Frequency divider */
-			RF_cmdPropRadioDivSetup.loDivider = IODIV_440MHZ;
-			/* Update center frequency to match band */
-			RF_cmdPropRadioDivSetup.centerFreq = getStartFreq() +
-					(getSpan() / 2U);
 			break;
 
 		case BAND_900M:
@@ -1252,11 +1739,6 @@ static void setBand(SABand band)
 			setEndFreq(ENDFREQ_900);
 			setMinFreq(MINFREQ_900);
 			setMaxFreq(MAXFREQ_900);
-			/* Update Frequency divider */
-			RF_cmdPropRadioDivSetup.loDivider = IODIV_915MHZ;
-			/* Update center frequency to match band */
-			RF_cmdPropRadioDivSetup.centerFreq = getStartFreq() +
-					(getSpan() / 2U);
 			break;
 
 		case BAND_2400M:
@@ -1265,11 +1747,6 @@ static void setBand(SABand band)
 			setEndFreq(ENDFREQ_2400);
 			setMinFreq(MINFREQ_2400);
 			setMaxFreq(MAXFREQ_2400);
-			/* Update Frequency divider */
-			RF_cmdPropRadioDivSetup.loDivider = IODIV_2440MHZ;
-			/* Update center frequency to match band */
-			RF_cmdPropRadioDivSetup.centerFreq = getStartFreq() +
-					(getSpan() / 2U);
 			break;
 
 		default: /* Entering unknown band */
@@ -1279,6 +1756,9 @@ static void setBand(SABand band)
 
 	if (isBandSet)
 	{
+		/* Update center frequency of the band's radio setup to match */
+		bandSetups[band - BAND_400M].centerFreq = getStartFreq() +
+				(getSpan() / 2U);
 		/* Reset to SPAN0 */
 		setSpanIndex(MINEZSPANINDEX);
 		/* Reset fractional frequency values to 0 */
@@ -1321,20 +1801,19 @@ static void nextBand(SABand currBand)
     }
 }
 
-/** @brief Change the RF sweep to the specified frequency band or the next
- *  band in the sequnce of bands.
- *
- *  Presently supports 440MHz, 900MHz and 2.4GHz ISM bands.
+/** @brief Select a frequency band without reprogramming the radio.
  *
  *  @param newBand #ChangeBandArg value corresponding to specific requested
  *  band (400M, 900M, or 2.4G) or request to switch to next band in sequence.
  *
+ *  @return TRUE when the radio needs to be updated for the band
+ *
  *  @par Usage
  *       @code
- *       changeBand(Set_400M_Band);
+ *       isBandChange = selectBand(SET_400M_BAND);
  *       @endcode
  */
-static void changeBand(ChangeBandArg newBand)
+static _Bool selectBand(ChangeBandArg newBand)
 {
     ChipType_t changeChipType = ChipInfo_GetChipType();
     SABand band = getBand();
@@ -1373,19 +1852,37 @@ static void changeBand(ChangeBandArg newBand)
     		break;
     }
 
-	if (isBandChange == TRUE)
-	{
-	    /* Call updateRadioRF to adjust rxBw, steps, and numsteps and reprogram PLL */
-	    updateRadioRF();
-	}
+	return isBandChange;
 }
 
-/** @brief Status of the RF sweep control mode between incremental (button) and
- *  host command modes.
+/** @brief Change the RF sweep to the specified frequency band or the next
+ *  band in the sequnce of bands.
+ *
+ *  Presently supports 440MHz, 900MHz and 2.4GHz ISM bands.
+ *
+ *  @param newBand #ChangeBandArg value corresponding to specific requested
+ *  band (400M, 900M, or 2.4G) or request to switch to next band in sequence.
  *
  *  @par Usage
  *       @code
- *       if(!getCommandMode()){//incremental mode code};
+ *       changeBand(Set_400M_Band);
+ *       @endcode
+ */
+static void changeBand(ChangeBandArg newBand)
+{
+	if (selectBand(newBand))
+	{
+	    /* Call updateRadioRF to adjust rxBw, steps, and numsteps and reprogram PLL */
+	    updateRadioRF();
+	}
+}
+
+/** @brief Status of the RF sweep control mode between incremental (button) and
+ *  host command modes.
+ *
+ *  @par Usage
+ *       @code
+ *       if(!getCommandMode()){//incremental mode code};
  *       @endcode
  */
 static _Bool getCommandMode(void)
@@ -1417,6 +1914,14 @@ static void setCommandMode(_Bool commandMode)
 		}
 	}
 
+	/* Every host and the button mode start with one read per step */
+	detectorMode = DETECTOR_SAMPLE;
+	detectorDwell = 1U;
+
+	/* A zero span or trigger ends with the host that started it */
+	stopZeroSpan();
+	stopTrigger();
+
 	isCommandMode = commandMode;
 }
 
@@ -1526,6 +2031,463 @@ static void cmdSetSpan(const uint8_t *values)
 	sa1350CmdParams.saSpan = (uint16_t)((values[0U] << 8U) | (values[1U]));
 }
 
+/** @brief Set the complete RF sweep configuration from one host command.
+ *
+ *  Band, frequencies, RBW and span are applied together and the radio is
+ *  reprogrammed once, so no sweep runs with part of the configuration.
+ *
+ *  @param values pointer to command payload, see CMD_SETSWEEP in
+ *  uartHostComms.c for the layout.
+ *
+ *  @par Usage
+ *       @code
+ *       cmdSetSweep(&values);
+ *       @endcode
+ */
+static void cmdSetSweep(const uint8_t *values)
+{
+	_Bool isBandChange;
+
+	cmdSetStartFreq(&values[1U]);
+	cmdSetEndFreq(&values[5U]);
+	cmdSetRbw(&values[9U]);
+	cmdSetFreqStep(&values[10U]);
+	cmdSetStepCount(&values[14U]);
+	cmdSetSpan(&values[16U]);
+
+	/* Band first, the new frequencies are checked against it */
+	isBandChange = selectBand((ChangeBandArg)values[0U]);
+
+	if (!changeSpan(values[18U]) && isBandChange)
+	{
+		/* Span index rejected, the radio still needs the new band */
+		updateRadioRF();
+	}
+
+	/* Do not send a sweep completed with the old configuration */
+	discardSweep();
+}
+
+/** @brief Set the detector of the RF sweep.
+ *
+ *  @param values pointer to command payload, detector mode and dwell count
+ *  checked by the UART task.
+ *
+ *  @par Usage
+ *       @code
+ *       cmdSetDetector(&values);
+ *       @endcode
+ */
+static void cmdSetDetector(const uint8_t *values)
+{
+	detectorMode = values[0U];
+	detectorDwell = values[1U];
+
+	/* Do not send a sweep completed with the old detector */
+	discardSweep();
+}
+
+/** @brief Tune the synthesizer once and sample RSSI over time, see
+ *  zeroSpanBlock(). Frequencies outside the band are ignored.
+ *
+ *  @param values pointer to command payload, frequency in MHz and 1/65536
+ *  MHz followed by the sample interval in microseconds.
+ *
+ *  @par Usage
+ *       @code
+ *       cmdStartZeroSpan(&values);
+ *       @endcode
+ */
+static void cmdStartZeroSpan(const uint8_t *values)
+{
+	uint16_t frequency = (uint16_t)((values[0U] << 8U) | values[1U]);
+	uint32_t intervalUs = (uint32_t)((values[4U] << 8U) | values[5U]);
+
+	if ((frequency < getMinFreq()) || (frequency > getMaxFreq()))
+	{
+		return;
+	}
+
+	stopZeroSpan();
+
+	RF_cmdFs.frequency = frequency;
+	RF_cmdFs.fractFreq = (uint16_t)((values[2U] << 8U) | values[3U]);
+
+	/* RX keeps running until stopZeroSpan(), RSSI is read without retuning */
+	Semaphore_reset(rfStepSemaphore, 0);
+	RF_postCmd(rfHandle, (RF_Op *)&RF_cmdFs, RF_PriorityNormal,
+			&rfCallbackFxn, (RF_EventMask)0);
+	zeroSpanRxCmd = RF_postCmd(rfHandle, (RF_Op *)&RF_cmdRxTest,
+			RF_PriorityNormal, (RF_Callback)0, (RF_EventMask)0);
+	Semaphore_pend(rfStepSemaphore, RF_STEP_TIMEOUT);
+	Task_sleep(rssiSettleTicks);
+
+	/* One tick is the shortest interval, it still lets the UART task run */
+	zeroSpanTicks = (intervalUs + Clock_tickPeriod - 1U) / Clock_tickPeriod;
+	if (zeroSpanTicks == 0U)
+	{
+		zeroSpanTicks = 1U;
+	}
+
+	isZeroSpan = TRUE;
+
+	/* Do not send a sweep as a zero span block */
+	discardSweep();
+}
+
+/** @brief Leave zero span, the sweep restarts at its start frequency.
+ *
+ *  @par Usage
+ *       @code
+ *       stopZeroSpan();
+ *       @endcode
+ */
+static void stopZeroSpan(void)
+{
+	if (!isZeroSpan)
+	{
+		return;
+	}
+
+	RF_cancelCmd(rfHandle, zeroSpanRxCmd, 0U);
+	isZeroSpan = FALSE;
+
+	/* Do not send a zero span block as a sweep */
+	discardSweep();
+}
+
+/** @brief Fill the next buffer with RSSI samples taken every #zeroSpanTicks
+ *  and publish it. A pending RF command ends the block early.
+ *
+ *  @par Usage
+ *       @code
+ *       zeroSpanBlock();
+ *       @endcode
+ */
+static void zeroSpanBlock(void)
+{
+	SweepBuffer *block = &sweepBuffers[fillBuffer];
+	uint16_t sampleIndex;
+	int8_t rssiValue;
+
+	block->startTick = Clock_getTicks();
+	block->endTick = block->startTick;
+
+	for (sampleIndex = 0U; sampleIndex < ZERO_SPAN_BLOCK_LENGTH; sampleIndex++)
+	{
+		if (Mailbox_getNumPendingMsgs(rfMailbox) > 0)
+		{
+			break;
+		}
+
+		if (sampleIndex > 0U)
+		{
+			Task_sleep(zeroSpanTicks);
+		}
+
+		block->endTick = Clock_getTicks();
+		rssiValue = RF_getRssi(rfHandle);
+
+		/* Same 2.4GHz band adjustment as the sweep */
+		if ((RF_cmdFs.frequency >= MINFREQ_2400)
+				&& (rssiValue != (int8_t)RF_GET_RSSI_ERROR_VAL))
+		{
+			rssiValue += RSSI_OFFSET_2400;
+		}
+		block->rssi[sampleIndex] = rssiValue;
+	}
+
+	if (sampleIndex > 0U)
+	{
+		setNewSweep(sampleIndex);
+	}
+}
+
+/** @brief Arm the threshold trigger. The ring restarts empty, see
+ *  triggerSweep().
+ *
+ *  @param values pointer to command payload, global level in dBm, sweeps
+ *  before and after the trigger sweep and the trigger flags.
+ *
+ *  @par Usage
+ *       @code
+ *       cmdArmTrigger(&values);
+ *       @endcode
+ */
+static void cmdArmTrigger(const uint8_t *values)
+{
+	IArg mutexKey;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	triggerLevel = (int8_t)values[0U];
+	triggerPre = values[1U];
+	triggerPost = values[2U];
+	triggerFlags = values[3U];
+	triggerHead = 0U;
+	triggerFill = 0U;
+	triggerState = TRIGGER_ARMED;
+	GateMutexPri_leave(sweepMutex, mutexKey);
+}
+
+/** @brief Disarm the trigger, a burst not yet sent is dropped.
+ *
+ *  @par Usage
+ *       @code
+ *       stopTrigger();
+ *       @endcode
+ */
+static void stopTrigger(void)
+{
+	IArg mutexKey;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	triggerState = TRIGGER_OFF;
+	GateMutexPri_leave(sweepMutex, mutexKey);
+}
+
+/** @brief Set up a sweep over segments in up to three bands. Each segment
+ *  sweeps an EasyRF span in its band, the radio switches to the prepared
+ *  setup of the next band between segments, see startSweepSegment().
+ *  Segments outside their band, a band used twice or more than
+ *  #MAX_SWEEP_LENGTH steps in total are ignored.
+ *
+ *  @param values pointer to command payload, the segment count followed by
+ *  #MULTIBAND_SEGMENT_SIZE bytes per segment, see CMD_SETMULTIBAND in
+ *  uartHostComms.c. No segments return to the single band sweep.
+ *
+ *  @par Usage
+ *       @code
+ *       cmdSetMultiBand(&values);
+ *       @endcode
+ */
+static void cmdSetMultiBand(const uint8_t *values)
+{
+	BandSegment segments[MULTIBAND_MAX_SEGMENTS];
+	const SASpan *span;
+	const uint8_t *segmentValues;
+	uint8_t count = values[0U], segment, bandIndex, bandMask = 0U;
+	uint16_t startFreq;
+	uint32_t length = 0U;
+
+	if (count == 0U)
+	{
+		stopMultiBand();
+		return;
+	}
+
+	if (count > MULTIBAND_MAX_SEGMENTS)
+	{
+		return;
+	}
+
+	for (segment = 0U; segment < count; segment++)
+	{
+		/* Band as in CHANGE_BAND, start frequency and EasyRF span index */
+		segmentValues = &values[1U + (segment * MULTIBAND_SEGMENT_SIZE)];
+		bandIndex = segmentValues[0U];
+		startFreq = (uint16_t)((segmentValues[1U] << 8U) | segmentValues[2U]);
+
+		if ((bandIndex >= BAND_COUNT) || ((bandMask & (1U << bandIndex)) != 0U)
+				|| (segmentValues[3U] > MAXEZSPANINDEX)
+				|| ((bandIndex == SET_2400M_BAND)
+						&& (ChipInfo_GetChipType() != CHIP_TYPE_CC1350)))
+		{
+			return;
+		}
+
+		span = &sa1350SpanParams[segmentValues[3U]];
+		length += (uint32_t)span->spanSpan * span->spanNumSteps;
+
+		if ((startFreq < bandInfo[bandIndex].minFreq)
+				|| ((startFreq + span->spanSpan) > bandInfo[bandIndex].maxFreq)
+				|| (length > MAX_SWEEP_LENGTH))
+		{
+			return;
+		}
+
+		bandMask |= (uint8_t)(1U << bandIndex);
+		segments[segment].band = (SABand)(BAND_400M + bandIndex);
+		segments[segment].startFreq = startFreq;
+		segments[segment].centerFreq = startFreq + (span->spanSpan / 2U);
+		segments[segment].spanIndex = segmentValues[3U];
+		segments[segment].end = (uint16_t)length;
+	}
+
+	for (segment = 0U; segment < count; segment++)
+	{
+		multiBand[segment] = segments[segment];
+	}
+	multiBandCount = count;
+
+	stopZeroSpan();
+
+	/* Do not send a sweep completed with the old segments */
+	discardSweep();
+}
+
+/** @brief Return from a multi-band sweep to the single band sweep.
+ *
+ *  @par Usage
+ *       @code
+ *       stopMultiBand();
+ *       @endcode
+ */
+static void stopMultiBand(void)
+{
+	if (multiBandCount == 0U)
+	{
+		return;
+	}
+
+	multiBandCount = 0U;
+	multiBandSegment = 0U;
+	selectSweepRadio();
+
+	/* Do not send a multi-band sweep as a single band one */
+	discardSweep();
+}
+
+/** @brief Continue the sweep at the start of a segment of a multi-band
+ *  sweep, switching the radio to the band of the segment. Segment 0 of a
+ *  single band sweep is the whole sweep.
+ *
+ *  @param segment index into #multiBand.
+ *
+ *  @par Usage
+ *       @code
+ *       startSweepSegment(0U);
+ *       @endcode
+ */
+static void startSweepSegment(uint8_t segment)
+{
+	const BandSegment *bandSegment;
+	uint8_t rbw;
+
+	multiBandSegment = segment;
+
+	if (multiBandCount == 0U)
+	{
+		RF_cmdFs.frequency = getStartFreq();
+		RF_cmdFs.fractFreq = getStartFracFreq();
+	}
+	else
+	{
+		bandSegment = &multiBand[segment];
+		rbw = sa1350SpanParams[bandSegment->spanIndex].spanRBW;
+
+		/* With a single segment the radio only switches once */
+		if ((bandSegment->band != radioBand)
+				|| (rbw != RF_cmdPropRadioDivSetup.rxBw)
+				|| (bandSegment->centerFreq
+						!= RF_cmdPropRadioDivSetup.centerFreq))
+		{
+			updateRssiSettle(bandSegment->band, rbw);
+			switchRadio(bandSegment->band, rbw, bandSegment->centerFreq);
+		}
+
+		RF_cmdFs.frequency = bandSegment->startFreq;
+		RF_cmdFs.fractFreq = 0U;
+	}
+
+	updateSweepPlan();
+}
+
+/** @brief Keep a completed sweep in the trigger ring and check it against
+ *  the trigger levels. After the post-trigger sweeps the ring is frozen
+ *  until the UART task sent it and called releaseTriggerBurst(). Sweeps
+ *  longer than #TRIGGER_MAX_LENGTH are not kept.
+ *
+ *  @param rssi RSSI values of the sweep
+ *  @param length Number of RSSI values
+ *
+ *  @par Usage
+ *       @code
+ *       triggerSweep(sweepBuffers[fillBuffer].rssi, *sweepIndex);
+ *       @endcode
+ */
+static void triggerSweep(const int8_t *rssi, uint16_t length)
+{
+	IArg mutexKey;
+	TriggerSweep *entry;
+	uint16_t index;
+	_Bool isCrossed = FALSE;
+
+	/* Only the RF task moves the state out of ARMED and POST */
+	if ((triggerState == TRIGGER_OFF) || (triggerState == TRIGGER_READY)
+			|| (length > TRIGGER_MAX_LENGTH))
+	{
+		return;
+	}
+
+	entry = &triggerBurst.sweeps[triggerHead];
+	for (index = 0U; index < length; index++)
+	{
+		entry->rssi[index] = rssi[index];
+	}
+	entry->length = length;
+	entry->tick = Clock_getTicks();
+
+	if (triggerState == TRIGGER_ARMED)
+	{
+		for (index = 0U; (index < length) && !isCrossed; index++)
+		{
+			isCrossed = (rssi[index] != (int8_t)RF_GET_RSSI_ERROR_VAL)
+					&& (rssi[index] >= ((triggerFlags & TRIGGER_PER_POINT)
+							? triggerLevels[index] : triggerLevel));
+		}
+	}
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+
+	if (triggerState == TRIGGER_POST)
+	{
+		triggerBurst.length++;
+		triggerPostLeft--;
+	}
+	else if (isCrossed)
+	{
+		/* Fewer pre-trigger sweeps if the ring is not filled yet */
+		index = (triggerFill < triggerPre) ? triggerFill : triggerPre;
+		triggerBurst.first = (uint8_t)((triggerHead + TRIGGER_RING_LENGTH - index)
+				% TRIGGER_RING_LENGTH);
+		triggerBurst.trigger = (uint8_t)index;
+		triggerBurst.length = (uint8_t)(index + 1U);
+		triggerPostLeft = triggerPost;
+		triggerState = TRIGGER_POST;
+	}
+
+	if ((triggerState == TRIGGER_POST) && (triggerPostLeft == 0U))
+	{
+		triggerBurst.count++;
+		triggerState = TRIGGER_READY;
+	}
+
+	triggerHead = (uint8_t)((triggerHead + 1U) % TRIGGER_RING_LENGTH);
+	if (triggerFill < TRIGGER_RING_LENGTH)
+	{
+		triggerFill++;
+	}
+
+	GateMutexPri_leave(sweepMutex, mutexKey);
+}
+
+/** @brief Drop the latest completed sweep. Readers see a length of 0 until
+ *  the next sweep completes.
+ *
+ *  @par Usage
+ *       @code
+ *       discardSweep();
+ *       @endcode
+ */
+static void discardSweep(void)
+{
+	IArg mutexKey;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	sweepBuffers[readyBuffer].length = 0U;
+	GateMutexPri_leave(sweepMutex, mutexKey);
+}
+
 /** @brief Update RF parameters based on user input.
  *
  *  This function is used to update RF parameters to increase/decrease span,
@@ -1548,6 +2510,14 @@ static _Bool rfCommand(void)
 	{
 		isCommandToExecute = TRUE;
 
+		/* Commands of the single band sweep end a multi-band sweep */
+		if (((cmdMessage.command >= DECREMENT_FREQ)
+				&& (cmdMessage.command <= SET_SWEEP))
+				|| (cmdMessage.command == START_ZERO_SPAN))
+		{
+			stopMultiBand();
+		}
+
 		switch (cmdMessage.command)
 		{
 			case NO_USER_COMMAND:
@@ -1602,10 +2572,32 @@ static _Bool rfCommand(void)
 			case SET_STEPCOUNT:		/* Set frequency step count */
 				cmdSetStepCount(cmdMessage.payload);
 				isCommandToExecute = FALSE;
+				break;
 			case SET_SPAN:		/* Set frequency span */
 				cmdSetSpan(cmdMessage.payload);
 				isCommandToExecute = FALSE;
 				break;
+			case SET_SWEEP:			/* Set complete sweep configuration */
+				cmdSetSweep(cmdMessage.payload);
+				break;
+			case SET_DETECTOR:		/* Set detector mode and dwell count */
+				cmdSetDetector(cmdMessage.payload);
+				break;
+			case START_ZERO_SPAN:	/* Sample RSSI at one frequency */
+				cmdStartZeroSpan(cmdMessage.payload);
+				break;
+			case STOP_ZERO_SPAN:	/* Back to the sweep */
+				stopZeroSpan();
+				break;
+			case ARM_TRIGGER:		/* Keep sweeps and check trigger levels */
+				cmdArmTrigger(cmdMessage.payload);
+				break;
+			case DISARM_TRIGGER:	/* Stop keeping sweeps */
+				stopTrigger();
+				break;
+			case SET_MULTIBAND:		/* Sweep segments in several bands */
+				cmdSetMultiBand(cmdMessage.payload);
+				break;
 			case SEND_SPECTRUM:		/* Sending new spectrum to host */
 				isCommandToExecute = FALSE;
 				break;
@@ -1636,27 +2628,130 @@ static _Bool rfCommand(void)
  */
 static void updateSweepState(uint16_t *sweepIndex)
 {
-	if (*sweepIndex == getSweepLength() || *sweepIndex == MAX_SWEEP_LENGTH)
+	if (*sweepIndex == sweepPlan.length || *sweepIndex == MAX_SWEEP_LENGTH)
 	{ /* If we reached the end of the sweep */
-		setNewSweep();
+		triggerSweep(sweepBuffers[fillBuffer].rssi, *sweepIndex);
+		setNewSweep(*sweepIndex);
 
 		rfCommand();
+		startSweepSegment(0U);
 
 		*sweepIndex = 0U;
-		RF_cmdFs.frequency = getStartFreq();
-		RF_cmdFs.fractFreq = getStartFracFreq();
 	}
-	else if (getCommandMode())
+	else if (*sweepIndex == sweepPlan.segmentEnd)
 	{
+		/* Next band of a multi-band sweep, no step of it is queued yet */
+		startSweepSegment(multiBandSegment + 1U);
+	}
+	else if (getCommandMode() && (Mailbox_getNumPendingMsgs(rfMailbox) > 0))
+	{
+		/* The step queued ahead was set up with the parameters in use */
+		cancelStepChain();
+
 		if (rfCommand())
 		{
+			startSweepSegment(0U);
+			restartFill();
 			*sweepIndex = 0U;
-			RF_cmdFs.frequency = getStartFreq();
-			RF_cmdFs.fractFreq = getStartFracFreq();
 		}
 	}
 }
 
+/** @brief Set up the chain of a sweep step: CMD_FS and, if the synthesizer
+ *  locked, CMD_RX_TEST until cancelled or #SweepPlan rxEndTime.
+ *
+ *  @param slot index into #stepFs and #stepRx, not in use by the RF core.
+ *  @param frequency synthesizer frequency in MHz.
+ *  @param fractFreq fractional part of the frequency.
+ *
+ *  @par Usage
+ *       @code
+ *       setStepChain(slot, RF_cmdFs.frequency, RF_cmdFs.fractFreq);
+ *       @endcode
+ */
+static void setStepChain(uint8_t slot, uint16_t frequency, uint16_t fractFreq)
+{
+	rfc_CMD_FS_t *cmdFs = &stepFs[slot];
+	rfc_CMD_RX_TEST_t *cmdRx = &stepRx[slot];
+
+	*cmdFs = RF_cmdFs;
+	cmdFs->status = IDLE;
+	cmdFs->frequency = frequency;
+	cmdFs->fractFreq = fractFreq;
+	cmdFs->pNextOp = (rfc_radioOp_t *)cmdRx;
+	cmdFs->condition.rule = COND_STOP_ON_FALSE;
+
+	*cmdRx = RF_cmdRxTest;
+	cmdRx->status = IDLE;
+	cmdRx->pNextOp = (rfc_radioOp_t *)NULL;
+	cmdRx->condition.rule = COND_NEVER;
+	cmdRx->endTrigger.triggerType = TRIG_REL_START;
+	cmdRx->endTime = sweepPlan.rxEndTime;
+}
+
+/** @brief Queue a sweep step set up by setStepChain() in the RF core.
+ *
+ *  @param slot index into #stepFs and #stepRx.
+ *
+ *  @return command handle of the chain, negative if the RF driver is full.
+ *
+ *  @par Usage
+ *       @code
+ *       stepCmd = postStepChain(slot);
+ *       @endcode
+ */
+static RF_CmdHandle postStepChain(uint8_t slot)
+{
+	/* rfCallbackFxn() is also called when the CMD_FS of the chain ends */
+	return RF_postCmd(rfHandle, (RF_Op *)&stepFs[slot], RF_PriorityNormal,
+			&rfCallbackFxn, RF_EventCmdDone);
+}
+
+/** @brief Read the RSSI of a sweep step. Once its CMD_RX_TEST has ended the
+ *  RF core may be receiving on the next step, so the value is not used.
+ *
+ *  @param slot index into #stepRx.
+ *
+ *  @return RSSI, 0 or #RF_GET_RSSI_ERROR_VAL if not valid.
+ *
+ *  @par Usage
+ *       @code
+ *       rssiValue = readStepRssi(slot);
+ *       @endcode
+ */
+static int8_t readStepRssi(uint8_t slot)
+{
+	uint32_t readTime = Timestamp_get32();
+	int8_t rssiValue = RF_getRssi(rfHandle);
+
+	perfRecord(PERF_RF_RSSI_READ, Timestamp_get32() - readTime);
+
+	if (stepRx[slot].status != ACTIVE)
+	{
+		rssiValue = (int8_t)RF_GET_RSSI_ERROR_VAL;
+	}
+
+	return rssiValue;
+}
+
+/** @brief Drop the sweep step queued ahead, e.g. before a command changes the
+ *  sweep. Returns once the RF core is done with its slot.
+ *
+ *  @par Usage
+ *       @code
+ *       cancelStepChain();
+ *       @endcode
+ */
+static void cancelStepChain(void)
+{
+	if (nextStepCmd >= 0)
+	{
+		RF_cancelCmd(rfHandle, nextStepCmd, 0U);
+		RF_pendCmd(rfHandle, nextStepCmd, (RF_EventMask)0);
+		nextStepCmd = RF_STEP_NONE;
+	}
+}
+
 /** @brief RF interrupt Callback function for radio calls.
  *
  *  @param hRf radio handle for interaction with RF driver.
@@ -1667,7 +2762,13 @@ static void updateSweepState(uint16_t *sweepIndex)
  */
 static void rfCallbackFxn(RF_Handle hRf, RF_CmdHandle hRfC, RF_EventMask e)
 {
-	/* Handle RF error */
+	/* A CMD_FS or the end of a chain, the RF task checks the status of the
+	 * CMD_FS it waits for */
+	if (e & (RF_EventCmdDone | RF_EventLastCmdDone | RF_EventCmdCancelled
+			| RF_EventCmdAborted | RF_EventCmdStopped))
+	{
+		Semaphore_post(rfStepSemaphore);
+	}
 }
 
 /** @brief Initialize parameters and open handle to radio.
@@ -1693,6 +2794,7 @@ static void openRadio(void)
 
     /* Indicate no active RF handle, configure radio to default operation */
     rfHandle = NULL;
+    prepareBandSetups();
     if (DEFAULT_BAND_900M)
     {
     	/* Place sweep out of band to force a change of bands */
@@ -1706,8 +2808,10 @@ static void openRadio(void)
     	changeBand(SET_400M_BAND);
     }
 
-	RF_cmdFs.frequency = getStartFreq();
-	RF_cmdFs.fractFreq = 0U;
+	startSweepSegment(0U);
+
+	/* Zero span RX runs until stopZeroSpan(), see setStepChain() for sweeps */
+	RF_cmdRxTest.endTrigger.triggerType = TRIG_NEVER;
 }
 
 /***** Global function definitions *****/
@@ -1757,7 +2861,7 @@ static void RfGateMutex_init(void)
     }
 }
 
-/** @brief Initialize and construct the new spectrum semaphore.
+/** @brief Initialize and construct the new spectrum and RF step semaphores.
  *
  *  @par Usage
  *       @code
@@ -1775,6 +2879,16 @@ static void RfSemaphore_init(void)
     if (newSpectrumSemaphore == NULL) {
         System_abort("Semaphore create failed\n");
     }
+
+    /* Posted by rfCallbackFxn() when CMD_FS ends, inital count 0 */
+    Semaphore_Params_init(&rfStepSemaphoreParams);
+    rfStepSemaphoreParams.mode = Semaphore_Mode_BINARY;
+    Semaphore_construct(&rfStepSemaphoreStruct, 0, &rfStepSemaphoreParams);
+    rfStepSemaphore = Semaphore_handle(&rfStepSemaphoreStruct);
+
+    if (rfStepSemaphore == NULL) {
+        System_abort("Semaphore create failed\n");
+    }
 }
 
 /** @brief Initialize and construct the RF task.
@@ -1786,6 +2900,14 @@ static void RfSemaphore_init(void)
  */
 void RfTask_init(void)
 {
+	uint16_t levelIndex;
+
+	/* Points without a per-point trigger level never trigger */
+	for (levelIndex = 0U; levelIndex < TRIGGER_MAX_LENGTH; levelIndex++)
+	{
+		triggerLevels[levelIndex] = INT8_MAX;
+	}
+
 	RfMailbox_init();
 	RfGateMutex_init();
 	RfSemaphore_init();
@@ -1808,11 +2930,13 @@ void RfTask_init(void)
  */
 static void rfTaskFxn(UArg rfArg0, UArg rfArg1)
 {
-	IArg mutexKey;
 	uint16_t rssiIndex = 0U;
-	int8_t *sweepArray = getSweepData();
-	uint8_t timeOut;
-	int8_t rssiValue = (int8_t)RF_GET_RSSI_ERROR_VAL;
+	int8_t *sweepArray;
+	uint8_t retry, dwell, sampleCount, slot = 0U;
+	int8_t rssiValue;
+	int8_t samples[DETECTOR_MAX_DWELL];
+	RF_CmdHandle stepCmd;
+	uint32_t fsWaitTime;
 
 	openRadio();
 
@@ -1820,55 +2944,105 @@ static void rfTaskFxn(UArg rfArg0, UArg rfArg1)
 	{
 		updateSweepState(&rssiIndex);
 
-        /* Store RSSI value. */
-        /* Lock out UART task from accessing RSSI array */
-    	mutexKey = lockSweepData();
+		if (isZeroSpan)
+		{
+			zeroSpanBlock();
+			continue;
+		}
 
-        /* Send CMD_FS and wait until it has completed */
-        RF_runCmd(rfHandle, (RF_Op *)&RF_cmdFs, RF_PriorityNormal,
-                &rfCallbackFxn, (RF_EventMask)0);
+        /* Only the RF task writes the buffer being filled */
+        sweepArray = sweepBuffers[fillBuffer].rssi;
 
-        /* Send asynchronous CMD_RX_TEST which enables RX for reading RSSI */
-        RF_CmdHandle rxTestCmd = RF_postCmd(rfHandle, (RF_Op *)&RF_cmdRxTest,
-                RF_PriorityNormal, (RF_Callback)0, (RF_EventMask)0);
+        /* Post this step unless it is already queued behind the last one */
+        stepCmd = nextStepCmd;
+        nextStepCmd = RF_STEP_NONE;
+        if (stepCmd < 0)
+        {
+            setStepChain(slot, RF_cmdFs.frequency, RF_cmdFs.fractFreq);
+            stepCmd = postStepChain(slot);
+        }
 
-        /* Make sure that the RX_TEST command is running */
-        /* Needed to avoid infinite loop here if task gets preempted during
-         * command status transition
+        /* Queue the next step in the other slot, the RF core starts its
+         * CMD_FS as soon as this CMD_RX_TEST ends. Not past the end of the
+         * sweep or its band segment or with a command pending, all may
+         * change the radio setup or the sweep.
          */
-        /* TODO 11/26 Figure out how to pend on a radio event instead of doing this timeout. */
-        timeOut = 0U;
-        while ((RF_cmdRxTest.status != ACTIVE) && (timeOut < 50U))
+        if (((rssiIndex + 1U) < sweepPlan.segmentEnd)
+                && ((rssiIndex + 1U) < MAX_SWEEP_LENGTH)
+                && !(getCommandMode()
+                        && (Mailbox_getNumPendingMsgs(rfMailbox) > 0)))
         {
-            timeOut++;
+            setStepChain(slot ^ 1U, stepFs[slot].frequency,
+                    stepFs[slot].fractFreq);
+            updateSweepFreq(&stepFs[slot ^ 1U]);
+            nextStepCmd = postStepChain(slot ^ 1U);
         }
 
-        /* Even though the command is running, we have to wait for the RF core
-         * to be in receive mode. RF core returns RSSI of 0 when not yet in
-         * receive mode
-         */
-        timeOut = 0U;
-        while (((rssiValue == (int8_t)RF_GET_RSSI_ERROR_VAL)
-                || (rssiValue == 0)) && (timeOut < 50U))
+        /* rfCallbackFxn() posts for each command ending in either chain */
+        fsWaitTime = Timestamp_get32();
+        while ((stepFs[slot].status <= ACTIVE)
+                && Semaphore_pend(rfStepSemaphore, RF_STEP_TIMEOUT))
+        {
+        }
+        perfRecord(PERF_RF_FS_WAIT, Timestamp_get32() - fsWaitTime);
+
+        rssiValue = (int8_t)RF_GET_RSSI_ERROR_VAL;
+        if (stepFs[slot].status == DONE_OK)
         {
-            rssiValue = RF_getRssi(rfHandle);
-            timeOut++;
+            /* Sleep for the settle time of the RBW from the end of CMD_FS,
+             * which started the CMD_RX_TEST. The RF core returns RSSI of 0
+             * when not yet in receive mode, e.g. after being preempted.
+             */
+            retry = 0U;
+            do
+            {
+                Task_sleep(rssiSettleTicks);
+                rssiValue = readStepRssi(slot);
+                retry++;
+            } while (((rssiValue == (int8_t)RF_GET_RSSI_ERROR_VAL)
+                    || (rssiValue == 0)) && (retry <= RSSI_READ_RETRIES));
+            perfRecord(PERF_RF_SETTLE_LOOPS, retry);
+
+            /* Further reads for the detector, invalid ones are skipped */
+            sampleCount = 0U;
+            if ((rssiValue != (int8_t)RF_GET_RSSI_ERROR_VAL) && (rssiValue != 0))
+            {
+                samples[sampleCount++] = rssiValue;
+            }
+            for (dwell = 1U; dwell < detectorDwell; dwell++)
+            {
+                Task_sleep(rssiDwellTicks);
+                rssiValue = readStepRssi(slot);
+                if ((rssiValue != (int8_t)RF_GET_RSSI_ERROR_VAL)
+                        && (rssiValue != 0))
+                {
+                    samples[sampleCount++] = rssiValue;
+                }
+            }
+            if (sampleCount > 0U)
+            {
+                rssiValue = detectorReduce(detectorMode, samples, sampleCount);
+            }
         }
 
-        sweepArray[rssiIndex] = RF_getRssi(rfHandle);
+        /* End RX, the queued step goes ahead without waiting for its end */
+        RF_cancelCmd(rfHandle, stepCmd, 0U);
+
+        sweepArray[rssiIndex] = rssiValue;
 
-        /* Adjustment needed for 2.4GHz band. Value determined empirically. */
-        if (RF_cmdFs.frequency >= MINFREQ_2400)
+        /* Adjustment needed for 2.4GHz band, see updateSweepPlan() */
+        if (rssiValue != (int8_t)RF_GET_RSSI_ERROR_VAL)
         {
-            sweepArray[rssiIndex]+= 20;
+            sweepArray[rssiIndex] += sweepPlan.rssiOffset;
         }
 
         rssiIndex++;
 
-        /* Permit Uart task to access RSSI array */
-        unlockSweepData(mutexKey);
+        /* Publish the value after it is written, see lockSweepProgress() */
+        sweepBuffers[fillBuffer].filled = rssiIndex;
 
-        updateSweepFreq();
+        updateSweepFreq(&RF_cmdFs);
+        slot ^= 1U;
     }
 }
 
@@ -2095,7 +3269,7 @@ uint8_t * getRbwTableEntryData(uint8_t rbwIndex, uint8_t rbwBand)
  */
 inline uint16_t getSweepMaxLength(void)
 {
-	return sizeof(rssiArray);
+	return MAX_SWEEP_LENGTH;
 }
 
 /** @brief Getter function for current sweep length in steps.
@@ -2111,8 +3285,13 @@ inline uint16_t getSweepLength(void)
 {
 	uint16_t length;
 
+	/* Segments of a multi-band sweep follow one another */
+	if (multiBandCount > 0U)
+	{
+		length = multiBand[multiBandCount - 1U].end;
+	}
 	/* Use number of steps per MHz times number of MHz for EasyRF */
-	if (!getCommandMode())
+	else if (!getCommandMode())
 	{
 		length = getSpan() * getNumSteps();
 	}
@@ -2131,18 +3310,36 @@ inline uint16_t getSweepLength(void)
 	return length;
 }
 
-/** @brief Getter function for current sweep data in RSSI values.
+/** @brief Getter function for the number of completed sweeps.
  *
- *  @return Pointer to RSSI array
+ *  @return Completed sweep counter, wraps around at 16 bits
  *
  *  @par Usage
  *       @code
- *       int8_t *rssiValues = getSweepData();
+ *       if (getSweepCount() != lastSweepCount)
  *       @endcode
  */
-inline int8_t * getSweepData(void)
+inline uint16_t getSweepCount(void)
 {
-    return rssiArray;
+	return sweepCount;
+}
+
+/** @brief Getter function for the time taken by band switches.
+ *
+ *  @param stats filled with the band switch counts and clock ticks.
+ *
+ *  @par Usage
+ *       @code
+ *       getBandSwitchStats(&stats);
+ *       @endcode
+ */
+void getBandSwitchStats(BandSwitchStats *stats)
+{
+	IArg mutexKey;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	*stats = bandSwitchStats;
+	GateMutexPri_leave(sweepMutex, mutexKey);
 }
 
 /** @brief Getter function for new sweep data request.
@@ -2157,32 +3354,165 @@ inline void getNewSweep(void)
 	Semaphore_pend(newSpectrumSemaphore, BIOS_WAIT_FOREVER);
 }
 
-/** @brief Lock access to the RSSI array.
+/** @brief Wait for the next completed sweep, giving up after a timeout.
+ *
+ *  @param timeout most ticks to wait.
+ *
+ *  @return TRUE if a sweep completed in time.
+ *
+ *  @par Usage
+ *       @code
+ *       if (waitNewSweep(DISPLAY_IDLE_TICKS)){//Draw sweep}
+ *       @endcode
+ */
+_Bool waitNewSweep(uint32_t timeout)
+{
+	return Semaphore_pend(newSpectrumSemaphore, timeout);
+}
+
+/** @brief Hold the latest completed sweep. The RF task does not reuse the
+ *  buffer until it is released with unlockSweepData().
+ *
+ *  @return Latest completed sweep
+ *
+ *  @par Usage
+ *       @code
+ *       const SweepBuffer *sweep = lockSweepData();
+ *       @endcode
+ */
+const SweepBuffer * lockSweepData(void)
+{
+	IArg mutexKey;
+	SweepBuffer *sweep;
+	uint32_t lockTime = Timestamp_get32();
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	perfRecord(PERF_SWEEP_LOCK_WAIT, Timestamp_get32() - lockTime);
+	sweep = &sweepBuffers[readyBuffer];
+	sweep->readers++;
+	GateMutexPri_leave(sweepMutex, mutexKey);
+
+	return sweep;
+}
+
+/** @brief Release a sweep held with lockSweepData().
  *
- *  @return Key to unlock access to the RSSI array
+ *  @param sweep Sweep returned by lockSweepData()
  *
  *  @par Usage
  *       @code
- *       mutexKey = lockSweepData();
+ *       unlockSweepData(sweep);
  *       @endcode
  */
-inline IArg lockSweepData(void)
+void unlockSweepData(const SweepBuffer *sweep)
 {
-    return GateMutexPri_enter(sweepMutex);
+	IArg mutexKey;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	sweepBuffers[sweep - sweepBuffers].readers--;
+	GateMutexPri_leave(sweepMutex, mutexKey);
 }
 
-/** @brief Unlock access to the RSSI array.
+/** @brief Hold the sweep the RF task is filling, so that its values can be
+ *  sent while it is measured. Values below filled are final as long as pass
+ *  does not change. The sweep is complete once its count equals the sequence
+ *  number. Release it with unlockSweepData().
+ *
+ *  @param sequence set to the sweep counter the sweep gets when completed
  *
- *  @param dataKey Key to unlock access to the RSSI array
+ *  @return Sweep being filled
  *
  *  @par Usage
  *       @code
- *       unlockSweepData(mutexKey);
+ *       const SweepBuffer *sweep = lockSweepProgress(&sequence);
  *       @endcode
  */
-inline void unlockSweepData(IArg dataKey)
+const SweepBuffer * lockSweepProgress(uint16_t *sequence)
 {
-    GateMutexPri_leave(sweepMutex, dataKey);
+	IArg mutexKey;
+	SweepBuffer *sweep;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	sweep = &sweepBuffers[fillBuffer];
+	sweep->readers++;
+	*sequence = sweepCount + 1U;
+	GateMutexPri_leave(sweepMutex, mutexKey);
+
+	return sweep;
+}
+
+/** @brief Get the trigger burst once the post-trigger sweeps are complete.
+ *  The ring stays frozen until releaseTriggerBurst().
+ *
+ *  @return Trigger burst, NULL while none is ready
+ *
+ *  @par Usage
+ *       @code
+ *       const TriggerBurst *burst = lockTriggerBurst();
+ *       @endcode
+ */
+const TriggerBurst * lockTriggerBurst(void)
+{
+	IArg mutexKey;
+	const TriggerBurst *burst = NULL;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	if (triggerState == TRIGGER_READY)
+	{
+		burst = &triggerBurst;
+	}
+	GateMutexPri_leave(sweepMutex, mutexKey);
+
+	return burst;
+}
+
+/** @brief Release a burst returned by lockTriggerBurst(). The trigger is
+ *  armed again with an empty ring if #TRIGGER_REARM was set, otherwise it
+ *  is off.
+ *
+ *  @par Usage
+ *       @code
+ *       releaseTriggerBurst();
+ *       @endcode
+ */
+void releaseTriggerBurst(void)
+{
+	IArg mutexKey;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	if (triggerState == TRIGGER_READY)
+	{
+		triggerHead = 0U;
+		triggerFill = 0U;
+		triggerState = (triggerFlags & TRIGGER_REARM)
+				? TRIGGER_ARMED : TRIGGER_OFF;
+	}
+	GateMutexPri_leave(sweepMutex, mutexKey);
+}
+
+/** @brief Set per-point trigger levels, used when the trigger is armed
+ *  with #TRIGGER_PER_POINT. Points without a level never trigger.
+ *
+ *  @param offset First sweep point
+ *  @param levels Levels in dBm, one byte per point
+ *  @param count Number of levels
+ *
+ *  @par Usage
+ *       @code
+ *       setTriggerLevels(0U, &payload[2U], count);
+ *       @endcode
+ */
+void setTriggerLevels(uint16_t offset, const uint8_t *levels, uint16_t count)
+{
+	IArg mutexKey;
+	uint16_t index;
+
+	mutexKey = GateMutexPri_enter(sweepMutex);
+	for (index = 0U; index < count; index++)
+	{
+		triggerLevels[offset + index] = (int8_t)levels[index];
+	}
+	GateMutexPri_leave(sweepMutex, mutexKey);
 }
 
 /** @brief Lock access to submit sweep commands.
@@ -0,0 +1,289 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file specPack.c
+ */
+#include "specPack.h"
+
+/***** Local Defines *****/
+
+/** @brief Frame header, value count and first value. */
+#define SPECPACK_HEADER     (2U)
+
+/***** Function definitions *****/
+
+/** @brief Zigzag map the difference of two values modulo 256.
+ *
+ *  @param value current value.
+ *  @param previous previous value.
+ *
+ *  @return 0, 1, 2 ... for the differences 0, -1, 1 ...
+ */
+static uint8_t zigzagDelta(int8_t value, int8_t previous)
+{
+	int8_t delta = (int8_t)(uint8_t)((uint8_t)value - (uint8_t)previous);
+
+	return (uint8_t)(((uint8_t)delta << 1U) ^ (uint8_t)(delta >> 7U));
+}
+
+/** @brief Number of bits needed for a zigzag mapped delta.
+ *
+ *  @param zigzag zigzag mapped delta.
+ *
+ *  @return bit width 0 - 8
+ */
+static uint8_t bitWidth(uint8_t zigzag)
+{
+	uint8_t width = 0U;
+
+	while (zigzag != 0U)
+	{
+		width++;
+		zigzag >>= 1U;
+	}
+
+	return width;
+}
+
+/** @brief Pack as many values as fit into one frame payload.
+ *
+ *  @param values RSSI values to pack.
+ *  @param count number of values, at least 1.
+ *  @param frame payload buffer of #SPECPACK_MAX_FRAME bytes.
+ *  @param packed returns the number of values in the frame.
+ *
+ *  @return payload length in bytes
+ *
+ *  @par Usage
+ *       @code
+ *       length = specPackFrame(&rssi[index], sweepSize, payload, &packed);
+ *       @endcode
+ */
+uint8_t specPackFrame(const int8_t *values, uint16_t count,
+		uint8_t *frame, uint16_t *packed)
+{
+	uint16_t valueIndex = 1U, groupSize, groupIndex;
+	uint8_t zigzag[SPECPACK_GROUP_SIZE];
+	uint8_t width, groupBytes, frameSize = SPECPACK_HEADER;
+	uint32_t bits;
+	uint8_t bitCount;
+
+	if (count > SPECPACK_MAX_FRAME)
+	{
+		count = SPECPACK_MAX_FRAME;
+	}
+
+	frame[1U] = (uint8_t)values[0U];
+
+	while (valueIndex < count)
+	{
+		groupSize = count - valueIndex;
+		if (groupSize > SPECPACK_GROUP_SIZE)
+		{
+			groupSize = SPECPACK_GROUP_SIZE;
+		}
+
+		width = 0U;
+		for (groupIndex = 0U; groupIndex < groupSize; groupIndex++)
+		{
+			zigzag[groupIndex] = zigzagDelta(values[valueIndex + groupIndex],
+					values[valueIndex + groupIndex - 1U]);
+			if (bitWidth(zigzag[groupIndex]) > width)
+			{
+				width = bitWidth(zigzag[groupIndex]);
+			}
+		}
+
+		/* The rest of the sweep goes into the next frame */
+		groupBytes = (uint8_t)(((groupSize * width) + 7U) / 8U);
+		if ((frameSize + 1U + groupBytes) > SPECPACK_MAX_FRAME)
+		{
+			break;
+		}
+
+		frame[frameSize++] = width;
+		bits = 0U;
+		bitCount = 0U;
+		for (groupIndex = 0U; groupIndex < groupSize; groupIndex++)
+		{
+			bits = (bits << width) | zigzag[groupIndex];
+			bitCount += width;
+			if (bitCount >= 8U)
+			{
+				bitCount -= 8U;
+				frame[frameSize++] = (uint8_t)(bits >> bitCount);
+			}
+		}
+		if (bitCount > 0U)
+		{
+			frame[frameSize++] = (uint8_t)(bits << (8U - bitCount));
+		}
+
+		valueIndex += groupSize;
+	}
+
+	frame[0U] = (uint8_t)valueIndex;
+	*packed = valueIndex;
+
+	return frameSize;
+}
+
+/** @brief Unpack the first packed frame of a payload.
+ *
+ *  @param frame packed payload.
+ *  @param length payload length in bytes.
+ *  @param values buffer for the unpacked RSSI values.
+ *  @param maxValues size of values.
+ *  @param used returns the number of payload bytes of the frame.
+ *
+ *  @return number of values, 0 for a malformed payload
+ */
+static uint16_t unpackBlock(const uint8_t *frame, uint16_t length,
+		int8_t *values, uint16_t maxValues, uint16_t *used)
+{
+	uint16_t count, valueIndex = 1U, groupEnd;
+	uint16_t frameIndex = SPECPACK_HEADER;
+	uint8_t width;
+	uint8_t value, mask, zigzag;
+	uint32_t bits;
+	uint8_t bitCount;
+
+	if ((length < SPECPACK_HEADER) || (frame[0U] == 0U)
+			|| (frame[0U] > maxValues))
+	{
+		return 0U;
+	}
+	count = frame[0U];
+	value = frame[1U];
+	values[0U] = (int8_t)value;
+
+	while (valueIndex < count)
+	{
+		if (frameIndex >= length)
+		{
+			return 0U;
+		}
+		width = frame[frameIndex++];
+		if (width > 8U)
+		{
+			return 0U;
+		}
+
+		groupEnd = valueIndex + SPECPACK_GROUP_SIZE;
+		if (groupEnd > count)
+		{
+			groupEnd = count;
+		}
+		if ((frameIndex + ((((groupEnd - valueIndex) * width) + 7U) / 8U)) > length)
+		{
+			return 0U;
+		}
+
+		mask = (uint8_t)((1U << width) - 1U);
+		bits = 0U;
+		bitCount = 0U;
+		while (valueIndex < groupEnd)
+		{
+			if (bitCount < width)
+			{
+				bits = (bits << 8U) | frame[frameIndex++];
+				bitCount += 8U;
+			}
+			bitCount -= width;
+			zigzag = (uint8_t)(bits >> bitCount) & mask;
+
+			/* Undo the zigzag mapping, the sum wraps modulo 256 */
+			value += (uint8_t)((zigzag >> 1U) ^ (uint8_t)(0U - (zigzag & 1U)));
+			values[valueIndex++] = (int8_t)value;
+		}
+	}
+
+	*used = frameIndex;
+	return count;
+}
+
+/** @brief Unpack one frame payload created by #specPackFrame.
+ *
+ *  @param frame packed payload.
+ *  @param length payload length in bytes.
+ *  @param values buffer for the unpacked RSSI values.
+ *  @param maxValues size of values.
+ *
+ *  @return number of values, 0 for a malformed payload
+ *
+ *  @par Usage
+ *       @code
+ *       count = specUnpackFrame(frame.Data, frame.Length, rssi, sizeof(rssi));
+ *       @endcode
+ */
+uint16_t specUnpackFrame(const uint8_t *frame, uint8_t length,
+		int8_t *values, uint16_t maxValues)
+{
+	uint16_t used;
+
+	return unpackBlock(frame, length, values, maxValues, &used);
+}
+
+/** @brief Unpack a payload of one or more packed frames sent back to back,
+ *  as in a version 2 protocol frame holding a whole sweep.
+ *
+ *  @param payload packed frames.
+ *  @param length payload length in bytes.
+ *  @param values buffer for the unpacked RSSI values.
+ *  @param maxValues size of values.
+ *
+ *  @return number of values, 0 for a malformed payload
+ *
+ *  @par Usage
+ *       @code
+ *       count = specUnpackFrames(frame.Data, frame.Length, rssi, sizeof(rssi));
+ *       @endcode
+ */
+uint16_t specUnpackFrames(const uint8_t *payload, uint16_t length,
+		int8_t *values, uint16_t maxValues)
+{
+	uint16_t count, total = 0U, offset = 0U, used;
+
+	while (offset < length)
+	{
+		count = unpackBlock(&payload[offset], length - offset,
+				&values[total], maxValues - total, &used);
+		if (count == 0U)
+		{
+			return 0U;
+		}
+		offset += used;
+		total += count;
+	}
+
+	return total;
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file specPack.h
+ *
+ *  Delta packed encoding of RSSI sweeps for the SA1350 host protocol. The
+ *  module is plain C and compiled by the firmware, the host DLL and the
+ *  simulator, so all of them share one definition of the format.
+ *
+ *  A packed frame payload holds up to 255 values and never exceeds 255
+ *  bytes, so it fits one protocol frame and decodes on its own:
+ *  - (byte 0) : Number of values N in the frame
+ *  - (byte 1) : First value, int8_t in dBm
+ *  - Groups of up to #SPECPACK_GROUP_SIZE deltas for the other N - 1 values.
+ *    Each group starts with one byte holding its bit width W (0 - 8), then
+ *    the deltas follow as W bit fields, MSB first, padded to a full byte.
+ *    A delta is the difference to the previous value modulo 256, zigzag
+ *    mapped so small changes of either sign need few bits.
+ *
+ *  A version 2 protocol frame carries a whole sweep as packed frames sent
+ *  back to back, #specUnpackFrames walks them.
+ */
+#ifndef __SPECPACK_H__
+#define __SPECPACK_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPECPACK_RAW        (0U)    /*!< One byte per value, the default	*/
+#define SPECPACK_DELTA      (1U)    /*!< Delta packed frames, see above		*/
+
+#define SPECPACK_MAX_FRAME  (255U)  /*!< Largest packed payload and values per frame */
+#define SPECPACK_GROUP_SIZE (32U)   /*!< Deltas sharing one bit width		*/
+
+extern uint8_t specPackFrame(const int8_t *values, uint16_t count,
+		uint8_t *frame, uint16_t *packed);
+extern uint16_t specUnpackFrame(const uint8_t *frame, uint8_t length,
+		int8_t *values, uint16_t maxValues);
+extern uint16_t specUnpackFrames(const uint8_t *payload, uint16_t length,
+		int8_t *values, uint16_t maxValues);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPECPACK_H__ */
@@ -16,6 +16,20 @@
  * - (byte N + 3)   : CRC High byte
  * - (byte N + 4)   : CRC Low byte
  *
+ * After #CMD_SETFRAMING version 2 the SA1350 sends its frames as below,
+ * commands from the host keep the format above:
+ * - (byte 0)       : 0x2B Version 2 frame prefix
+ * - (byte 1 - 2)   : 0xLLLL Payload length in bytes, big endian
+ * - (byte 3)       : 0xCC Command number
+ * - (byte 4)       : Frame sequence number, counts up by one per frame
+ * - (byte 5 - 6)   : Sweep ID, sequence number of the sweep, block or burst
+ *                    the payload belongs to, 0 for other frames
+ * - (byte 7 - N+6) : Payload
+ * - (byte N + 7)   : CRC High byte
+ * - (byte N + 8)   : CRC Low byte
+ * The CRC is seeded with 0x2A like a version 1 frame and covers bytes 1 to
+ * N + 6. A gap in the frame sequence number shows a lost frame.
+ *
  * Commands cheat sheet
  * -------------------------------------------------------------------------
  * - General Commands
@@ -51,7 +65,94 @@
  *                             0, 0 indicates success "no errors".
  *                             Bytes from host: [0x2A, 0x02, 0x06, 0x00, 0x00, 0x1E, 0xCF]
  *  + #CMD_SYNC          =  7, This command is unused, but included with an ACK.
- * 							   Bytes from host: [0x2A, 0x00, 0x07, 0x##, 0x##]
+ *                             It confirms the new rate of #CMD_SETBAUDRATE.
+ * 							   Bytes from host: [0x2A, 0x00, 0x07, 0xF5, 0xCF]
+ *  + #CMD_SETBAUDRATE   =  8, Changes the UART baud rate. The four byte
+ *                             payload is the new rate in bit/s in big endian
+ *                             order, one of 115200, 230400, 460800 or 921600.
+ *                             The ACK is sent at the current rate, then the
+ *                             SA1350 switches and waits 100 ms for a
+ *                             #CMD_SYNC at the new rate. The SYNC is ACKed
+ *                             at the new rate, without it the SA1350 returns
+ *                             to the previous rate. #CMD_DISCONNECT restores
+ *                             115200 after its ACK. So does a host that lost
+ *                             the rate: three bad frames, framing errors or
+ *                             breaks in a row, or 10 s without a valid frame
+ *                             while not streaming, end the streams of the
+ *                             host and return to 115200 without an ACK.
+ *                             Unsupported rates and requests while streaming
+ *                             are ignored and not ACKed.
+ *                             Bytes from host: [0x2A, 0x04, 0x08, 0x00, 0x0E, 0x10, 0x00, 0x52, 0xE4]
+ *  + #CMD_SETENCODING   =  9, Selects the encoding of the RSSI values in
+ *                             #CMD_GETSPECNOINIT and #CMD_STREAMDATA frames.
+ *                             The one byte payload defines the encoding:
+ *                             0 -> One byte per value (default)
+ *                             1 -> Delta packed frames, see specPack.h
+ *                             All other values are ignored and not ACKed.
+ *                             #CMD_CONNECT and #CMD_DISCONNECT restore 0.
+ *                             No additional response required after ACK.
+ *                             Bytes from host: [0x2A, 0x01, 0x09, 0x01, 0x74, 0xA4]
+ *  + #CMD_SETFRAMING    = 15, Selects the format of the frames the SA1350
+ *                             sends. The one byte payload is the version:
+ *                             1 -> Frames above, at most 255 payload bytes
+ *                             (default)
+ *                             2 -> Version 2 frames above. A spectrum sweep
+ *                             is sent in one #CMD_GETSPECNOINIT or
+ *                             #CMD_STREAMDATA frame, delta packed frames
+ *                             back to back, and #CMD_GETSPECNOINIT sends
+ *                             no #CMD_GETLASTERROR after it.
+ *                             The ACK is sent in the previous format, the
+ *                             frame sequence number starts at 0 after it.
+ *                             All other values are ignored and not ACKed.
+ *                             #CMD_CONNECT and #CMD_DISCONNECT restore 1.
+ *                             No additional response required after ACK.
+ *                             Bytes from host: [0x2A, 0x01, 0x0F, 0x02, 0xEE, 0x61]
+ *  + #CMD_SETDECIMATION = 14, Reduces the RSSI values of #CMD_GETSPECNOINIT
+ *                             and #CMD_STREAMDATA frames to at most the
+ *                             requested number of bins. The three byte
+ *                             payload holds the 16-bit bin count in big
+ *                             endian order (0 for full resolution, else
+ *                             1 - 1024) followed by the detector mode of
+ *                             #CMD_SETDETECTOR used to reduce the points of
+ *                             a bin, for example 1 -> Peak or 2 -> Average.
+ *                             Each bin holds ceil(points / bins) consecutive
+ *                             sweep points, the last bin the remaining ones.
+ *                             Sweeps with no more points than bins are sent
+ *                             as they are. The #CMD_STREAMSWEEP length
+ *                             counts bins. Other values are ignored and not
+ *                             ACKed. #CMD_CONNECT and #CMD_DISCONNECT
+ *                             restore full resolution.
+ *                             No additional response required after ACK.
+ *                             Bytes from host: [0x2A, 0x03, 0x0E, 0x01, 0x40, 0x01, 0x39, 0xB0]
+ *  + #CMD_GETBANDSTATS  = 44, Requests the time taken by band switches
+ *                             since start-up. A 32 byte response is
+ *                             expected after ACK. It holds, for band
+ *                             switches run on the open radio and then
+ *                             for those that reopen it in another RF mode
+ *                             (sub-1GHz to 2.4GHz or back), the count and
+ *                             the time of the last, the longest and all
+ *                             switches in microseconds, each 32-bit in
+ *                             big endian order. Times have the resolution
+ *                             of the RTOS clock tick, 10 microseconds.
+ *                             Bytes from host: [0x2A, 0x00, 0x2C, 0x60, 0xC6]
+ *  + #CMD_GETPERFSTATS  = 45, Requests the firmware performance counters.
+ *                             An optional one byte payload of 1 clears the
+ *                             counters after they are sent, 0 or no payload
+ *                             keeps them. Other values are ignored and not
+ *                             ACKed. A 144 byte response is expected after
+ *                             ACK, in big endian order: the timestamp
+ *                             frequency in Hz (32-bit), then for each
+ *                             counter of #PerfCounterId the count, minimum
+ *                             and maximum (32-bit each) and the sum (64-bit)
+ *                             of its values. Times are in timestamp counts:
+ *                             - Wait of the RF task for the CMD_FS of a step
+ *                             - RSSI settle waits per step (count)
+ *                             - Time of one RSSI read
+ *                             - Bytes queued per sent sweep (count)
+ *                             - Wait for UART TX queue space per sent sweep
+ *                             - Wait for the sweep mutex in lockSweepData()
+ *                             - Time of one LCD frame
+ *                             Bytes from host: [0x2A, 0x01, 0x2D, 0x01, 0xBE, 0x86]
  * - Frequency Commands
  *  + #CMD_SETFBAND      = 20, Sets frequency band of the scan. The one byte
  *                             payload defines the band as follows:
@@ -115,6 +216,52 @@
  *                             sent for a span of 19 megaHertz.
  *                             No additional response required after ACK.
  *                             Bytes from host: [0x2A, 0x02, 0x1B, 0x00, 0x13, 0x3D, 0xAF]
+ *  + #CMD_SETSWEEP      = 28, Sets the complete scan configuration at once,
+ *                             replacing commands 20 - 27. The 19 byte payload
+ *                             holds, in this order, the payloads of:
+ *                             20 (1 byte), 21 (4 bytes), 22 (4 bytes),
+ *                             25 (1 byte), 24 (4 bytes), 26 (2 bytes),
+ *                             27 (2 bytes) and 23 (1 byte).
+ *                             The RF task applies it as one update and restarts
+ *                             the sweep, so no sweep mixes old and new values.
+ *                             A completed sweep not yet sent is dropped.
+ *                             Commands with another payload length are
+ *                             ignored and not ACKed.
+ *                             No additional response required after ACK.
+ *                             Bytes from host: [0x2A, 0x13, 0x1C, 0x01, 0x03, 0x93, 0x85, 0x67, 0x03, 0xA6, 0x84, 0x87, 0x26, 0x00, 0x00, 0x12, 0x48, 0x00, 0x0E, 0x00, 0x13, 0x08, 0x9C, 0x8E]
+ *  + #CMD_SETDETECTOR   = 29, Sets the detector of the scan. The two byte
+ *                             payload is the detector mode followed by the
+ *                             number of RSSI reads per frequency step (1 - 16).
+ *                             The reads of a step are reduced on the SA1350:
+ *                             0 -> Sample, the last read (default)
+ *                             1 -> Peak, the highest read
+ *                             2 -> Average of the dBm values
+ *                             3 -> RMS, the mean power in dBm
+ *                             More reads take longer per step. Other values
+ *                             are ignored and not ACKed. #CMD_CONNECT and
+ *                             #CMD_DISCONNECT restore sample with one read.
+ *                             No additional response required after ACK.
+ *                             Bytes from host: [0x2A, 0x02, 0x1D, 0x01, 0x04, 0xDE, 0xE8]
+ *  + #CMD_SETMULTIBAND  = 43, Sweeps segments in up to three bands as one
+ *                             scan. The payload holds four bytes per
+ *                             segment in sweep order: the band as in
+ *                             #CMD_SETFBAND (0 - 2), the 16-bit start
+ *                             frequency in megaHertz in big endian order
+ *                             and the span index of #CMD_SETSPANINDEX
+ *                             (0 - 8). Each band may be used once. The
+ *                             segment sweeps the span with its own step
+ *                             and RBW, the SA1350 switches band between
+ *                             segments. The RSSI values of all segments
+ *                             follow one another in the scan. Commands
+ *                             20 - 28, #CMD_STARTZEROSPAN, #CMD_CONNECT,
+ *                             #CMD_DISCONNECT and an empty payload return
+ *                             to the single band scan. Segments outside their band, a
+ *                             band used twice or more than 2048 points in
+ *                             total leave the scan unchanged. Commands
+ *                             with a partial segment or more than three
+ *                             segments are ignored and not ACKed.
+ *                             No additional response required after ACK.
+ *                             Bytes from host (903MHz and 2428MHz, span 0): [0x2A, 0x08, 0x2B, 0x01, 0x03, 0x87, 0x00, 0x02, 0x09, 0x7C, 0x00, 0x1C, 0x95]
  * - Spectrum Measurement Commands
  *  + #CMD_INITPARAMETER = 30, **Not implemented in this version.**
  *                             This command always precedes command 31 and it
@@ -135,7 +282,123 @@
  *                             byte scan, the SA1350 would first send a
  *                             message with the first 255 values and then a
  *                             second message with the remaining 33 values.
+ *                             With delta encoding (#CMD_SETENCODING) each
+ *                             message holds as many values as its packed
+ *                             payload fits, the first byte tells how many.
+ *                             Ignored during zero span (#CMD_STARTZEROSPAN).
  *                             Bytes from host: [0x2A, 0x00, 0x1F, 0x66, 0xF6]
+ *  + #CMD_STARTSTREAM   = 32, Starts streaming mode. After the ACK every
+ *                             completed sweep is sent without further host
+ *                             requests. Each sweep starts with a
+ *                             #CMD_STREAMSWEEP frame, followed by the RSSI
+ *                             values in #CMD_STREAMDATA frames of at most
+ *                             255 bytes. Sweeps completed by the RF task
+ *                             while the previous one is still being sent
+ *                             are skipped, which shows as a gap in the
+ *                             sequence number.
+ *                             Bytes from host: [0x2A, 0x00, 0x20, 0xA1, 0x4A]
+ *  + #CMD_STOPSTREAM    = 33, Stops streaming mode. The ACK is sent after
+ *                             the last frame of the sweep in progress, so
+ *                             no stream frames follow it. It also ends zero
+ *                             span and disarms the trigger, the sweep
+ *                             restarts.
+ *                             Bytes from host: [0x2A, 0x00, 0x21, 0xB1, 0x6B]
+ *  + #CMD_STARTZEROSPAN = 36, Starts zero span (time domain) streaming. The
+ *                             six byte payload holds the frequency in the
+ *                             format of #CMD_SETFSTART followed by the
+ *                             16-bit sample interval in microseconds, both
+ *                             in big endian order. 0 samples as fast as
+ *                             possible, one sample per clock tick (10 us).
+ *                             The synthesizer is tuned once and RX keeps
+ *                             running. After the ACK the RSSI samples are
+ *                             sent in #CMD_ZEROSPANDATA frames until
+ *                             #CMD_STOPSTREAM. Frequencies outside the
+ *                             current band send no frames. Commands with
+ *                             another payload length are ignored and not
+ *                             ACKed.
+ *                             Bytes from host: [0x2A, 0x06, 0x24, 0x03, 0x93, 0x80, 0x00, 0x00, 0x00, 0x69, 0xC3]
+ *  + #CMD_ARMTRIGGER    = 38, Arms the threshold trigger. The four byte
+ *                             payload holds the trigger level in dBm as a
+ *                             signed byte, the number of sweeps sent before
+ *                             and after the trigger sweep, and the flags:
+ *                             bit 0 uses the per-point levels of
+ *                             #CMD_SETTRIGGERLEVELS instead of the level
+ *                             byte, bit 1 re-arms after each burst. The
+ *                             RF task keeps the last sweeps in a ring and
+ *                             the first sweep with a value at or above the
+ *                             level triggers. After the ACK only the
+ *                             sweeps of each burst are sent, as
+ *                             #CMD_TRIGGERSWEEP frames each followed by
+ *                             #CMD_STREAMDATA frames, until
+ *                             #CMD_STOPSTREAM. Sweeps longer than 512
+ *                             points never trigger. Commands with another
+ *                             payload length, more than 3 sweeps before
+ *                             and after together or unknown flags are
+ *                             ignored and not ACKed.
+ *                             Bytes from host (-60 dBm, 1 before, 2 after, re-arm): [0x2A, 0x04, 0x26, 0xC4, 0x01, 0x02, 0x02, 0x85, 0xCF]
+ *  + #CMD_SETTRIGGERLEVELS = 39, Sets per-point trigger levels. The payload
+ *                             holds the 16-bit index of the first point in
+ *                             big endian order followed by up to 17 signed
+ *                             levels in dBm, one per point. Longer level
+ *                             lists take several commands. Points without
+ *                             a level never trigger. Commands beyond point
+ *                             512 or without levels are ignored and not
+ *                             ACKed.
+ *                             Bytes from host (points 0 and 1 at -70 dBm): [0x2A, 0x04, 0x27, 0x00, 0x00, 0xBA, 0xBA, 0xD0, 0x8C]
+ *  + #CMD_STARTCHUNKSTREAM = 41, Starts chunked streaming. The one byte
+ *                             payload holds the number of values per chunk,
+ *                             1 to 249. After the ACK the values of each
+ *                             sweep are sent in #CMD_SWEEPCHUNK frames as
+ *                             soon as a chunk is measured, while the RF task
+ *                             continues the sweep, until #CMD_STOPSTREAM.
+ *                             The last chunk of a sweep may be shorter.
+ *                             Sweeps completed while the UART task still
+ *                             sends the previous one are skipped, which
+ *                             shows as a gap in the sequence number.
+ *                             Commands with another payload length or chunk
+ *                             size are ignored and not ACKed.
+ *                             Bytes from host (64 values): [0x2A, 0x01, 0x29, 0x40, 0x2A, 0xA7]
+ * - Streaming Responses
+ *  + #CMD_STREAMSWEEP   = 34, Start of a streamed sweep. The four byte
+ *                             payload holds the 16-bit sweep sequence number
+ *                             and the 16-bit sweep length in big endian order.
+ *                             The length counts values, not payload bytes.
+ *  + #CMD_STREAMDATA    = 35, RSSI values of the streamed sweep, in the same
+ *                             format as the #CMD_GETSPECNOINIT response.
+ *  + #CMD_ZEROSPANDATA  = 37, One block of zero span samples. The payload
+ *                             holds the 16-bit block sequence number, the
+ *                             32-bit times of the first and the last sample
+ *                             in microseconds since start-up, all in big
+ *                             endian order, followed by up to 245 RSSI
+ *                             samples, one byte each, evenly spaced between
+ *                             the two times. Blocks completed while the
+ *                             previous one is still being sent are skipped,
+ *                             which shows as a gap in the sequence number.
+ *                             #CMD_SETENCODING and #CMD_SETDECIMATION do not
+ *                             apply.
+ *  + #CMD_TRIGGERSWEEP  = 40, Start of one sweep of a trigger burst. The
+ *                             eleven byte payload holds the 16-bit burst
+ *                             sequence number, the index of the sweep in
+ *                             the burst, the number of sweeps in the burst,
+ *                             the index of the trigger sweep, the 32-bit
+ *                             time the sweep completed in microseconds
+ *                             since start-up and the 16-bit sweep length,
+ *                             all in big endian order. The RSSI values
+ *                             follow in #CMD_STREAMDATA frames. A burst
+ *                             has fewer sweeps before the trigger if the
+ *                             trigger fired before the ring was filled.
+ *  + #CMD_SWEEPCHUNK    = 42, One chunk of the sweep being measured. The
+ *                             payload holds the 16-bit sweep sequence
+ *                             number, the 16-bit index of the first value
+ *                             and the 16-bit sweep length, all in big
+ *                             endian order, followed by the RSSI values,
+ *                             one byte each. The length is final in the
+ *                             last chunk. A chunk at index 0 with a
+ *                             sequence number seen before means the sweep
+ *                             restarted, e.g. after #CMD_SETSWEEP, and
+ *                             replaces the values received so far.
+ *                             #CMD_SETENCODING and #CMD_SETDECIMATION do not
+ *                             apply.
  ***************************************************************************
  *
  *  @note Deciding against enum for command definitions due to need
@@ -153,6 +416,10 @@
 #define CMD_GETRFPARAMS     (5)
 #define CMD_GETLASTERROR    (6)
 #define CMD_SYNC            (7)
+#define CMD_SETBAUDRATE     (8)
+#define CMD_SETENCODING     (9)
+#define CMD_SETDECIMATION   (14)
+#define CMD_SETFRAMING      (15)
 #define CMD_SETFBAND        (20)
 #define CMD_SETFSTART       (21)
 #define CMD_SETFSTOP        (22)
@@ -161,8 +428,24 @@
 #define CMD_SETRBW          (25)
 #define CMD_SETSTEPCOUNT    (26)
 #define CMD_SETSPAN         (27)
+#define CMD_SETSWEEP        (28)
+#define CMD_SETDETECTOR     (29)
 #define CMD_INITPARAMETER   (30)
 #define CMD_GETSPECNOINIT   (31)
+#define CMD_STARTSTREAM     (32)
+#define CMD_STOPSTREAM      (33)
+#define CMD_STREAMSWEEP     (34)
+#define CMD_STREAMDATA      (35)
+#define CMD_STARTZEROSPAN   (36)
+#define CMD_ZEROSPANDATA    (37)
+#define CMD_ARMTRIGGER      (38)
+#define CMD_SETTRIGGERLEVELS (39)
+#define CMD_TRIGGERSWEEP    (40)
+#define CMD_STARTCHUNKSTREAM (41)
+#define CMD_SWEEPCHUNK      (42)
+#define CMD_SETMULTIBAND    (43)
+#define CMD_GETBANDSTATS    (44)
+#define CMD_GETPERFSTATS    (45)
 
 #define HDR_PREFIX          (0x2AU)
 #define HDR_LENGTH          (3U)
@@ -172,17 +455,79 @@
 #define HDR_CMD_INDEX       (2U)
 
 #define CRC_LENGTH          (2U)
+
+#define HDR_V2_PREFIX       (0x2BU)
+#define HDR_V2_LENGTH       (7U)
+
+#define FRAMING_V1          (1U)
+#define FRAMING_V2          (2U)
 /**  @} */
 
-/** @brief Command size of 10 assumes that host will never send a
- *  payload > 5 bytes. See \ref HostCommand for details.
+/** @brief Command size of 24 fits the largest host payload, the 19 byte
+ *  #CMD_SETSWEEP configuration. See \ref HostCommand for details.
  */
-#define MAX_COMMAND_SIZE    (10U)
+#define MAX_COMMAND_SIZE    (24U)
 /** @brief Payload size does not include header, with the CRC acting as
  *  the final 2 payload bytes. See \ref HostCommand for details.
  */
 #define MAX_PAYLOAD_SIZE    (MAX_COMMAND_SIZE - HDR_LENGTH)
 
+/** @brief UART read timeout in clock ticks. A timed out read lets the
+ *  UART task check for a completed sweep while streaming.
+ */
+#define UART_READ_TIMEOUT   (5U * (1000U / Clock_tickPeriod))
+
+/** @brief UART rate after reset and #CMD_DISCONNECT.
+ */
+#define UART_DEFAULT_BAUD   (115200U)
+
+/** @brief Time the host has to confirm a new rate with #CMD_SYNC,
+ *  see #CMD_SETBAUDRATE.
+ */
+#define UART_SYNC_TIMEOUT   (100U * (1000U / Clock_tickPeriod))
+
+/** @brief Bad frames, framing errors or breaks in a row at a raised rate
+ *  before the SA1350 returns to #UART_DEFAULT_BAUD.
+ */
+#define UART_RX_ERROR_LIMIT (3U)
+
+/** @brief Time without a valid frame at a raised rate, while not streaming,
+ *  before the SA1350 returns to #UART_DEFAULT_BAUD.
+ */
+#ifndef UART_IDLE_TIMEOUT
+#define UART_IDLE_TIMEOUT   (10000U * (1000U / Clock_tickPeriod))
+#endif
+
+/** @brief Bytes read per UART_read() when dropping the rest of a bad frame.
+ */
+#define UART_FLUSH_CHUNK    (16U)
+
+/** @brief Time for the ACK to leave the TX FIFO before the rate changes.
+ *  32 bytes take 2.8 ms at 115200 baud.
+ */
+#define UART_DRAIN_TICKS    (3U * (1000U / Clock_tickPeriod))
+
+/** @brief Bytes of the UART TX queue, a power of two. Frames are copied in
+ *  and sent by the UART driver in callback mode while the UART task goes on.
+ */
+#define UART_TX_QUEUE_SIZE  (512U)
+
+/** @brief Most bins of a sweep reduced by #CMD_SETDECIMATION.
+ */
+#define DECIMATION_MAX_BINS (1024U)
+
+/** @brief Sequence number and sample times ahead of the zero span samples.
+ */
+#define ZERO_SPAN_HDR_LENGTH (10U)
+
+/** @brief Sequence number, index and sweep length ahead of the chunk values.
+ */
+#define CHUNK_HDR_LENGTH    (6U)
+
+/** @brief Most values of one #CMD_SWEEPCHUNK frame.
+ */
+#define CHUNK_MAX_VALUES    (255U - CHUNK_HDR_LENGTH)
+
 /***** Structures *****/
 
 /** @brief A type and struct for receiving and sending host command messages.
@@ -216,10 +561,128 @@ UART_Params uartParams;
  */
 UART_Handle uart;
 
+/** @brief  Bytes waiting for the UART, see queueHostTx().
+ */
+static uint8_t txQueue[UART_TX_QUEUE_SIZE];
+
+/** @brief  Free running index of the next byte queued by the UART task.
+ */
+static volatile uint16_t txHead = 0U;
+
+/** @brief  Free running index of the next byte not yet sent by the UART.
+ *          Advanced by uartWriteCallback().
+ */
+static volatile uint16_t txTail = 0U;
+
+/** @brief  Bytes handed to UART_write(), 0 while the UART is idle.
+ */
+static volatile uint16_t txActive = 0U;
+
+/** @brief  Semaphore struct for free space in the UART TX queue.
+ */
+static Semaphore_Struct txSpaceSemaphoreStruct;
+
+/** @brief  Semaphore parameters for free space in the UART TX queue.
+ */
+static Semaphore_Params txSpaceSemaphoreParams;
+
+/** @brief  Semaphore handle posted each time the UART sent queued bytes.
+ */
+static Semaphore_Handle txSpaceSemaphore;
+
 /** @brief  Local buffer for host mailbox message
  */
 static CommandMessage hostMessage = { NO_USER_COMMAND, {0U, 0U, 0U, 0U } };
 
+/** @brief  Streaming mode active, see #CMD_STARTSTREAM.
+ */
+static _Bool isStreaming = FALSE;
+
+/** @brief  Bad frames from the host in a row, see #UART_RX_ERROR_LIMIT.
+ */
+static uint8_t rxErrorCount = 0U;
+
+/** @brief  Clock ticks of the last valid frame or rate change, see
+ *          #UART_IDLE_TIMEOUT.
+ */
+static uint32_t hostFrameTicks = 0U;
+
+/** @brief  Timestamp counts queueHostTx() waited for TX queue space, see
+ *          #PERF_SPECTRUM_TX_WAIT.
+ */
+static uint32_t txWaitTime = 0U;
+
+/** @brief  Sweep counter of the last streamed sweep.
+ */
+static uint16_t streamSweepCount = 0U;
+
+/** @brief  Streaming zero span blocks instead of sweeps, see
+ *          #CMD_STARTZEROSPAN.
+ */
+static _Bool isZeroSpan = FALSE;
+
+/** @brief  Streaming trigger bursts instead of sweeps, see #CMD_ARMTRIGGER.
+ */
+static _Bool isTrigger = FALSE;
+
+/** @brief  Values per chunk of #CMD_STARTCHUNKSTREAM, 0 while sending
+ *          whole sweeps.
+ */
+static uint8_t chunkValues = 0U;
+
+/** @brief  Sweep being sent in chunks, held with lockSweepProgress().
+ */
+static const SweepBuffer *chunkSweep = NULL;
+
+/** @brief  Sweep counter the held sweep gets when completed.
+ */
+static uint16_t chunkSequence = 0U;
+
+/** @brief  Index of the next value of the held sweep to send.
+ */
+static uint16_t chunkOffset = 0U;
+
+/** @brief  Fill pass of the held sweep the sent values belong to.
+ */
+static uint8_t chunkPass = 0U;
+
+/** @brief  Encoding of the RSSI values sent to the host, see #CMD_SETENCODING.
+ */
+static uint8_t specEncoding = SPECPACK_RAW;
+
+/** @brief  Format of the frames sent to the host, see #CMD_SETFRAMING.
+ */
+static uint8_t hostFraming = FRAMING_V1;
+
+/** @brief  Sequence number of the next version 2 frame.
+ */
+static uint8_t txSequence = 0U;
+
+/** @brief  Sweep ID of the version 2 frames being sent, 0 outside of sweeps.
+ */
+static uint16_t txSweepId = 0U;
+
+/** @brief  CRC of the frame being sent.
+ */
+static uint16_t txFrameCrc;
+
+/** @brief  Payload of one delta packed spectrum frame, zero span frame or
+ *          #CMD_GETPERFSTATS response. Kept off the UART task stack.
+ */
+static uint8_t packedFrame[SPECPACK_MAX_FRAME];
+
+/** @brief  Bins requested with #CMD_SETDECIMATION, 0 for full resolution.
+ */
+static uint16_t decimationBins = 0U;
+
+/** @brief  Detector mode reducing the points of a bin.
+ */
+static uint8_t decimationMode = DETECTOR_PEAK;
+
+/** @brief  Bins of the sweep being sent. Kept off the UART task stack.
+ */
+static int8_t decimatedRssi[DECIMATION_MAX_BINS];
+
 /** @brief  IArg key for the RF command gate mutex.
  */
 IArg uartCmdKey;
@@ -232,6 +695,10 @@ static PIN_Handle gledPinHandle;
  */
 static PIN_State gledPinState;
 
+/** @brief  UART rates accepted by #CMD_SETBAUDRATE.
+ */
+static const uint32_t uartBaudRates[] = {115200U, 230400U, 460800U, 921600U};
+
 /** @brief  PIN driver pin list and pin attributes for green LED.
  *          GLED initially off.
  */
@@ -243,11 +710,20 @@ static PIN_Config gledPinTable[] = {
 /***** Function prototypes *****/
 
 static void openUart(void);
-static void crc16AddByte(uint16_t *addb, uint8_t u8);
+static void reopenUart(uint32_t baudRate);
+static void startHostTx(void);
+static void uartWriteCallback(UART_Handle handle, void *buf, size_t count);
+static void queueHostTx(const void *data, uint16_t size);
+static void flushHostTx(void);
+static _Bool waitBaudSync(void);
 static uint16_t calcCrc16(void *data, uint8_t dataLength);
+static void beginHostFrame(uint8_t command, uint16_t length);
+static void writeHostFrame(const void *data, uint16_t size);
+static void endHostFrame(void);
 static void sendHostResponse(uint8_t *tx, uint8_t txSize);
 static void sendHostArrayResponse(HostCommand arrCmd, const uint8_t *txArr, size_t txSize);
 static void sendHostAck(HostCommand cmdToAck);
+static void resetHostSession(void);
 static void connect(HostCommand connectCmd);
 static void disconnect(HostCommand disconnectCmd);
 static void getDeviceVersion(HostCommand getDeviceVersionCmd);
@@ -255,6 +731,10 @@ static void getFWVersion(HostCommand getFWVersionCmd);
 static void getRFParameters(HostCommand getRFParametersCmd);
 static void getLastError(HostCommand getLastErrorCmd);
 static void sync(HostCommand syncCmd);
+static void setBaudRate(HostCommand setBaudRateCmd);
+static void setEncoding(HostCommand setEncodingCmd);
+static void setFraming(HostCommand setFramingCmd);
+static void setDecimation(HostCommand setDecimationCmd);
 static void setFBand(HostCommand setFBandCmd);
 static void setFStart(HostCommand setFStartCmd);
 static void setFStop(HostCommand setFStopCmd);
@@ -263,9 +743,35 @@ static void setFStep(HostCommand setFStepCmd);
 static void setStepCount(HostCommand setStepCountCmd);
 static void setSpan(HostCommand setSpanCmd);
 static void setRbw(HostCommand setRbwCmd);
+static void setSweep(HostCommand setSweepCmd);
+static void setDetector(HostCommand setDetectorCmd);
+static void setMultiBand(HostCommand setMultiBandCmd);
+static void getBandStats(HostCommand getBandStatsCmd);
+static void getPerfStats(HostCommand getPerfStatsCmd);
 static void initParameter(HostCommand initParameterCmd);
-static void sendSpectrum(void);
+static uint16_t decimateSpectrum(const int8_t *rssi, uint16_t length,
+		const int8_t **rssiValues);
+static uint8_t spectrumFrame(const int8_t *rssiValues, uint16_t count,
+		const uint8_t **payload, uint16_t *frameValues);
+static void sendSpectrum(uint8_t specCmd, const int8_t *rssiValues,
+		uint16_t sweepSize);
 static void getSpecNoInit(HostCommand getSpecNoInitCmd);
+static void startStream(HostCommand startStreamCmd);
+static void stopStream(HostCommand stopStreamCmd);
+static void stopStreamMode(HostCommand stopModeCmd);
+static void startZeroSpan(HostCommand startZeroSpanCmd);
+static void sendZeroSpan(const SweepBuffer *block);
+static void armTrigger(HostCommand armTriggerCmd);
+static void setTriggerLevelsCmd(HostCommand setTriggerLevelsCmd);
+static void sendTriggerBurst(void);
+static void startChunkStream(HostCommand startChunkStreamCmd);
+static void stopChunkStream(void);
+static void streamChunks(void);
+static void streamSpectrum(void);
+static void flushHostRx(void);
+static void resetHostLink(void);
+static void hostRxError(void);
+static _Bool readHost(void *rx, size_t rxSize);
 static void processHostCommand(HostCommand hostCmd);
 static void uartTaskFxn(UArg uartArg0, UArg uartArg1);
 
@@ -280,6 +786,16 @@ static void uartTaskFxn(UArg uartArg0, UArg uartArg1);
  */
 static void openUart(void)
 {
+    /* Signals free space in the TX queue, initial count 0 */
+    Semaphore_Params_init(&txSpaceSemaphoreParams);
+    txSpaceSemaphoreParams.mode = Semaphore_Mode_BINARY;
+    Semaphore_construct(&txSpaceSemaphoreStruct, 0, &txSpaceSemaphoreParams);
+    txSpaceSemaphore = Semaphore_handle(&txSpaceSemaphoreStruct);
+
+    if (txSpaceSemaphore == NULL) {
+        System_abort("Semaphore create failed\n");
+    }
+
     /* Call UART init function */
     UART_init();
 
@@ -289,8 +805,10 @@ static void openUart(void)
     uartParams.readDataMode = UART_DATA_BINARY;
     uartParams.readReturnMode = UART_RETURN_FULL;
     uartParams.readEcho = UART_ECHO_OFF;
-    uartParams.baudRate = 115200U;
-    uartParams.writeMode = UART_MODE_BLOCKING;
+    uartParams.baudRate = UART_DEFAULT_BAUD;
+    uartParams.readTimeout = UART_READ_TIMEOUT;
+    uartParams.writeMode = UART_MODE_CALLBACK;
+    uartParams.writeCallback = uartWriteCallback;
     uartParams.writeDataMode = UART_DATA_BINARY; //UART_DATA_TEXT
     uart = UART_open(Board_UART0, &uartParams);
 
@@ -299,25 +817,195 @@ static void openUart(void)
     }
 }
 
-/** @brief Add byte to current CRC16 value.
+/** @brief Close the UART and open it again at another rate.
+ *
+ *  @param baudRate new UART rate in bit/s.
  *
- *  @param addb active CRC16 value.
- *  @param u8 data byte to add to active CRC16 value.
+ *  @par Usage
+ *       @code
+ *       reopenUart(UART_DEFAULT_BAUD);
+ *       @endcode
+ */
+static void reopenUart(uint32_t baudRate)
+{
+    /* Let the last response leave the TX FIFO at the old rate */
+    flushHostTx();
+    Task_sleep(UART_DRAIN_TICKS);
+    UART_close(uart);
+
+    uartParams.baudRate = baudRate;
+    uart = UART_open(Board_UART0, &uartParams);
+
+    if (uart == NULL) {
+        System_abort("Error opening the UART\n");
+    }
+
+    /* The host gets the full idle time at the new rate */
+    hostFrameTicks = Clock_getTicks();
+    rxErrorCount = 0U;
+}
+
+/** @brief Hand the oldest contiguous bytes of the TX queue to the UART,
+ *  unless it is still sending. Called by the UART task with interrupts
+ *  disabled and by uartWriteCallback().
  *
  *  @par Usage
  *       @code
- *       crc16AddByte(&crc, bytes[crcIndex]);
+ *       startHostTx();
  *       @endcode
+ */
+static void startHostTx(void)
+{
+	uint16_t start = txTail & (UART_TX_QUEUE_SIZE - 1U);
+	uint16_t count = txHead - txTail;
+
+	if ((txActive != 0U) || (count == 0U))
+	{
+		return;
+	}
+
+	/* UART_write() needs contiguous bytes, the rest follows on wrap around */
+	if (count > (UART_TX_QUEUE_SIZE - start))
+	{
+		count = UART_TX_QUEUE_SIZE - start;
+	}
+
+	txActive = count;
+	UART_write(uart, &txQueue[start], count);
+}
+
+/** @brief UART write callback. Frees the sent bytes of the TX queue and
+ *  sends the next ones.
  *
- *  @pre Initialize overall CRC16 routine before calling this function.
-*/
-static void crc16AddByte(uint16_t *addb, uint8_t u8)
+ *  @param handle UART driver handle.
+ *  @param buf bytes passed to UART_write().
+ *  @param count number of bytes sent.
+ *
+ *  @par Usage - Not called by user code. Called by the UART driver.
+ */
+static void uartWriteCallback(UART_Handle handle, void *buf, size_t count)
+{
+	txTail += (uint16_t)count;
+	txActive = 0U;
+
+	startHostTx();
+
+	Semaphore_post(txSpaceSemaphore);
+}
+
+/** @brief Queue bytes for the host. Returns once the bytes are copied, so
+ *  the caller may reuse or release its buffer while the UART sends them.
+ *  Waits only while the TX queue is full.
+ *
+ *  @param data bytes to send.
+ *  @param size number of bytes.
+ *
+ *  @par Usage
+ *       @code
+ *       queueHostTx(header, headerSize);
+ *       @endcode
+ */
+static void queueHostTx(const void *data, uint16_t size)
+{
+	const uint8_t *bytes = data;
+	uint16_t space, index;
+	uint32_t waitTime;
+	UInt hwiKey;
+
+	while (size > 0U)
+	{
+		space = UART_TX_QUEUE_SIZE - (uint16_t)(txHead - txTail);
+
+		if (space == 0U)
+		{
+			waitTime = Timestamp_get32();
+			Semaphore_pend(txSpaceSemaphore, BIOS_WAIT_FOREVER);
+			txWaitTime += Timestamp_get32() - waitTime;
+			continue;
+		}
+
+		if (space > size)
+		{
+			space = size;
+		}
+
+		for (index = 0U; index < space; index++)
+		{
+			txQueue[(uint16_t)(txHead + index) & (UART_TX_QUEUE_SIZE - 1U)] =
+					bytes[index];
+		}
+
+		bytes += space;
+		size -= space;
+
+		hwiKey = Hwi_disable();
+		txHead += space;
+		startHostTx();
+		Hwi_restore(hwiKey);
+	}
+}
+
+/** @brief Wait until the UART sent all queued bytes.
+ *
+ *  @par Usage
+ *       @code
+ *       flushHostTx();
+ *       @endcode
+ */
+static void flushHostTx(void)
+{
+	while (txTail != txHead)
+	{
+		Semaphore_pend(txSpaceSemaphore, BIOS_WAIT_FOREVER);
+	}
+}
+
+/** @brief Wait for the host to confirm a new UART rate with #CMD_SYNC.
+ *  The frame is checked here, not by processHostCommand(), so bytes
+ *  garbled by a rate mismatch cannot lock up the UART task.
+ *
+ *  @return TRUE if a valid #CMD_SYNC arrived and was ACKed in time.
+ *
+ *  @par Usage
+ *       @code
+ *       if (!waitBaudSync()) { reopenUart(oldBaudRate); }
+ *       @endcode
+ */
+static _Bool waitBaudSync(void)
 {
-	*addb  = (*addb >> 8U) | (*addb << 8U);
-	*addb ^=  u8;
-	*addb ^= (*addb & 0xFFU) >> 4U;
-	*addb ^= (*addb << 8U) << 4U;
-	*addb ^= ((*addb & 0xFFU) << 4U) << 1U;
+	HostCommand syncCmd = {0};
+	uint8_t *rxBytes = (uint8_t *)&syncCmd;
+	size_t rxSize = HDR_LENGTH + CRC_LENGTH;
+	uint32_t startTicks = Clock_getTicks();
+	int_fast32_t rxCount;
+
+	while ((rxSize > 0U)
+			&& ((Clock_getTicks() - startTicks) < UART_SYNC_TIMEOUT))
+	{
+		rxCount = UART_read(uart, rxBytes, rxSize);
+
+		if (rxCount > 0)
+		{
+			rxBytes += rxCount;
+			rxSize -= (size_t)rxCount;
+		}
+	}
+
+	if ((rxSize > 0U) || (syncCmd.prefix != HDR_PREFIX)
+			|| (syncCmd.length != 0U) || (syncCmd.command != CMD_SYNC))
+	{
+		return FALSE;
+	}
+
+	if (calcCrc16(&syncCmd, HDR_LENGTH)
+			!= ((syncCmd.payload[0U] << 8U) | syncCmd.payload[1U]))
+	{
+		return FALSE;
+	}
+
+	sendHostAck(syncCmd); /* ACK Command at the new rate */
+
+	return TRUE;
 }
 
 /** @brief Calculate CRC16 of given raw data bytestream.
@@ -334,16 +1022,96 @@ static void crc16AddByte(uint16_t *addb, uint8_t u8)
 */
 static uint16_t calcCrc16(void *data, uint8_t dataLength)
 {
-	uint8_t crcIndex;
-	uint16_t crc = HDR_PREFIX;
 	uint8_t *bytes = data;
 
-	for (crcIndex = 1U; crcIndex < dataLength; crcIndex++)
+	/* The prefix byte is the CRC seed */
+	if (dataLength <= 1U)
+	{
+		return HDR_PREFIX;
+	}
+
+	return crc16Update(HDR_PREFIX, &bytes[1U], dataLength - 1U);
+}
+
+/** @brief Send the header of a frame to the host in the format selected
+ *  by #CMD_SETFRAMING. The payload follows with #writeHostFrame, the frame
+ *  ends with #endHostFrame.
+ *
+ *  @param command command number of the frame.
+ *  @param length payload length in bytes, at most 255 for version 1.
+ *
+ *  @par Usage
+ *       @code
+ *       beginHostFrame(CMD_STREAMDATA, sweepSize);
+ *       @endcode
+ */
+static void beginHostFrame(uint8_t command, uint16_t length)
+{
+	uint8_t header[HDR_V2_LENGTH];
+	uint8_t headerSize;
+
+	if (hostFraming == FRAMING_V2)
 	{
-		crc16AddByte(&crc, bytes[crcIndex]);
+		header[0U] = HDR_V2_PREFIX;
+		header[1U] = (length & 0xFF00U) >> 8U;
+		header[2U] = length & 0x00FFU;
+		header[3U] = command;
+		header[4U] = txSequence++;
+		header[5U] = (txSweepId & 0xFF00U) >> 8U;
+		header[6U] = txSweepId & 0x00FFU;
+		headerSize = HDR_V2_LENGTH;
 	}
+	else
+	{
+		header[0U] = HDR_PREFIX;
+		header[1U] = (uint8_t)length;
+		header[2U] = command;
+		headerSize = HDR_LENGTH;
+	}
+
+	/* Both formats seed the CRC with the version 1 prefix */
+	txFrameCrc = crc16Update(HDR_PREFIX, &header[1U], headerSize - 1U);
+
+	queueHostTx(header, headerSize);
+}
+
+/** @brief Send payload bytes of the frame started by #beginHostFrame.
+ *
+ *  @param data payload bytes.
+ *  @param size number of bytes.
+ *
+ *  @par Usage
+ *       @code
+ *       writeHostFrame(packedFrame, frameSize);
+ *       @endcode
+ */
+static void writeHostFrame(const void *data, uint16_t size)
+{
+	if (size == 0U)
+	{
+		return;
+	}
+
+	txFrameCrc = crc16Update(txFrameCrc, data, size);
 
-	return crc;
+	queueHostTx(data, size);
+}
+
+/** @brief Send the CRC of the frame started by #beginHostFrame.
+ *
+ *  @par Usage
+ *       @code
+ *       endHostFrame();
+ *       @endcode
+ */
+static void endHostFrame(void)
+{
+	uint8_t crc[CRC_LENGTH];
+
+	crc[0U] = (txFrameCrc & 0xFF00U) >> 8U;
+	crc[1U] = txFrameCrc & 0x00FFU;
+
+	queueHostTx(crc, CRC_LENGTH);
 }
 
 /** @brief Send command response back to host.
@@ -360,12 +1128,20 @@ static void sendHostResponse(uint8_t *tx, uint8_t txSize)
 {
     uint16_t txCrc;
 
+    if (hostFraming == FRAMING_V2)
+    {
+    	beginHostFrame(tx[HDR_CMD_INDEX], tx[HDR_CMDSIZE_INDEX]);
+    	writeHostFrame(&tx[HDR_LENGTH], tx[HDR_CMDSIZE_INDEX]);
+    	endHostFrame();
+    	return;
+    }
+
     txCrc = calcCrc16(tx, txSize - CRC_LENGTH);
 
     tx[txSize - 2U] = (txCrc & 0xFF00U) >> 8U;
     tx[txSize - 1U] = txCrc & 0x00FFU;
 
-    UART_write(uart, tx, txSize);
+    queueHostTx(tx, txSize);
 }
 
 /** @brief Send command response back to host with a payload array.
@@ -382,40 +1158,28 @@ static void sendHostResponse(uint8_t *tx, uint8_t txSize)
 static void sendHostArrayResponse(HostCommand arrCmd,
 		const uint8_t *txArr, size_t txSize)
 {
-	uint16_t arrCmdCrc, crcIndex, txArrIndex = 0U;
+	uint16_t frameSize, txArrIndex = 0U;
 
 	while (txSize > 0U)
 	{
-		/* Determine size of frame to send to host */
-		if (txSize <= 255U)
+		/* Determine size of frame to send to host, version 2 frames
+		 * take the whole array
+		 */
+		if ((txSize <= 255U) || (hostFraming == FRAMING_V2))
 		{
-			arrCmd.length = (uint8_t)txSize;
+			frameSize = (uint16_t)txSize;
 		}
 		else
 		{
-			arrCmd.length = 255U;
+			frameSize = 255U;
 		}
 
-		/* send response preamble to host */
-		UART_write(uart, &arrCmd, HDR_LENGTH);
-
-		/* send payload */
-		UART_write(uart, &txArr[txArrIndex], arrCmd.length);
-
-		/* CRC calculation */
-		arrCmdCrc = calcCrc16(&arrCmd, HDR_LENGTH);
-
-		for (crcIndex = 0U; crcIndex < arrCmd.length; crcIndex++)
-		{
-			crc16AddByte(&arrCmdCrc, txArr[txArrIndex]);
-			txArrIndex++;
-			txSize--;
-		}
+		beginHostFrame(arrCmd.command, frameSize);
+		writeHostFrame(&txArr[txArrIndex], frameSize);
+		endHostFrame();
 
-		/* send response CRC to host */
-		arrCmd.payload[0U] = (arrCmdCrc & 0xFF00U) >> 8U;
-		arrCmd.payload[1U]= arrCmdCrc & 0x00FFU;
-		UART_write(uart, &arrCmd.payload, CRC_LENGTH);
+		txArrIndex += frameSize;
+		txSize -= frameSize;
 	}
 }
 
@@ -460,6 +1224,28 @@ void sendSweepMessage(HostCommand sweepCmd)
 	setPendSweepCmd(&hostMessage);
 }
 
+/** @brief Drop the state a host left behind: stop streaming, zero span,
+ *  the trigger and chunked streaming and return to one byte per value of
+ *  every point in version 1 frames.
+ *
+ *  @par Usage
+ *       @code
+ *       resetHostSession();
+ *       @endcode
+ */
+static void resetHostSession(void)
+{
+	isStreaming = FALSE;
+	isZeroSpan = FALSE;
+	isTrigger = FALSE;
+	stopChunkStream();
+
+	/* A new host expects one byte per value of every point */
+	specEncoding = SPECPACK_RAW;
+	decimationBins = 0U;
+	hostFraming = FRAMING_V1;
+}
+
 /** @brief Configure system to operate with UART connected.
  *
  *  @param connectCmd #HostCommand full command received from host.
@@ -473,6 +1259,9 @@ static void connect(HostCommand connectCmd)
 {
 	uartCmdKey = lockSweepCmd();
 
+	/* A host that connects again without disconnecting starts over */
+	resetHostSession();
+
 	/* Change to command adjustment mode */
 	hostMessage.command = CHANGE_MODE;
 
@@ -499,6 +1288,8 @@ static void connect(HostCommand connectCmd)
  */
 static void disconnect(HostCommand disconnectCmd)
 {
+	resetHostSession();
+
 	unlockButton();
     /* Turn off Board_PIN_GLED to indicate host released the board */
     PIN_setOutputValue(gledPinHandle, Board_PIN_GLED, 0U);
@@ -514,6 +1305,12 @@ static void disconnect(HostCommand disconnectCmd)
     unlockSweepCmd(uartCmdKey);
 
     sendHostAck(disconnectCmd); /* ACK Command */
+
+    /* The next host connects at the default rate */
+    if (uartParams.baudRate != UART_DEFAULT_BAUD)
+    {
+    	reopenUart(UART_DEFAULT_BAUD);
+    }
 }
 
 /** @brief Send device version to host.
@@ -635,268 +1432,1274 @@ static void sync(HostCommand syncCmd)
     sendHostAck(syncCmd); /* ACK Command */
 }
 
-/** @brief Update the frequency band of the spectrum sweep.
+/** @brief Change the UART rate and confirm it with a #CMD_SYNC handshake.
  *
- *  @param setFBandCmd #HostCommand full command received from host.
+ *  @param setBaudRateCmd #HostCommand full command received from host.
  *
  *  @par Usage
  *       @code
- *       setFBand(hostCmd);
+ *       setBaudRate(hostCmd);
  *       @endcode
  */
-static void setFBand(HostCommand setFBandCmd)
+static void setBaudRate(HostCommand setBaudRateCmd)
 {
-	/* Set Frequency band of operation */
-	hostMessage.command = CHANGE_BAND;
+	uint32_t oldBaudRate = uartParams.baudRate;
+	uint32_t newBaudRate;
+	uint8_t rateIndex;
 
-	sendSweepMessage(setFBandCmd);
+	/* Stream frames would be sent at a rate the host does not expect yet */
+	if ((setBaudRateCmd.length != 4U) || isStreaming)
+	{
+		return;
+	}
 
-    sendHostAck(setFBandCmd); /* ACK Command */
-}
+	newBaudRate = ((uint32_t)setBaudRateCmd.payload[0U] << 24U)
+			| ((uint32_t)setBaudRateCmd.payload[1U] << 16U)
+			| ((uint32_t)setBaudRateCmd.payload[2U] << 8U)
+			| (uint32_t)setBaudRateCmd.payload[3U];
 
-/** @brief Update the start frequency of the spectrum sweep.
- *
- *  @param setFStartCmd #HostCommand full command received from host.
- *
- *  @par Usage
- *       @code
+	for (rateIndex = 0U; rateIndex < (sizeof(uartBaudRates) / sizeof(uartBaudRates[0U])); rateIndex++)
+	{
+		if (uartBaudRates[rateIndex] == newBaudRate)
+		{
+			break;
+		}
+	}
+	if (rateIndex == (sizeof(uartBaudRates) / sizeof(uartBaudRates[0U])))
+	{
+		return;
+	}
+
+    sendHostAck(setBaudRateCmd); /* ACK Command at the old rate */
+
+    reopenUart(newBaudRate);
+
+    /* Without a confirmation the host could not follow, fall back */
+    if (!waitBaudSync())
+    {
+    	reopenUart(oldBaudRate);
+    }
+}
+
+/** @brief Select the encoding of spectrum data frames.
+ *
+ *  @param setEncodingCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setEncoding(hostCmd);
+ *       @endcode
+ */
+static void setEncoding(HostCommand setEncodingCmd)
+{
+	if ((setEncodingCmd.length != 1U)
+			|| (setEncodingCmd.payload[0U] > SPECPACK_DELTA))
+	{
+		return;
+	}
+
+	specEncoding = setEncodingCmd.payload[0U];
+
+    sendHostAck(setEncodingCmd); /* ACK Command */
+}
+
+/** @brief Select the format of the frames sent to the host.
+ *
+ *  @param setFramingCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setFraming(hostCmd);
+ *       @endcode
+ */
+static void setFraming(HostCommand setFramingCmd)
+{
+	if ((setFramingCmd.length != 1U)
+			|| (setFramingCmd.payload[0U] < FRAMING_V1)
+			|| (setFramingCmd.payload[0U] > FRAMING_V2))
+	{
+		return;
+	}
+
+    sendHostAck(setFramingCmd); /* ACK Command in the previous format */
+
+	hostFraming = setFramingCmd.payload[0U];
+	txSequence = 0U;
+}
+
+/** @brief Select the number of bins and their reduction for spectrum data
+ *  frames.
+ *
+ *  @param setDecimationCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setDecimation(hostCmd);
+ *       @endcode
+ */
+static void setDecimation(HostCommand setDecimationCmd)
+{
+	uint16_t bins = ((uint16_t)setDecimationCmd.payload[0U] << 8U)
+			| setDecimationCmd.payload[1U];
+
+	/* Invalid settings get no ACK */
+	if ((setDecimationCmd.length != 3U)
+			|| (bins > DECIMATION_MAX_BINS)
+			|| (setDecimationCmd.payload[2U] > DETECTOR_RMS))
+	{
+		return;
+	}
+
+	decimationBins = bins;
+	decimationMode = setDecimationCmd.payload[2U];
+
+    sendHostAck(setDecimationCmd); /* ACK Command */
+}
+
+/** @brief Update the frequency band of the spectrum sweep.
+ *
+ *  @param setFBandCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setFBand(hostCmd);
+ *       @endcode
+ */
+static void setFBand(HostCommand setFBandCmd)
+{
+	/* Set Frequency band of operation */
+	hostMessage.command = CHANGE_BAND;
+
+	sendSweepMessage(setFBandCmd);
+
+    sendHostAck(setFBandCmd); /* ACK Command */
+}
+
+/** @brief Update the start frequency of the spectrum sweep.
+ *
+ *  @param setFStartCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
  *       setFStart(hostCmd);
  *       @endcode
  */
-static void setFStart(HostCommand setFStartCmd)
+static void setFStart(HostCommand setFStartCmd)
+{
+	/* Set Start Frequency fstart */
+	hostMessage.command = SET_START_FREQ;
+
+	sendSweepMessage(setFStartCmd);
+
+    sendHostAck(setFStartCmd); /* ACK Command */
+}
+
+/** @brief Update stop frequency of the spectrum sweep.
+ *
+ *  @param setFStopCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setFStop(hostCmd);
+ *       @endcode
+ */
+static void setFStop(HostCommand setFStopCmd)
+{
+    /* Set Stop  Frequency fstop */
+    hostMessage.command = SET_END_FREQ;
+
+    sendSweepMessage(setFStopCmd);
+
+    sendHostAck(setFStopCmd); /* ACK Command */
+}
+
+/** @brief Update span index of the spectrum sweep.
+ *
+ *  @param setSpanIndexCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setSpanIndex(hostCmd);
+ *       @endcode
+ */
+static void setSpanIndex(HostCommand setSpanIndexCmd)
+{
+    /* Set Span index */
+    hostMessage.command = CHANGE_SPAN;
+
+    sendSweepMessage(setSpanIndexCmd);
+
+    sendHostAck(setSpanIndexCmd); /* ACK Command */
+}
+
+/** @brief Update FSW of the spectrum sweep.
+ *
+ *  @param setFStepCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setFStep(hostCmd);
+ *       @endcode
+ */
+static void setFStep(HostCommand setFStepCmd)
+{
+    /* Set Step  Frequency fstep */
+    hostMessage.command = SET_FREQSTEP;
+
+    sendSweepMessage(setFStepCmd);
+
+    sendHostAck(setFStepCmd); /* ACK Command */
+}
+
+/** @brief Update frequency step count of the spectrum sweep.
+ *
+ *  @param setStepCountCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setStepCount(hostCmd);
+ *       @endcode
+ */
+static void setStepCount(HostCommand setStepCountCmd)
+{
+    /* Set Step  Count fcount */
+    hostMessage.command = SET_STEPCOUNT;
+
+    sendSweepMessage(setStepCountCmd);
+
+    sendHostAck(setStepCountCmd); /* ACK Command */
+}
+
+/** @brief Update span of the spectrum sweep.
+ *
+ *  @param setSpanCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setSpan(hostCmd);
+ *       @endcode
+ */
+static void setSpan(HostCommand setSpanCmd)
+{
+    /* Set Span  Frequency fspan */
+    hostMessage.command = SET_SPAN;
+
+    sendSweepMessage(setSpanCmd);
+
+    sendHostAck(setSpanCmd); /* ACK Command */
+}
+
+/** @brief Update RBW of the spectrum sweep.
+ *
+ *  @param setRbwCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setRbw(hostCmd);
+ *       @endcode
+ */
+static void setRbw(HostCommand setRbwCmd)
+{
+    /* Set Rx Filter bandwidth */
+    hostMessage.command = SET_RBW;
+
+    sendSweepMessage(setRbwCmd);
+
+    sendHostAck(setRbwCmd); /* ACK Command */
+}
+
+/** @brief Update the complete configuration of the spectrum sweep at once.
+ *
+ *  @param setSweepCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setSweep(hostCmd);
+ *       @endcode
+ */
+static void setSweep(HostCommand setSweepCmd)
+{
+	/* Without the full configuration the host gets no ACK */
+	if (setSweepCmd.length != SWEEP_CONFIG_LENGTH)
+	{
+		return;
+	}
+
+	/* Set all sweep parameters in one RF task update */
+	hostMessage.command = SET_SWEEP;
+
+	sendSweepMessage(setSweepCmd);
+
+    sendHostAck(setSweepCmd); /* ACK Command */
+}
+
+/** @brief Update the detector of the spectrum sweep.
+ *
+ *  @param setDetectorCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setDetector(hostCmd);
+ *       @endcode
+ */
+static void setDetector(HostCommand setDetectorCmd)
+{
+	/* Invalid settings get no ACK */
+	if ((setDetectorCmd.length != 2U)
+			|| (setDetectorCmd.payload[0U] > DETECTOR_RMS)
+			|| (setDetectorCmd.payload[1U] == 0U)
+			|| (setDetectorCmd.payload[1U] > DETECTOR_MAX_DWELL))
+	{
+		return;
+	}
+
+	/* Set detector mode and dwell count */
+	hostMessage.command = SET_DETECTOR;
+
+	sendSweepMessage(setDetectorCmd);
+
+    sendHostAck(setDetectorCmd); /* ACK Command */
+}
+
+/** @brief Start or end a multi-band sweep.
+ *
+ *  @param setMultiBandCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       setMultiBand(hostCmd);
+ *       @endcode
+ */
+static void setMultiBand(HostCommand setMultiBandCmd)
+{
+	uint8_t pyldIndex;
+
+	/* Whole segments only, the RF task checks their bands and spans */
+	if (((setMultiBandCmd.length % MULTIBAND_SEGMENT_SIZE) != 0U)
+			|| (setMultiBandCmd.length
+					> (MULTIBAND_MAX_SEGMENTS * MULTIBAND_SEGMENT_SIZE)))
+	{
+		return;
+	}
+
+	/* Segment count followed by the segments */
+	hostMessage.command = SET_MULTIBAND;
+	hostMessage.payload[0U] = setMultiBandCmd.length / MULTIBAND_SEGMENT_SIZE;
+	for (pyldIndex = 0U; pyldIndex < setMultiBandCmd.length; pyldIndex++)
+	{
+		hostMessage.payload[1U + pyldIndex] = setMultiBandCmd.payload[pyldIndex];
+	}
+
+	setPendSweepCmd(&hostMessage);
+
+    sendHostAck(setMultiBandCmd); /* ACK Command */
+}
+
+/** @brief Send the time taken by band switches to host.
+ *
+ *  @param getBandStatsCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       getBandStats(hostCmd);
+ *       @endcode
+ */
+static void getBandStats(HostCommand getBandStatsCmd)
+{
+	BandSwitchStats stats;
+	const BandSwitchTimes *switchTimes[] = {&stats.setup, &stats.reopen};
+	uint32_t statValues[4U];
+	uint8_t statsCmd[sizeof(switchTimes) / sizeof(switchTimes[0U])
+			* sizeof(statValues)];
+	uint8_t timesIndex, valueIndex, *statByte = statsCmd;
+
+    sendHostAck(getBandStatsCmd); /* First ACK Command */
+
+    getBandSwitchStats(&stats);
+
+    for (timesIndex = 0U;
+    		timesIndex < (sizeof(switchTimes) / sizeof(switchTimes[0U]));
+    		timesIndex++)
+    {
+    	statValues[0U] = switchTimes[timesIndex]->count;
+    	statValues[1U] = switchTimes[timesIndex]->lastTicks * Clock_tickPeriod;
+    	statValues[2U] = switchTimes[timesIndex]->maxTicks * Clock_tickPeriod;
+    	statValues[3U] = switchTimes[timesIndex]->totalTicks * Clock_tickPeriod;
+
+    	for (valueIndex = 0U; valueIndex < 4U; valueIndex++)
+    	{
+    		*statByte++ = (statValues[valueIndex] >> 24U) & 0xFFU;
+    		*statByte++ = (statValues[valueIndex] >> 16U) & 0xFFU;
+    		*statByte++ = (statValues[valueIndex] >> 8U) & 0xFFU;
+    		*statByte++ = statValues[valueIndex] & 0xFFU;
+    	}
+    }
+
+    sendHostArrayResponse(getBandStatsCmd, statsCmd, sizeof(statsCmd));
+}
+
+/** @brief Send the performance counters to host, see #PerfCounterId. The
+ *  response of 4 + 20 bytes per counter is built in #packedFrame, which
+ *  holds it for up to 12 counters.
+ *
+ *  @param getPerfStatsCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       getPerfStats(hostCmd);
+ *       @endcode
+ */
+static void getPerfStats(HostCommand getPerfStatsCmd)
+{
+	PerfCounter counter;
+	uint32_t statValues[3U];
+	uint32_t freq = getPerfFreq();
+	uint8_t counterIndex, valueIndex, byteIndex, *statByte = packedFrame;
+	_Bool reset = FALSE;
+
+	if (getPerfStatsCmd.length > 1U)
+	{
+		return;
+	}
+	if (getPerfStatsCmd.length == 1U)
+	{
+		if (getPerfStatsCmd.payload[0U] > 1U)
+		{
+			return;
+		}
+		reset = (getPerfStatsCmd.payload[0U] == 1U);
+	}
+
+    sendHostAck(getPerfStatsCmd); /* First ACK Command */
+
+    *statByte++ = (freq >> 24U) & 0xFFU;
+    *statByte++ = (freq >> 16U) & 0xFFU;
+    *statByte++ = (freq >> 8U) & 0xFFU;
+    *statByte++ = freq & 0xFFU;
+
+    for (counterIndex = 0U; counterIndex < PERF_COUNTER_COUNT; counterIndex++)
+    {
+    	getPerfCounter((PerfCounterId)counterIndex, &counter, reset);
+
+    	statValues[0U] = counter.count;
+    	statValues[1U] = counter.min;
+    	statValues[2U] = counter.max;
+
+    	for (valueIndex = 0U; valueIndex < 3U; valueIndex++)
+    	{
+    		*statByte++ = (statValues[valueIndex] >> 24U) & 0xFFU;
+    		*statByte++ = (statValues[valueIndex] >> 16U) & 0xFFU;
+    		*statByte++ = (statValues[valueIndex] >> 8U) & 0xFFU;
+    		*statByte++ = statValues[valueIndex] & 0xFFU;
+    	}
+    	for (byteIndex = 0U; byteIndex < sizeof(counter.sum); byteIndex++)
+    	{
+    		*statByte++ = (counter.sum >> (56U - (8U * byteIndex))) & 0xFFU;
+    	}
+    }
+
+    sendHostArrayResponse(getPerfStatsCmd, packedFrame,
+    		(size_t)(statByte - packedFrame));
+}
+
+/** @brief Update parameters sent with previous host commands to spectrum sweep.
+ *
+ *  @param initParameterCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       initParameter(hostCmd);
+ *       @endcode
+ */
+static void initParameter(HostCommand initParameterCmd)
+{
+    /* Notify RF Task that sweep parameters are updated */
+	/* RF Task will need to complete a sweep prior to getSpecNoInit, but there
+	 * are otherwise no major differences and thus the same command is reused.
+	 */
+    hostMessage.command = SEND_SPECTRUM;
+
+    sendSweepMessage(initParameterCmd);
+
+    sendHostAck(initParameterCmd); /* ACK Command */
+}
+
+/** @brief Reduce a sweep to the bins requested with #CMD_SETDECIMATION.
+ *
+ *  @param rssi RSSI values of a sweep held with lockSweepData() or
+ *  lockTriggerBurst().
+ *  @param length number of RSSI values.
+ *  @param rssiValues set to the values to send, the sweep itself at full
+ *  resolution.
+ *
+ *  @return number of values to send
+ *
+ *  @par Usage
+ *       @code
+ *       sweepSize = decimateSpectrum(sweep->rssi, sweep->length, &rssiValues);
+ *       @endcode
+ */
+static uint16_t decimateSpectrum(const int8_t *rssi, uint16_t length,
+		const int8_t **rssiValues)
+{
+	uint16_t factor = detectorDecimateFactor(length, decimationBins);
+
+	if (factor == 1U)
+	{
+		*rssiValues = rssi;
+		return length;
+	}
+
+	*rssiValues = decimatedRssi;
+	return detectorDecimate(decimationMode, rssi, length, factor,
+			decimatedRssi);
+}
+
+/** @brief Prepare the payload of one version 1 spectrum frame.
+ *
+ *  @param rssiValues values not sent yet.
+ *  @param count number of values, at least 1.
+ *  @param payload returns the payload, packedFrame for delta encoding.
+ *  @param frameValues returns the number of values in the payload.
+ *
+ *  @return payload length in bytes
+ *
+ *  @par Usage
+ *       @code
+ *       frameSize = spectrumFrame(&rssiValues[rssiIndex],
+ *               sweepSize - rssiIndex, &payload, &frameValues);
+ *       @endcode
+ */
+static uint8_t spectrumFrame(const int8_t *rssiValues, uint16_t count,
+		const uint8_t **payload, uint16_t *frameValues)
+{
+	if (specEncoding == SPECPACK_DELTA)
+	{
+		*payload = packedFrame;
+		return specPackFrame(rssiValues, count, packedFrame, frameValues);
+	}
+
+	if (count > 255U)
+	{
+		count = 255U;
+	}
+	*payload = (const uint8_t *)rssiValues;
+	*frameValues = count;
+
+	return (uint8_t)count;
+}
+
+/** @brief Send spectrum sweep data to host. Version 1 frames hold up to
+ *  255 bytes each, a version 2 frame takes the payloads of all of them.
+ *
+ *  @param specCmd command number of the data frames.
+ *  @param rssiValues values from decimateSpectrum().
+ *  @param sweepSize number of values.
+ *
+ *  @par Usage
+ *       @code
+ *       sendSpectrum(CMD_GETSPECNOINIT, rssiValues, sweepSize);
+ *       @endcode
+ */
+static void sendSpectrum(uint8_t specCmd, const int8_t *rssiValues,
+		uint16_t sweepSize)
+{
+	uint16_t rssiIndex, frameValues, sweepBytes = 0U;
+	uint16_t startHead = txHead;
+	uint32_t startWait = txWaitTime;
+	const uint8_t *framePayload;
+	uint8_t frameSize;
+
+	if (hostFraming == FRAMING_V2)
+	{
+		/* The header needs the packed size, so the sweep is packed twice
+		 * instead of buffering it
+		 */
+		for (rssiIndex = 0U; rssiIndex < sweepSize; rssiIndex += frameValues)
+		{
+			sweepBytes += spectrumFrame(&rssiValues[rssiIndex],
+					sweepSize - rssiIndex, &framePayload, &frameValues);
+		}
+		beginHostFrame(specCmd, sweepBytes);
+	}
+
+	for (rssiIndex = 0U; rssiIndex < sweepSize; rssiIndex += frameValues)
+	{
+		frameSize = spectrumFrame(&rssiValues[rssiIndex],
+				sweepSize - rssiIndex, &framePayload, &frameValues);
+
+		if (hostFraming == FRAMING_V1)
+		{
+			beginHostFrame(specCmd, frameSize);
+			writeHostFrame(framePayload, frameSize);
+			endHostFrame();
+		}
+		else
+		{
+			writeHostFrame(framePayload, frameSize);
+		}
+	}
+
+	if (hostFraming == FRAMING_V2)
+	{
+		endHostFrame();
+	}
+
+	perfRecord(PERF_SPECTRUM_BYTES, (uint16_t)(txHead - startHead));
+	perfRecord(PERF_SPECTRUM_TX_WAIT, txWaitTime - startWait);
+}
+
+/** @brief Respond to request for spectrum sweep data with latest sweep.
+ *
+ *  @param getSpecNoInitCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       getSpecNoInit(hostCmd);
+ *       @endcode
+ */
+static void getSpecNoInit(HostCommand getSpecNoInitCmd)
+{
+	const SweepBuffer *sweep;
+	const int8_t *rssiValues;
+	uint16_t sweepSize;
+
+	/* Array to store payload for end of frame indication. */
+    uint8_t eofCmd[] = {HDR_PREFIX, 0x02U, CMD_GETLASTERROR, 0x00U, 0x00U,
+    		0U, 0U};
+
+    /* The RF task holds one frequency, there is no sweep to send */
+    if (isZeroSpan)
+    {
+    	return;
+    }
+
+    /* Notify RF Task that we're sending a sweep out */
+    hostMessage.command = SEND_SPECTRUM;
+
+    sendSweepMessage(getSpecNoInitCmd);
+
+    getNewSweep();
+
+    /* Hold the completed sweep, the RF task fills another buffer */
+    sweep = lockSweepData();
+
+    /* Wait for a new sweep if the last one was dropped by #CMD_SETSWEEP */
+    while (sweep->length == 0U)
+    {
+    	unlockSweepData(sweep);
+    	getNewSweep();
+    	sweep = lockSweepData();
+    }
+
+    sendHostAck(getSpecNoInitCmd); /* First ACK Command */
+
+    /* Send a frame of spectrum to host */
+    sweepSize = decimateSpectrum(sweep->rssi, sweep->length, &rssiValues);
+    txSweepId = sweep->count;
+    sendSpectrum(CMD_GETSPECNOINIT, rssiValues, sweepSize);
+    txSweepId = 0U;
+
+    /* Send host notification of end of frame, a version 2 frame holds the
+     * whole sweep
+     */
+    if (hostFraming == FRAMING_V1)
+    {
+    	sendHostResponse(eofCmd, sizeof(eofCmd));
+    }
+
+    /* Notify RF Task that we're done sending out sweep */
+    unlockSweepData(sweep);
+}
+
+/** @brief Start pushing every completed sweep to the host.
+ *
+ *  @param startStreamCmd #HostCommand full command received from host.
+ *
+ *  @par Usage
+ *       @code
+ *       startStream(hostCmd);
+ *       @endcode
+ */
+static void startStream(HostCommand startStreamCmd)
 {
-	/* Set Start Frequency fstart */
-	hostMessage.command = SET_START_FREQ;
+    stopStreamMode(startStreamCmd);
 
-	sendSweepMessage(setFStartCmd);
+    sendHostAck(startStreamCmd); /* ACK Command */
 
-    sendHostAck(setFStartCmd); /* ACK Command */
+    /* First streamed sweep is the next one the RF task completes */
+    streamSweepCount = getSweepCount();
+    isStreaming = TRUE;
 }
 
-/** @brief Update stop frequency of the spectrum sweep.
+/** @brief Stop pushing sweeps to the host.
  *
- *  @param setFStopCmd #HostCommand full command received from host.
+ *  @param stopStreamCmd #HostCommand full command received from host.
  *
  *  @par Usage
  *       @code
- *       setFStop(hostCmd);
+ *       stopStream(hostCmd);
  *       @endcode
  */
-static void setFStop(HostCommand setFStopCmd)
+static void stopStream(HostCommand stopStreamCmd)
 {
-    /* Set Stop  Frequency fstop */
-    hostMessage.command = SET_END_FREQ;
+    isStreaming = FALSE;
 
-    sendSweepMessage(setFStopCmd);
+    stopStreamMode(stopStreamCmd);
 
-    sendHostAck(setFStopCmd); /* ACK Command */
+    sendHostAck(stopStreamCmd); /* ACK Command */
 }
 
-/** @brief Update span index of the spectrum sweep.
+/** @brief End zero span, the trigger or chunked streaming, the RF task
+ *  continues the sweep.
  *
- *  @param setSpanIndexCmd #HostCommand full command received from host.
+ *  @param stopModeCmd #HostCommand passed on to the RF task.
  *
  *  @par Usage
  *       @code
- *       setSpanIndex(hostCmd);
+ *       stopStreamMode(hostCmd);
  *       @endcode
  */
-static void setSpanIndex(HostCommand setSpanIndexCmd)
+static void stopStreamMode(HostCommand stopModeCmd)
 {
-    /* Set Span index */
-    hostMessage.command = CHANGE_SPAN;
+    if (isZeroSpan)
+    {
+    	isZeroSpan = FALSE;
 
-    sendSweepMessage(setSpanIndexCmd);
+    	/* Notify RF Task to continue the sweep */
+    	hostMessage.command = STOP_ZERO_SPAN;
 
-    sendHostAck(setSpanIndexCmd); /* ACK Command */
+    	sendSweepMessage(stopModeCmd);
+    }
+
+    if (isTrigger)
+    {
+    	isTrigger = FALSE;
+
+    	/* Notify RF Task to stop keeping sweeps */
+    	hostMessage.command = DISARM_TRIGGER;
+
+    	sendSweepMessage(stopModeCmd);
+    }
+
+    stopChunkStream();
 }
 
-/** @brief Update FSW of the spectrum sweep.
+/** @brief Tune to one frequency and push RSSI samples over time to the host.
  *
- *  @param setFStepCmd #HostCommand full command received from host.
+ *  @param startZeroSpanCmd #HostCommand full command received from host.
  *
  *  @par Usage
  *       @code
- *       setFStep(hostCmd);
+ *       startZeroSpan(hostCmd);
  *       @endcode
  */
-static void setFStep(HostCommand setFStepCmd)
+static void startZeroSpan(HostCommand startZeroSpanCmd)
 {
-    /* Set Step  Frequency fstep */
-    hostMessage.command = SET_FREQSTEP;
+	if (startZeroSpanCmd.length != 6U)
+	{
+		return;
+	}
 
-    sendSweepMessage(setFStepCmd);
+	stopStreamMode(startZeroSpanCmd);
 
-    sendHostAck(setFStepCmd); /* ACK Command */
+	/* Notify RF Task to sample at the frequency */
+	hostMessage.command = START_ZERO_SPAN;
+
+	sendSweepMessage(startZeroSpanCmd);
+
+    sendHostAck(startZeroSpanCmd); /* ACK Command */
+
+    /* First block is the next one the RF task completes */
+    streamSweepCount = getSweepCount();
+    isZeroSpan = TRUE;
+    isStreaming = TRUE;
 }
 
-/** @brief Update frequency step count of the spectrum sweep.
+/** @brief Send one zero span block to the host as a #CMD_ZEROSPANDATA frame.
  *
- *  @param setStepCountCmd #HostCommand full command received from host.
+ *  @param block block held with lockSweepData().
  *
  *  @par Usage
  *       @code
- *       setStepCount(hostCmd);
+ *       sendZeroSpan(sweep);
  *       @endcode
  */
-static void setStepCount(HostCommand setStepCountCmd)
+static void sendZeroSpan(const SweepBuffer *block)
 {
-    /* Set Step  Count fcount */
-    hostMessage.command = SET_STEPCOUNT;
-
-    sendSweepMessage(setStepCountCmd);
+	HostCommand zeroSpanCmd = {HDR_PREFIX, 0U, CMD_ZEROSPANDATA, {0U}};
+	uint32_t startUs = block->startTick * Clock_tickPeriod;
+	uint32_t endUs = block->endTick * Clock_tickPeriod;
+	uint16_t sampleIndex;
+
+	packedFrame[0U] = (block->count & 0xFF00U) >> 8U;
+	packedFrame[1U] = block->count & 0x00FFU;
+	packedFrame[2U] = (startUs >> 24U) & 0xFFU;
+	packedFrame[3U] = (startUs >> 16U) & 0xFFU;
+	packedFrame[4U] = (startUs >> 8U) & 0xFFU;
+	packedFrame[5U] = startUs & 0xFFU;
+	packedFrame[6U] = (endUs >> 24U) & 0xFFU;
+	packedFrame[7U] = (endUs >> 16U) & 0xFFU;
+	packedFrame[8U] = (endUs >> 8U) & 0xFFU;
+	packedFrame[9U] = endUs & 0xFFU;
+
+	for (sampleIndex = 0U; sampleIndex < block->length; sampleIndex++)
+	{
+		packedFrame[ZERO_SPAN_HDR_LENGTH + sampleIndex] =
+				(uint8_t)block->rssi[sampleIndex];
+	}
 
-    sendHostAck(setStepCountCmd); /* ACK Command */
+	txSweepId = block->count;
+	sendHostArrayResponse(zeroSpanCmd, packedFrame,
+			ZERO_SPAN_HDR_LENGTH + block->length);
+	txSweepId = 0U;
 }
 
-/** @brief Update span of the spectrum sweep.
+/** @brief Arm the threshold trigger and push each burst to the host.
  *
- *  @param setSpanCmd #HostCommand full command received from host.
+ *  @param armTriggerCmd #HostCommand full command received from host.
  *
  *  @par Usage
  *       @code
- *       setSpan(hostCmd);
+ *       armTrigger(hostCmd);
  *       @endcode
  */
-static void setSpan(HostCommand setSpanCmd)
+static void armTrigger(HostCommand armTriggerCmd)
 {
-    /* Set Span  Frequency fspan */
-    hostMessage.command = SET_SPAN;
+	if ((armTriggerCmd.length != 4U)
+			|| ((armTriggerCmd.payload[1U] + armTriggerCmd.payload[2U])
+					>= TRIGGER_RING_LENGTH)
+			|| ((armTriggerCmd.payload[3U]
+					& ~(TRIGGER_PER_POINT | TRIGGER_REARM)) != 0U))
+	{
+		return;
+	}
 
-    sendSweepMessage(setSpanCmd);
+	stopStreamMode(armTriggerCmd);
 
-    sendHostAck(setSpanCmd); /* ACK Command */
+	/* Notify RF Task to keep sweeps and check the levels */
+	hostMessage.command = ARM_TRIGGER;
+
+	sendSweepMessage(armTriggerCmd);
+
+    sendHostAck(armTriggerCmd); /* ACK Command */
+
+    isTrigger = TRUE;
+    isStreaming = TRUE;
 }
 
-/** @brief Update RBW of the spectrum sweep.
+/** @brief Set per-point trigger levels used by #CMD_ARMTRIGGER.
  *
- *  @param setRbwCmd #HostCommand full command received from host.
+ *  @param setTriggerLevelsCmd #HostCommand full command received from host.
  *
  *  @par Usage
  *       @code
- *       setRbw(hostCmd);
+ *       setTriggerLevelsCmd(hostCmd);
  *       @endcode
  */
-static void setRbw(HostCommand setRbwCmd)
+static void setTriggerLevelsCmd(HostCommand setTriggerLevelsCmd)
 {
-    /* Set Rx Filter bandwidth */
-    hostMessage.command = SET_RBW;
+	uint16_t offset = (uint16_t)((setTriggerLevelsCmd.payload[0U] << 8U)
+			| setTriggerLevelsCmd.payload[1U]);
+	uint16_t count = setTriggerLevelsCmd.length - 2U;
 
-    sendSweepMessage(setRbwCmd);
+	if ((setTriggerLevelsCmd.length < 3U)
+			|| ((offset + count) > TRIGGER_MAX_LENGTH))
+	{
+		return;
+	}
 
-    sendHostAck(setRbwCmd); /* ACK Command */
+	setTriggerLevels(offset, &setTriggerLevelsCmd.payload[2U], count);
+
+    sendHostAck(setTriggerLevelsCmd); /* ACK Command */
 }
 
-/** @brief Update parameters sent with previous host commands to spectrum sweep.
+/** @brief Send the trigger burst to the host once the RF task collected
+ *  the post-trigger sweeps, then let it re-arm.
  *
- *  @param initParameterCmd #HostCommand full command received from host.
+ *  @par Usage
+ *       @code
+ *       sendTriggerBurst();
+ *       @endcode
+ */
+static void sendTriggerBurst(void)
+{
+	const TriggerBurst *burst;
+	const TriggerSweep *entry;
+	const int8_t *rssiValues;
+	uint16_t sweepSize;
+	uint32_t timeUs;
+	uint8_t sweepIndex;
+
+	/* Array to store payload for start of burst sweep indication. */
+    uint8_t sweepCmd[] = {HDR_PREFIX, 0x0BU, CMD_TRIGGERSWEEP, 0U, 0U, 0U, 0U,
+    		0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
+
+    burst = lockTriggerBurst();
+    if (burst == NULL)
+    {
+    	return;
+    }
+
+    for (sweepIndex = 0U; sweepIndex < burst->length; sweepIndex++)
+    {
+    	entry = &burst->sweeps[(burst->first + sweepIndex) % TRIGGER_RING_LENGTH];
+    	timeUs = entry->tick * Clock_tickPeriod;
+    	sweepSize = decimateSpectrum(entry->rssi, entry->length, &rssiValues);
+
+    	sweepCmd[3] = (burst->count & 0xFF00U) >> 8U;
+    	sweepCmd[4] = burst->count & 0x00FFU;
+    	sweepCmd[5] = sweepIndex;
+    	sweepCmd[6] = burst->length;
+    	sweepCmd[7] = burst->trigger;
+    	sweepCmd[8] = (timeUs >> 24U) & 0xFFU;
+    	sweepCmd[9] = (timeUs >> 16U) & 0xFFU;
+    	sweepCmd[10] = (timeUs >> 8U) & 0xFFU;
+    	sweepCmd[11] = timeUs & 0xFFU;
+    	sweepCmd[12] = (sweepSize & 0xFF00U) >> 8U;
+    	sweepCmd[13] = sweepSize & 0x00FFU;
+
+    	/* Send host notification of start of sweep */
+    	txSweepId = burst->count;
+    	sendHostResponse(sweepCmd, sizeof(sweepCmd));
+
+    	/* Send the sweep to host */
+    	sendSpectrum(CMD_STREAMDATA, rssiValues, sweepSize);
+    }
+    txSweepId = 0U;
+
+    releaseTriggerBurst();
+}
+
+/** @brief Push the values of each sweep to the host in chunks while it is
+ *  measured.
+ *
+ *  @param startChunkStreamCmd #HostCommand full command received from host.
  *
  *  @par Usage
  *       @code
- *       initParameter(hostCmd);
+ *       startChunkStream(hostCmd);
  *       @endcode
  */
-static void initParameter(HostCommand initParameterCmd)
+static void startChunkStream(HostCommand startChunkStreamCmd)
 {
-    /* Notify RF Task that sweep parameters are updated */
-	/* RF Task will need to complete a sweep prior to getSpecNoInit, but there
-	 * are otherwise no major differences and thus the same command is reused.
-	 */
-    hostMessage.command = SEND_SPECTRUM;
+	if ((startChunkStreamCmd.length != 1U)
+			|| (startChunkStreamCmd.payload[0U] == 0U)
+			|| (startChunkStreamCmd.payload[0U] > CHUNK_MAX_VALUES))
+	{
+		return;
+	}
 
-    sendSweepMessage(initParameterCmd);
+	stopStreamMode(startChunkStreamCmd);
 
-    sendHostAck(initParameterCmd); /* ACK Command */
+    sendHostAck(startChunkStreamCmd); /* ACK Command */
+
+    /* First chunk is from the sweep the RF task is filling */
+    chunkValues = startChunkStreamCmd.payload[0U];
+    isStreaming = TRUE;
+}
+
+/** @brief Stop sending chunks and release the held sweep.
+ *
+ *  @par Usage
+ *       @code
+ *       stopChunkStream();
+ *       @endcode
+ */
+static void stopChunkStream(void)
+{
+	chunkValues = 0U;
+
+	if (chunkSweep != NULL)
+	{
+		unlockSweepData(chunkSweep);
+		chunkSweep = NULL;
+	}
 }
 
-/** @brief Send latest spectrum sweep data to host.
+/** @brief Send every complete chunk the RF task measured since the last
+ *  call as #CMD_SWEEPCHUNK frames, and the rest once the sweep is complete.
  *
  *  @par Usage
  *       @code
- *       sendSpectrum();
+ *       streamChunks();
  *       @endcode
  */
-static void sendSpectrum(void)
+static void streamChunks(void)
 {
-	uint16_t specCrc, sweepIndex, rssiIndex = 0U,
-			sweepSize = getSweepLength();
-	int8_t *rssiValues = getSweepData();
-	HostCommand gsniCmd = {HDR_PREFIX, 0xFFU, CMD_GETSPECNOINIT,
-			{0U}};
-//TODO: Refactor to re-use more generic function sendHostArrayResponse() instead of the code below.
-	while (sweepSize > 0U)
+	HostCommand chunkCmd = {HDR_PREFIX, 0U, CMD_SWEEPCHUNK, {0U}};
+	uint16_t length, filled, count, valueIndex;
+	uint8_t pass;
+	_Bool isComplete;
+
+	if (chunkSweep == NULL)
+	{
+		chunkSweep = lockSweepProgress(&chunkSequence);
+		chunkPass = chunkSweep->pass;
+		chunkOffset = 0U;
+	}
+
+	while (chunkSweep != NULL)
 	{
-		/* Determine size of frame to send to host */
-		if (sweepSize <= 255U)
+		/* Read in this order, filled is final once the sweep is complete */
+		pass = chunkSweep->pass;
+		isComplete = (chunkSweep->count == chunkSequence);
+		filled = chunkSweep->filled;
+
+		if (pass != chunkPass)
+		{
+			/* Filling restarted, the sweep is sent again */
+			chunkPass = pass;
+			chunkOffset = 0U;
+		}
+
+		if (isComplete)
 		{
-			gsniCmd.length = (uint8_t)sweepSize;
+			length = chunkSweep->length;
 		}
 		else
 		{
-			gsniCmd.length = 255U;
+			length = getSweepLength();
+			if (length > getSweepMaxLength())
+			{
+				length = getSweepMaxLength();
+			}
+		}
+
+		count = (filled > chunkOffset) ? (filled - chunkOffset) : 0U;
+		if (count > chunkValues)
+		{
+			count = chunkValues;
 		}
 
-		/* calculate initial crc */
-		specCrc = calcCrc16(&gsniCmd, HDR_LENGTH);
+		if ((count < chunkValues) && !isComplete)
+		{
+			/* Wait for the RF task to measure the rest of the chunk */
+			return;
+		}
 
-		/* send response preamble to host */
-		UART_write(uart, &gsniCmd, HDR_LENGTH);
+		for (valueIndex = 0U; valueIndex < count; valueIndex++)
+		{
+			packedFrame[CHUNK_HDR_LENGTH + valueIndex] =
+					(uint8_t)chunkSweep->rssi[chunkOffset + valueIndex];
+		}
 
-		/* send payload */
-		UART_write(uart, &rssiValues[rssiIndex], gsniCmd.length);
+		if (chunkSweep->pass != pass)
+		{
+			/* Values overwritten while copied */
+			continue;
+		}
 
-		/* CRC calculation */
-		for (sweepIndex = 0U; sweepIndex < gsniCmd.length; sweepIndex++)
+		if (count > 0U)
 		{
-			crc16AddByte(&specCrc, rssiValues[rssiIndex]);
-			rssiIndex++;
-			sweepSize--;
+			packedFrame[0U] = (chunkSequence & 0xFF00U) >> 8U;
+			packedFrame[1U] = chunkSequence & 0x00FFU;
+			packedFrame[2U] = (chunkOffset & 0xFF00U) >> 8U;
+			packedFrame[3U] = chunkOffset & 0x00FFU;
+			packedFrame[4U] = (length & 0xFF00U) >> 8U;
+			packedFrame[5U] = length & 0x00FFU;
+
+			txSweepId = chunkSequence;
+			sendHostArrayResponse(chunkCmd, packedFrame,
+					CHUNK_HDR_LENGTH + count);
+			txSweepId = 0U;
+
+			chunkOffset += count;
 		}
 
-		/* send response CRC to host */
-		gsniCmd.payload[0U] = (specCrc & 0xFF00U) >> 8U;
-		gsniCmd.payload[1U]= specCrc & 0x00FFU;
-		UART_write(uart, &gsniCmd.payload, CRC_LENGTH);
+		if (isComplete && (chunkOffset >= length))
+		{
+			/* The next sweep is the one the RF task is filling by then */
+			unlockSweepData(chunkSweep);
+			chunkSweep = NULL;
+		}
 	}
 }
 
-/** @brief Respond to request for spectrum sweep data with latest sweep.
- *
- *  @param getSpecNoInitCmd #HostCommand full command received from host.
+/** @brief Send the latest sweep to the host if the RF task completed one
+ *  since the last call.
  *
  *  @par Usage
  *       @code
- *       getSpecNoInit(hostCmd);
+ *       streamSpectrum();
  *       @endcode
  */
-static void getSpecNoInit(HostCommand getSpecNoInitCmd)
+static void streamSpectrum(void)
 {
-	IArg sweepMutexKey;
+	const SweepBuffer *sweep;
+	const int8_t *rssiValues;
+	uint16_t sweepSize;
 
-	/* Array to store payload for end of frame indication. */
-    uint8_t eofCmd[] = {HDR_PREFIX, 0x02U, CMD_GETLASTERROR, 0x00U, 0x00U,
+	/* Array to store payload for start of sweep indication. */
+    uint8_t sweepCmd[] = {HDR_PREFIX, 0x04U, CMD_STREAMSWEEP, 0U, 0U, 0U, 0U,
     		0U, 0U};
 
-    /* Notify RF Task that we're sending a sweep out */
-    hostMessage.command = SEND_SPECTRUM;
+    if (isTrigger)
+    {
+    	sendTriggerBurst();
+    	return;
+    }
 
-    sendSweepMessage(getSpecNoInitCmd);
+    if (chunkValues != 0U)
+    {
+    	streamChunks();
+    	return;
+    }
 
-    getNewSweep();
+    if (getSweepCount() == streamSweepCount)
+    {
+    	return;
+    }
 
-    sweepMutexKey = lockSweepData();
+    /* Hold the completed sweep, the RF task fills another buffer */
+    sweep = lockSweepData();
 
-    sendHostAck(getSpecNoInitCmd); /* First ACK Command */
+    streamSweepCount = sweep->count;
 
-    /* Send a frame of spectrum to host */
-    sendSpectrum();
+    /* Sweep dropped by #CMD_SETSWEEP, or completed before zero span started
+     * or stopped
+     */
+    if ((sweep->length == 0U) || (sweep->isZeroSpan != isZeroSpan))
+    {
+    	unlockSweepData(sweep);
+    	return;
+    }
+
+    if (isZeroSpan)
+    {
+    	sendZeroSpan(sweep);
+    	unlockSweepData(sweep);
+    	return;
+    }
 
-    /* Send host notification of end of frame */
-    sendHostResponse(eofCmd, sizeof(eofCmd));
+    sweepSize = decimateSpectrum(sweep->rssi, sweep->length, &rssiValues);
 
-    /* Notify RF Task that we're done sending out sweep */
-    /* RF Task can continue collecting data */
-    unlockSweepData(sweepMutexKey);
+    sweepCmd[3] = (sweep->count & 0xFF00U) >> 8U;
+    sweepCmd[4] = sweep->count & 0x00FFU;
+    sweepCmd[5] = (sweepSize & 0xFF00U) >> 8U;
+    sweepCmd[6] = sweepSize & 0x00FFU;
+
+    /* Send host notification of start of sweep */
+    txSweepId = sweep->count;
+    sendHostResponse(sweepCmd, sizeof(sweepCmd));
+
+    /* Send the sweep to host */
+    sendSpectrum(CMD_STREAMDATA, rssiValues, sweepSize);
+    txSweepId = 0U;
+
+    unlockSweepData(sweep);
+}
+
+/** @brief Drop the bytes the host sends until the line is quiet for one
+ *  read timeout, at most one command, so the next read starts at a frame.
+ *
+ *  @par Usage
+ *       @code
+ *       flushHostRx();
+ *       @endcode
+ */
+static void flushHostRx(void)
+{
+	uint8_t rxBytes[UART_FLUSH_CHUNK];
+	uint8_t chunk;
+
+	for (chunk = 0U; chunk < ((MAX_COMMAND_SIZE + UART_FLUSH_CHUNK - 1U)
+			/ UART_FLUSH_CHUNK); chunk++)
+	{
+		if (UART_read(uart, rxBytes, sizeof(rxBytes)) < (int_fast32_t)sizeof(rxBytes))
+		{
+			break;
+		}
+	}
+}
+
+/** @brief Return to #UART_DEFAULT_BAUD for a host that lost the raised rate.
+ *  Its streams end, it finds the SA1350 at the default rate and connects
+ *  again.
+ *
+ *  @par Usage
+ *       @code
+ *       resetHostLink();
+ *       @endcode
+ */
+static void resetHostLink(void)
+{
+	resetHostSession();
+	reopenUart(UART_DEFAULT_BAUD);
+}
+
+/** @brief Count a bad frame, framing error or break from the host and drop
+ *  what is left of it. After #UART_RX_ERROR_LIMIT in a row at a raised rate
+ *  the host most likely sends at another rate, see resetHostLink().
+ *
+ *  @par Usage
+ *       @code
+ *       hostRxError();
+ *       @endcode
+ */
+static void hostRxError(void)
+{
+	flushHostRx();
+
+	if (rxErrorCount < UART_RX_ERROR_LIMIT)
+	{
+		rxErrorCount++;
+	}
+
+	if ((rxErrorCount >= UART_RX_ERROR_LIMIT)
+			&& (uartParams.baudRate != UART_DEFAULT_BAUD))
+	{
+		resetHostLink();
+	}
+}
+
+/** @brief Read a fixed number of bytes from the host. Streams completed
+ *  sweeps while the host is silent.
+ *
+ *  @param rx buffer for the received bytes.
+ *  @param rxSize number of bytes to read.
+ *
+ *  @return FALSE if a receive error or the idle timeout at a raised rate
+ *  dropped the bytes read so far.
+ *
+ *  @par Usage
+ *       @code
+ *       if (readHost(&hostCmd, HDR_LENGTH)) { ... }
+ *       @endcode
+ */
+static _Bool readHost(void *rx, size_t rxSize)
+{
+	uint8_t *rxBytes = rx;
+	int_fast32_t rxCount;
+
+	while (rxSize > 0U)
+	{
+		rxCount = UART_read(uart, rxBytes, rxSize);
+
+		if (rxCount > 0)
+		{
+			rxBytes += rxCount;
+			rxSize -= (size_t)rxCount;
+		}
+		else if (rxCount < 0)
+		{
+			/* Framing error, overrun or break */
+			hostRxError();
+			return FALSE;
+		}
+		else if (isStreaming)
+		{
+			streamSpectrum();
+		}
+		else if ((uartParams.baudRate != UART_DEFAULT_BAUD)
+				&& ((Clock_getTicks() - hostFrameTicks) >= UART_IDLE_TIMEOUT))
+		{
+			resetHostLink();
+			return FALSE;
+		}
+	}
+
+	return TRUE;
 }
 
 /** @brief Process command from host and dispatch appropriately.
@@ -917,6 +2720,9 @@ static void processHostCommand(HostCommand hostCmd)
     /* Check CRC low and high bytes */
     if (cmdCrc == hostCrc)
     {
+    	rxErrorCount = 0U;
+    	hostFrameTicks = Clock_getTicks();
+
         /* Process command from host and send appropriate response. */
         switch(hostCmd.command) /* Command Number */
         {
@@ -951,6 +2757,30 @@ static void processHostCommand(HostCommand hostCmd)
             	sync(hostCmd);
             break;
 
+            case CMD_SETBAUDRATE:
+            	setBaudRate(hostCmd);
+            break;
+
+            case CMD_SETENCODING:
+            	setEncoding(hostCmd);
+            break;
+
+            case CMD_SETFRAMING:
+            	setFraming(hostCmd);
+            break;
+
+            case CMD_SETDECIMATION:
+            	setDecimation(hostCmd);
+            break;
+
+            case CMD_GETBANDSTATS:
+            	getBandStats(hostCmd);
+            break;
+
+            case CMD_GETPERFSTATS:
+            	getPerfStats(hostCmd);
+            break;
+
         /****************************/
         /**** Frequency Commands ****/
             case CMD_SETFBAND:
@@ -985,6 +2815,18 @@ static void processHostCommand(HostCommand hostCmd)
                 setSpan(hostCmd);
             break;
 
+            case CMD_SETSWEEP:
+                setSweep(hostCmd);
+            break;
+
+            case CMD_SETDETECTOR:
+                setDetector(hostCmd);
+            break;
+
+            case CMD_SETMULTIBAND:
+                setMultiBand(hostCmd);
+            break;
+
 
         /***************************************/
         /**** Spectrum Measurement Commands ****/
@@ -997,6 +2839,30 @@ static void processHostCommand(HostCommand hostCmd)
             	getSpecNoInit(hostCmd);
             break;
 
+            case CMD_STARTSTREAM:
+            	startStream(hostCmd);
+            break;
+
+            case CMD_STOPSTREAM:
+            	stopStream(hostCmd);
+            break;
+
+            case CMD_STARTZEROSPAN:
+            	startZeroSpan(hostCmd);
+            break;
+
+            case CMD_ARMTRIGGER:
+            	armTrigger(hostCmd);
+            break;
+
+            case CMD_SETTRIGGERLEVELS:
+            	setTriggerLevelsCmd(hostCmd);
+            break;
+
+            case CMD_STARTCHUNKSTREAM:
+            	startChunkStream(hostCmd);
+            break;
+
             default:
             break;
         }
@@ -1004,7 +2870,7 @@ static void processHostCommand(HostCommand hostCmd)
     }
     else
     {
-        while(1){}; /* CRC error */
+        hostRxError(); /* CRC error */
     }
 }
 
@@ -1054,22 +2920,28 @@ static void uartTaskFxn(UArg uartArg0, UArg uartArg1)
     /* Loop forever */
     while (1) {
     	/* Get command number and length */
-    	UART_read(uart, &hostCmd, HDR_LENGTH);
+    	if (!readHost(&hostCmd, HDR_LENGTH))
+    	{
+    		continue;
+    	}
 
         if (hostCmd.prefix != HDR_PREFIX) /* Not a valid command */
         {
-            UART_write(uart, sa1350Prompt, sizeof(sa1350Prompt));
+            queueHostTx(sa1350Prompt, sizeof(sa1350Prompt));
+
+            /* At a raised rate it is a host sending at another one */
+            if (uartParams.baudRate != UART_DEFAULT_BAUD)
+            {
+            	hostRxError();
+            }
         }
-        else if(hostCmd.length > MAX_PAYLOAD_SIZE) /* Overflow */
+        else if(hostCmd.length > (MAX_PAYLOAD_SIZE - CRC_LENGTH)) /* Overflow */
         {
-        	while(1){}; /* Packet error */
+        	hostRxError(); /* Packet error */
         }
-        else
+        else if (readHost(&hostCmd.payload, hostCmd.length + CRC_LENGTH))
         {
-            /* Read remaining bytes of command and CRC */
-            UART_read(uart, &hostCmd.payload,
-            		hostCmd.length + CRC_LENGTH);
-
+            /* Remaining bytes of command and CRC read */
             processHostCommand(hostCmd);
         }
     }
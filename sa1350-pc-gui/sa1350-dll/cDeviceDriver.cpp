@@ -29,6 +29,7 @@
  * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * --/COPYRIGHT--*/
+#include <string.h>
 #include "cDeviceDriver.h"
 
 using namespace std;
@@ -52,10 +53,12 @@ cDeviceDriver::cDeviceDriver()
     eDecoderExit           = new cEvent(false);
 
     eventFrameReceived     = new cEvent(true);
+    eventFrameAvailable    = new cEvent(false);
     eventFrameErrorCrc     = new cEvent(true);
     eventFrameErrorTimeOut = new cEvent(true);
 
-    FrameFifo              = new list<sFrame>;
+    FrameFifo              = new cFrameQueue(DRV_FRAME_QUEUE_SIZE);
+    rxSequence             = -1;
     ThreadHandle           = new TThread<cDeviceDriver>(*this,&cDeviceDriver::run);
 
     // Check if Objects are created
@@ -103,6 +106,7 @@ cDeviceDriver::~cDeviceDriver()
     delete eventFrameErrorCrc;
     delete eventFrameErrorTimeOut;
     delete eventFrameReceived;
+    delete eventFrameAvailable;
 }
 
 // Public Function Defintion
@@ -113,17 +117,16 @@ bool cDeviceDriver::IsInit(void)
 
 bool cDeviceDriver::Open(std::string strPort)
 {
+    // Clear FrameFifo while the decoder thread is idle
+    if(!eDrvOpen->Check())
+        FrameFifo->Clear();
+
     if(!drvOpen(strPort))
     {
         flagOpen = false;
     }
     else
     {
-        // Clear FrameFifo
-        FrameFifoAccess.Lock();
-        FrameFifo->clear();
-        FrameFifoAccess.Unlock();
-
         eventFrameErrorCrc->Reset();
         eventFrameErrorTimeOut->Reset();
         eventFrameReceived->Reset();
@@ -170,15 +173,49 @@ bool cDeviceDriver::SendFrame(unsigned char Cmd, unsigned char *Data, unsigned s
     return(ok);
 }
 
+bool cDeviceDriver::SetBaudRate(unsigned long BaudRate)
+{
+    bool ok = false;
+    BaudRateType baud;
+
+    switch(BaudRate)
+    {
+    case 115200:
+        baud = B115200;
+        break;
+    case 230400:
+    case 460800:
+    case 921600:
+        baud = (BaudRateType)BaudRate;
+        break;
+    default:
+        return(false);
+    };
+
+    if(Drv && eDrvOpen->Check())
+    {
+        DrvAccess.Lock();
+        if(Drv->ChangeBaudRate(baud))
+        {
+            ok = true;
+        }
+        else
+        {
+            drvSignalError(Drv->GetLastErrorCode(),Drv->GetLastErrorString());
+        };
+        DrvAccess.Unlock();
+    };
+
+    return(ok);
+}
+
 bool cDeviceDriver::IsFrameFifoEmpty(void)
 {
     bool answ = false;
 
     if(Drv)
     {
-        FrameFifoAccess.Lock();
-        answ = FrameFifo->empty();
-        FrameFifoAccess.Unlock();
+        answ = FrameFifo->IsEmpty();
     };
 
     return(answ);
@@ -188,9 +225,7 @@ bool cDeviceDriver::GetFrameFifoSize(unsigned short &Size)
 {
     if(Drv)
     {
-        FrameFifoAccess.Lock();
-        Size = FrameFifo->size();
-        FrameFifoAccess.Unlock();
+        Size = (unsigned short)FrameFifo->Size();
         return(true);
     };
 
@@ -198,23 +233,56 @@ bool cDeviceDriver::GetFrameFifoSize(unsigned short &Size)
 
     return(false);
 }
+
 bool cDeviceDriver::GetFrame(sFrame *Frame)
 {
+    sFrame *front;
+
     if(Drv && Frame!=NULL)
     {
-        FrameFifoAccess.Lock();
-        if(!FrameFifo->empty())
+        front = FrameFifo->Front();
+        if(front)
         {
-            *Frame = FrameFifo->front();
-            FrameFifo->pop_front();
+            *Frame = *front;
+            FrameFifo->Pop();
+            return(true);
         };
-        FrameFifoAccess.Unlock();
-        return(true);
     };
 
     return(false);
 }
 
+sFrame *cDeviceDriver::PeekFrame(void)
+{
+    if(Drv)
+    {
+        return(FrameFifo->Front());
+    };
+
+    return(NULL);
+}
+
+void cDeviceDriver::ReleaseFrame(void)
+{
+    if(Drv && !FrameFifo->IsEmpty())
+    {
+        FrameFifo->Pop();
+    };
+}
+
+bool cDeviceDriver::WaitForFrame(unsigned long ms)
+{
+    if(!Drv)
+        return(false);
+
+    // The event stays set if a frame was pushed after the last check.
+    // If that frame was already taken the queue is empty again, wait on
+    while(FrameFifo->IsEmpty() && eventFrameAvailable->CheckSignal(ms))
+        ;
+
+    return(!FrameFifo->IsEmpty());
+}
+
 bool cDeviceDriver::HasFrameReceived(void)
 {
     return(eventFrameReceived->Check());
@@ -260,24 +328,36 @@ bool cDeviceDriver::drvOpen(std::string strPort)
     return(ok);
 }
 
-bool cDeviceDriver::drvGetData(std::string *rxFifo)
+bool cDeviceDriver::drvGetData(cRingBuffer *rxFifo)
 {
     bool ok = false;
     unsigned long size=0;
+    unsigned long span=0;
+    unsigned char *dst;
 
     DrvAccess.Lock();
     if(Drv->GetRcvBufferSize(size))
     {
-        if(size>0)
+        // Leave what does not fit in the comport buffer until the decoder made room
+        if(size > rxFifo->Free())
+            size = rxFifo->Free();
+        ok = (size>0);
+        while(size>0 && ok)
         {
-            rxFifo->resize(rxFifo->size()+size);
-            if(Drv->ReadData((unsigned char*)(rxFifo->data()),(unsigned short)size))
+            dst = rxFifo->WriteSpan(span);
+            if(span > size)
+                span = size;
+            if(span > 0xFFFF)
+                span = 0xFFFF;
+            if(Drv->ReadData(dst,(unsigned short)span))
             {
-                ok = true;
+                rxFifo->Commit(span);
+                size -= span;
             }
             else
             {
                 drvSignalError(Drv->GetLastErrorCode(),Drv->GetLastErrorString());
+                ok = false;
             };
         };
     };
@@ -308,26 +388,6 @@ bool cDeviceDriver::drvClose(void)
     return(ok);
 }
 
-void cDeviceDriver::Raw2Frame(std::string &Raw, sFrame &Frame)
-{
-    if(Raw.size()<4)
-    {
-        return;
-    };
-    Frame.Cmd      = Raw.at(1);
-    Frame.Length   = Raw.at(2);
-    Frame.Data.clear();
-    if(Frame.Length>0)
-    {
-        Frame.Data.append((Raw.data()+4),Frame.Length);
-        Frame.Crc = (unsigned short)((Raw.at(3+Frame.Length)<<8) + (Raw.at(4+Frame.Length)<<8));
-    }
-    else
-    {
-        Frame.Crc = (unsigned short)((Raw.at(3)<<8) + (Raw.at(4)<<8));
-    };
-}
-
 void cDeviceDriver::Frame2Raw(sFrame &Frame, std::string &Raw)
 {
     Raw.clear();
@@ -335,12 +395,12 @@ void cDeviceDriver::Frame2Raw(sFrame &Frame, std::string &Raw)
     Raw.resize(3);
 
     Raw[0] = 0x2A;
-    Raw[1] = Frame.Length;
+    Raw[1] = (unsigned char)Frame.Length;
     Raw[2] = Frame.Cmd;
 
-    if(Frame.Data.size()>0)
+    if(Frame.Length>0)
     {
-        Raw.append(Frame.Data);
+        Raw.append((const char*)Frame.Data,Frame.Length);
     };
     Raw.resize(Raw.size()+2);
     Frame.Crc = calcCrc16(Raw);
@@ -348,28 +408,13 @@ void cDeviceDriver::Frame2Raw(sFrame &Frame, std::string &Raw)
     Raw[Raw.size()-1] = (unsigned char) (Frame.Crc & 0xff);
 }
 
-void cDeviceDriver::crc16AddByte(unsigned short &crc, unsigned char u8)
-{
-    crc  = (unsigned char)(crc>>8)|(crc<<8);
-    crc ^=  u8;
-    crc ^= (unsigned char)(crc & 0xff)>>4;
-    crc ^= (crc << 8) << 4;
-    crc ^= ((crc & 0xff) << 4)<< 1;
-}
-
 unsigned short cDeviceDriver::calcCrc16(std::string &Raw)
 {
-    int index;
-    int datalength;
-    unsigned short crc = 0x2A;
-
-    datalength = Raw.size()-2;
+    // Marker is the seed, the two Crc bytes at the end are excluded
+    if(Raw.size() < FRAME_CRC_LENGTH+1)
+        return(FRAME_MARKER);
 
-    for(index=1 ; index<datalength; index++)
-    {
-        crc16AddByte(crc,(unsigned char)Raw.at(index));
-    };
-    return(crc);
+    return(crc16Update(FRAME_MARKER,Raw.data()+1,Raw.size()-FRAME_CRC_LENGTH-1));
 }
 
 bool cDeviceDriver::drvSendFrame(sFrame *Frame)
@@ -413,111 +458,143 @@ void cDeviceDriver::drvSignalErrorReset(void)
     eDrvError->Reset();
 }
 
-void cDeviceDriver::FrameDecoderInit(void)
-{
-    DecoderState.Crc       = 0x2A;
-    DecoderState.CrcIndex  = 0;
-    DecoderState.DataIndex = 0;
-    DecoderState.State     = DS_WAITSMARKER;
-    ResetFrame(&DecoderState.Frame);
-}
-
-bool cDeviceDriver::FrameDecoder(std::string *rxFifo)
+bool cDeviceDriver::FrameDecoder(cRingBuffer *rxFifo)
 {
-    bool exit = false;
-    unsigned char u8Data = 0xff;
-
-    while(!rxFifo->empty() && !exit)
+    bool received = false;
+    unsigned long span;
+    unsigned long offset;
+    unsigned long crcEnd;
+    unsigned long frameSize;
+    unsigned long headerSize;
+    unsigned short length;
+    const unsigned char *data;
+    unsigned short crc;
+    unsigned char seq;
+    unsigned char cmd;
+    const unsigned char *marker;
+    sFrame *frame;
+
+    while(rxFifo->Size() >= (FRAME_HEADER_LENGTH+FRAME_CRC_LENGTH))
     {
-        u8Data = (char) rxFifo->at(0);
-        rxFifo->erase(rxFifo->begin());
-        switch(DecoderState.State)
+        // Skip everything in front of the next frame marker of either version
+        data = rxFifo->ReadSpan(0,span);
+        if(data[0] != FRAME_MARKER && data[0] != FRAME_V2_MARKER)
         {
-        case DS_WAITSMARKER:
-            if(u8Data==0x2A)
-            {
-                DecoderState.Crc = 0x2A;
-                DecoderState.CrcIndex = 0;
-                DecoderState.DataIndex = 0;
-                ResetFrame(&DecoderState.Frame);
-                DecoderState.State = DS_WAITLENGTH;
-            };
-            break;
-        case DS_WAITLENGTH:
-            DecoderState.Frame.Length = u8Data;
-            crc16AddByte(DecoderState.Crc,u8Data);
-            DecoderState.State = DS_WAITCMD;
-            break;
-        case DS_WAITCMD:
-            DecoderState.Frame.Cmd = u8Data;
-            crc16AddByte(DecoderState.Crc,u8Data);
-            if(DecoderState.Frame.Length > 0)
-                DecoderState.State = DS_WAITDATA;
-            else
-                DecoderState.State = DS_CRC_HIGH;
-            break;
-        case DS_WAITDATA:
-            DecoderState.Frame.Data.push_back(u8Data);
-            crc16AddByte(DecoderState.Crc,u8Data);
-            DecoderState.DataIndex++;
-            if(DecoderState.DataIndex == DecoderState.Frame.Length)
-            {
-                DecoderState.State = DS_CRC_HIGH;
-            };
+            offset = span;
+            marker = (const unsigned char*)memchr(data, FRAME_MARKER, span);
+            if(marker)
+                offset = (unsigned long)(marker-data);
+            marker = (const unsigned char*)memchr(data, FRAME_V2_MARKER, offset);
+            if(marker)
+                offset = (unsigned long)(marker-data);
+            rxFifo->Consume(offset);
+            continue;
+        };
+
+        if(data[0] == FRAME_V2_MARKER)
+        {// Version 2 frames carry a 16-bit length
+            if(rxFifo->Size() < FRAME_V2_HEADER_LENGTH)
+                break;
+            headerSize = FRAME_V2_HEADER_LENGTH;
+            length     = (unsigned short)((rxFifo->Peek(1)<<8) | rxFifo->Peek(2));
+            cmd        = rxFifo->Peek(3);
+        }
+        else
+        {
+            headerSize = FRAME_HEADER_LENGTH;
+            length     = rxFifo->Peek(1);
+            cmd        = rxFifo->Peek(2);
+        };
+        if(cmd > FRAME_CMD_MAX || length > FRAME_DATA_SIZE)
+        {// Not a frame, resync on the next marker
+            rxFifo->Consume(1);
+            continue;
+        };
+
+        // Wait for the rest of the frame
+        frameSize = headerSize + length + FRAME_CRC_LENGTH;
+        if(rxFifo->Size() < frameSize)
             break;
-        case DS_CRC_HIGH:
-            DecoderState.Frame.Crc = (unsigned short)(u8Data<<8);
-            DecoderState.State = DS_CRC_LOW;
+
+        // Leave the frame in the ring buffer until the consumer made room
+        frame = FrameFifo->Alloc();
+        if(!frame)
             break;
-        case DS_CRC_LOW:
-            DecoderState.Frame.Length = DecoderState.Frame.Data.size();
-            DecoderState.Frame.Crc += (unsigned short)(u8Data);
-            DecoderState.State = DS_WAITSMARKER;
-            if(DecoderState.Frame.Crc == DecoderState.Crc)
-            {
-                FrameFifoAccess.Lock();
-                FrameFifo->push_back(DecoderState.Frame);
-                eventFrameReceived->Signal();
-                FrameFifoAccess.Unlock();
+
+        // Crc over length, cmd and payload, straight out of the ring buffer
+        crc    = FRAME_MARKER;
+        crcEnd = frameSize-FRAME_CRC_LENGTH;
+        for(offset=1; offset<crcEnd; offset+=span)
+        {
+            data = rxFifo->ReadSpan(offset,span);
+            if(span > crcEnd-offset)
+                span = crcEnd-offset;
+            crc = crc16Update(crc,data,span);
+        };
+
+        // Build the frame directly in the queue slot
+        frame->Crc = (unsigned short)((rxFifo->Peek(crcEnd)<<8) | rxFifo->Peek(crcEnd+1));
+        if(frame->Crc == crc)
+        {
+            frame->Length = length;
+            if(headerSize == FRAME_V2_HEADER_LENGTH)
+            {// A gap in the sequence numbers shows lost or corrupted frames
+                frame->Cmd     = cmd;
+                seq            = rxFifo->Peek(4);
+                frame->SweepId = (unsigned short)((rxFifo->Peek(5)<<8) | rxFifo->Peek(6));
+                frame->Lost    = (rxSequence < 0) ? 0 : (unsigned char)(seq - rxSequence);
+                rxSequence     = (unsigned char)(seq + 1);
             }
             else
             {
-                eventFrameErrorCrc->Signal();
+                frame->Cmd     = cmd;
+                frame->SweepId = 0;
+                frame->Lost    = 0;
             };
-            break;
-        default:
-            break;
+            rxFifo->Copy(headerSize,frame->Data,frame->Length);
+            FrameFifo->Push();
+            received = true;
+            rxFifo->Consume(frameSize);
+        }
+        else
+        {// The marker may belong to no frame, resync on the next one
+            eventFrameErrorCrc->Signal();
+            rxFifo->Consume(1);
         };
     };
 
-    return(false);
-}
+    if(received)
+    {
+        eventFrameReceived->Signal();
+        eventFrameAvailable->Signal();
+    };
 
-void cDeviceDriver::ResetFrame(sFrame *Frame)
-{
-    Frame->Cmd    = 0;
-    Frame->Length = 0;
-    Frame->Data.clear();
-    Frame->Crc    = 0;
+    return(received);
 }
 
 void cDeviceDriver::MakeFrame(sFrame *Frame, unsigned char Cmd, unsigned char *Data, unsigned short Length)
 {
-    Frame->Cmd  = Cmd;
-    Frame->Data.clear();
-    Frame->Length = (unsigned char) Length;
+    // Commands to the device always use version 1 frames
+    if(Length > FRAME_V1_DATA_SIZE)
+        Length = FRAME_V1_DATA_SIZE;
+
+    Frame->Cmd    = Cmd;
+    Frame->Length = Length;
     if(Data && Length>0)
     {
-        Frame->Data.append((const char*)Data, (int)Length);
+        memcpy(Frame->Data,Data,Length);
+    }
+    else
+    {
+        Frame->Length = 0;
     };
 }
 
 void cDeviceDriver::run(void)
 {
     DriverState State;
-    std::string RxFifo;
-
-    RxFifo.clear();
+    cRingBuffer RxFifo(DRV_RX_BUFFER_SIZE);
+    bool newData;
 
     State = DRV_INIT;
 
@@ -528,18 +605,21 @@ void cDeviceDriver::run(void)
         case DRV_INIT:
             if(this->eDrvOpen->CheckSignal(20))
             {
-                RxFifo.clear();
-                FrameDecoderInit();
+                RxFifo.Clear();
+                rxSequence = -1;
                 State = DRV_RUN;
             };
             break;
         case DRV_RUN:
-            if(!this->drvGetData(&RxFifo) && RxFifo.empty())
+            // Block on the comport only if neither new data arrived nor a buffered frame could be queued
+            newData = this->drvGetData(&RxFifo);
+            if(!FrameDecoder(&RxFifo) && !newData)
             {
-                Sleep(1);
-                break;
+                if(DRV_RX_WAIT_MS && FrameFifo->Alloc())
+                    Drv->WaitForData(DRV_RX_WAIT_MS);
+                else
+                    Sleep(1);
             };
-            FrameDecoder(&RxFifo);
             break;
         case DRV_STOP:
             Sleep(10);
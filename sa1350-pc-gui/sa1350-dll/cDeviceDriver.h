@@ -37,22 +37,24 @@ using namespace std;
 #include "cDriver.h"
 #include "cMutex.h"
 #include "cThread.h"
+#include "cRingBuffer.h"
+#include "cFrameQueue.h"
 #include "sa1350TypeDef.h"
-
-/*!
- \brief Frame Decoder States
-
- \enum DecoderState
-*/
-enum DecoderState
-{
-    DS_WAITSMARKER = 0, /*!< Add in-line comment */
-    DS_WAITLENGTH,      /*!< Add in-line comment */
-    DS_WAITCMD,         /*!< Add in-line comment */
-    DS_WAITDATA,        /*!< Add in-line comment */
-    DS_CRC_HIGH,        /*!< Add in-line comment */
-    DS_CRC_LOW,         /*!< Add in-line comment */
-};
+#include "sa1350Cmd.h"
+#include "crc16.h"
+
+#define FRAME_MARKER        0x2A    /*!< Start of frame marker */
+#define FRAME_HEADER_LENGTH 3       /*!< Marker, length and command byte */
+#define FRAME_V1_DATA_SIZE  255     /*!< Payload limit of the one byte length, all frames to the device */
+#define FRAME_V2_MARKER     0x2B    /*!< Start of a version 2 frame, see CMD_SETFRAMING */
+#define FRAME_V2_HEADER_LENGTH 7    /*!< Marker, length (u16 BE), command, sequence number and sweep id (u16 BE) */
+#define FRAME_CRC_LENGTH    2       /*!< Crc high and low byte */
+#define FRAME_CMD_MAX       (CMD_END - 1) /*!< Highest command of SA1350Cmd. A marker followed by a higher command byte starts no frame */
+#define DRV_RX_BUFFER_SIZE  0x10000 /*!< Receiver ring buffer size in bytes */
+#define DRV_FRAME_QUEUE_SIZE 256    /*!< Number of decoded frame slots */
+#ifndef DRV_RX_WAIT_MS
+#define DRV_RX_WAIT_MS      20      /*!< Longest blocking comport wait before the thread checks its state events, 0 polls the comport every 1 ms */
+#endif
 
 /*!
  \brief Comport driver thread States
@@ -67,25 +69,6 @@ enum DriverState
     DRV_EXIT,   /*!< Add in-line comment */
 };
 
-/*!
- \brief TODO Add brief
-
- \typedef struct _sFrameDecoderState sFrameDecoderState
-*/
-/*!
- \brief Decoder Frame Format
-
- \struct _sFrameDecoderState cDeviceDriver.h "cDeviceDriver.h"
-*/
-typedef struct _sFrameDecoderState
-{
-    DecoderState  State; /*!< Add in-line comment */
-    unsigned short DataIndex; /*!< Add in-line comment */
-    unsigned short CrcIndex; /*!< Add in-line comment */
-    unsigned short Crc; /*!< Add in-line comment */
-    sFrame        Frame; /*!< Add in-line comment */
-}sFrameDecoderState;
-
 /*!
  \brief SA1350 Driver Class
 
@@ -93,6 +76,8 @@ typedef struct _sFrameDecoderState
 */
 class cDeviceDriver
 {
+    friend class cDeviceDriverTest; /*!< Host tests feed the frame decoder directly */
+
 public:
     /*!
      \brief Constructor
@@ -144,6 +129,12 @@ public:
      \param size Add param
     */
     bool SendFrame(unsigned char Cmd, unsigned char *Data, unsigned short size);
+    /*!
+     \brief Switch the comport to another baudrate after the sent frames have left
+
+     \param BaudRate 115200, 230400, 460800 or 921600 bit/s
+    */
+    bool SetBaudRate(unsigned long BaudRate);
     /*!
      \brief Checks if the receiver frame buffer is empty
 
@@ -161,6 +152,23 @@ public:
      \param Frame Add param
     */
     bool GetFrame(sFrame *Frame);
+    /*!
+     \brief Return the first received frame in place without copying, NULL if the Fifo is empty
+
+       The frame stays valid until ReleaseFrame is called. Only one thread may consume frames.
+    */
+    sFrame *PeekFrame(void);
+    /*!
+     \brief Delete the frame returned by PeekFrame from the Fifo
+
+    */
+    void ReleaseFrame(void);
+    /*!
+     \brief Block until a frame is available or the timeout elapsed
+
+     \param ms Timeout in milliseconds
+    */
+    bool WaitForFrame(unsigned long ms);
     /*!
      \brief Check if in the  meantime framed from the SA1350 device are received
 
@@ -197,13 +205,6 @@ private:
      \param Length Add param
     */
     void MakeFrame(sFrame *Frame, unsigned char Cmd, unsigned char *Data, unsigned short Length);
-    /*!
-     \brief Converts byte stream to a SA1350 frame
-
-     \param Raw Add param
-     \param Frame Add param
-    */
-    void Raw2Frame(std::string &Raw, sFrame &Frame);
     /*!
      \brief Converts a SA1350 frame to a raw byte stream
 
@@ -218,13 +219,6 @@ private:
      \param Raw Add param
     */
     unsigned short calcCrc16(std::string &Raw);
-    /*!
-     \brief Add byte to the 16 bit Crc summ
-
-     \param crc Add param
-     \param u8 Add param
-    */
-    void crc16AddByte(unsigned short &crc, unsigned char u8);
 
     //Driver Variables and Functions
     cMutex  DrvAccess;  /*!< Driver Mutex Lock */
@@ -251,11 +245,11 @@ private:
     */
     bool drvSendFrame(sFrame *Frame);
     /*!
-     \brief Read complete comport rx buffer and copy to std string buffer
+     \brief Read complete comport rx buffer directly into the free space of the ring buffer
 
      \param rxFifo Add param
     */
-    bool drvGetData(std::string *rxFifo);
+    bool drvGetData(cRingBuffer *rxFifo);
     /*!
      \brief Signals an error from the comport thread to upper class level
 
@@ -281,48 +275,30 @@ private:
 
     // FrameDecoder Variables and Functions
     cEvent  *eventFrameReceived; /*!< Add in-line comment */
+    cEvent  *eventFrameAvailable; /*!< Auto reset, wakes WaitForFrame */
     cEvent  *eventFrameErrorCrc; /*!< Add in-line comment */
     cEvent  *eventFrameErrorTimeOut; /*!< Add in-line comment */
 
-    sFrameDecoderState DecoderState; /*!< Add in-line comment */
-
-    /*!
-     \brief Init SA1350 Frame Decoder
-
-    */
-    void FrameDecoderInit(void);
-
     // Frame Variables and Functions
-    cMutex  FrameFifoAccess; /*!< Add in-line comment */
-    list<sFrame> *FrameFifo; /*!< Add in-line comment */
+    cFrameQueue *FrameFifo; /*!< Decoder to consumer frame queue */
+    int          rxSequence; /*!< Expected sequence number of the next version 2 frame, -1 after the decoder restarted */
 
     /*!
-     \brief
+     \brief Decode all complete frames stored in the ring buffer
 
-    */
-    int  FrameReceived(void);
-    /*!
-     \brief Push frame to the Fifo
+     Scans for the frame marker of either version, waits until the whole
+     frame is buffered and checks the Crc in place. Incomplete frames stay in
+     the buffer, as do complete ones while the frame queue is full. Gaps in
+     the version 2 sequence numbers are counted in sFrame::Lost.
 
-     \param Frame Add param
-    */
-    bool FramePush(sFrame *Frame);
-    /*!
-     \brief Pop Frame from the Fifo
-
-     \param Frame Add param
-    */
-    bool FramePop(sFrame *Frame);
-    /*!
-     \brief Decode input stream data
+     A marker byte inside a payload or a corrupted header looks like the
+     start of a frame. A header with an unknown command or a version 2
+     length above FRAME_DATA_SIZE, and a Crc mismatch, only drop the marker
+     and the scan goes on with the next byte, so the real frames buffered
+     behind it are not lost. A false length that passes the checks delays
+     those frames until that many bytes have arrived.
 
      \param rxFifo Add param
     */
-    bool FrameDecoder(std::string *rxFifo);
-    /*!
-     \brief Reset frame content to initial values
-
-     \param Frame Add param
-    */
-    void ResetFrame(sFrame *Frame);
+    bool FrameDecoder(cRingBuffer *rxFifo);
 };
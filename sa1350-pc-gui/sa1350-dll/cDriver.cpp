@@ -29,6 +29,7 @@
  * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
  * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * --/COPYRIGHT--*/
+#include <string.h>
 #include "cDriver.h"
 
 using namespace std;
@@ -38,6 +39,15 @@ cDriver::cDriver()
     eErrorSignal = new cEvent(true);
     SignalErrorReset();
     hPort = INVALID_HANDLE_VALUE;
+
+    memset(&ovRead,0,sizeof(OVERLAPPED));
+    memset(&ovWrite,0,sizeof(OVERLAPPED));
+    memset(&ovWait,0,sizeof(OVERLAPPED));
+    ovRead.hEvent  = CreateEvent(NULL,TRUE,FALSE,NULL);
+    ovWrite.hEvent = CreateEvent(NULL,TRUE,FALSE,NULL);
+    ovWait.hEvent  = CreateEvent(NULL,TRUE,FALSE,NULL);
+    waitMask       = 0;
+    waitPending    = false;
 }
 
 cDriver::~cDriver()
@@ -45,6 +55,9 @@ cDriver::~cDriver()
     Close();
     delete  eErrorSignal;
     hPort = INVALID_HANDLE_VALUE;
+    CloseHandle(ovRead.hEvent);
+    CloseHandle(ovWrite.hEvent);
+    CloseHandle(ovWait.hEvent);
 }
 
 bool cDriver::Open(std::string strPort, BaudRateType Baud, DataBitsType Bits, ParityType Parity, StopBitsType Stopbits, FlowType FlowCtrl)
@@ -57,7 +70,7 @@ bool cDriver::Open(std::string strPort, BaudRateType Baud, DataBitsType Bits, Pa
 
     SignalErrorReset();
 
-    hPort=CreateFile(strPort.c_str(), GENERIC_READ|GENERIC_WRITE,0, NULL, OPEN_EXISTING, 0, NULL);
+    hPort=CreateFile(strPort.c_str(), GENERIC_READ|GENERIC_WRITE,0, NULL, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, NULL);
     if(hPort==INVALID_HANDLE_VALUE)
     {
         SignalError(GetLastError(),"Driver: Could not open com port");
@@ -87,6 +100,13 @@ bool cDriver::Open(std::string strPort, BaudRateType Baud, DataBitsType Bits, Pa
         SignalError(GetLastError(),"Driver: Could not setup com port");
         return(false);
     };
+    // Wake WaitForData on every received character
+    waitPending = false;
+    if(!SetCommMask(hPort, EV_RXCHAR))
+    {
+        SignalError(GetLastError(),"Driver: Could not set comm mask");
+        return(false);
+    };
 
     return(true);
 }
@@ -95,8 +115,11 @@ bool cDriver::Close(void)
 {
     if(hPort != INVALID_HANDLE_VALUE)
     {
+        // Completes a pending WaitCommEvent
+        SetCommMask(hPort, 0);
         CloseHandle(hPort);
         hPort = INVALID_HANDLE_VALUE;
+        waitPending = false;
     };
     return(true);
 }
@@ -185,10 +208,14 @@ bool cDriver::WriteData(unsigned char *Data, unsigned short size)
 {
     DWORD retVal = 0;
 
-    if(!WriteFile(hPort, (void*)Data, (DWORD)size, &retVal, NULL))
+    ResetEvent(ovWrite.hEvent);
+    if(!WriteFile(hPort, (void*)Data, (DWORD)size, &retVal, &ovWrite))
     {
-        SignalError(GetLastError(),"Driver: Write Data Error");
-        return(false);
+        if(GetLastError()!=ERROR_IO_PENDING || !GetOverlappedResult(hPort, &ovWrite, &retVal, TRUE))
+        {
+            SignalError(GetLastError(),"Driver: Write Data Error");
+            return(false);
+        };
     };
 
     return(true);
@@ -198,11 +225,65 @@ bool cDriver::ReadData(unsigned char *Data, unsigned short size)
 {
     DWORD retVal = 0;
 
-    if(!ReadFile(hPort, (void*)Data, (DWORD)size, &retVal,NULL))
+    ResetEvent(ovRead.hEvent);
+    if(!ReadFile(hPort, (void*)Data, (DWORD)size, &retVal, &ovRead))
+    {
+        if(GetLastError()!=ERROR_IO_PENDING || !GetOverlappedResult(hPort, &ovRead, &retVal, TRUE))
+        {
+            SignalError(GetLastError(),"Driver: Read Data Error");
+            return(false);
+        };
+    };
+
+    return(true);
+}
+
+bool cDriver::WaitForData(unsigned long ms)
+{
+    DWORD         retVal = 0;
+    unsigned long size   = 0;
+
+    if(!isOpen())
+        return(false);
+
+    if(!waitPending)
+    {
+        waitMask = 0;
+        ResetEvent(ovWait.hEvent);
+        if(WaitCommEvent(hPort, &waitMask, &ovWait))
+            return(true);
+        if(GetLastError()!=ERROR_IO_PENDING)
+        {
+            SignalError(GetLastError(),"Driver: WaitCommEvent Error");
+            return(false);
+        };
+        waitPending = true;
+        // Characters received before the wait was armed do not raise EV_RXCHAR
+        if(GetRcvBufferSize(size) && size>0)
+            return(true);
+    };
+
+    if(WaitForSingleObject(ovWait.hEvent, ms)!=WAIT_OBJECT_0)
+        return(false);
+
+    waitPending = false;
+    GetOverlappedResult(hPort, &ovWait, &retVal, FALSE);
+
+    return(true);
+}
+
+bool cDriver::ChangeBaudRate(BaudRateType Baud)
+{
+    if(!isOpen())
+        return(false);
+
+    // Bytes still in the UART would go out at the new rate
+    if(!FlushFileBuffers(hPort))
     {
-        SignalError(GetLastError(),"Driver: Read Data Error");
+        SignalError(GetLastError(),"Driver: Could not drain com port");
         return(false);
     };
+    setBaudRate(Baud);
 
     return(true);
 }
@@ -434,6 +515,7 @@ void cDriver::setBaudRate(BaudRateType baudRate)
             PortSetting.BaudRate=B926100;
             break;
         default:
+            PortSetting.BaudRate=baudRate;
             break;
         };
     };
@@ -67,6 +67,9 @@ using namespace std;
 /*!
  \brief Valid Baudrate Values
 
+   The names clash with the termios.h speed macros, the POSIX backend
+   includes termios.h only after this header.
+
  \enum BaudRateType
 */
 enum BaudRateType
@@ -93,6 +96,9 @@ enum BaudRateType
     B115200,       /*!< Add in-line comment */
     B128000,       /*!< Add in-line comment */ //WINDOWS ONLY
     B256000,       /*!< Add in-line comment */ //WINDOWS ONLY
+    B230400=230400,/*!< Value is the bit rate, like the rates below */
+    B460800=460800,/*!< Add in-line comment */
+    B921600=921600,/*!< Add in-line comment */
     B926100=926100 /*!< Add in-line comment */
 };
 
@@ -287,6 +293,20 @@ public:
      \return bool
     */
     bool ReadData(unsigned char *Data, unsigned short size);
+    /*!
+     \brief Block until the comport has received data or the timeout elapsed
+
+     \param ms Timeout in milliseconds
+     \return bool true: data is waiting in the receive buffer
+    */
+    bool WaitForData(unsigned long ms);
+    /*!
+     \brief Switch the baudrate of the open comport once all written data has left
+
+     \param Baud New baudrate
+     \return bool
+    */
+    bool ChangeBaudRate(BaudRateType Baud);
     /*!
     \brief Reset comport driver
 
@@ -295,10 +315,19 @@ public:
     bool Reset(void);
 
 private:
-    HANDLE hPort;              /*!< Add in-line comment */
     sPortSetting PortSetting;  /*!< Add in-line comment */
+#ifdef _WIN32
+    HANDLE hPort;              /*!< Add in-line comment */
     COMMCONFIG   PortConfig;   /*!< Add in-line comment */
     COMMTIMEOUTS PortTimeouts; /*!< Add in-line comment */
+    OVERLAPPED   ovRead;       /*!< Overlapped read request */
+    OVERLAPPED   ovWrite;      /*!< Overlapped write request */
+    OVERLAPPED   ovWait;       /*!< Overlapped WaitCommEvent request */
+    DWORD        waitMask;     /*!< Comm events reported by ovWait */
+    volatile bool waitPending; /*!< ovWait is armed */
+#else
+    int          hPort;        /*!< tty file descriptor, -1 when closed */
+#endif
 
     sError      Error;         /*!< Add in-line comment */
     std::string rxFifo;        /*!< Add in-line comment */
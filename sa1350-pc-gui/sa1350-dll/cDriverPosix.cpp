@@ -0,0 +1,573 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include <string.h>
+#include "cDriver.h"
+
+using namespace std;
+
+/*!
+ \brief Returns the bit rate of a BaudRateType value
+
+   Defined before termios.h is included, which redefines the B* names.
+
+ \param baudRate Add param
+ \return unsigned long
+*/
+static unsigned long baudRateValue(BaudRateType baudRate)
+{
+    switch(baudRate)
+    {
+    case B50:     return(50);
+    case B75:     return(75);
+    case B110:    return(110);
+    case B134:    return(134);
+    case B150:    return(150);
+    case B200:    return(200);
+    case B300:    return(300);
+    case B600:    return(600);
+    case B1200:   return(1200);
+    case B1800:   return(1800);
+    case B2400:   return(2400);
+    case B4800:   return(4800);
+    case B9600:   return(9600);
+    case B14400:  return(14400);
+    case B19200:  return(19200);
+    case B38400:  return(38400);
+    case B56000:  return(56000);
+    case B57600:  return(57600);
+    case B76800:  return(76800);
+    case B115200: return(115200);
+    case B128000: return(128000);
+    case B256000: return(256000);
+    default:      return((unsigned long)baudRate);
+    };
+}
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/ioctl.h>
+
+/*!
+ \brief termios speed table, ascending
+*/
+static const struct
+{
+    unsigned long Bps;   /*!< Bit rate */
+    speed_t       Speed; /*!< termios speed value */
+} SpeedTable[] =
+{
+    {50,B50},{75,B75},{110,B110},{134,B134},{150,B150},{200,B200},{300,B300},
+    {600,B600},{1200,B1200},{1800,B1800},{2400,B2400},{4800,B4800},{9600,B9600},
+    {19200,B19200},{38400,B38400},{57600,B57600},{115200,B115200},
+#ifdef B230400
+    {230400,B230400},
+#endif
+#ifdef B460800
+    {460800,B460800},
+#endif
+#ifdef B921600
+    {921600,B921600},
+#endif
+};
+
+cDriver::cDriver()
+{
+    eErrorSignal = new cEvent(true);
+    SignalErrorReset();
+    hPort = -1;
+}
+
+cDriver::~cDriver()
+{
+    Close();
+    delete  eErrorSignal;
+    hPort = -1;
+}
+
+bool cDriver::Open(std::string strPort, BaudRateType Baud, DataBitsType Bits, ParityType Parity, StopBitsType Stopbits, FlowType FlowCtrl)
+{
+    struct termios tio;
+
+    if(strPort.find('/')!=0)
+        strPort = "/dev/" + strPort;
+
+    Close();
+
+    SignalErrorReset();
+
+    hPort = open(strPort.c_str(), O_RDWR|O_NOCTTY|O_NONBLOCK);
+    if(hPort<0)
+    {
+        hPort = -1;
+        SignalError(errno,"Driver: Could not open com port");
+        return(false);
+    };
+    if(tcgetattr(hPort, &tio)!=0)
+    {
+        SignalError(errno,"Driver: Could not setup com port");
+        return(false);
+    };
+    // Raw binary mode, reads never block, WaitForData does the blocking
+    cfmakeraw(&tio);
+    tio.c_cflag |= (CLOCAL|CREAD);
+    tio.c_cc[VMIN]  = 0;
+    tio.c_cc[VTIME] = 0;
+    if(tcsetattr(hPort, TCSANOW, &tio)!=0)
+    {
+        SignalError(errno,"Driver: Could not setup com port");
+        return(false);
+    };
+    Flush();
+
+    // Force every setter to apply its value
+    PortSetting.BaudRate    = (BaudRateType)-1;
+    PortSetting.DataBits    = (DataBitsType)-1;
+    PortSetting.Parity      = (ParityType)-1;
+    PortSetting.StopBits    = (StopBitsType)-1;
+    PortSetting.FlowControl = (FlowType)-1;
+    setBaudRate(Baud);
+    setDataBits(Bits);
+    setStopBits(Stopbits);
+    setParity(Parity);
+    setFlowControl(FlowCtrl);
+    setTimeout(1000);
+
+    return(isOpen());
+}
+
+bool cDriver::Close(void)
+{
+    if(hPort != -1)
+    {
+        close(hPort);
+        hPort = -1;
+    };
+    return(true);
+}
+
+bool cDriver::Flush(void)
+{
+    bool ok = false;
+
+    if(isOpen())
+    {
+        if(tcflush(hPort, TCIOFLUSH)!=0)
+        {
+            SignalError(errno,"Driver: tcflush");
+        }
+        else
+        {
+            ok = true;
+        };
+    };
+    return(ok);
+}
+
+bool cDriver::GetRcvBufferSize(unsigned long &Size)
+{
+    int count = 0;
+
+    if(isOpen())
+    {
+        if(ioctl(hPort, FIONREAD, &count)==0)
+        {
+            Size = (unsigned long)count;
+            return(true);
+        }
+        else
+        {
+            SignalError(errno,"Driver: FIONREAD");
+        };
+    };
+    Size = 0;
+    return(false);
+}
+
+int cDriver::SetDtr(bool state)
+{
+    int ok = 0;
+    int bits = TIOCM_DTR;
+
+    if(isOpen())
+        ok = (ioctl(hPort, state ? TIOCMBIS : TIOCMBIC, &bits)==0);
+
+    return(ok);
+}
+
+int cDriver::SetRts(bool state)
+{
+    int ok = 0;
+    int bits = TIOCM_RTS;
+
+    if(isOpen())
+        ok = (ioctl(hPort, state ? TIOCMBIS : TIOCMBIC, &bits)==0);
+
+    return(ok);
+}
+
+bool cDriver::GetCts(void)
+{
+    int bits = 0;
+
+    if(isOpen() && ioctl(hPort, TIOCMGET, &bits)==0)
+        return((bits & TIOCM_CTS)!=0);
+
+    return(false);
+}
+
+bool cDriver::WriteData(unsigned char *Data, unsigned short size)
+{
+    ssize_t        retVal = 0;
+    struct pollfd  pfd;
+
+    pfd.fd     = hPort;
+    pfd.events = POLLOUT;
+    while(size)
+    {
+        retVal = write(hPort, (void*)Data, size);
+        if(retVal>0)
+        {
+            Data += retVal;
+            size -= (unsigned short)retVal;
+        }
+        else if(retVal<0 && errno!=EAGAIN && errno!=EINTR)
+        {
+            SignalError(errno,"Driver: Write Data Error");
+            return(false);
+        }
+        else if(poll(&pfd, 1, PortSetting.TimeoutMs<0 ? 0 : (int)PortSetting.TimeoutMs)==0)
+        {
+            SignalError(E_PORT_TIMEOUT,"Driver: Write Data Timeout");
+            return(false);
+        };
+    };
+
+    return(true);
+}
+
+bool cDriver::ReadData(unsigned char *Data, unsigned short size)
+{
+    ssize_t        retVal = 0;
+    struct pollfd  pfd;
+
+    pfd.fd     = hPort;
+    pfd.events = POLLIN;
+    while(size)
+    {
+        retVal = read(hPort, (void*)Data, size);
+        if(retVal>0)
+        {
+            Data += retVal;
+            size -= (unsigned short)retVal;
+        }
+        else if(retVal<0 && errno!=EAGAIN && errno!=EINTR)
+        {
+            SignalError(errno,"Driver: Read Data Error");
+            return(false);
+        }
+        else if(retVal==0 && poll(&pfd, 1, 0)>0 && (pfd.revents & POLLHUP))
+        {
+            // tty has gone away
+            SignalError(E_INVALID_DEVICE,"Driver: Read Data Error");
+            return(false);
+        }
+        else if(poll(&pfd, 1, PortSetting.TimeoutMs<0 ? 0 : (int)PortSetting.TimeoutMs)==0)
+        {
+            // Same as a Win32 read timeout, the bytes read so far are kept
+            break;
+        };
+    };
+
+    return(true);
+}
+
+bool cDriver::WaitForData(unsigned long ms)
+{
+    struct pollfd pfd;
+    int           ret;
+
+    if(!isOpen())
+        return(false);
+
+    pfd.fd      = hPort;
+    pfd.events  = POLLIN;
+    pfd.revents = 0;
+    ret = poll(&pfd, 1, (int)ms);
+    if(ret<0)
+    {
+        if(errno!=EINTR)
+            SignalError(errno,"Driver: poll Error");
+        return(false);
+    };
+    if(ret>0 && (pfd.revents & (POLLERR|POLLNVAL|POLLHUP)) && !(pfd.revents & POLLIN))
+    {
+        SignalError(E_INVALID_DEVICE,"Driver: Device removed");
+        return(false);
+    };
+
+    return(ret>0);
+}
+
+bool cDriver::ChangeBaudRate(BaudRateType Baud)
+{
+    if(!isOpen())
+        return(false);
+
+    // Bytes still in the UART would go out at the new rate
+    if(tcdrain(hPort)!=0 && errno!=EINTR)
+    {
+        SignalError(errno,"Driver: Could not drain com port");
+        return(false);
+    };
+    setBaudRate(Baud);
+
+    return(true);
+}
+
+bool cDriver::Reset(void)
+{
+
+    return(false);
+}
+
+bool cDriver::IsOk(void)
+{
+    return(!eErrorSignal->Check());
+}
+
+int cDriver::GetLastErrorCode(void)
+{
+    return(Error.Code);
+}
+
+std::string cDriver::GetLastErrorString(void)
+{
+    if(Error.Code)
+    {
+        return(Error.Msg);
+    };
+    return("DevDriver: No Error");
+}
+
+// Private Function Definition
+
+void cDriver::SignalError(int Code, std::string Msg)
+{
+    Error.Code = Code;
+    Error.Msg  = Msg;
+    eErrorSignal->Signal();
+    Close();
+}
+
+void cDriver::SignalErrorReset(void)
+{
+    Error.Code = E_NO_ERROR;
+    Error.Msg  = "No Error";
+    eErrorSignal->Reset();
+}
+
+bool cDriver::isOpen(void)
+{
+    if(hPort!=-1)
+        return(true);
+    return(false);
+}
+
+/*!
+ \brief Read-modify-write the termios settings of an open port
+
+ \param fd Add param
+ \param clearFlags c_cflag bits to clear
+ \param setFlags c_cflag bits to set
+ \return bool
+*/
+static bool updateCFlags(int fd, tcflag_t clearFlags, tcflag_t setFlags)
+{
+    struct termios tio;
+
+    if(tcgetattr(fd, &tio)!=0)
+        return(false);
+    tio.c_cflag = (tio.c_cflag & ~clearFlags) | setFlags;
+    return(tcsetattr(fd, TCSANOW, &tio)==0);
+}
+
+void cDriver::setFlowControl(FlowType flow)
+{
+    struct termios tio;
+
+    if(PortSetting.FlowControl== flow)
+        return;
+
+    PortSetting.FlowControl=flow;
+
+    if(isOpen() && tcgetattr(hPort, &tio)==0)
+    {
+        switch(flow)
+        {
+        /*No Flow Control*/
+        case FLOW_OFF:
+            tio.c_cflag &= ~CRTSCTS;
+            tio.c_iflag &= ~(IXON|IXOFF|IXANY);
+            break;
+            /*Software (XON/XOFF) Flow Control*/
+        case FLOW_XONXOFF:
+            tio.c_cflag &= ~CRTSCTS;
+            tio.c_iflag |= (IXON|IXOFF);
+            break;
+            /*Hardwarwe Flow Control*/
+        case FLOW_HARDWARE:
+            tio.c_cflag |= CRTSCTS;
+            tio.c_iflag &= ~(IXON|IXOFF|IXANY);
+            break;
+        };
+        tcsetattr(hPort, TCSANOW, &tio);
+    };
+}
+
+void cDriver::setParity(ParityType parity)
+{
+    if(PortSetting.Parity == parity)
+        return;
+
+    PortSetting.Parity = parity;
+    if(isOpen())
+    {
+        switch(parity)
+        {
+        /*space parity, as in termios without CMSPAR: no parity bit*/
+        case PAR_SPACE:
+        case PAR_NONE:
+            updateCFlags(hPort, PARENB|PARODD, 0);
+            break;
+            /*mark parity - WINDOWS ONLY*/
+        case PAR_MARK:
+            break;
+            /*even parity*/
+        case PAR_EVEN:
+            updateCFlags(hPort, PARODD, PARENB);
+            break;
+            /*odd parity*/
+        case PAR_ODD:
+            updateCFlags(hPort, 0, PARENB|PARODD);
+            break;
+        };
+    };
+}
+
+void cDriver::setDataBits(DataBitsType dataBits)
+{
+    if(PortSetting.DataBits==dataBits)
+        return;
+
+    PortSetting.DataBits=dataBits;
+    if(isOpen())
+    {
+        switch(dataBits)
+        {
+        /*5 data bits*/
+        case DAT_5:
+            updateCFlags(hPort, CSIZE, CS5);
+            break;
+            /*6 data bits*/
+        case DAT_6:
+            updateCFlags(hPort, CSIZE, CS6);
+            break;
+            /*7 data bits*/
+        case DAT_7:
+            updateCFlags(hPort, CSIZE, CS7);
+            break;
+            /*8 data bits*/
+        case DAT_8:
+            updateCFlags(hPort, CSIZE, CS8);
+            break;
+        };
+    };
+}
+
+void cDriver::setStopBits(StopBitsType stopBits)
+{
+    if(PortSetting.StopBits==stopBits)
+        return;
+
+    PortSetting.StopBits=stopBits;
+    if(isOpen())
+    {
+        switch (stopBits)
+        {
+        /*one stop bit*/
+        case STOP_1:
+            updateCFlags(hPort, CSTOPB, 0);
+            break;
+            /*1.5 stop bits - WINDOWS ONLY*/
+        case STOP_1_5:
+            break;
+            /*two stop bits*/
+        case STOP_2:
+            updateCFlags(hPort, 0, CSTOPB);
+            break;
+        };
+    };
+}
+
+void cDriver::setBaudRate(BaudRateType baudRate)
+{
+    struct termios tio;
+    unsigned long  bps   = baudRateValue(baudRate);
+    speed_t        speed = SpeedTable[0].Speed;
+    unsigned int   i;
+
+    if(PortSetting.BaudRate==baudRate)
+        return;
+
+    PortSetting.BaudRate=baudRate;
+
+    // Windows only rates fall back to the next lower termios rate
+    for(i=0; i<sizeof(SpeedTable)/sizeof(SpeedTable[0]); i++)
+    {
+        if(SpeedTable[i].Bps<=bps)
+            speed = SpeedTable[i].Speed;
+    };
+    if(isOpen() && tcgetattr(hPort, &tio)==0)
+    {
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+        tcsetattr(hPort, TCSANOW, &tio);
+    };
+}
+
+void cDriver::setTimeout(long ms)
+{
+    // Bounds ReadData/WriteData, -1 returns at once like MAXDWORD on Win32
+    PortSetting.TimeoutMs = ms;
+}
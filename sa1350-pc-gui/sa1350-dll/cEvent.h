@@ -31,7 +31,11 @@
  * --/COPYRIGHT--*/
 /*! \file sa1350-dll/cEvent.h */
 #pragma once
-#include <windows.h>
+#include "sa1350Platform.h"
+#ifndef _WIN32
+#include <mutex>
+#include <condition_variable>
+#endif
 
 using namespace std;
 
@@ -88,9 +92,17 @@ public:
     void Reset(void);
 
     bool m_bCreated;  /*!< Add in-line comment */
+#ifdef _WIN32
     HANDLE m_event;   /*!< Add in-line comment */
+#endif
 
 private:
+#ifndef _WIN32
+    std::mutex              m_lock;     /*!< Guards m_bSignaled */
+    std::condition_variable m_cond;     /*!< Wakes waiting threads */
+    bool                    m_bManual;  /*!< Stays signaled until Reset */
+    bool                    m_bSignaled;/*!< Current event state */
+#endif
 
 
 };
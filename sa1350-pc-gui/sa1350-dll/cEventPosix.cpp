@@ -0,0 +1,97 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include "cEvent.h"
+#include <chrono>
+
+using namespace std;
+
+cEvent::cEvent(bool manual):m_bCreated(true),m_bManual(manual),m_bSignaled(false)
+{
+}
+
+cEvent::~cEvent()
+{
+}
+
+// Public Function Defintion
+
+void cEvent::Signal(void)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_bSignaled = true;
+    }
+    if(m_bManual)
+        m_cond.notify_all();
+    else
+        m_cond.notify_one();
+}
+
+bool cEvent::Wait(void)
+{
+    return(CheckSignal(INFINITE));
+}
+
+bool cEvent::CheckSignal(DWORD ms)
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+
+    if(ms == INFINITE)
+    {
+        m_cond.wait(guard, [this]{ return m_bSignaled; });
+    }
+    else if(ms == 0)
+    {// wait_for would still enter the kernel with an expired timeout
+        if(!m_bSignaled)
+            return false;
+    }
+    else if(!m_cond.wait_for(guard, std::chrono::milliseconds(ms), [this]{ return m_bSignaled; }))
+    {
+        return false;
+    };
+    // Auto reset events release exactly one waiter
+    if(!m_bManual)
+        m_bSignaled = false;
+
+    return true;
+}
+
+bool cEvent::Check(void)
+{
+    return(CheckSignal(0));
+}
+
+void cEvent::Reset(void)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_bSignaled = false;
+}
@@ -0,0 +1,100 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include "cFrameQueue.h"
+
+using namespace std;
+
+cFrameQueue::cFrameQueue(unsigned long Capacity)
+{
+    unsigned long size = 1;
+
+    while(size < Capacity)
+        size <<= 1;
+
+    Slots = new sFrame[size];
+    Mask  = size-1;
+    Head.store(0,std::memory_order_relaxed);
+    Tail.store(0,std::memory_order_relaxed);
+}
+
+cFrameQueue::~cFrameQueue(void)
+{
+    delete[] Slots;
+}
+
+sFrame *cFrameQueue::Alloc(void)
+{
+    unsigned long head = Head.load(std::memory_order_relaxed);
+
+    if(head-Tail.load(std::memory_order_acquire) > Mask)
+        return(NULL);
+
+    return(&Slots[head & Mask]);
+}
+
+void cFrameQueue::Push(void)
+{
+    Head.store(Head.load(std::memory_order_relaxed)+1,std::memory_order_release);
+}
+
+sFrame *cFrameQueue::Front(void)
+{
+    unsigned long tail = Tail.load(std::memory_order_relaxed);
+
+    if(tail == Head.load(std::memory_order_acquire))
+        return(NULL);
+
+    return(&Slots[tail & Mask]);
+}
+
+void cFrameQueue::Pop(void)
+{
+    Tail.store(Tail.load(std::memory_order_relaxed)+1,std::memory_order_release);
+}
+
+void cFrameQueue::Clear(void)
+{
+    Tail.store(Head.load(std::memory_order_acquire),std::memory_order_release);
+}
+
+unsigned long cFrameQueue::Size(void)
+{
+    // Tail first, Head can only have moved further ahead since
+    unsigned long tail = Tail.load(std::memory_order_acquire);
+
+    return(Head.load(std::memory_order_acquire)-tail);
+}
+
+bool cFrameQueue::IsEmpty(void)
+{
+    return(Size()==0);
+}
@@ -0,0 +1,112 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file cFrameQueue.h */
+#pragma once
+#include <atomic>
+
+using namespace std;
+
+#include "sa1350TypeDef.h"
+
+#define CACHE_LINE_SIZE 64 /*!< Padding between producer and consumer index */
+
+/*!
+ \brief Lock-free single-producer/single-consumer frame queue
+
+ All frame slots are allocated once in the constructor. The decoder thread
+ fills the slot returned by Alloc() in place and publishes it with Push(),
+ the consumer reads the slot returned by Front() in place and releases it
+ with Pop(). Head is only written by the producer and Tail only by the
+ consumer, both live on their own cache line.
+
+ \class cFrameQueue cFrameQueue.h "cFrameQueue.h"
+*/
+class cFrameQueue
+{
+public:
+    /*!
+     \brief Constructor
+
+     \param Capacity Number of frame slots, rounded up to the next power of two
+    */
+    cFrameQueue(unsigned long Capacity);
+    /*!
+     \brief Destructor
+
+    */
+    ~cFrameQueue(void);
+
+    /*!
+     \brief Producer: return the next free slot or NULL if the queue is full
+
+    */
+    sFrame *Alloc(void);
+    /*!
+     \brief Producer: publish the slot returned by Alloc
+
+    */
+    void Push(void);
+    /*!
+     \brief Consumer: return the oldest frame or NULL if the queue is empty
+
+    */
+    sFrame *Front(void);
+    /*!
+     \brief Consumer: release the slot returned by Front
+
+    */
+    void Pop(void);
+    /*!
+     \brief Consumer: drop all queued frames
+
+    */
+    void Clear(void);
+    /*!
+     \brief Return the number of queued frames
+
+    */
+    unsigned long Size(void);
+    /*!
+     \brief Check if the queue is empty
+
+    */
+    bool IsEmpty(void);
+
+private:
+    sFrame        *Slots;                                       /*!< Frame slots */
+    unsigned long  Mask;                                        /*!< Capacity - 1 */
+    char           PadHead[CACHE_LINE_SIZE];                    /*!< Padding */
+    std::atomic<unsigned long> Head;                            /*!< Free running producer index */
+    char           PadTail[CACHE_LINE_SIZE-sizeof(unsigned long)]; /*!< Padding */
+    std::atomic<unsigned long> Tail;                            /*!< Free running consumer index */
+    char           PadEnd[CACHE_LINE_SIZE-sizeof(unsigned long)];  /*!< Padding */
+};
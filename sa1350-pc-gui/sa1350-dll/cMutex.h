@@ -31,7 +31,12 @@
  * --/COPYRIGHT--*/
 /*! \file cMutex.h */
 #pragma once
-#include <windows.h>
+#include "sa1350Platform.h"
+#ifndef _WIN32
+#include <atomic>
+#include <mutex>
+#include <thread>
+#endif
 
 using namespace std;
 
@@ -67,7 +72,12 @@ public:
     bool bCreated; /*!< Add in-line comment */
 
 private:
+#ifdef _WIN32
     HANDLE hMutex; /*!< Add in-line comment */
     DWORD  dwOwner; /*!< Add in-line comment */
+#else
+    std::mutex                   hMutex;  /*!< Add in-line comment */
+    std::atomic<std::thread::id> dwOwner; /*!< Thread holding hMutex */
+#endif
 };
 
@@ -31,7 +31,7 @@
  * --/COPYRIGHT--*/
 /*! \file cRegAccess.h */
 #pragma once
-#include <windows.h>
+#include "sa1350Platform.h"
 
 using namespace std;
 
@@ -101,6 +101,7 @@ private:
         std::string strValue;  /*!< Add in-line comment */
     }sRegEntry;
 
+#ifdef _WIN32
     /*!
      \brief Returns the specific Windows Registry Key value(s)
 
@@ -109,4 +110,5 @@ private:
      \return bool
     */
     bool RegGetKeyValues(HKEY hKey, list<sRegEntry> *regEntryList);
+#endif
 };
@@ -0,0 +1,204 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include "cRegAccess.h"
+#include <dirent.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <fstream>
+
+using namespace std;
+
+#define SYSFS_TTY_PATH  "/sys/class/tty/" /*!< sysfs tty class directory */
+#define SA1350_USB_VID  "0451"            /*!< SA1350 USB vendor id */
+#define SA1350_USB_PID  "bef3"            /*!< SA1350 USB product id */
+
+/*!
+ \brief Read the first line of a sysfs attribute
+
+ \param path
+ \param value
+ \return bool
+*/
+static bool readSysAttr(const std::string &path, std::string &value)
+{
+    ifstream file(path.c_str());
+
+    value.clear();
+    if(!file.is_open())
+        return(false);
+    getline(file, value);
+
+    return(!value.empty());
+}
+
+/*!
+ \brief Scan the tty class for SA1350 USB CDC ports
+
+   The sysfs equivalent of the Enum\\USB\\Vid_0451&Pid_BEF3 registry keys.
+
+ \param usbDeviceList
+ \return bool
+*/
+static bool scanUsbDevices(vUsbDeviceList *usbDeviceList)
+{
+    bool ok = false;
+    DIR *dir;
+    struct dirent *entry;
+    char resolved[PATH_MAX];
+    std::string devPath, vid, pid;
+    sUsbDeviceInfo usbDeviceInfo;
+
+    usbDeviceList->clear();
+
+    dir = opendir(SYSFS_TTY_PATH);
+    if(!dir)
+        return(false);
+
+    while((entry = readdir(dir))!=NULL)
+    {
+        std::string name(entry->d_name);
+        if(name.compare(0,6,"ttyACM")!=0 && name.compare(0,6,"ttyUSB")!=0)
+            continue;
+        if(!realpath((SYSFS_TTY_PATH + name + "/device").c_str(), resolved))
+            continue;
+
+        // Walk up from the interface to the USB device node holding the ids
+        devPath = resolved;
+        while(devPath.size()>1 && !readSysAttr(devPath + "/idVendor", vid))
+            devPath = devPath.substr(0, devPath.rfind('/'));
+        if(!readSysAttr(devPath + "/idProduct", pid))
+            continue;
+        if(strcasecmp(vid.c_str(),SA1350_USB_VID)!=0 || strcasecmp(pid.c_str(),SA1350_USB_PID)!=0)
+            continue;
+
+        if(!readSysAttr(devPath + "/serial", usbDeviceInfo.SerialNr))
+            usbDeviceInfo.SerialNr = name;
+        if(!readSysAttr(devPath + "/product", usbDeviceInfo.DevDesc))
+            usbDeviceInfo.DevDesc = "SA1350";
+        usbDeviceInfo.LocationInformation = devPath.substr(devPath.rfind('/')+1);
+        usbDeviceInfo.ParentIdPrefix.clear();
+        usbDeviceInfo.PortName  = name;
+        usbDeviceInfo.Connected = false;
+        usbDeviceList->push_back(usbDeviceInfo);
+        ok = true;
+    };
+    closedir(dir);
+
+    return(ok);
+}
+
+cRegAccess::cRegAccess(void)
+{
+}
+
+cRegAccess::~cRegAccess(void)
+{
+}
+
+bool cRegAccess::LoadComPortList(lComPortList *comPortList)
+{
+    bool ok = false;
+    DIR *dir;
+    struct dirent *entry;
+    char resolved[PATH_MAX];
+    sComPortDescr ComPortDescr;
+
+    comPortList->clear();
+
+    dir = opendir(SYSFS_TTY_PATH);
+    if(!dir)
+        return(false);
+
+    while((entry = readdir(dir))!=NULL)
+    {
+        // Only ttys backed by a device, not the virtual consoles
+        std::string name(entry->d_name);
+        if(name[0]=='.' || !realpath((SYSFS_TTY_PATH + name + "/device").c_str(), resolved))
+            continue;
+
+        ComPortDescr.Name = "/dev/" + name;
+        ComPortDescr.Nr   = name;
+        comPortList->push_back(ComPortDescr);
+        ok = true;
+    };
+    closedir(dir);
+
+    return(ok);
+}
+
+bool cRegAccess::LoadRegDeviceList(vUsbDeviceList *usbDeviceList)
+{
+    return(scanUsbDevices(usbDeviceList));
+}
+
+bool cRegAccess::GetPortSerial(std::string port, std::string & UsbSerial)
+{
+    bool ok = false;
+    vUsbDeviceList UsbDeviceList;
+    scanUsbDevices(&UsbDeviceList);
+
+    // Accept "ttyACM0" as well as "/dev/ttyACM0"
+    port = port.substr(port.rfind('/')+1);
+    for(vector<sUsbDeviceInfo>::iterator iComPort=UsbDeviceList.begin();iComPort<UsbDeviceList.end();iComPort++)
+    {
+        if(iComPort->PortName.compare(port)==0)
+        {
+            UsbSerial = iComPort->SerialNr;
+            ok = true;
+            break;
+        };
+    };
+
+    return(ok);
+}
+
+bool cRegAccess::LoadRegDeviceDetails(vUsbDeviceList::iterator item)
+{
+    bool ok = false;
+    vUsbDeviceList UsbDeviceList;
+    scanUsbDevices(&UsbDeviceList);
+
+    for(vector<sUsbDeviceInfo>::iterator iDevice=UsbDeviceList.begin();iDevice<UsbDeviceList.end();iDevice++)
+    {
+        if(iDevice->SerialNr.compare(item->SerialNr)==0)
+        {
+            item->DevDesc             = iDevice->DevDesc;
+            item->LocationInformation = iDevice->LocationInformation;
+            item->PortName            = iDevice->PortName;
+            ok = true;
+            break;
+        };
+    };
+
+    return(ok);
+}
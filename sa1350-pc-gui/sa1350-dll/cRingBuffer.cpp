@@ -0,0 +1,141 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include <string.h>
+#include "cRingBuffer.h"
+
+using namespace std;
+
+cRingBuffer::cRingBuffer(unsigned long Capacity)
+{
+    unsigned long size = 1;
+
+    while(size < Capacity)
+        size <<= 1;
+
+    Buffer = new unsigned char[size];
+    Mask   = size-1;
+    Head   = 0;
+    Tail   = 0;
+}
+
+cRingBuffer::~cRingBuffer(void)
+{
+    delete[] Buffer;
+}
+
+void cRingBuffer::Clear(void)
+{
+    Head = 0;
+    Tail = 0;
+}
+
+unsigned long cRingBuffer::Capacity(void)
+{
+    return(Mask+1);
+}
+
+unsigned long cRingBuffer::Size(void)
+{
+    return(Head-Tail);
+}
+
+unsigned long cRingBuffer::Free(void)
+{
+    return(Capacity()-Size());
+}
+
+unsigned char *cRingBuffer::WriteSpan(unsigned long &Length)
+{
+    unsigned long pos = Head & Mask;
+
+    Length = Capacity()-pos;
+    if(Length > Free())
+        Length = Free();
+
+    return(Buffer+pos);
+}
+
+void cRingBuffer::Commit(unsigned long Length)
+{
+    if(Length > Free())
+        Length = Free();
+    Head += Length;
+}
+
+const unsigned char *cRingBuffer::ReadSpan(unsigned long Offset, unsigned long &Length)
+{
+    unsigned long pos = (Tail+Offset) & Mask;
+
+    if(Offset >= Size())
+    {
+        Length = 0;
+        return(Buffer+pos);
+    };
+
+    Length = Capacity()-pos;
+    if(Length > Size()-Offset)
+        Length = Size()-Offset;
+
+    return(Buffer+pos);
+}
+
+unsigned char cRingBuffer::Peek(unsigned long Offset)
+{
+    return(Buffer[(Tail+Offset) & Mask]);
+}
+
+unsigned long cRingBuffer::Copy(unsigned long Offset, unsigned char *Data, unsigned long Length)
+{
+    unsigned long copied = 0;
+    unsigned long span;
+    const unsigned char *src;
+
+    while(copied < Length)
+    {
+        src = ReadSpan(Offset+copied,span);
+        if(span == 0)
+            break;
+        if(span > Length-copied)
+            span = Length-copied;
+        memcpy(Data+copied,src,span);
+        copied += span;
+    };
+
+    return(copied);
+}
+
+void cRingBuffer::Consume(unsigned long Length)
+{
+    if(Length > Size())
+        Length = Size();
+    Tail += Length;
+}
@@ -0,0 +1,126 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file cRingBuffer.h */
+#pragma once
+
+using namespace std;
+
+/*!
+ \brief Fixed capacity byte ring buffer
+
+ The receiver thread writes the comport data directly into the free space of
+ the buffer and the frame decoder works on the stored bytes in place. The
+ buffer is owned by one thread and therefore not locked.
+
+ \class cRingBuffer cRingBuffer.h "cRingBuffer.h"
+*/
+class cRingBuffer
+{
+public:
+    /*!
+     \brief Constructor
+
+     \param Capacity Buffer size in bytes, rounded up to the next power of two
+    */
+    cRingBuffer(unsigned long Capacity);
+    /*!
+     \brief Destructor
+
+    */
+    ~cRingBuffer(void);
+
+    /*!
+     \brief Discard all stored bytes
+
+    */
+    void Clear(void);
+    /*!
+     \brief Return the buffer size in bytes
+
+    */
+    unsigned long Capacity(void);
+    /*!
+     \brief Return the number of stored bytes
+
+    */
+    unsigned long Size(void);
+    /*!
+     \brief Return the number of free bytes
+
+    */
+    unsigned long Free(void);
+    /*!
+     \brief Return the next contiguous block of free space
+
+     \param Length Returns the size of the block in bytes
+    */
+    unsigned char *WriteSpan(unsigned long &Length);
+    /*!
+     \brief Mark bytes written to the WriteSpan block as stored
+
+     \param Length Number of written bytes
+    */
+    void Commit(unsigned long Length);
+    /*!
+     \brief Return the contiguous block of stored bytes starting at Offset
+
+     \param Offset Offset from the oldest stored byte
+     \param Length Returns the size of the block in bytes
+    */
+    const unsigned char *ReadSpan(unsigned long Offset, unsigned long &Length);
+    /*!
+     \brief Return one stored byte without removing it
+
+     \param Offset Offset from the oldest stored byte
+    */
+    unsigned char Peek(unsigned long Offset);
+    /*!
+     \brief Copy stored bytes without removing them
+
+     \param Offset Offset from the oldest stored byte
+     \param Data Destination buffer
+     \param Length Number of bytes to copy
+    */
+    unsigned long Copy(unsigned long Offset, unsigned char *Data, unsigned long Length);
+    /*!
+     \brief Remove the oldest bytes from the buffer
+
+     \param Length Number of bytes to remove
+    */
+    void Consume(unsigned long Length);
+
+private:
+    unsigned char *Buffer; /*!< Buffer memory */
+    unsigned long  Mask;   /*!< Capacity - 1 */
+    unsigned long  Head;   /*!< Free running write counter */
+    unsigned long  Tail;   /*!< Free running read counter */
+};
@@ -4,8 +4,10 @@ Permissive via Author: Emad Barsoum
  * --/COPYRIGHT--*/
 /*! \file cThread.h */
 #pragma once
-#include <windows.h>
+#include "sa1350Platform.h"
+#ifdef _WIN32
 #include <process.h>
+#endif
 
 using namespace std;
 
@@ -23,6 +25,10 @@ enum eTaskState{
     FAULT     /*!< Add in-line comment */
 };
 
+#ifndef _WIN32
+#include "cThreadPosix.h"
+#else
+
 //-- Begin of CThread Declaration --
 
 /*!
@@ -561,3 +567,5 @@ template<typename T> unsigned __stdcall TThread<T>::_ThreadProc(LPVOID lpParamet
     pThread->OnRunning();
     return 0;
 }
+
+#endif // _WIN32
@@ -0,0 +1,136 @@
+/* --COPYRIGHT--,
+Permissive via Author: Emad Barsoum
+15. September 2011
+ * --/COPYRIGHT--*/
+#include "cThread.h"
+
+using namespace std;
+
+cThread::cThread(int nPriority):m_eStarted(false),m_eFinished(true)
+{
+    m_bTerminate = true;
+    m_bSuspend = true;
+    m_bIsRunning = false;
+    m_nInitPriority = nPriority;
+    m_nPriority = nPriority;
+}
+
+bool cThread::Start(void)
+{
+    if(m_bTerminate)
+    {
+        if(m_thread.joinable())
+            m_thread.join();
+        m_eFinished.Reset();
+        try
+        {
+            m_thread = std::thread(_ThreadProc,(void*)this);
+        }
+        catch(const std::system_error &)
+        {
+            return false;
+        }
+
+        m_bTerminate = false;
+        m_bSuspend = false;
+
+        return true;
+    }
+
+    return true;
+}
+
+bool cThread::StartAndWait(void)
+{
+    bool bRet = Start();
+    if(bRet)
+        m_eStarted.Wait();
+
+    return bRet;
+}
+
+bool cThread::Pause(void)
+{
+    return false;
+}
+
+bool cThread::IsRunning(void)
+{
+    return m_bIsRunning;
+}
+
+bool cThread::IsTerminated(void)
+{
+    return m_bTerminate;
+}
+
+bool cThread::IsSuspend(void)
+{
+    return m_bSuspend;
+}
+
+void cThread::Terminate(void)
+{
+    if(m_thread.joinable())
+    {
+        if(!m_eFinished.Check())
+            pthread_cancel(m_thread.native_handle());
+        m_thread.join();
+    }
+    m_bIsRunning = false;
+    m_bTerminate = true;
+}
+
+void cThread::Exit(void)
+{
+    m_bIsRunning = false;
+    m_bTerminate = true;
+    m_eFinished.Signal();
+    pthread_exit(NULL);
+}
+
+bool cThread::WaitUntilTerminate(DWORD dwMiliSec)
+{
+    if(!m_eFinished.CheckSignal(dwMiliSec))
+        return false;
+    if(m_thread.joinable())
+        m_thread.join();
+    m_bIsRunning = false;
+    m_bTerminate = true;
+    return true;
+}
+
+void cThread::SetPriority(int nLevel)
+{
+    m_nPriority = nLevel;
+}
+
+int cThread::GetPriority(void)
+{
+    return m_nPriority;
+}
+
+void cThread::SpeedUp(void)
+{
+    if(m_nPriority < THREAD_PRIORITY_TIME_CRITICAL)
+        SetPriority(m_nPriority+1);
+}
+
+void cThread::SlowDown(void)
+{
+    if(m_nPriority > THREAD_PRIORITY_IDLE)
+        SetPriority(m_nPriority-1);
+}
+
+void cThread::_ThreadProc(void *lpParameter)
+{
+    cThread* pThread = reinterpret_cast<cThread*>(lpParameter);
+
+    pThread->SetPriority(pThread->m_nInitPriority);
+    pThread->m_bIsRunning = true;
+    pThread->m_eStarted.Signal();
+    pThread->OnInitInstance();
+    pThread->OnRunning();
+    pThread->OnExitInstance();
+    pThread->m_eFinished.Signal();
+}
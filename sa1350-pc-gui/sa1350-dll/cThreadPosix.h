@@ -0,0 +1,485 @@
+/* --COPYRIGHT--,
+Permissive via Author: Emad Barsoum
+15. September 2011
+ * --/COPYRIGHT--*/
+/*! \file cThreadPosix.h
+ \brief std::thread based cThread/TThread, included by cThread.h on POSIX builds
+
+ Threads can not be suspended on POSIX, so Pause() always fails. The priority
+ level is only recorded, normal Linux scheduling has no per-thread priority
+ without extra privileges.
+*/
+#pragma once
+#include <pthread.h>
+#include <thread>
+
+#include "cEvent.h"
+
+//-- Begin of CThread Declaration --
+
+/*!
+ \brief Add brief
+
+ \class cThread cThreadPosix.h "cThread.h"
+*/
+class cThread
+{
+public:
+    /*!
+     \brief Constructor
+
+     \param nPriority Add param
+    */
+    cThread(int nPriority = THREAD_PRIORITY_NORMAL);
+
+    /*!
+     \brief Start the thread or recreate it, if it has been terminated before
+
+     \return bool
+    */
+    bool Start(void);
+    /*!
+     \brief Start the thread and return when it actualy start
+
+     \return bool
+    */
+    bool StartAndWait(void);
+    /*!
+     \brief Pause the thread, not supported on POSIX
+
+     \return bool
+    */
+    bool Pause(void);
+    /*!
+     \brief Check if the thread is running or not
+
+     \return bool
+    */
+    bool IsRunning(void);
+    /*!
+     \brief Check if the thread has been terminated or not
+
+     \return bool
+    */
+    bool IsTerminated(void);
+    /*!
+     \brief Check for the thread is suspend or not
+
+     \return bool
+    */
+    bool IsSuspend(void);
+    /*!
+     \brief Terminate immediate the thread - Unsafe
+
+    */
+    void Terminate(void);
+    /*!
+     \brief Wait until the thread terminate
+
+       After this function you are sure that the thread is terminated
+
+     \param dwMiliSec Add param
+     \return bool
+    */
+    bool WaitUntilTerminate(DWORD dwMiliSec = INFINITE);
+    /*!
+     \brief Set thread priority
+
+     \param nLevel Add param
+    */
+    void SetPriority(int nLevel);
+    /*!
+     \brief Get thread priority
+
+     \return int
+    */
+    int GetPriority(void);
+    /*!
+     \brief Speed up thread execution - increase priority level
+
+    */
+    void SpeedUp(void);
+    /*!
+     \brief Slow down Thread execution - decrease priority level
+
+    */
+    void SlowDown(void);
+
+protected:
+    /*!
+     \brief Destructor
+
+    */
+    virtual ~cThread()
+    {
+        if(m_thread.joinable())
+            m_thread.detach();
+    }
+    /*!
+     \brief Put the initialization code here
+
+    */
+    virtual void OnInitInstance(void){}
+    /*!
+     \brief Put the main code of the thread here
+
+        Must be overloaded
+
+    */
+    virtual void OnRunning(void) = 0;
+    /*!
+     \brief Put the cleanup code here
+
+     \return DWORD
+    */
+    virtual DWORD OnExitInstance(void){return 0;}
+    /*!
+     \brief Exit the thread safety
+
+    */
+    void Exit(void);
+    /*!
+     \brief Thread function
+
+     \param lpParameter Add param
+    */
+    static void _ThreadProc(void *lpParameter);
+
+protected:
+    std::thread m_thread;      /*!< Thread object */
+    cEvent m_eStarted,         /*!< Auto reset, set when the thread function runs */
+           m_eFinished;        /*!< Manual reset, set when the thread function returns */
+    int m_nInitPriority,       /*!< Add in-line comment */
+        m_nPriority;           /*!< Recorded priority level */
+    bool m_bTerminate,         /*!< Thread state is terminated */
+         m_bSuspend,           /*!< Thread state is suspended */
+         m_bIsRunning;         /*!< Thread state is running */
+};
+
+//-- End of CThread Class Declaration --
+
+//-- Begin of TThread Declaration --
+
+/*!
+ \brief Template Thread Class
+
+ \class TThread cThreadPosix.h "cThread.h"
+ \tparam T Thread
+*/
+template<typename T>
+class TThread
+{
+public:
+    /*!
+     \brief The constructor
+
+     \param thObject Add param
+     \param (*pfnOnRunning)() Add param
+     \param nPriority Add param
+    */
+    TThread(T& thObject, void (T::*pfnOnRunning)(), int nPriority = THREAD_PRIORITY_NORMAL);
+    /*!
+     \brief Destructor
+
+    */
+    virtual ~TThread()
+    {
+        if(m_thread.joinable())
+            m_thread.detach();
+    }
+
+    /*!
+     \brief Wait until the thread terminate, after this function you are sure that the thread is terminated
+
+     \param dwMiliSec Add param
+     \return bool
+    */
+    bool WaitUntilTerminate(DWORD dwMiliSec = INFINITE);
+    /*!
+    \brief Start the thread or recreate it, if it has been terminated before
+
+     \return bool
+    */
+    bool Start(void);
+    /*!
+     \brief Start the thread and return when it actualy start
+
+     \return bool
+    */
+    bool StartAndWait(void);
+    /*!
+     \brief Pause the thread, not supported on POSIX
+
+     \return bool
+    */
+    bool Pause(void);
+    /*!
+     \brief Check if the thread is running or not
+
+     \return bool
+    */
+    bool IsRunning(void);
+    /*!
+     \brief Check if the thread has been terminated or not
+
+     \return bool
+    */
+    bool IsTerminated(void);
+    /*!
+     \brief Check for the thread is suspend or not
+
+     \return bool
+    */
+    bool IsSuspend(void);
+    /*!
+     \brief Set thread priority
+
+     \param nLevel Add param
+    */
+    void SetPriority(int nLevel);
+    /*!
+     \brief Get thread priority
+
+     \return int
+    */
+    int GetPriority(void);
+    /*!
+     \brief Speed up thread execution - increase priority level
+
+    */
+    void SpeedUp(void);
+    /*!
+     \brief Slow down Thread execution - decrease priority level
+
+    */
+    void SlowDown(void);
+    /*!
+     \brief Terminate immediate the thread Unsafe
+
+    */
+    void Terminate(void);
+
+protected:
+    /*!
+     \brief Thread function
+
+     \param lpParameter Add param
+    */
+    static void _ThreadProc(void *lpParameter);
+    /*!
+     \brief Call the running member function
+
+    */
+    inline void OnRunning(void);
+
+protected:
+    T& m_thObject;               /*!< Add in-line comment */
+    void (T::*m_pfnOnRunning)(); /*!< Add in-line comment */
+    std::thread m_thread;        /*!< Thread object */
+    cEvent m_eStarted,           /*!< Auto reset, set when the thread function runs */
+           m_eFinished;          /*!< Manual reset, set when the thread function returns */
+    int m_nInitPriority,         /*!< Add in-line comment */
+        m_nPriority;             /*!< Recorded priority level */
+    bool m_bTerminate,           /*!< Thread state is terminated */
+         m_bSuspend,             /*!< Thread state is suspended */
+         m_bIsRunning;           /*!< Thread state is running */
+};
+
+//-- End of TThread Class Declaration --
+
+//-- Start of TThread Definition --
+
+/*!
+ \brief TThread constructor
+
+ \param thObject Add param
+ \param (*pfnOnRunning)() Add param
+ \param nPriority Add param
+*/
+template<typename T> TThread<T>::TThread(T& thObject,void (T::*pfnOnRunning)(), int nPriority):m_thObject(thObject),m_pfnOnRunning(pfnOnRunning),m_eStarted(false),m_eFinished(true)
+{
+    m_bTerminate = true;
+    m_bSuspend = true;
+    m_bIsRunning = false;
+    m_nInitPriority = nPriority;
+    m_nPriority = nPriority;
+}
+
+/*!
+ \brief Start
+
+ \return bool
+*/
+template<typename T> bool TThread<T>::Start(void)
+{
+    if(m_bTerminate)
+    {
+        if(m_thread.joinable())
+            m_thread.join();
+        m_eFinished.Reset();
+        try
+        {
+            m_thread = std::thread(_ThreadProc,(void*)this);
+        }
+        catch(const std::system_error &)
+        {
+            return false;
+        }
+
+        m_bTerminate = false;
+        m_bSuspend = false;
+        return true;
+    }
+    return true;
+}
+
+/*!
+ \brief StartAndWait
+
+ \return bool
+*/
+template<typename T> bool TThread<T>::StartAndWait(void)
+{
+    bool bRet = Start();
+    if(bRet)
+        m_eStarted.Wait();
+    return bRet;
+}
+
+/*!
+ \brief Pause
+
+ \return bool
+*/
+template<typename T> bool TThread<T>::Pause(void)
+{
+    return false;
+}
+
+/*!
+ \brief IsRunning
+
+ \return bool
+*/
+template<typename T> bool TThread<T>::IsRunning(void)
+{
+    return m_bIsRunning;
+}
+
+/*!
+ \brief IsTerminated
+
+ \return bool
+*/
+template<typename T> bool TThread<T>::IsTerminated(void)
+{
+    return m_bTerminate;
+}
+
+/*!
+ \brief IsSuspend
+
+ \return bool
+*/
+template<typename T> bool TThread<T>::IsSuspend(void)
+{
+    return m_bSuspend;
+}
+
+/*!
+ \brief Terminate
+
+*/
+template<typename T> void TThread<T>::Terminate(void)
+{
+    if(m_thread.joinable())
+    {
+        if(!m_eFinished.Check())
+            pthread_cancel(m_thread.native_handle());
+        m_thread.join();
+    }
+    m_bIsRunning = false;
+    m_bTerminate = true;
+}
+
+/*!
+ \brief WaitUntilTerminate
+
+ \param dwMiliSec Add param
+ \return bool
+*/
+template<typename T> bool TThread<T>::WaitUntilTerminate(DWORD dwMiliSec)
+{
+    if(!m_eFinished.CheckSignal(dwMiliSec))
+        return false;
+    if(m_thread.joinable())
+        m_thread.join();
+    m_bIsRunning = false;
+    m_bTerminate = true;
+    return true;
+}
+
+/*!
+ \brief SetPriority
+
+ \param nLevel Add param
+*/
+template<typename T> void TThread<T>::SetPriority(int nLevel)
+{
+    m_nPriority = nLevel;
+}
+
+/*!
+ \brief GetPriority
+
+ \return int
+*/
+template<typename T> int TThread<T>::GetPriority(void)
+{
+    return m_nPriority;
+}
+
+/*!
+ \brief SpeedUp
+
+*/
+template<typename T> void TThread<T>::SpeedUp(void)
+{
+    if(m_nPriority < THREAD_PRIORITY_TIME_CRITICAL)
+        SetPriority(m_nPriority+1);
+}
+
+/*!
+ \brief SlowDown
+
+*/
+template<typename T> void TThread<T>::SlowDown(void)
+{
+    if(m_nPriority > THREAD_PRIORITY_IDLE)
+        SetPriority(m_nPriority-1);
+}
+
+/*!
+ \brief OnRunning
+
+*/
+template<typename T> void TThread<T>::OnRunning(void)
+{
+    (m_thObject.*m_pfnOnRunning)();
+}
+
+/*!
+ \brief
+
+ \param lpParameter Add param
+*/
+template<typename T> void TThread<T>::_ThreadProc(void *lpParameter)
+{
+    TThread<T>* pThread = reinterpret_cast<TThread<T>*>(lpParameter);
+
+    pThread->SetPriority(pThread->m_nInitPriority);
+    pThread->m_bIsRunning = true;
+    pThread->m_eStarted.Signal();
+    pThread->OnRunning();
+    pThread->m_eFinished.Signal();
+}
@@ -31,8 +31,10 @@
  * --/COPYRIGHT--*/
 /*! \file cUsbDetect.h */
 #pragma once
-#include <windows.h>
+#include "sa1350Platform.h"
+#ifdef _WIN32
 #include <dbt.h>
+#endif
 
 using namespace std;
 
@@ -40,6 +42,7 @@ using namespace std;
 #include "cRegAccess.h"
 #include "cThread.h"
 
+#ifdef _WIN32
 static const GUID GuidDevInterfaceList[] =
 {
     { 0xa5dcbf10, 0x6530, 0x11d2, { 0x90, 0x1f, 0x00, 0xc0, 0x4f, 0xb9, 0x51, 0xed } },
@@ -47,6 +50,9 @@ static const GUID GuidDevInterfaceList[] =
     { 0x4d1e55b2, 0xf16f, 0x11Cf, { 0x88, 0xcb, 0x00, 0x11, 0x11, 0x00, 0x00, 0x30 } },
     { 0xad498944, 0x762f, 0x11d0, { 0x8d, 0xcb, 0x00, 0xc0, 0x4f, 0xc3, 0x35, 0x8c } }
 };
+#else
+#define USB_DETECT_POLL_MS 250 /*!< Interval for checking the tty device node */
+#endif
 
 /*!
  \brief Usb Detect Class
@@ -104,14 +110,18 @@ private:
     std::string strComPortName; /*!< Add in-line comment */
     std::string strComPortSerial; /*!< Add in-line comment */
     bool flagCreated; /*!< Add in-line comment */
-    const char *className; /*!< Add in-line comment */
-    WNDCLASSA wincl; /*!< Add in-line comment */
     cRegAccess RegAccess; /*!< Add in-line comment */
 
     cEvent *eUnpluggedEvent; /*!< Add in-line comment */
+#ifdef _WIN32
+    const char *className; /*!< Add in-line comment */
+    WNDCLASSA wincl; /*!< Add in-line comment */
     HWND  hparent; /*!< Add in-line comment */
     DEV_BROADCAST_DEVICEINTERFACE NotificationFilter; /*!< Add in-line comment */
     HDEVNOTIFY hDeviceNotify; /*!< Add in-line comment */
+#else
+    cEvent *eExitEvent; /*!< Wakes the polling thread on exit */
+#endif
     TThread<cUsbDetect> *ThreadHandle; /*!< Add in-line comment */
     volatile bool flagExitThread; /*!< Add in-line comment */
 
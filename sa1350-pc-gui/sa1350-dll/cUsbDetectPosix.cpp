@@ -0,0 +1,156 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include "cUsbDetect.h"
+#include <unistd.h>
+
+using namespace std;
+
+cUsbDetect::cUsbDetect(void)
+{
+    flagCreated = false;
+
+    // Init Thread
+    flagExitThread = false;
+    ThreadHandle   = NULL;
+
+    // Create and Init Objects
+    eUnpluggedEvent = new cEvent(false);
+    eExitEvent      = new cEvent(true);
+
+    if(eUnpluggedEvent && eExitEvent)
+    {
+        ThreadHandle   = new TThread<cUsbDetect>(*this,&cUsbDetect::run);
+        if(ThreadHandle)
+        {
+            flagCreated = true;
+        };
+    };
+
+    if(flagCreated)
+    {
+        ThreadHandle->StartAndWait();
+        if(ThreadHandle->IsRunning())
+            flagCreated = true;
+        else
+            flagCreated = false;
+    };
+}
+
+cUsbDetect::~cUsbDetect(void)
+{
+    flagExitThread = true;
+    eExitEvent->Signal();
+    if(ThreadHandle)
+    {
+        ThreadHandle->WaitUntilTerminate();
+        delete ThreadHandle;
+    };
+    delete eExitEvent;
+    delete eUnpluggedEvent;
+}
+
+bool cUsbDetect::On(std::string strComPort)
+{
+    if(!flagCreated || strComPort.empty())
+        return(false);
+
+    // Ports which are not SA1350 USB devices (e.g. a pty) are traced by path only
+    if(!RegAccess.GetPortSerial(strComPort,strComPortSerial))
+        strComPortSerial.clear();
+
+    if(strComPort.find('/')!=0)
+        strComPort = "/dev/" + strComPort;
+    eUnpluggedEvent->Reset();
+    strComPortName = strComPort;
+
+    return(true);
+}
+
+bool cUsbDetect::Off(void)
+{
+    bool ok = false;
+
+    if(!flagCreated)
+    {
+        ok = false;
+    }
+    else
+    {
+        strComPortName.clear();
+        strComPortSerial.clear();
+        eUnpluggedEvent->Reset();
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool cUsbDetect::IsActivePortConnected(void)
+{
+    std::string strPort = strComPortName;
+
+    if(strPort.empty())
+        return(false);
+
+    return(access(strPort.c_str(), F_OK)==0);
+}
+
+bool cUsbDetect::EventUnplugged(void)
+{
+    if(strComPortName.empty())
+    {
+        return(false);
+    };
+
+    return(eUnpluggedEvent->Check());
+}
+
+bool cUsbDetect::IsSame(std::string *strTest)
+{
+    if(strComPortName.compare(strTest->c_str())==0)
+    {
+        return(true);
+    };
+
+    return(false);
+}
+
+void cUsbDetect::run(void)
+{
+    // udev removes the device node as soon as the USB device is gone
+    do
+    {
+        // Raised until Off() stops tracing the port
+        if(!strComPortName.empty() && !IsActivePortConnected())
+            eUnpluggedEvent->Signal();
+    }while(!flagExitThread && !eExitEvent->CheckSignal(USB_DETECT_POLL_MS));
+}
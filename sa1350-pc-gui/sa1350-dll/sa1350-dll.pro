@@ -6,32 +6,67 @@ TEMPLATE  = lib
 CONFIG    += warn_on
 CONFIG    += thread
 CONFIG	  += dll
-
-LIBS      += -lsetupapi
+CONFIG    += c++11
 
 DEFINES += SA1350_EXPORTS
-DEFINES -= UNICODE
-DEFINES += "WINVER=0x0500"
+
+win32 {
+    LIBS      += -lsetupapi
+
+    DEFINES -= UNICODE
+    DEFINES += "WINVER=0x0500"
+}
+unix {
+    LIBS      += -lpthread
+    QMAKE_CXXFLAGS += -fvisibility=hidden
+}
+
+INCLUDEPATH += ../../sa1350-firmware/crc16
+INCLUDEPATH += ../../sa1350-firmware/specpack
 
 SOURCES += \
-    cUsbDetect.cpp \
-    cThread.cpp \
-    cRegAccess.cpp \
-    cMutex.cpp \
-    cEvent.cpp \
-    cDriver.cpp \
+    ../../sa1350-firmware/crc16/crc16.c \
+    ../../sa1350-firmware/specpack/specPack.c \
     cDeviceDriver.cpp \
-    dllmain.cpp \
+    cRingBuffer.cpp \
+    cFrameQueue.cpp \
     sa1350.cpp
 
+# Platform backend: Win32 comport/threads or termios/std::thread
+win32 {
+    SOURCES += \
+        cUsbDetect.cpp \
+        cThread.cpp \
+        cRegAccess.cpp \
+        cMutex.cpp \
+        cEvent.cpp \
+        cDriver.cpp \
+        dllmain.cpp
+}
+unix {
+    SOURCES += \
+        cUsbDetectPosix.cpp \
+        cThreadPosix.cpp \
+        cRegAccessPosix.cpp \
+        cMutexPosix.cpp \
+        cEventPosix.cpp \
+        cDriverPosix.cpp
+}
+
 HEADERS +=\
+    ../../sa1350-firmware/crc16/crc16.h \
+    ../../sa1350-firmware/specpack/specPack.h \
     cUsbDetect.h \
     cThread.h \
+    cThreadPosix.h \
+    sa1350Platform.h \
     cRegAccess.h \
     cMutex.h \
     cEvent.h \
     cDriver.h \
     cDeviceDriver.h \
+    cRingBuffer.h \
+    cFrameQueue.h \
     sa1350.h \
     sa1350TypeDef.h \
     sa1350_global.h \
@@ -32,13 +32,15 @@
 /*! \file sa1350.cpp
  \brief Defines the exported functions for the DLL application.
 */
+#include <string.h>
 #include "sa1350.h"
 #include "cDeviceDriver.h"
 #include "cUsbDetect.h"
+#include "specPack.h"
 
 using namespace std;
 
-#define DLL_VERSION		((unsigned short)(0x0103)) /*!< DLL version number in High_byte.Low_byte format */
+#define DLL_VERSION		((unsigned short)(0x0105)) /*!< DLL version number in High_byte.Low_byte format */
 
 volatile bool           flagInit      = false; /*!< Add in-line comment */
 volatile bool           flagConnected = false; /*!< Add in-line comment */
@@ -305,20 +307,22 @@ SA1350_API bool API_CALL sa1350GetFrameFifoSize(unsigned short &Size)
 SA1350_API bool API_CALL sa1350GetFrame(SA1350Frame *Frame)
 {
     bool ok = false;
-    sFrame srcFrame;
-    if(flagInit && flagConnected)
+    sFrame *srcFrame;
+    if(flagInit && flagConnected && Frame)
     {
         if(Device)
         {
-            if(Device->GetFrame(&srcFrame))
+            // Copy straight out of the queue slot
+            srcFrame = Device->PeekFrame();
+            if(srcFrame)
             {
-                Frame->Cmd		= srcFrame.Cmd;
-                Frame->Crc		= srcFrame.Crc;
-                Frame->Length	= srcFrame.Length;
-                for(unsigned int index=0;index<srcFrame.Data.size();index++)
-                {
-                    Frame->Data[index] = srcFrame.Data[index];
-                };
+                Frame->Cmd		= srcFrame->Cmd;
+                Frame->Crc		= srcFrame->Crc;
+                Frame->SweepId	= srcFrame->SweepId;
+                Frame->Lost		= srcFrame->Lost;
+                Frame->Length	= srcFrame->Length;
+                memcpy(Frame->Data,srcFrame->Data,srcFrame->Length);
+                Device->ReleaseFrame();
                 ok = true;
             };
         };
@@ -327,6 +331,50 @@ SA1350_API bool API_CALL sa1350GetFrame(SA1350Frame *Frame)
     return(ok);
 }
 
+SA1350_API bool API_CALL sa1350GetFrames(SA1350Frame *Frames, unsigned short MaxFrames, unsigned short &Count)
+{
+    sFrame *srcFrame;
+
+    Count = 0;
+    if(flagInit && flagConnected && Frames)
+    {
+        if(Device)
+        {
+            while(Count < MaxFrames)
+            {
+                srcFrame = Device->PeekFrame();
+                if(!srcFrame)
+                    break;
+                Frames[Count].Cmd		= srcFrame->Cmd;
+                Frames[Count].Crc		= srcFrame->Crc;
+                Frames[Count].SweepId	= srcFrame->SweepId;
+                Frames[Count].Lost		= srcFrame->Lost;
+                Frames[Count].Length	= srcFrame->Length;
+                memcpy(Frames[Count].Data,srcFrame->Data,srcFrame->Length);
+                Device->ReleaseFrame();
+                Count++;
+            };
+        };
+    };
+
+    return(Count>0);
+}
+
+SA1350_API bool API_CALL sa1350WaitForFrame(unsigned long TimeoutMs)
+{
+    bool ok = false;
+
+    if(flagInit && flagConnected)
+    {
+        if(Device)
+        {
+            ok = Device->WaitForFrame(TimeoutMs);
+        };
+    };
+
+    return(ok);
+}
+
 SA1350_API bool API_CALL sa1350SendCmd(unsigned char Cmd, unsigned char *Data, unsigned short Size)
 {
     bool ok = false;
@@ -341,3 +389,38 @@ SA1350_API bool API_CALL sa1350SendCmd(unsigned char Cmd, unsigned char *Data, u
 
     return(ok);
 }
+
+SA1350_API bool API_CALL sa1350SetBaudRate(unsigned long BaudRate)
+{
+    bool ok = false;
+
+    if(flagInit && flagConnected)
+    {
+        if(Device)
+        {
+            ok = Device->SetBaudRate(BaudRate);
+        };
+    };
+
+    return(ok);
+}
+
+SA1350_API bool API_CALL sa1350UnpackFrame(SA1350Frame *Frame)
+{
+    bool ok = false;
+    signed char values[FRAME_MAX_DATA_LENGTH];
+    unsigned short count;
+
+    if(Frame)
+    {
+        count = specUnpackFrames(Frame->Data,Frame->Length,(int8_t *)values,FRAME_MAX_DATA_LENGTH);
+        if(count > 0)
+        {
+            memcpy(Frame->Data,values,count);
+            Frame->Length = count;
+            ok = true;
+        };
+    };
+
+    return(ok);
+}
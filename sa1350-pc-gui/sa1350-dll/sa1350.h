@@ -40,7 +40,9 @@ using namespace std;
 // that uses this DLL. This way any other project whose source files include this file see
 // SA1350_API functions as being imported from a DLL, whereas this DLL sees symbols
 // defined with this macro as being exported.
-#ifdef SA1350_EXPORTS
+#if !defined(_WIN32)
+#define SA1350_API __attribute__((visibility("default"))) /*!< Add in-line comment */
+#elif defined(SA1350_EXPORTS)
 #define SA1350_API __declspec(dllexport) /*!< Add in-line comment */
 #else
 #define SA1350_API __declspec(dllimport) /*!< Add in-line comment */
@@ -55,7 +57,7 @@ extern "C"
 {
 #endif
 
-#define FRAME_MAX_DATA_LENGTH	255 /*!< Add in-line comment */
+#define FRAME_MAX_DATA_LENGTH	2560 /*!< Largest payload, a version 2 frame (CMD_SETFRAMING) holds a whole sweep */
 
 /*!
  \brief Add brief
@@ -89,9 +91,11 @@ typedef struct sa1350UsbDevice
 typedef struct sa1350Frame
 {
     unsigned char  Cmd;            /*!< Add in-line comment */
-    unsigned char  Length;         /*!< Add in-line comment */
+    unsigned short Length;         /*!< Add in-line comment */
     unsigned char  Data[FRAME_MAX_DATA_LENGTH]; /*!< Add in-line comment */
     unsigned short Crc;            /*!< Add in-line comment */
+    unsigned short SweepId;        /*!< Version 2 frames: sweep, block or burst of the payload, 0 otherwise */
+    unsigned char  Lost;           /*!< Version 2 frames missing right before this one, by sequence number */
 }SA1350Frame;
 
 /*!
@@ -213,6 +217,24 @@ SA1350_API bool API_CALL sa1350GetFrameFifoSize(unsigned short &Size);
 */
 SA1350_API bool API_CALL sa1350GetFrame(sa1350Frame *Frame);
 
+/*!
+ \brief Move all available frames, up to MaxFrames, from the Frame Fifo Buffer into Frames
+
+ \param Frames Caller provided array of at least MaxFrames entries
+ \param MaxFrames Add param
+ \param Count Number of frames copied to Frames
+ \return bool true if at least one frame was copied
+*/
+SA1350_API bool API_CALL sa1350GetFrames(sa1350Frame *Frames, unsigned short MaxFrames, unsigned short &Count);
+
+/*!
+ \brief Block until the Frame Fifo Buffer holds a frame or the timeout elapsed
+
+ \param TimeoutMs Add param
+ \return bool true if a frame is available
+*/
+SA1350_API bool API_CALL sa1350WaitForFrame(unsigned long TimeoutMs);
+
 /*!
  \brief Sends a Frame to the SA1350 Device
 
@@ -223,6 +245,28 @@ SA1350_API bool API_CALL sa1350GetFrame(sa1350Frame *Frame);
 */
 SA1350_API bool API_CALL sa1350SendCmd(unsigned char Cmd, unsigned char *Data, unsigned short Size);
 
+/*!
+ \brief Switch the comport baudrate once the sent commands have left
+
+   Only changes the host side, the device is switched with CMD_SETBAUDRATE.
+
+ \param BaudRate 115200, 230400, 460800 or 921600 bit/s
+ \return bool
+*/
+SA1350_API bool API_CALL sa1350SetBaudRate(unsigned long BaudRate);
+
+/*!
+ \brief Replace the delta packed payload of a spectrum frame by its RSSI values
+
+   For CMD_GETSPECNOINIT and CMD_STREAMDATA frames after CMD_SETENCODING
+   ENCODING_DELTA. Length becomes the number of values, one signed byte each.
+   Version 2 frames may hold several packed frames back to back.
+
+ \param Frame Add param
+ \return bool false if the payload is malformed, Frame is unchanged then
+*/
+SA1350_API bool API_CALL sa1350UnpackFrame(sa1350Frame *Frame);
+
 #ifdef __cplusplus
 }
 #endif
@@ -81,6 +81,11 @@ enum SA1350Cmd
     CMD_GETFWVER       =  4,  /*!< Get device's firmware version                            */
     CMD_GETRFPARAMS    =  5,  /*!< Get RF RBW table size, RBW values, maximum spectrum size */
     CMD_GETLASTERROR   =  6,  /*!< Indicate full spectrum received                          */
+    CMD_SYNC           =  7,  /*!< ACK only, confirms the rate of CMD_SETBAUDRATE           */
+    CMD_SETBAUDRATE    =  8,  /*!< Switch the UART rate, confirmed by CMD_SYNC              */
+    CMD_SETENCODING    =  9,  /*!< Select the spectrum frame encoding, see SA1350Encoding   */
+    CMD_SETDECIMATION  = 14,  /*!< Reduce spectrum frames to bins (u16 BE), SA1350Detector  */
+    CMD_SETFRAMING     = 15,  /*!< Select the format of device frames, see SA1350Framing    */
 
     // Frequency Commands
     CMD_SETFRANGE      =  20, /*!< Set Frequency Range frange                               */
@@ -91,8 +96,62 @@ enum SA1350Cmd
     CMD_SETRBW         =  25, /*!< Set Rx Filter bandwidth                                  */
     CMD_SETSTEPCOUNT   =  26, /*!< Set number of fsteps per MHz                             */
     CMD_SETSPAN        =  27, /*!< Set Frequency  Span fspan                                */
+    CMD_SETSWEEP       =  28, /*!< Set commands 20 - 27 at once, applied as one update      */
+    CMD_SETDETECTOR    =  29, /*!< Set detector mode and RSSI reads per step                */
 
     // Spectrum Measurement Comman
     CMD_INITPARAMETER  =  30, /*!< Setup the system for spectrum measurement                */
     CMD_GETSPECNOINIT  =  31, /*!< Measures the spectrum previously defined                 */
+    CMD_STARTSTREAM    =  32, /*!< Push every completed sweep until CMD_STOPSTREAM          */
+    CMD_STOPSTREAM     =  33, /*!< Stop pushing sweeps, ACK follows the last stream frame   */
+    CMD_STREAMSWEEP    =  34, /*!< Start of a streamed sweep: sequence, length (u16 BE)     */
+    CMD_STREAMDATA     =  35, /*!< RSSI values of the streamed sweep                        */
+    CMD_STARTZEROSPAN  =  36, /*!< Push RSSI over time at one frequency until CMD_STOPSTREAM */
+    CMD_ZEROSPANDATA   =  37, /*!< Zero span block: sequence, first/last sample us, RSSI     */
+    CMD_ARMTRIGGER     =  38, /*!< Arm the threshold trigger: level, pre, post, flags        */
+    CMD_SETTRIGGERLEVELS = 39, /*!< Per-point trigger levels: first point (u16 BE), levels  */
+    CMD_TRIGGERSWEEP   =  40, /*!< Start of a burst sweep: burst, index, count, trigger, us, length */
+    CMD_STARTCHUNKSTREAM = 41, /*!< Stream each sweep in chunks while it is measured: values per chunk */
+    CMD_SWEEPCHUNK     =  42, /*!< Chunk of the sweep being measured: sequence, first value, length (u16 BE), RSSI */
+    CMD_SETMULTIBAND   =  43, /*!< Sweep up to 3 bands as one: band, start MHz (u16 BE), span index per band */
+    CMD_GETBANDSTATS   =  44, /*!< Band switch times: count, last, max, total us (u32 BE), on the open radio then reopened */
+    CMD_GETPERFSTATS   =  45, /*!< Performance counters: timestamp Hz, count, min, max (u32 BE), sum (u64 BE) each */
+
+    CMD_END,                  /*!< One past the highest command, new commands go above      */
+};
+
+/*!
+ \brief Payload of CMD_SETENCODING, encoding of CMD_GETSPECNOINIT and CMD_STREAMDATA frames
+
+ \enum SA1350Encoding
+*/
+enum SA1350Encoding
+{
+    ENCODING_RAW       =  0,  /*!< One signed byte per RSSI value                           */
+    ENCODING_DELTA     =  1,  /*!< Delta packed frames, decoded by sa1350UnpackFrame()      */
+};
+
+/*!
+ \brief Payload of CMD_SETFRAMING, format of the frames sent by the device
+
+ \enum SA1350Framing
+*/
+enum SA1350Framing
+{
+    FRAMING_V1         =  1,  /*!< 0x2A frames, one byte length                             */
+    FRAMING_V2         =  2,  /*!< 0x2B frames, u16 length, sequence number and sweep id    */
+};
+
+/*!
+ \brief First payload byte of CMD_SETDETECTOR, reduction of the RSSI reads of one step,
+        and last payload byte of CMD_SETDECIMATION, reduction of the points of one bin
+
+ \enum SA1350Detector
+*/
+enum SA1350Detector
+{
+    DETMODE_SAMPLE     =  0,  /*!< Last read                                                */
+    DETMODE_PEAK       =  1,  /*!< Highest read                                             */
+    DETMODE_AVERAGE    =  2,  /*!< Mean of the dBm values                                   */
+    DETMODE_RMS        =  3,  /*!< Mean power in the linear domain                          */
 };
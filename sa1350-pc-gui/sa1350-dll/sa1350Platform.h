@@ -0,0 +1,63 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file sa1350Platform.h
+ \brief Win32 names used by the driver classes, mapped for POSIX builds
+*/
+#pragma once
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+
+typedef unsigned long DWORD; /*!< Win32 double word */
+
+#define INFINITE                        0xFFFFFFFF /*!< Wait without timeout */
+
+#define THREAD_PRIORITY_IDLE            (-15) /*!< Add in-line comment */
+#define THREAD_PRIORITY_LOWEST          (-2)  /*!< Add in-line comment */
+#define THREAD_PRIORITY_BELOW_NORMAL    (-1)  /*!< Add in-line comment */
+#define THREAD_PRIORITY_NORMAL          0     /*!< Add in-line comment */
+#define THREAD_PRIORITY_ABOVE_NORMAL    1     /*!< Add in-line comment */
+#define THREAD_PRIORITY_HIGHEST         2     /*!< Add in-line comment */
+#define THREAD_PRIORITY_TIME_CRITICAL   15    /*!< Add in-line comment */
+
+/*!
+ \brief Suspend the calling thread
+
+ \param ms Time in milliseconds
+*/
+inline void Sleep(DWORD ms)
+{
+    usleep(ms*1000);
+}
+#endif
@@ -37,6 +37,8 @@
 
 using namespace std;
 
+#define FRAME_DATA_SIZE 2560 /*!< Maximum payload length of one frame, a version 2 frame holds a whole sweep */
+
 /*!
  \brief Add brief
 
@@ -93,9 +95,11 @@ typedef struct sUsbDeviceInfo
 typedef struct sFrame
 {
  unsigned char  Cmd;            /*!< Add in-line comment */
- unsigned char  Length;         /*!< Add in-line comment */
- std::string    Data;           /*!< Add in-line comment */
+ unsigned short Length;         /*!< Add in-line comment */
+ unsigned char  Data[FRAME_DATA_SIZE]; /*!< Fixed size payload, no heap allocation per frame */
  unsigned short Crc;            /*!< Add in-line comment */
+ unsigned short SweepId;        /*!< Version 2 frames: sweep, block or burst of the payload, 0 otherwise */
+ unsigned char  Lost;           /*!< Version 2 frames missing right before this one */
 }sFrame;
 
 /*!
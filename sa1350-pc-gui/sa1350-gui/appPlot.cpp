@@ -60,6 +60,7 @@ appPlot::appPlot(QwtPlot *qwtPlot)
     traceCtrl[1] = new appCurve(qwtCtrl,"Trc1",Qt::green );
     traceCtrl[2] = new appCurve(qwtCtrl,"Trc2",Qt::yellow);
     traceCtrl[3] = new appCurve(qwtCtrl,"Trc3",Qt::blue  );
+    zeroSpanCtrl = new appCurve(qwtCtrl,"ZeroSpan",Qt::red);
     // Init Objects
     Init();
 }
@@ -119,11 +120,15 @@ bool appPlot::SetNewSpectrumParameter(int SpecId,sFrqValues *NewParameters,sCali
 bool appPlot::SetSpectrumData(sSpectrum *NewSpectrum)
 {
     bool done = false;
-    if(NewSpectrum)
+    if(NewSpectrum && !flagZeroSpan)
     {
         if(NewSpectrum->SpecId == ActiveSpecId)
         {
-            if(flagDataFirstSpectrum)
+            if(NewSpectrum->Filled < NewSpectrum->Data.count())
+            {// Sweep in progress, the other traces wait for the complete sweep
+                DataCalcClrWrite(&NewSpectrum->Data);
+            }
+            else if(flagDataFirstSpectrum)
             { // First Frame of the new Spectrum
                 DataCalcClrWrite(&NewSpectrum->Data);
                 DataMaxHold = DataClrWrite;
@@ -156,6 +161,119 @@ bool appPlot::SetSpectrumData(sSpectrum *NewSpectrum)
     return(done);
 }
 
+// Public Zero Span Function Defintion
+void appPlot::ZeroSpanOn(double WindowMs)
+{
+    QwtText strText;
+
+    if(!flagZeroSpan)
+    {// Spectrum traces and markers keep their settings for ZeroSpanOff
+        for(int index=0;index<4;index++)
+            traceCtrl[index]->Off();
+        for(int index=0;index<3;index++)
+            markerCtrl[index]->Off();
+        flagZeroSpan = true;
+    };
+
+    ZeroSpanWindowMs = (WindowMs > 0) ? WindowMs : 1;
+    ZeroSpanHead  = 0;
+    ZeroSpanCount = 0;
+    ZeroSpanX.clear();
+    ZeroSpanY.clear();
+
+    strText.setFont(QFont("Arial",9));
+    strText.setText("ms");
+    qwtCtrl->setAxisTitle(QwtPlot::xBottom,strText);
+    SetFrequencyRange(-ZeroSpanWindowMs,0);
+
+    zeroSpanCtrl->SetColor(traceCfg[TRACE_0].Color);
+    zeroSpanCtrl->SetData(&ZeroSpanX,&ZeroSpanY);
+    zeroSpanCtrl->On();
+    qwtCtrl->replot();
+}
+
+void appPlot::ZeroSpanOff(void)
+{
+    QwtText strText;
+
+    if(!flagZeroSpan)
+        return;
+
+    flagZeroSpan = false;
+    zeroSpanCtrl->Off();
+
+    strText.setFont(QFont("Arial",9));
+    strText.setText("MHz");
+    qwtCtrl->setAxisTitle(QwtPlot::xBottom,strText);
+    if(!DataX.isEmpty())
+        SetFrequencyRange(DataX.first(),DataX.last());
+
+    for(int index=0;index<4;index++)
+    {
+        if(traceCfg[index].On)
+        {
+            TraceDataUpdate((eTrace)index);
+            traceCtrl[index]->On();
+        };
+    };
+    for(int index=0;index<3;index++)
+    {
+        if(markerCfg[index].On)
+            markerCtrl[index]->On();
+    };
+    qwtCtrl->replot();
+}
+
+bool appPlot::ZeroSpanIsOn(void)
+{
+    return(flagZeroSpan);
+}
+
+bool appPlot::SetZeroSpanData(sZeroSpanBlock *Block)
+{
+    bool   done = false;
+    int    count;
+    int    slot;
+    double stepUs;
+    double newestUs;
+    double ms;
+
+    if(!Block || !flagZeroSpan || Block->Data.isEmpty())
+        return(done);
+
+    // Samples are evenly spaced between the block times
+    count  = Block->Data.count();
+    stepUs = (count>1) ? (Block->EndUs-Block->StartUs)/(double)(count-1) : 0;
+    for(int index=0;index<count;index++)
+    {
+        ZeroSpanRingUs[ZeroSpanHead]  = Block->StartUs + stepUs*index;
+        ZeroSpanRingdBm[ZeroSpanHead] = Block->Data.at(index);
+        ZeroSpanHead = (ZeroSpanHead+1) % ZEROSPAN_RING_SIZE;
+        if(ZeroSpanCount < ZEROSPAN_RING_SIZE)
+            ZeroSpanCount++;
+    };
+
+    // Unroll oldest to newest, the newest sample is at 0 ms
+    newestUs = Block->EndUs;
+    ZeroSpanX.clear();
+    ZeroSpanY.clear();
+    slot = (ZeroSpanHead - ZeroSpanCount + ZEROSPAN_RING_SIZE) % ZEROSPAN_RING_SIZE;
+    for(int index=0;index<ZeroSpanCount;index++)
+    {
+        ms = (ZeroSpanRingUs.at(slot)-newestUs)/(double)1000.0;
+        if(ms >= -ZeroSpanWindowMs)
+        {
+            ZeroSpanX.append(ms);
+            ZeroSpanY.append(ZeroSpanRingdBm.at(slot));
+        };
+        slot = (slot+1) % ZEROSPAN_RING_SIZE;
+    };
+    zeroSpanCtrl->SetData(&ZeroSpanX,&ZeroSpanY);
+    done = true;
+
+    return(done);
+}
+
 // Public Grid Function Defintion
 void appPlot::GridOff(void)
 {
@@ -571,8 +689,8 @@ void appPlot::TraceSetMode(eTrace traceNr, eTraceMode traceMode)
         TraceDataUpdate(traceNr);
     };
 
-    if(flagOn)
-    {
+    if(flagOn && !flagZeroSpan)
+    {// The time domain view shows the trace again in ZeroSpanOff
         if(!TraceIsOn(traceNr) && traceMode != T_MODE_OFF && traceMode != T_MODE_UNDEFINED)
         {
             TraceOn(traceNr);
@@ -813,6 +931,15 @@ void appPlot::initData(void)
     DataReset(&traceCfg[TRACE_3].DataHoldY,50,-(123));
     DataReset(&DataOffset,50,0);
     flagDataFirstSpectrum = false;
+    // Zero Span
+    flagZeroSpan     = false;
+    ZeroSpanWindowMs = 1;
+    DataReset(&ZeroSpanRingUs,ZEROSPAN_RING_SIZE,0);
+    DataReset(&ZeroSpanRingdBm,ZEROSPAN_RING_SIZE,0);
+    ZeroSpanHead  = 0;
+    ZeroSpanCount = 0;
+    ZeroSpanX.clear();
+    ZeroSpanY.clear();
 }
 
 void appPlot::DataReset(QVector<double> *Data,int newSize, double fillValue)
@@ -1046,6 +1173,7 @@ void appPlot::Init(void)
     traceCtrl[TRACE_1]->Off();
     traceCtrl[TRACE_2]->Off();
     traceCtrl[TRACE_3]->Off();
+    zeroSpanCtrl->Off();
 
     qwtCtrl->replot();
 }
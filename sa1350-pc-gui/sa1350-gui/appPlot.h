@@ -37,6 +37,8 @@
 #include "appMarker.h"
 #include "appTypedef.h"
 
+#define ZEROSPAN_RING_SIZE (8192) /*!< Most zero span samples kept for the time domain view */
+
 /*!
  \brief Add brief
 
@@ -134,6 +136,32 @@ public:
     */
     bool SetSpectrumData(sSpectrum *NewSpectrum);
 
+    // Public Zero Span Function Decleration
+    /*!
+     \brief Show RSSI over time instead of the spectrum, see drvSA1350::zeroSpanStart
+
+     \param WindowMs time shown left of the newest sample
+    */
+    void ZeroSpanOn(double WindowMs);
+    /*!
+     \brief Back to the spectrum and its traces
+
+    */
+    void ZeroSpanOff(void);
+    /*!
+     \brief Time domain view is shown
+
+     \return bool
+    */
+    bool ZeroSpanIsOn(void);
+    /*!
+     \brief Append a block to the time domain view
+
+     \param Block
+     \return bool false: the time domain view is off
+    */
+    bool SetZeroSpanData(sZeroSpanBlock *Block);
+
     // Public Grid Function Decleration
     /*!
      \brief Add brief
@@ -378,6 +406,17 @@ private:
     // Spectrum
     int          ActiveSpecId; /*!< Add in-line comment */
 
+    // Zero Span
+    appCurve        *zeroSpanCtrl;    /*!< Curve of the time domain view */
+    bool            flagZeroSpan;     /*!< Time domain view shown instead of the spectrum */
+    double          ZeroSpanWindowMs; /*!< Time span of the x axis */
+    QVector<double> ZeroSpanRingUs;   /*!< Sample times, ring of ZEROSPAN_RING_SIZE */
+    QVector<double> ZeroSpanRingdBm;  /*!< Samples, ring of ZEROSPAN_RING_SIZE */
+    int             ZeroSpanHead;     /*!< Next ring slot to write */
+    int             ZeroSpanCount;    /*!< Samples held in the ring */
+    QVector<double> ZeroSpanX;        /*!< Plotted ms relative to the newest sample */
+    QVector<double> ZeroSpanY;        /*!< Plotted dBm */
+
     // Data
     bool            flagDataFirstSpectrum; /*!< Add in-line comment */
     QVector<double> DataX;                 /*!< Add in-line comment */
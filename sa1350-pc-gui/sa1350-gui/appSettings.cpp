@@ -119,6 +119,13 @@ bool appSettings::LoadFrqSettings(QString FileName,sFrqSetting *FrqListItem)
             return(false);
         QXmlStreamReader reader(&fileXml);
 
+        // Profiles saved before the detector, bin and chunk settings use one read per step, every point and whole sweeps
+        FrqListItem->Values.DetectorIndex   = 0;
+        FrqListItem->Values.DetectorDwell   = 1;
+        FrqListItem->Values.DecimationBins  = 0;
+        FrqListItem->Values.DecimationIndex = 1;
+        FrqListItem->Values.ChunkValues     = 0;
+
         do
         {
             // N?chsten Token lesen
@@ -141,6 +148,11 @@ bool appSettings::LoadFrqSettings(QString FileName,sFrqSetting *FrqListItem)
                 if(xmlReadInt(&reader,QString("RefDcLevelIndex"    ),FrqListItem->Values.RefDcLevelIndex)){};
                 if(xmlReadDouble(&reader,QString("RBW"             ),FrqListItem->Values.RBW            )){};
                 if(xmlReadInt(&reader,QString("RBWIndex"           ),FrqListItem->Values.RBWIndex       )){};
+                if(xmlReadInt(&reader,QString("DetectorIndex"      ),FrqListItem->Values.DetectorIndex  )){};
+                if(xmlReadInt(&reader,QString("DetectorDwell"      ),FrqListItem->Values.DetectorDwell  )){};
+                if(xmlReadInt(&reader,QString("DecimationBins"     ),FrqListItem->Values.DecimationBins )){};
+                if(xmlReadInt(&reader,QString("DecimationIndex"    ),FrqListItem->Values.DecimationIndex)){};
+                if(xmlReadInt(&reader,QString("ChunkValues"        ),FrqListItem->Values.ChunkValues    )){};
                 {
                     done = true;
                 };
@@ -181,6 +193,11 @@ bool appSettings::SaveFrqSettings(sFrqSetting *FrqListItem)
             xmlWriteItem(&writer,"RefDcLevelIndex"  ,QString("%0").arg((int   )FrqListItem->Values.RefDcLevelIndex));
             xmlWriteItem(&writer,"RBW"              ,QString("%0").arg((double)FrqListItem->Values.RBW            ));
             xmlWriteItem(&writer,"RBWIndex"         ,QString("%0").arg((int   )FrqListItem->Values.RBWIndex       ));
+            xmlWriteItem(&writer,"DetectorIndex"    ,QString("%0").arg((int   )FrqListItem->Values.DetectorIndex  ));
+            xmlWriteItem(&writer,"DetectorDwell"    ,QString("%0").arg((int   )FrqListItem->Values.DetectorDwell  ));
+            xmlWriteItem(&writer,"DecimationBins"   ,QString("%0").arg((int   )FrqListItem->Values.DecimationBins ));
+            xmlWriteItem(&writer,"DecimationIndex"  ,QString("%0").arg((int   )FrqListItem->Values.DecimationIndex));
+            xmlWriteItem(&writer,"ChunkValues"      ,QString("%0").arg((int   )FrqListItem->Values.ChunkValues    ));
             writer.writeEndElement();
             writer.writeEndDocument();
             fileXml.close();
@@ -47,6 +47,7 @@ appStatusBar::appStatusBar(QStatusBar *statusBar)
 
     sbCtrl->addWidget(&txtStatusConnect,1);
     sbCtrl->addWidget(&txtStatusDllVer,1);
+    sbCtrl->addWidget(&txtPerf,1);
     sbCtrl->addWidget(&txtTime,1);
     sbCtrl->addWidget(&imgLogo,1);
 
@@ -90,6 +91,39 @@ void appStatusBar::SetDeviceConnected(sa1350UsbDevice *DevInfo)
 void appStatusBar::SetDeviceDisconnected(void)
 {
     txtStatusConnect.setText("\t Device is NOT connected \t");
+    SetPerfStats(NULL);
+    sbCtrl->update();
+}
+
+void appStatusBar::SetPerfStats(const sPerfStats *Stats)
+{
+    static const char *names[PERF_COUNTER_COUNT] = {
+        "CMD_FS wait [us]", "Settle waits", "RSSI read [us]", "Sweep bytes",
+        "TX wait [us]", "Sweep lock wait [us]", "LCD frame [us]"};
+    QString tip;
+
+    if(!Stats)
+    {
+        txtPerf.setText("");
+        txtPerf.setToolTip("");
+        return;
+    };
+
+    txtPerf.setText(QString("\t FS %0 us, RSSI %1 us, TX wait %2 us, LCD %3 ms \t").arg(
+                        Stats->Counter[PERF_RF_FS_WAIT].Avg,0,'f',0).arg(
+                            Stats->Counter[PERF_RF_RSSI_READ].Avg,0,'f',0).arg(
+                                Stats->Counter[PERF_SPECTRUM_TX_WAIT].Avg,0,'f',0).arg(
+                                    Stats->Counter[PERF_DISPLAY_REDRAW].Avg/1000.0,0,'f',1));
+
+    // Min / average / max of every counter, the times resolve to one timestamp count
+    tip = QString("Firmware counters, timestamp %0 Hz").arg(Stats->TimestampHz,0,'f',0);
+    for(int counter=0;counter<PERF_COUNTER_COUNT;counter++)
+        tip += QString("\n%0: %1 / %2 / %3 (%4 values)").arg(QString(names[counter])).arg(
+                   Stats->Counter[counter].Min,0,'f',1).arg(
+                       Stats->Counter[counter].Avg,0,'f',1).arg(
+                           Stats->Counter[counter].Max,0,'f',1).arg(
+                               Stats->Counter[counter].Count);
+    txtPerf.setToolTip(tip);
     sbCtrl->update();
 }
 
@@ -108,6 +142,9 @@ void appStatusBar::Init(void)
     txtStatusDllVer.setText("\t DLL V--.--, GUI V--.-- \t");
     txtStatusDllVer.setAlignment(Qt::AlignHCenter);
     txtStatusDllVer.setMinimumWidth(100);
+    txtPerf.setText("");
+    txtPerf.setAlignment(Qt::AlignHCenter);
+    txtPerf.setMinimumWidth(100);
     txtTime.setText(QString("\t Time: %0 \t").arg(QTime::currentTime().toString()));
     txtTime.setAlignment(Qt::AlignHCenter);
     txtTime.setMinimumWidth(100);
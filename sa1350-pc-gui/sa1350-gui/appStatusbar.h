@@ -35,6 +35,7 @@
 #include <QStatusBar>
 
 #include "../sa1350-dll/sa1350.h"
+#include "appTypedef.h"
 
 /*!
  \brief Add brief
@@ -76,6 +77,12 @@ public:
 
     */
     void SetDeviceDisconnected(void);
+    /*!
+     \brief Show the averages of the firmware performance counters, all of them in the tooltip
+
+     \param Stats NULL clears the counters
+    */
+    void SetPerfStats(const sPerfStats *Stats);
 
 private slots:
     /*!
@@ -91,6 +98,7 @@ private:
     QPixmap *imgDisconnected; /*!< Add in-line comment */
     QLabel  txtStatusConnect; /*!< Add in-line comment */
     QLabel  txtStatusDllVer;  /*!< Add in-line comment */
+    QLabel  txtPerf;          /*!< Firmware performance counters, see SetPerfStats */
     QLabel  txtTime;          /*!< Add in-line comment */
     QLabel  imgLogo;          /*!< Add in-line comment */
 
@@ -284,6 +284,11 @@ typedef struct _sFrqValues
     signed char    RefDcLevel;        /*!< Add in-line comment */
     int            RBWIndex;          /*!< Add in-line comment */
     double         RBW;               /*!< Add in-line comment */
+    int            DetectorIndex;     /*!< SA1350Detector mode of CMD_SETDETECTOR */
+    int            DetectorDwell;     /*!< RSSI reads per frequency step */
+    int            DecimationBins;    /*!< CMD_SETDECIMATION bins per sweep, 0 for full resolution */
+    int            DecimationIndex;   /*!< SA1350Detector mode reducing the points of a bin */
+    int            ChunkValues;       /*!< CMD_STARTCHUNKSTREAM values per chunk, 0 streams whole sweeps */
 }sFrqValues;
 
 /*!
@@ -428,8 +433,96 @@ typedef struct _sSpectrum
 {
     int SpecId;            /*!< Add in-line comment */
     QVector<double>  Data; /*!< Add in-line comment */
+    int Filled;            /*!< Values of Data from the sweep in progress, the rest from the last one */
 }sSpectrum;
 
+/*!
+ \brief One CMD_ZEROSPANDATA block of RSSI samples at a single frequency
+
+ \typedef struct _sZeroSpanBlock sZeroSpanBlock
+*/
+/*!
+ \brief One CMD_ZEROSPANDATA block of RSSI samples at a single frequency
+
+ \struct _sZeroSpanBlock appTypedef.h "appTypedef.h"
+*/
+typedef struct _sZeroSpanBlock
+{
+    unsigned short   Seq;     /*!< Block sequence number, a gap means blocks were skipped */
+    double           StartUs; /*!< Device time of the first sample in us */
+    double           EndUs;   /*!< Device time of the last sample in us */
+    QVector<double>  Data;    /*!< Samples in dBm, evenly spaced from StartUs to EndUs */
+}sZeroSpanBlock;
+
+/*!
+ \brief Sweeps around one crossing of the CMD_ARMTRIGGER level
+
+ \typedef struct _sTriggerBurst sTriggerBurst
+*/
+/*!
+ \brief Sweeps around one crossing of the CMD_ARMTRIGGER level
+
+ \struct _sTriggerBurst appTypedef.h "appTypedef.h"
+*/
+typedef struct _sTriggerBurst
+{
+    unsigned short   Seq;          /*!< Burst sequence number */
+    int              TriggerIndex; /*!< Index of the sweep that crossed the level */
+    QVector<double>  TimeUs;       /*!< Device time each sweep completed in us */
+    QVector<sSpectrum> Sweeps;     /*!< Sweeps oldest first, pre-trigger sweeps ahead of TriggerIndex */
+}sTriggerBurst;
+
+/*!
+ \brief Firmware performance counters, in the order of the CMD_GETPERFSTATS response
+
+ \enum ePerfCounter
+*/
+enum ePerfCounter
+{
+    PERF_RF_FS_WAIT = 0,    /*!< Wait of the RF task for the CMD_FS of a step in us */
+    PERF_RF_SETTLE_LOOPS,   /*!< RSSI settle waits per step */
+    PERF_RF_RSSI_READ,      /*!< Time of one RSSI read in us */
+    PERF_SPECTRUM_BYTES,    /*!< Bytes queued per sent sweep */
+    PERF_SPECTRUM_TX_WAIT,  /*!< Wait for UART TX queue space per sent sweep in us */
+    PERF_SWEEP_LOCK_WAIT,   /*!< Wait for the sweep of the RF task in us */
+    PERF_DISPLAY_REDRAW,    /*!< Time of one LCD frame in us */
+    PERF_COUNTER_COUNT      /*!< Number of counters */
+};
+
+/*!
+ \brief One firmware performance counter, see ePerfCounter for the unit
+
+ \typedef struct _sPerfCounter sPerfCounter
+*/
+/*!
+ \brief One firmware performance counter, see ePerfCounter for the unit
+
+ \struct _sPerfCounter appTypedef.h "appTypedef.h"
+*/
+typedef struct _sPerfCounter
+{
+    unsigned long    Count; /*!< Values recorded */
+    double           Min;   /*!< Smallest value */
+    double           Max;   /*!< Largest value */
+    double           Avg;   /*!< Mean of all values, 0 without values */
+}sPerfCounter;
+
+/*!
+ \brief Firmware performance counters of one CMD_GETPERFSTATS
+
+ \typedef struct _sPerfStats sPerfStats
+*/
+/*!
+ \brief Firmware performance counters of one CMD_GETPERFSTATS
+
+ \struct _sPerfStats appTypedef.h "appTypedef.h"
+*/
+typedef struct _sPerfStats
+{
+    double           TimestampHz;                  /*!< Timestamp frequency, the resolution of the times */
+    sPerfCounter     Counter[PERF_COUNTER_COUNT];  /*!< Counters since the previous read with Reset */
+}sPerfStats;
+
 /*!
  \brief Add brief
 
@@ -32,11 +32,41 @@
 #include "drvSA1350.h"
 
 #include <QDebug>
+#include <QElapsedTimer>
 
 #include "../sa1350-dll/sa1350Cmd.h"
 
 #define MIN_FW_VERSION		((unsigned short)(0x0103)) /*!<  FW version number in High_byte.Low_byte format  */
 #define NULL_FW_VERSION     ((unsigned short)(0xFFFF)) /*!<  Invalid/Unknown FW version number */
+#define STREAM_FW_VERSION	((unsigned short)(0x0104)) /*!<  First FW version with CMD_STARTSTREAM */
+#define SETSWEEP_FW_VERSION	((unsigned short)(0x0105)) /*!<  First FW version with CMD_SETSWEEP */
+#define SETSWEEP_SIZE		(19)                       /*!<  Payload size of CMD_SETSWEEP */
+#define BAUDRATE_FW_VERSION	((unsigned short)(0x0106)) /*!<  First FW version with CMD_SETBAUDRATE */
+#define DEFAULT_BAUDRATE	(115200UL)                 /*!<  UART rate after connect and CMD_DISCONNECT */
+#define BAUDRATE_SYNC_MS	(250)                      /*!<  CMD_SYNC ACK timeout, longer than the 100 ms firmware window */
+#define ENCODING_FW_VERSION	((unsigned short)(0x0107)) /*!<  First FW version with CMD_SETENCODING */
+#define DETECTOR_FW_VERSION	((unsigned short)(0x0108)) /*!<  First FW version with CMD_SETDETECTOR */
+#define DETECTOR_DWELL_MAX	(16)                       /*!<  Most RSSI reads per step of CMD_SETDETECTOR */
+#define DECIMATION_FW_VERSION	((unsigned short)(0x0109)) /*!<  First FW version with CMD_SETDECIMATION */
+#define DECIMATION_MAX_BINS	(1024)                     /*!<  Most bins per sweep of CMD_SETDECIMATION */
+#define ZEROSPAN_FW_VERSION	((unsigned short)(0x010A)) /*!<  First FW version with CMD_STARTZEROSPAN */
+#define ZEROSPAN_HDR_SIZE	(10)                       /*!<  Sequence and sample times ahead of the CMD_ZEROSPANDATA samples */
+#define TRIGGER_FW_VERSION	((unsigned short)(0x010B)) /*!<  First FW version with CMD_ARMTRIGGER */
+#define TRIGGER_HDR_SIZE	(11)                       /*!<  Payload of CMD_TRIGGERSWEEP */
+#define TRIGGER_LEVELS_MAX	(17)                       /*!<  Most levels per CMD_SETTRIGGERLEVELS */
+#define TRIGGER_FLAG_POINTS	(0x01)                     /*!<  CMD_ARMTRIGGER flag, use the CMD_SETTRIGGERLEVELS levels */
+#define TRIGGER_FLAG_REARM	(0x02)                     /*!<  CMD_ARMTRIGGER flag, arm again after each burst */
+#define CHUNK_FW_VERSION	((unsigned short)(0x010C)) /*!<  First FW version with CMD_STARTCHUNKSTREAM */
+#define CHUNK_HDR_SIZE		(6)                        /*!<  Sequence, first value and length ahead of the CMD_SWEEPCHUNK values */
+#define CHUNK_MAX_VALUES	(249)                      /*!<  Most values per CMD_SWEEPCHUNK */
+#define CHUNK_EMPTY_DBM		(-128.0)                   /*!<  Shown for points not measured yet after the sweep length changed */
+#define FRAMING_FW_VERSION	((unsigned short)(0x010D)) /*!<  First FW version with CMD_SETFRAMING */
+#define PERFSTATS_FW_VERSION	((unsigned short)(0x010F)) /*!<  First FW version with CMD_GETPERFSTATS */
+#define PERFSTATS_HDR_SIZE	(4)                        /*!<  Timestamp frequency ahead of the CMD_GETPERFSTATS counters */
+#define PERFSTATS_COUNTER_SIZE	(20)                       /*!<  Count, min, max and sum of one CMD_GETPERFSTATS counter */
+
+/*! UART rates of CMD_SETBAUDRATE, fastest first and the default rate last */
+static const unsigned long baudRates[] = {921600, 460800, 230400, DEFAULT_BAUDRATE};
 
 drvSA1350::drvSA1350()
 {
@@ -46,6 +76,15 @@ drvSA1350::drvSA1350()
     Status.flagSpecTrigger      = false;
     Status.flagSpecIsBusy       = false;
     Status.flagSpecNewParameter = false;
+    Status.flagSpecContinuousModeOn = false;
+    Status.flagSpecStreamStop   = false;
+    Status.flagZeroSpanStart    = false;
+    Status.flagZeroSpanOn       = false;
+    Status.flagZeroSpanStop     = false;
+    Status.flagTriggerArm       = false;
+    Status.flagTriggerOn        = false;
+    Status.flagTriggerStop      = false;
+    Status.flagPerfStatsRequest = false;
 
     Status.flagDevInfoLoaded    = false;
 
@@ -54,10 +93,32 @@ drvSA1350::drvSA1350()
     signalSpecIsBusy            = new cThreads::cEvent(true);
     signalSpecNewParameter      = new cThreads::cEvent(true);
     signalSpecTrigger           = new cThreads::cEvent(true);
+    signalWakeUp                = new cThreads::cEvent(false);
 
     currentSpectrumId = 0;
     DecoderSpectrumBuffer.clear();
     SpectrumBuffer.clear();
+    streamSeq      = 0;
+    streamLength   = 0;
+    streamReceived = 0;
+    activeBaudRate = DEFAULT_BAUDRATE;
+    specEncoding   = ENCODING_RAW;
+    specFraming    = FRAMING_V1;
+    zeroSpanFrq      = 0.0;
+    zeroSpanInterval = 0;
+    deviceLastUs     = 0;
+    deviceWrapUs     = 0.0;
+    ZeroSpanBuffer.clear();
+    triggerLevel      = 0.0;
+    triggerPre        = 0;
+    triggerPost       = 0;
+    triggerReArm      = false;
+    triggerSweepIndex = 0;
+    triggerSweepCount = 0;
+    triggerSweepUs    = 0.0;
+    TriggerBuffer.clear();
+    perfStatsReset    = false;
+    PerfStatsBuffer.clear();
 
     sa1350Init();
     if(sa1350IsInit())
@@ -82,6 +143,7 @@ drvSA1350::~drvSA1350()
     delete signalSpecIsBusy;
     delete signalSpecNewParameter;
     delete signalSpecTrigger;
+    delete signalWakeUp;
 }
 
 // Public Function Defintion
@@ -137,10 +199,26 @@ bool drvSA1350::deviceConnect(sa1350UsbDevice *usbInfo)
         Status.flagSpecTrigger       = false;
         Status.flagSpecIsBusy        = false;
         Status.flagSpecNewParameter  = false;
+        Status.flagSpecContinuousModeOn = false;
+        Status.flagSpecStreamStop    = false;
+        Status.flagZeroSpanStart     = false;
+        Status.flagZeroSpanOn        = false;
+        Status.flagZeroSpanStop      = false;
+        Status.flagTriggerArm        = false;
+        Status.flagTriggerOn         = false;
+        Status.flagTriggerStop       = false;
+        Status.flagPerfStatsRequest  = false;
 
         currentSpectrumId     = 0;
         DecoderSpectrumBuffer.clear();
         SpectrumBuffer.clear();
+        ZeroSpanBuffer.clear();
+        TriggerBuffer.clear();
+        PerfStatsBuffer.clear();
+        streamLength          = 0;
+        activeBaudRate        = DEFAULT_BAUDRATE;
+        specEncoding          = ENCODING_RAW;
+        specFraming           = FRAMING_V1;
 
         signalDeviceOpen->Signal();
         return(true);
@@ -233,6 +311,7 @@ bool drvSA1350::spectrumSetParameter(sFrqValues *FrqValues)
         Status.activeFrqValues = *FrqValues;
 
         Status.flagSpecNewParameter = true;
+        signalWakeUp->Signal();
         done = true;
     };
 
@@ -256,6 +335,7 @@ bool drvSA1350::spectrumTriggerOn(void)
 {
     bool done = false;
     Status.flagSpecTrigger = true;
+    signalWakeUp->Signal();
 
     return(done);
 }
@@ -264,6 +344,11 @@ bool drvSA1350::spectrumTriggerOff(void)
 {
     bool done = false;
     Status.flagSpecTrigger = false;
+    if(Status.flagSpecContinuousModeOn)
+    {
+        Status.flagSpecStreamStop = true;
+        signalWakeUp->Signal();
+    };
 
     return(done);
 }
@@ -281,6 +366,131 @@ bool drvSA1350::spectrumGetData(sSpectrum *Spectrum)
     return(done);
 }
 
+bool drvSA1350::zeroSpanStart(double FrqMHz, unsigned long IntervalUs)
+{
+    bool done = false;
+    if(signalDeviceOpen->Check() && Status.flagDevInfoLoaded && FwSupportsZeroSpan())
+    {
+        zeroSpanFrq      = FrqMHz;
+        zeroSpanInterval = (IntervalUs > ZEROSPAN_MAX_INTERVAL) ? ZEROSPAN_MAX_INTERVAL : IntervalUs;
+
+        Status.flagZeroSpanStop  = false;
+        Status.flagZeroSpanStart = true;
+        Status.flagTriggerArm    = false;
+        signalWakeUp->Signal();
+        done = true;
+    };
+
+    return(done);
+}
+
+bool drvSA1350::zeroSpanStop(void)
+{
+    bool done = false;
+    if(signalDeviceOpen->Check())
+    {
+        Status.flagZeroSpanStart = false;
+        Status.flagZeroSpanStop  = true;
+        signalWakeUp->Signal();
+        done = true;
+    };
+
+    return(done);
+}
+
+bool drvSA1350::zeroSpanGetData(sZeroSpanBlock *Block)
+{
+    bool done = false;
+    if(!Block || ZeroSpanBuffer.isEmpty())
+        return(done);
+
+    *Block = ZeroSpanBuffer.first();
+    ZeroSpanBuffer.pop_front();
+    done = true;
+
+    return(done);
+}
+
+bool drvSA1350::triggerArm(double LeveldBm, unsigned char Pre, unsigned char Post, bool ReArm,
+                           const QVector<double> *PointLevels)
+{
+    bool done = false;
+    if(signalDeviceOpen->Check() && Status.flagDevInfoLoaded && FwSupportsTrigger()
+            && ((Pre + Post) <= TRIGGER_MAX_SWEEPS))
+    {
+        triggerLevel = LeveldBm;
+        triggerPre   = Pre;
+        triggerPost  = Post;
+        triggerReArm = ReArm;
+        triggerPointLevels.clear();
+        if(PointLevels)
+            triggerPointLevels = PointLevels->mid(0,TRIGGER_MAX_POINTS);
+
+        Status.flagTriggerStop   = false;
+        Status.flagTriggerArm    = true;
+        Status.flagZeroSpanStart = false;
+        signalWakeUp->Signal();
+        done = true;
+    };
+
+    return(done);
+}
+
+bool drvSA1350::triggerDisarm(void)
+{
+    bool done = false;
+    if(signalDeviceOpen->Check())
+    {
+        Status.flagTriggerArm  = false;
+        Status.flagTriggerStop = true;
+        signalWakeUp->Signal();
+        done = true;
+    };
+
+    return(done);
+}
+
+bool drvSA1350::triggerGetData(sTriggerBurst *Burst)
+{
+    bool done = false;
+    if(!Burst || TriggerBuffer.isEmpty())
+        return(done);
+
+    *Burst = TriggerBuffer.first();
+    TriggerBuffer.pop_front();
+    done = true;
+
+    return(done);
+}
+
+bool drvSA1350::perfStatsRequest(bool Reset)
+{
+    bool done = false;
+    if(signalDeviceOpen->Check() && Status.flagDevInfoLoaded && FwSupportsPerfStats())
+    {
+        perfStatsReset = Reset;
+
+        Status.flagPerfStatsRequest = true;
+        signalWakeUp->Signal();
+        done = true;
+    };
+
+    return(done);
+}
+
+bool drvSA1350::perfStatsGet(sPerfStats *Stats)
+{
+    bool done = false;
+    if(!Stats || PerfStatsBuffer.isEmpty())
+        return(done);
+
+    *Stats = PerfStatsBuffer.first();
+    PerfStatsBuffer.pop_front();
+    done = true;
+
+    return(done);
+}
+
 // Public Signals Function Definition
 
 // Public Slot Function Definiton
@@ -291,11 +501,13 @@ void drvSA1350::run(void)
     flagThreadExit = false;
     State = STATE_INIT;
     sa1350Status Status;
+    bool busy;
 
     qDebug()<<"drvSA1350: Start Driver Thread";
 
     do
     {
+        busy = false;
         switch(State)
         {
         case STATE_INIT:
@@ -308,7 +520,7 @@ void drvSA1350::run(void)
             stateSetup();
             break;
         case STATE_RUN:
-            stateRun();
+            busy = stateRun();
             break;
         case STATE_EXIT:
             stateExit();
@@ -327,7 +539,9 @@ void drvSA1350::run(void)
             };
         };
 
-        this->msleep(1);
+        // Keep going without a break while frames are coming in
+        if(!busy)
+            waitForWork();
     }while(!flagThreadExit);
 
     qDebug()<<"drvSA1350: Exit Driver Thread";
@@ -353,7 +567,7 @@ bool drvSA1350::stateInit(void)
 
 bool drvSA1350::stateOpen(void)
 {
-    if(signalDeviceOpen->CheckSignal(1))
+    if(signalDeviceOpen->CheckSignal(DRV_IDLE_WAIT_MS))
     {
         qDebug()<<"drvSA1350: Is Open";
         State = STATE_SETUP;
@@ -373,8 +587,8 @@ bool drvSA1350::stateSetup(void)
     Status.activeDeviceInfo.RBWTableBand1.clear();
     Status.activeDeviceInfo.MaxSpecLength = 0;
 
-    // Firmware Function First
-    if(cmdGetFWVersion(&Status.activeDeviceInfo.FWVersion))
+    // Firmware Function First, at the rate the device was left at
+    if(cmdFindBaudRate() && cmdGetFWVersion(&Status.activeDeviceInfo.FWVersion))
     {
         if(cmdGetDeviceVersion(&Status.activeDeviceInfo.DeviceVersion))
         {
@@ -399,8 +613,17 @@ bool drvSA1350::stateSetup(void)
                 {
                     if(cmdConnect())
                     {
-                        Status.flagDevInfoLoaded = true;
-                        done = true;
+                        if(cmdNegotiateBaudRate())
+                        {
+                            cmdSetEncoding();
+                            cmdSetFraming();
+                            Status.flagDevInfoLoaded = true;
+                            done = true;
+                        }
+                        else
+                        {
+                            emit signalErrorMsg("Device lost during baud rate negotiation");
+                        };
                     }
                     else
                     {
@@ -451,6 +674,36 @@ bool drvSA1350::stateExit(void)
 
 bool drvSA1350::stateRun(void)
 {
+    unsigned short count = 0;
+    bool busy = false;
+
+    statePerfStats();
+    if(stateTrigger(busy))
+        return(busy);
+    if(stateZeroSpan(busy))
+        return(busy);
+
+    if(Status.flagSpecContinuousModeOn)
+    {// The device pushes every sweep, no trigger needed
+        Status.flagSpecTrigger = false;
+        if(Status.flagSpecNewParameter || Status.flagSpecStreamStop)
+        {// Stop the stream before new parameters are set
+            if(!cmdStopStream())
+                emit signalErrorMsg("Failed to stop spectrum stream !!");
+            Status.flagSpecContinuousModeOn = false;
+            Status.flagSpecStreamStop       = false;
+            DecoderSpectrumBuffer.clear();
+            streamLength = 0;
+        }
+        else
+        {
+            GetFrames(DecoderFrames,DECODER_FRAME_BATCH,count);
+            for(unsigned short index=0;index<count;index++)
+                specStreamFrame(&DecoderFrames[index]);
+            return(count>0);
+        };
+    };
+
     if(!Status.flagSpecIsBusy)
     {// Ready to set new spectrum parameter
         if(Status.flagSpecNewParameter)
@@ -461,8 +714,7 @@ bool drvSA1350::stateRun(void)
                 currentSpectrumId++;
                 emit signalNewParameterSet(true,currentSpectrumId);
                 Status.flagSpecNewParameter=false;
-                cmdGetSpectrum();
-                Status.flagSpecIsBusy=true;
+                specStart();
             }
             else
             {// Failed to set new spectrum parameter
@@ -483,35 +735,222 @@ bool drvSA1350::stateRun(void)
         };
     }
     else
-    {// Wait for requested spectrum data
-        if(sa1350IsFrameAvailable())
+    {// Wait for requested spectrum data, drain everything the dll has decoded so far
+        GetFrames(DecoderFrames,DECODER_FRAME_BATCH,count);
+        for(unsigned short index=0;index<count;index++)
         {
-            DecoderFrame.Cmd = 0xff;
-            DecoderFrame.Crc = 0;
-            DecoderFrame.Length = 0;
-            memset(&DecoderFrame.Data[0],0,FRAME_MAX_DATA_LENGTH);
-            if(sa1350GetFrame(&DecoderFrame))
+            switch(DecoderFrames[index].Cmd)
             {
-                switch(DecoderFrame.Cmd)
-                {
-                case CMD_GETSPECNOINIT:
-                    DecoderSpectrumBuffer.append(DecoderFrame);
-                    break;
-                case CMD_GETLASTERROR:
-                    if(DecoderFrame.Length==2)
-                    {// End of requeted spectrum
-                        Status.flagSpecIsBusy = false;
-                        specSave(&DecoderSpectrumBuffer);
-                        DecoderSpectrumBuffer.clear();
-                    };
-                    break;
-                default:
-                    break;
+            case CMD_GETSPECNOINIT:
+                if(specUnpack(&DecoderFrames[index]))
+                    DecoderSpectrumBuffer.append(DecoderFrames[index]);
+                if(specFraming == FRAMING_V2)
+                {// One frame holds the whole spectrum, no CMD_GETLASTERROR follows
+                    Status.flagSpecIsBusy = false;
+                    specSave(&DecoderSpectrumBuffer);
+                    DecoderSpectrumBuffer.clear();
                 };
+                break;
+            case CMD_GETLASTERROR:
+                if(DecoderFrames[index].Length==2)
+                {// End of requeted spectrum
+                    Status.flagSpecIsBusy = false;
+                    specSave(&DecoderSpectrumBuffer);
+                    DecoderSpectrumBuffer.clear();
+                };
+                break;
+            default:
+                break;
             };
         };
     };
-    return(false);
+    return(count>0);
+}
+
+bool drvSA1350::stateZeroSpan(bool &Busy)
+{
+    unsigned short count = 0;
+
+    if(Status.flagZeroSpanStop)
+    {
+        Status.flagZeroSpanStop = false;
+        if(Status.flagZeroSpanOn)
+        {
+            if(!cmdStopStream())
+                emit signalErrorMsg("Failed to stop zero span !!");
+            Status.flagZeroSpanOn = false;
+            // Pending parameters restart the sweep on their own
+            if(!Status.flagSpecNewParameter)
+                specStart();
+        };
+    };
+
+    if(Status.flagZeroSpanStart && !Status.flagSpecIsBusy)
+    {// Waits for a requested spectrum to come in first
+        Status.flagZeroSpanStart = false;
+        if(Status.flagSpecContinuousModeOn)
+        {
+            if(!cmdStopStream())
+                emit signalErrorMsg("Failed to stop spectrum stream !!");
+            Status.flagSpecContinuousModeOn = false;
+            Status.flagSpecStreamStop       = false;
+            DecoderSpectrumBuffer.clear();
+            streamLength = 0;
+        };
+        if(Status.flagZeroSpanOn)
+        {// New frequency or interval, the device retunes
+            cmdStopStream();
+            Status.flagZeroSpanOn = false;
+        };
+
+        ZeroSpanBuffer.clear();
+        deviceLastUs = 0;
+        deviceWrapUs = 0.0;
+        if(cmdStartZeroSpan())
+        {
+            Status.flagZeroSpanOn = true;
+        }
+        else
+        {
+            emit signalErrorMsg("Failed to start zero span !!");
+            if(!Status.flagSpecNewParameter)
+                specStart();
+        };
+    };
+
+    if(!Status.flagZeroSpanOn)
+        return(false);
+
+    // No sweep while zero span runs, new parameters stay pending
+    Status.flagSpecTrigger = false;
+    GetFrames(DecoderFrames,DECODER_FRAME_BATCH,count);
+    for(unsigned short index=0;index<count;index++)
+    {
+        if(DecoderFrames[index].Cmd == CMD_ZEROSPANDATA)
+            zeroSpanSave(&DecoderFrames[index]);
+    };
+    Busy = (count>0);
+
+    return(true);
+}
+
+bool drvSA1350::stateTrigger(bool &Busy)
+{
+    unsigned short count = 0;
+
+    if(Status.flagTriggerStop)
+    {
+        Status.flagTriggerStop = false;
+        if(Status.flagTriggerOn)
+        {
+            if(!cmdStopStream())
+                emit signalErrorMsg("Failed to disarm trigger !!");
+            Status.flagTriggerOn = false;
+            streamLength = 0;
+            // Pending parameters restart the sweep on their own
+            if(!Status.flagSpecNewParameter)
+                specStart();
+        };
+    };
+
+    if(Status.flagTriggerOn && (Status.flagSpecNewParameter || Status.flagZeroSpanStart))
+    {// Disarm while the new sweep is set, armed again afterwards
+        cmdStopStream();
+        Status.flagTriggerOn  = false;
+        Status.flagTriggerArm = !Status.flagZeroSpanStart;
+        streamLength = 0;
+    };
+
+    if(Status.flagTriggerArm && !Status.flagSpecIsBusy && !Status.flagSpecNewParameter)
+    {// Waits for a requested spectrum to come in first
+        Status.flagTriggerArm = false;
+        if(Status.flagSpecContinuousModeOn)
+        {
+            if(!cmdStopStream())
+                emit signalErrorMsg("Failed to stop spectrum stream !!");
+            Status.flagSpecContinuousModeOn = false;
+            Status.flagSpecStreamStop       = false;
+        };
+        if(Status.flagZeroSpanOn || Status.flagTriggerOn)
+        {// New level, the device restarts the ring
+            cmdStopStream();
+            Status.flagZeroSpanOn = false;
+            Status.flagTriggerOn  = false;
+        };
+
+        DecoderSpectrumBuffer.clear();
+        streamLength = 0;
+        TriggerBuffer.clear();
+        deviceLastUs = 0;
+        deviceWrapUs = 0.0;
+        if(cmdArmTrigger())
+        {
+            Status.flagTriggerOn = true;
+        }
+        else
+        {
+            emit signalErrorMsg("Failed to arm trigger !!");
+            specStart();
+        };
+    };
+
+    if(!Status.flagTriggerOn)
+        return(false);
+
+    // No sweep while the trigger is armed
+    Status.flagSpecTrigger = false;
+    GetFrames(DecoderFrames,DECODER_FRAME_BATCH,count);
+    for(unsigned short index=0;index<count;index++)
+        triggerStreamFrame(&DecoderFrames[index]);
+    Busy = (count>0);
+
+    return(true);
+}
+
+void drvSA1350::statePerfStats(void)
+{
+    unsigned char reset;
+    sa1350Frame   frame;
+
+    if(!Status.flagPerfStatsRequest)
+        return;
+    Status.flagPerfStatsRequest = false;
+    reset = perfStatsReset ? 1 : 0;
+
+    if(Status.flagSpecIsBusy || Status.flagSpecContinuousModeOn || Status.flagZeroSpanOn
+            || Status.flagTriggerOn)
+    {// Waiting for the reply would drop the frames of the measurement, GetFrames picks it out
+        sa1350SendCmd(CMD_GETPERFSTATS,&reset,1);
+    }
+    else if(cmdSetX(CMD_GETPERFSTATS,&reset,1) && cmdWaitForData(CMD_GETPERFSTATS,&frame,1000))
+    {// A missing reply is not reported, the next request asks again
+        perfStatsSave(&frame);
+    };
+}
+
+void drvSA1350::waitForWork(void)
+{
+    switch(State)
+    {
+    case STATE_OPEN:
+        // stateOpen already blocks on signalDeviceOpen
+        break;
+    case STATE_RUN:
+        if(Status.flagSpecIsBusy || Status.flagSpecContinuousModeOn || Status.flagZeroSpanOn
+                || Status.flagTriggerOn)
+        {
+            if(!sa1350WaitForFrame(DRV_IDLE_WAIT_MS) && !sa1350IsConnected())
+                this->msleep(1);
+        }
+        else
+        {
+            signalWakeUp->CheckSignal(DRV_IDLE_WAIT_MS);
+        };
+        break;
+    default:
+        this->msleep(1);
+        break;
+    };
 }
 
 // Private SA1350 Command Function Definition
@@ -533,24 +972,52 @@ bool drvSA1350::GetFrame(sa1350Frame *frame)
     return(ok);
 }
 
+bool drvSA1350::GetFrames(sa1350Frame *frames, unsigned short max, unsigned short &count)
+{
+    bool ok = false;
+    unsigned short kept = 0;
+    DrvAccess.lock();
+    ok = sa1350GetFrames(frames,max,count);
+    DrvAccess.unlock();
+
+    // Replies to a CMD_GETPERFSTATS sent during a measurement, see statePerfStats
+    for(unsigned short index=0;index<count;index++)
+    {
+        if(frames[index].Cmd == CMD_GETPERFSTATS)
+            perfStatsSave(&frames[index]);
+        else
+        {
+            if(kept != index)
+                frames[kept] = frames[index];
+            kept++;
+        };
+    };
+    count = kept;
+    return(ok);
+}
+
 bool drvSA1350::cmdWaitForConfirmation(unsigned char Cmd,unsigned long ms)
 {
     bool done = false;
     sa1350Frame rcvFrame;
+    QElapsedTimer timer;
+    qint64 elapsed;
 
-    ms = ms;
-
+    timer.start();
     do
     {
-        if(sa1350IsFrameAvailable())
-            if(sa1350GetFrame(&rcvFrame))
-                if(rcvFrame.Cmd == Cmd && rcvFrame.Length == 0)
-                    done = true;
+        while(!done && sa1350GetFrame(&rcvFrame))
+            if(rcvFrame.Cmd == Cmd && rcvFrame.Length == 0)
+                done = true;
 
-        if(ms==0 && !done)
-            return(false);
-        usleep(1000);
-        ms--;
+        if(!done)
+        {
+            elapsed = timer.elapsed();
+            if(elapsed >= (qint64)ms || !sa1350IsConnected())
+                return(false);
+            // Wakes as soon as the decoder has queued the next frame
+            sa1350WaitForFrame(ms-(unsigned long)elapsed);
+        };
     }while(!done);
 
     return(done);
@@ -560,21 +1027,27 @@ bool drvSA1350::cmdWaitForData(unsigned char Cmd,sa1350Frame *dataFrame, unsigne
 {
     bool done = false;
     sa1350Frame tmpFrame;
+    QElapsedTimer timer;
+    qint64 elapsed;
 
+    timer.start();
     do
     {
-        if(sa1350IsFrameAvailable())
-            if(sa1350GetFrame(&tmpFrame))
-                if(tmpFrame.Cmd == Cmd)
-                    if(tmpFrame.Length)
-                    {
-                        *dataFrame = tmpFrame;
-                        done = true;
-                    };
-        if(ms==0 && !done)
-            return(false);
-        usleep(1000);
-        ms--;
+        while(!done && sa1350GetFrame(&tmpFrame))
+            if(tmpFrame.Cmd == Cmd)
+                if(tmpFrame.Length)
+                {
+                    *dataFrame = tmpFrame;
+                    done = true;
+                };
+
+        if(!done)
+        {
+            elapsed = timer.elapsed();
+            if(elapsed >= (qint64)ms || !sa1350IsConnected())
+                return(false);
+            sa1350WaitForFrame(ms-(unsigned long)elapsed);
+        };
     }while(!done);
 
     return(done);
@@ -880,6 +1353,47 @@ bool drvSA1350::cmdGetSpectrum(void)
     return(done);
 }
 
+bool drvSA1350::cmdStartStream(void)
+{
+    bool done = false;
+
+    if(sa1350SendCmd(CMD_STARTSTREAM,NULL,0))
+    {
+        if(cmdWaitForConfirmation(CMD_STARTSTREAM,500))
+        {
+            done = true;
+        };
+    };
+
+    return(done);
+}
+
+bool drvSA1350::cmdStartChunkStream(int Values)
+{
+    unsigned char u8[1];
+
+    // The device ignores, and does not ACK, sizes out of range
+    u8[0] = (unsigned char)qBound(1,Values,CHUNK_MAX_VALUES);
+
+    return(cmdSetX(CMD_STARTCHUNKSTREAM,u8,1));
+}
+
+bool drvSA1350::cmdStopStream(void)
+{
+    bool done = false;
+
+    // The ACK follows the rest of the sweep in progress
+    if(sa1350SendCmd(CMD_STOPSTREAM,NULL,0))
+    {
+        if(cmdWaitForConfirmation(CMD_STOPSTREAM,1000))
+        {
+            done = true;
+        };
+    };
+
+    return(done);
+}
+
 bool drvSA1350::cmdFlashRead(unsigned short AddrStart, QByteArray *Data, unsigned short Size)
 {
     bool done = false;
@@ -1063,8 +1577,16 @@ bool drvSA1350::cmdSetFrq(sFrqValues *FrqSetting, sFrqValues *FrqCorrected)
     FrqCorrected->RefDcLevel       = FrqSetting->RefDcLevel;
     FrqCorrected->RBWIndex         = FrqSetting->RBWIndex;
     FrqCorrected->RBW              = FrqSetting->RBW;
-
-    if(cmdSetU8(CMD_SETFRANGE,FrqData.FrqRange))
+    FrqCorrected->DetectorIndex    = FrqSetting->DetectorIndex;
+    FrqCorrected->DetectorDwell    = FrqSetting->DetectorDwell;
+    FrqCorrected->DecimationBins   = 0;
+    FrqCorrected->DecimationIndex  = FrqSetting->DecimationIndex;
+
+    if(FwSupportsSetSweep())
+    {// One round trip, the device applies all values at once
+        done = cmdSetSweep(&FrqData);
+    }
+    else if(cmdSetU8(CMD_SETFRANGE,FrqData.FrqRange))
         if(cmdSetU32(CMD_SETFSTART,FrqData.FrqStart))
             if(cmdSetU32(CMD_SETFSTOP,FrqData.FrqStop))
                 if(cmdSetU8(CMD_SETRBW,FrqData.RBW))
@@ -1076,9 +1598,118 @@ bool drvSA1350::cmdSetFrq(sFrqValues *FrqSetting, sFrqValues *FrqCorrected)
                                     done = true;
                                 };
 
+    if(done && FwSupportsDetector())
+        done = cmdSetDetector(FrqSetting);
+
+    if(done && FwSupportsDecimation())
+    {// Older firmware always sends every sweep point
+        done = cmdSetDecimation(FrqSetting);
+        FrqCorrected->DecimationBins = FrqSetting->DecimationBins;
+        _calcDecimation(FrqCorrected);
+    };
+
     return(done);
 }
 
+bool drvSA1350::cmdSetSweep(sFrqParameterBuffer *FrqData)
+{
+    unsigned char u8[SETSWEEP_SIZE];
+
+    // Payloads of CMD_SETFRANGE, FSTART, FSTOP, RBW, FSTEP, STEPCOUNT, SPAN and SPANINDEX
+    u8[0]  = FrqData->FrqRange;
+    u8[1]  = (unsigned char)(FrqData->FrqStart>>24);
+    u8[2]  = (unsigned char)(FrqData->FrqStart>>16);
+    u8[3]  = (unsigned char)(FrqData->FrqStart>> 8);
+    u8[4]  = (unsigned char)(FrqData->FrqStart);
+    u8[5]  = (unsigned char)(FrqData->FrqStop>>24);
+    u8[6]  = (unsigned char)(FrqData->FrqStop>>16);
+    u8[7]  = (unsigned char)(FrqData->FrqStop>> 8);
+    u8[8]  = (unsigned char)(FrqData->FrqStop);
+    u8[9]  = FrqData->RBW;
+    u8[10] = (unsigned char)(FrqData->FrqStepWidth>>24);
+    u8[11] = (unsigned char)(FrqData->FrqStepWidth>>16);
+    u8[12] = (unsigned char)(FrqData->FrqStepWidth>> 8);
+    u8[13] = (unsigned char)(FrqData->FrqStepWidth);
+    u8[14] = (unsigned char)(FrqData->FrqStepCount>>8);
+    u8[15] = (unsigned char)(FrqData->FrqStepCount & 0xff);
+    u8[16] = (unsigned char)(FrqData->FrqSpan>>8);
+    u8[17] = (unsigned char)(FrqData->FrqSpan & 0xff);
+    u8[18] = FrqData->SpanIndex;
+
+    return(cmdSetX(CMD_SETSWEEP,u8,SETSWEEP_SIZE));
+}
+
+bool drvSA1350::cmdSetDetector(sFrqValues *FrqSetting)
+{
+    unsigned char u8[2];
+
+    // The device ignores, and does not ACK, values out of range
+    u8[0] = DETMODE_SAMPLE;
+    if((FrqSetting->DetectorIndex >= DETMODE_SAMPLE) && (FrqSetting->DetectorIndex <= DETMODE_RMS))
+        u8[0] = (unsigned char)FrqSetting->DetectorIndex;
+    u8[1] = 1;
+    if((FrqSetting->DetectorDwell >= 1) && (FrqSetting->DetectorDwell <= DETECTOR_DWELL_MAX))
+        u8[1] = (unsigned char)FrqSetting->DetectorDwell;
+
+    return(cmdSetX(CMD_SETDETECTOR,u8,2));
+}
+
+bool drvSA1350::cmdSetDecimation(sFrqValues *FrqSetting)
+{
+    unsigned char u8[3];
+    int bins = 0;
+
+    // The device ignores, and does not ACK, values out of range
+    if((FrqSetting->DecimationBins > 0) && (FrqSetting->DecimationBins <= DECIMATION_MAX_BINS))
+        bins = FrqSetting->DecimationBins;
+    u8[0] = (unsigned char)(bins>>8);
+    u8[1] = (unsigned char)(bins);
+    u8[2] = DETMODE_PEAK;
+    if((FrqSetting->DecimationIndex >= DETMODE_SAMPLE) && (FrqSetting->DecimationIndex <= DETMODE_RMS))
+        u8[2] = (unsigned char)FrqSetting->DecimationIndex;
+
+    return(cmdSetX(CMD_SETDECIMATION,u8,3));
+}
+
+bool drvSA1350::cmdStartZeroSpan(void)
+{
+    unsigned char u8[6];
+
+    // Frequency in the CMD_SETFSTART format, then the interval
+    u32toPar((unsigned long)lround(zeroSpanFrq*(double)65536.0),&u8[0]);
+    u16toPar((unsigned short)zeroSpanInterval,&u8[4]);
+
+    return(cmdSetX(CMD_STARTZEROSPAN,u8,6));
+}
+
+bool drvSA1350::cmdArmTrigger(void)
+{
+    bool           done = true;
+    unsigned char  u8[2+TRIGGER_LEVELS_MAX];
+    unsigned short offset;
+    int            size;
+
+    // Per-point levels in the largest host frames the device accepts
+    for(offset=0;done && (offset<triggerPointLevels.count());offset+=TRIGGER_LEVELS_MAX)
+    {
+        size = qMin(TRIGGER_LEVELS_MAX,triggerPointLevels.count()-offset);
+        u16toPar(offset,&u8[0]);
+        for(int index=0;index<size;index++)
+            u8[2+index] = (unsigned char)(signed char)qBound(-128L,lround(triggerPointLevels[offset+index]),127L);
+        done = cmdSetX(CMD_SETTRIGGERLEVELS,u8,2+size);
+    };
+    if(!done)
+        return(done);
+
+    u8[0] = (unsigned char)(signed char)qBound(-128L,lround(triggerLevel),127L);
+    u8[1] = triggerPre;
+    u8[2] = triggerPost;
+    u8[3] = (triggerPointLevels.isEmpty() ? 0 : TRIGGER_FLAG_POINTS)
+          | (triggerReArm ? TRIGGER_FLAG_REARM : 0);
+
+    return(cmdSetX(CMD_ARMTRIGGER,u8,4));
+}
+
 // Private SA1350 SetFrq Helper Function Definition
 double drvSA1350::_calcFrqCorrect(double frq)
 {
@@ -1186,6 +1817,37 @@ unsigned char  drvSA1350::_calcFrqGain(unsigned char RefDcLevelIndex)
     return(FrqTableRefLevel[RefDcLevelIndex].RegValue);
 }
 
+void drvSA1350::_calcDecimation(sFrqValues *FrqCorrected)
+{
+    unsigned long length = (unsigned long)((FrqCorrected->FrqSpan*(double)1000.0)/FrqCorrected->FrqStepWidth) + 1;
+    unsigned long factor = 1;
+    unsigned long bins;
+    double        step;
+
+    // Points per bin, same as detectorDecimateFactor() in the firmware
+    if((FrqCorrected->DecimationBins > 0) && ((unsigned long)FrqCorrected->DecimationBins < length))
+        factor = (length + FrqCorrected->DecimationBins - 1)/FrqCorrected->DecimationBins;
+    if(factor == 1)
+        return;
+    bins = (length + factor - 1)/factor;
+
+    // A bin is shown at the centre of its points
+    step = FrqCorrected->FrqStepWidth*(double)factor;
+    FrqCorrected->FrqStart    += (FrqCorrected->FrqStepWidth/(double)1000.0)*(double)(factor - 1)/(double)2.0;
+    FrqCorrected->FrqStepWidth = step;
+    FrqCorrected->FrqSpan      = (step/(double)1000.0)*(double)(bins - 1);
+    // Step counts derived from span and step are truncated, they must still give bins
+    while(
+          ((unsigned long)((FrqCorrected->FrqSpan*(double)1000.0)/step) + 1 < bins)
+          || ((unsigned long)(FrqCorrected->FrqSpan/(step/(double)1000.0)) + 1 < bins)
+          )
+    {
+        FrqCorrected->FrqSpan = nextafter(FrqCorrected->FrqSpan, FrqCorrected->FrqSpan + (double)1.0);
+    };
+    FrqCorrected->FrqStop   = FrqCorrected->FrqStart + FrqCorrected->FrqSpan;
+    FrqCorrected->FrqCenter = FrqCorrected->FrqStart + FrqCorrected->FrqSpan/(double)2.0;
+}
+
 void drvSA1350::u16toPar(unsigned short value, unsigned char *par)
 {
     *par    = (unsigned char) ((value>>8) & 0xff);
@@ -1322,29 +1984,166 @@ bool drvSA1350::GetDataStr(char *Str , int Length)
 // Private SA1350 Spectrum Function Definition
 void drvSA1350::specSave(QList<sa1350Frame> *DecoderBuffer)
 {
-    int index;
     int steps;
     Q_UNUSED(steps)
-    signed char tmpValue;
     sSpectrum spectrum;
 
     if(!DecoderBuffer)
         return;
 
-    spectrum.SpecId = currentSpectrumId;
-    spectrum.Data.clear();
+    specDecode(DecoderBuffer,&spectrum);
+    SpectrumBuffer.append(spectrum);
+    emit signalSpectrumReceived();
+}
+
+void drvSA1350::specDecode(QList<sa1350Frame> *DecoderBuffer, sSpectrum *Spectrum)
+{
+    int index;
+    signed char tmpValue;
+
+    Spectrum->SpecId = currentSpectrumId;
+    Spectrum->Data.clear();
     foreach(sa1350Frame item, *DecoderBuffer)
     {
         for(index=0;index<item.Length;index++)
         {
             tmpValue = (signed char) item.Data[index];
-            spectrum.Data.append(tmpValue);
+            Spectrum->Data.append(tmpValue);
         };
     };
+    Spectrum->Filled = Spectrum->Data.count();
 
+    specOffset(Spectrum);
+}
+
+void drvSA1350::specStart(void)
+{
+    if(Status.activeFrqValues.flagModeContinuous && FwSupportsChunkStream()
+            && (Status.activeFrqValues.ChunkValues > 0) && (Status.activeFrqValues.DecimationBins == 0))
+    {// Chunks show the sweep in progress, they carry every point so display bins stream whole sweeps
+        streamLength = 0;
+        chunkData.clear();
+        if(cmdStartChunkStream(Status.activeFrqValues.ChunkValues))
+        {
+            Status.flagSpecContinuousModeOn = true;
+            return;
+        };
+    };
+
+    if(Status.activeFrqValues.flagModeContinuous && FwSupportsStream())
+    {// Continuous mode without a host round trip per sweep
+        streamLength = 0;
+        if(cmdStartStream())
+        {
+            Status.flagSpecContinuousModeOn = true;
+            return;
+        };
+    };
+
+    cmdGetSpectrum();
+    Status.flagSpecIsBusy = true;
+}
+
+void drvSA1350::specStreamFrame(sa1350Frame *Frame)
+{
+    switch(Frame->Cmd)
+    {
+    case CMD_STREAMSWEEP:
+        if(Frame->Length==4)
+        {// Start of a sweep, drops what is left of an incomplete one
+            streamSeq      = (unsigned short)((Frame->Data[0]<<8) | Frame->Data[1]);
+            streamLength   = (unsigned short)((Frame->Data[2]<<8) | Frame->Data[3]);
+            streamReceived = 0;
+            DecoderSpectrumBuffer.clear();
+        };
+        break;
+    case CMD_STREAMDATA:
+        if(Frame->Lost || (specFraming == FRAMING_V2 && Frame->SweepId != streamSeq))
+        {// Frames of the sweep went missing, wait for the next CMD_STREAMSWEEP
+            DecoderSpectrumBuffer.clear();
+            streamLength = 0;
+            break;
+        };
+        if(streamLength && specUnpack(Frame))
+        {
+            DecoderSpectrumBuffer.append(*Frame);
+            streamReceived += Frame->Length;
+            if(streamReceived >= streamLength)
+            {// Complete sweep, anything longer is a framing error
+                if(streamReceived == streamLength)
+                    specSave(&DecoderSpectrumBuffer);
+                DecoderSpectrumBuffer.clear();
+                streamLength = 0;
+            };
+        };
+        break;
+    case CMD_SWEEPCHUNK:
+        specChunkFrame(Frame);
+        break;
+    default:
+        break;
+    };
+}
+
+void drvSA1350::specChunkFrame(sa1350Frame *Frame)
+{
+    sSpectrum      spectrum;
+    unsigned short seq;
+    unsigned short offset;
+    unsigned short length;
+    int            count;
+
+    if(Frame->Length <= CHUNK_HDR_SIZE)
+        return;
+
+    seq    = (unsigned short)((Frame->Data[0]<<8) | Frame->Data[1]);
+    offset = (unsigned short)((Frame->Data[2]<<8) | Frame->Data[3]);
+    length = (unsigned short)((Frame->Data[4]<<8) | Frame->Data[5]);
+    count  = Frame->Length - CHUNK_HDR_SIZE;
+
+    if(offset==0)
+    {// Start of a sweep, or the sweep in progress restarted
+        streamSeq      = seq;
+        streamReceived = 0;
+    }
+    else if(!streamLength || seq!=streamSeq || offset!=streamReceived)
+    {// A lost chunk drops the rest of the sweep
+        streamLength = 0;
+        return;
+    };
+    if(offset+count > length)
+    {// Framing error
+        streamLength = 0;
+        return;
+    };
+    streamLength = length;
+
+    // Points not measured yet keep the values of the last sweep
+    if(chunkData.count()!=length)
+        chunkData.fill(CHUNK_EMPTY_DBM,length);
+    for(int index=0;index<count;index++)
+        chunkData[offset+index] = (signed char)Frame->Data[CHUNK_HDR_SIZE+index];
+    streamReceived = offset+count;
+
+    spectrum.SpecId = currentSpectrumId;
+    spectrum.Data   = chunkData;
+    spectrum.Filled = streamReceived;
     specOffset(&spectrum);
     SpectrumBuffer.append(spectrum);
     emit signalSpectrumReceived();
+
+    if(streamReceived==streamLength)
+        streamLength = 0;
+}
+
+bool drvSA1350::specUnpack(sa1350Frame *Frame)
+{
+    bool ok = true;
+
+    if(specEncoding == ENCODING_DELTA)
+        ok = sa1350UnpackFrame(Frame);
+
+    return(ok);
 }
 
 void drvSA1350::specCalcOffset(int SpecId, sFrqValues *FrqValues)
@@ -1386,6 +2185,268 @@ void drvSA1350::specOffset(sSpectrum *Spectrum)
     // };
 }
 
+void drvSA1350::zeroSpanSave(sa1350Frame *Frame)
+{
+    sZeroSpanBlock block;
+    unsigned long  startUs;
+    unsigned long  endUs;
+
+    if(!Frame || Frame->Length < ZEROSPAN_HDR_SIZE)
+        return;
+
+    block.Seq = (unsigned short)((Frame->Data[0]<<8) | Frame->Data[1]);
+    startUs   = ((unsigned long)Frame->Data[2]<<24) | ((unsigned long)Frame->Data[3]<<16)
+              | ((unsigned long)Frame->Data[4]<<8)  |  (unsigned long)Frame->Data[5];
+    endUs     = ((unsigned long)Frame->Data[6]<<24) | ((unsigned long)Frame->Data[7]<<16)
+              | ((unsigned long)Frame->Data[8]<<8)  |  (unsigned long)Frame->Data[9];
+    block.StartUs = deviceTime(startUs);
+    block.EndUs   = deviceTime(endUs);
+
+    block.Data.clear();
+    for(int index=ZEROSPAN_HDR_SIZE;index<Frame->Length;index++)
+        block.Data.append((signed char)Frame->Data[index]);
+
+    ZeroSpanBuffer.append(block);
+    emit signalZeroSpanReceived();
+}
+
+void drvSA1350::perfStatsSave(sa1350Frame *Frame)
+{
+    sPerfStats           stats;
+    unsigned long        values[3];
+    double               sum;
+    double               scale;
+    const unsigned char *data;
+
+    // The ACK comes without payload
+    if(!Frame || Frame->Length != PERFSTATS_HDR_SIZE + PERF_COUNTER_COUNT*PERFSTATS_COUNTER_SIZE)
+        return;
+
+    stats.TimestampHz = (double)(((unsigned long)Frame->Data[0]<<24) | ((unsigned long)Frame->Data[1]<<16)
+                                 | ((unsigned long)Frame->Data[2]<<8) | (unsigned long)Frame->Data[3]);
+
+    for(int counter=0;counter<PERF_COUNTER_COUNT;counter++)
+    {
+        data = &Frame->Data[PERFSTATS_HDR_SIZE + counter*PERFSTATS_COUNTER_SIZE];
+        for(int index=0;index<3;index++)
+            values[index] = ((unsigned long)data[4*index]<<24) | ((unsigned long)data[4*index+1]<<16)
+                          | ((unsigned long)data[4*index+2]<<8) | (unsigned long)data[4*index+3];
+        sum = 0.0;
+        for(int index=12;index<PERFSTATS_COUNTER_SIZE;index++)
+            sum = sum*256.0 + data[index];
+
+        // Times are in timestamp counts, the other counters count steps and bytes
+        scale = 1.0;
+        if((counter != PERF_RF_SETTLE_LOOPS) && (counter != PERF_SPECTRUM_BYTES) && (stats.TimestampHz > 0.0))
+            scale = 1000000.0 / stats.TimestampHz;
+
+        stats.Counter[counter].Count = values[0];
+        stats.Counter[counter].Min   = values[1] * scale;
+        stats.Counter[counter].Max   = values[2] * scale;
+        stats.Counter[counter].Avg   = values[0] ? (sum * scale) / values[0] : 0.0;
+    };
+
+    // Only the latest counters are of interest
+    PerfStatsBuffer.clear();
+    PerfStatsBuffer.append(stats);
+    emit signalPerfStatsReceived();
+}
+
+double drvSA1350::deviceTime(unsigned long Us)
+{
+    if(Us < deviceLastUs)
+        deviceWrapUs += (double)4294967296.0;
+    deviceLastUs = Us;
+
+    return(deviceWrapUs + (double)Us);
+}
+
+void drvSA1350::triggerStreamFrame(sa1350Frame *Frame)
+{
+    sSpectrum     spectrum;
+    unsigned long us;
+
+    switch(Frame->Cmd)
+    {
+    case CMD_TRIGGERSWEEP:
+        if(Frame->Length==TRIGGER_HDR_SIZE)
+        {// Start of a burst sweep, drops what is left of an incomplete one
+            triggerSweepIndex = Frame->Data[2];
+            triggerSweepCount = Frame->Data[3];
+            if(triggerSweepIndex==0)
+            {
+                TriggerBurst.Seq          = (unsigned short)((Frame->Data[0]<<8) | Frame->Data[1]);
+                TriggerBurst.TriggerIndex = Frame->Data[4];
+                TriggerBurst.TimeUs.clear();
+                TriggerBurst.Sweeps.clear();
+            };
+            us = ((unsigned long)Frame->Data[5]<<24) | ((unsigned long)Frame->Data[6]<<16)
+               | ((unsigned long)Frame->Data[7]<<8)  |  (unsigned long)Frame->Data[8];
+            triggerSweepUs = deviceTime(us);
+            streamLength   = (unsigned short)((Frame->Data[9]<<8) | Frame->Data[10]);
+            streamReceived = 0;
+            DecoderSpectrumBuffer.clear();
+        };
+        break;
+    case CMD_STREAMDATA:
+        if(Frame->Lost)
+        {// Frames of the sweep went missing, the burst is incomplete
+            DecoderSpectrumBuffer.clear();
+            streamLength = 0;
+            break;
+        };
+        if(streamLength && specUnpack(Frame))
+        {
+            DecoderSpectrumBuffer.append(*Frame);
+            streamReceived += Frame->Length;
+            if(streamReceived >= streamLength)
+            {// Complete sweep, anything longer is a framing error
+                if((streamReceived == streamLength)
+                        && (TriggerBurst.Sweeps.count() == triggerSweepIndex))
+                {
+                    specDecode(&DecoderSpectrumBuffer,&spectrum);
+                    TriggerBurst.TimeUs.append(triggerSweepUs);
+                    TriggerBurst.Sweeps.append(spectrum);
+                    if(TriggerBurst.Sweeps.count() == triggerSweepCount)
+                    {// Only complete bursts, TriggerIndex counts on every sweep
+                        TriggerBuffer.append(TriggerBurst);
+                        emit signalTriggerReceived();
+                    };
+                };
+                DecoderSpectrumBuffer.clear();
+                streamLength = 0;
+            };
+        };
+        break;
+    default:
+        break;
+    };
+}
+
+bool drvSA1350::cmdSync(unsigned long ms)
+{
+    bool done = false;
+
+    if(sa1350SendCmd(CMD_SYNC,NULL,0))
+    {
+        if(cmdWaitForConfirmation(CMD_SYNC,ms))
+        {
+            done = true;
+        };
+    };
+
+    return(done);
+}
+
+bool drvSA1350::cmdSetBaudRate(unsigned long BaudRate)
+{
+    bool done = false;
+    unsigned char u8[4];
+
+    u32toPar(BaudRate,u8);
+    if(sa1350SendCmd(CMD_SETBAUDRATE,u8,4))
+    {
+        if(cmdWaitForConfirmation(CMD_SETBAUDRATE,500))
+        {
+            // The device switched after its ACK and waits for CMD_SYNC at the new rate
+            if(sa1350SetBaudRate(BaudRate))
+                done = cmdSync(BAUDRATE_SYNC_MS);
+
+            if(done)
+            {
+                activeBaudRate = BaudRate;
+            }
+            else
+            {
+                // The device is back at the old rate once its sync window closed
+                sa1350SetBaudRate(activeBaudRate);
+            };
+        };
+    };
+
+    return(done);
+}
+
+bool drvSA1350::cmdFindBaudRate(void)
+{
+    unsigned int i;
+
+    // After a reset or CMD_DISCONNECT the device is at the default rate
+    if(cmdSync(BAUDRATE_SYNC_MS))
+        return(true);
+
+    // A device left at a raised rate by a host that went away. The frames
+    // sent at other rates make it fall back to the default rate, tried last.
+    for(i=0; i<sizeof(baudRates)/sizeof(baudRates[0]); i++)
+    {
+        if(sa1350SetBaudRate(baudRates[i]) && cmdSync(BAUDRATE_SYNC_MS))
+        {
+            qDebug()<<"drvSA1350: Device found at baud rate"<<baudRates[i];
+            activeBaudRate = baudRates[i];
+            return(true);
+        };
+    };
+
+    sa1350SetBaudRate(activeBaudRate);
+    return(false);
+}
+
+bool drvSA1350::cmdNegotiateBaudRate(void)
+{
+    unsigned int i;
+
+    if(!FwSupportsBaudRate())
+        return(true);
+
+    for(i=0; baudRates[i]!=DEFAULT_BAUDRATE; i++)
+    {
+        if(cmdSetBaudRate(baudRates[i]))
+        {
+            qDebug()<<"drvSA1350: Baud rate"<<baudRates[i];
+            return(true);
+        };
+        // A failed attempt leaves both sides at the previous rate
+        if(!cmdSync(500))
+            return(false);
+    };
+
+    return(true);
+}
+
+bool drvSA1350::cmdSetFraming(void)
+{
+    bool done = false;
+
+    specFraming = FRAMING_V1;
+    if(FwSupportsFraming())
+    {
+        if(cmdSetU8(CMD_SETFRAMING,FRAMING_V2))
+        {
+            specFraming = FRAMING_V2;
+            done = true;
+        };
+    };
+
+    return(done);
+}
+
+bool drvSA1350::cmdSetEncoding(void)
+{
+    bool done = false;
+
+    specEncoding = ENCODING_RAW;
+    if(FwSupportsEncoding())
+    {
+        if(cmdSetU8(CMD_SETENCODING,ENCODING_DELTA))
+        {
+            specEncoding = ENCODING_DELTA;
+            done = true;
+        };
+    };
+
+    return(done);
+}
+
 // Private SA1350 Firmware Updater Definition
 bool drvSA1350::FwVersionIsOk(void)
 {
@@ -1401,3 +2462,168 @@ bool drvSA1350::FwVersionIsOk(void)
 
     return(ok);
 }
+
+bool drvSA1350::FwSupportsSetSweep(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= SETSWEEP_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsStream(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= STREAM_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsBaudRate(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= BAUDRATE_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsDecimation(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= DECIMATION_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsZeroSpan(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= ZEROSPAN_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsFraming(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= FRAMING_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsPerfStats(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= PERFSTATS_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsChunkStream(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= CHUNK_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsTrigger(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= TRIGGER_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsDetector(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= DETECTOR_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
+
+bool drvSA1350::FwSupportsEncoding(void)
+{
+    bool ok = false;
+
+    if(
+            (Status.activeDeviceInfo.FWVersion >= ENCODING_FW_VERSION)
+            && (Status.activeDeviceInfo.FWVersion != NULL_FW_VERSION)
+            )
+    {
+        ok = true;
+    };
+
+    return(ok);
+}
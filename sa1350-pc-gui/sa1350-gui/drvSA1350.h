@@ -65,6 +65,12 @@ enum  eDrvState
 #define FLASH_SEGMENT_SIZE    ((unsigned short) (512))   /*!< Add in-line comment */
 #define PROGTYPE_CALC         ((unsigned short) ( 62))   /*!< Add in-line comment */
 
+#define DECODER_FRAME_BATCH   ((unsigned short) ( 32))   /*!< Frames fetched from the dll per sa1350GetFrames call */
+#define DRV_IDLE_WAIT_MS      ((unsigned long)  ( 20))   /*!< Longest idle wait before USB removal is checked again */
+#define ZEROSPAN_MAX_INTERVAL ((unsigned long)  (65535)) /*!< Longest sample interval of CMD_STARTZEROSPAN in us */
+#define TRIGGER_MAX_SWEEPS    ((unsigned char)  (  3))   /*!< Most sweeps before and after the trigger sweep together */
+#define TRIGGER_MAX_POINTS    ((int)            (512))   /*!< Longest sweep checked by the trigger */
+
 /*!
  \brief Add brief
 
@@ -82,7 +88,15 @@ typedef struct sStatusSA1350
     bool   flagSpecTrigger;                     /*!< Add in-line comment */
     bool   flagSpecIsBusy;                      /*!< Add in-line comment */
     bool   flagSpecNewParameter;                /*!< Add in-line comment */
-    bool   flagSpecContinuousModeOn;            /*!< Add in-line comment */
+    bool   flagSpecContinuousModeOn;            /*!< Device pushes every sweep, see CMD_STARTSTREAM */
+    bool   flagSpecStreamStop;                  /*!< Stop of the sweep stream requested */
+    bool   flagZeroSpanStart;                   /*!< Zero span at zeroSpanFrq requested, see CMD_STARTZEROSPAN */
+    bool   flagZeroSpanOn;                      /*!< Device pushes zero span blocks instead of sweeps */
+    bool   flagZeroSpanStop;                    /*!< Return to the sweep requested */
+    bool   flagTriggerArm;                      /*!< Arming the trigger requested, see CMD_ARMTRIGGER */
+    bool   flagTriggerOn;                       /*!< Device pushes trigger bursts instead of sweeps */
+    bool   flagTriggerStop;                     /*!< Disarm and return to the sweep requested */
+    bool   flagPerfStatsRequest;                /*!< CMD_GETPERFSTATS requested, see perfStatsRequest */
     bool   flagDevInfoLoaded;                   /*!< Add in-line comment */
     sCalibrationData  activeCalData;            /*!< Add in-line comment */
     sa1350UsbDevice   activeUsbInterface;       /*!< Add in-line comment */
@@ -202,6 +216,79 @@ public:
      \return bool
     */
     bool spectrumGetData(sSpectrum *Spectrum);
+    /*!
+     \brief Sample the RSSI over time at one frequency instead of sweeping
+
+       Needs a connected device with FW 1.10 or newer. FrqMHz must lie in
+       the band of the active sweep. Calling it again while zero span runs
+       moves to the new frequency and interval.
+
+     \param FrqMHz
+     \param IntervalUs time between samples, 0 for the fastest rate
+     \return bool false: not connected or not supported by the firmware
+    */
+    bool zeroSpanStart(double FrqMHz, unsigned long IntervalUs);
+    /*!
+     \brief Stop zero span, the sweep continues as before
+
+     \return bool
+    */
+    bool zeroSpanStop(void);
+    /*!
+     \brief Take the oldest received zero span block
+
+     \param Block
+     \return bool false: no block left
+    */
+    bool zeroSpanGetData(sZeroSpanBlock *Block);
+    /*!
+     \brief Send only the sweeps around a level crossing instead of every sweep
+
+       Needs a connected device with FW 1.11 or newer. The device checks
+       sweeps of up to TRIGGER_MAX_POINTS points. Calling it again while
+       armed changes the level and restarts the pre-trigger ring. Zero span
+       stops, new sweep parameters disarm and arm again.
+
+     \param LeveldBm level crossed by any point of a sweep
+     \param Pre sweeps sent before the trigger sweep
+     \param Post sweeps sent after the trigger sweep
+     \param ReArm false: disarm after the first burst
+     \param PointLevels one level per sweep point instead of LeveldBm, may be NULL
+     \return bool false: not connected, not supported by the firmware or
+       Pre and Post above TRIGGER_MAX_SWEEPS
+    */
+    bool triggerArm(double LeveldBm, unsigned char Pre, unsigned char Post, bool ReArm,
+                    const QVector<double> *PointLevels = NULL);
+    /*!
+     \brief Disarm the trigger, the sweep continues as before
+
+     \return bool
+    */
+    bool triggerDisarm(void);
+    /*!
+     \brief Take the oldest received trigger burst
+
+     \param Burst
+     \return bool false: no burst left
+    */
+    bool triggerGetData(sTriggerBurst *Burst);
+    /*!
+     \brief Ask the device for its performance counters, see signalPerfStatsReceived
+
+       Needs a connected device with FW 1.15 or newer. A running sweep,
+       zero span or trigger goes on, the reply is picked out of its frames.
+
+     \param Reset true: the device clears the counters after sending them
+     \return bool false: not connected or not supported by the firmware
+    */
+    bool perfStatsRequest(bool Reset);
+    /*!
+     \brief Take the latest received performance counters
+
+     \param Stats
+     \return bool false: none received since the last call
+    */
+    bool perfStatsGet(sPerfStats *Stats);
 
 signals:
     /*!
@@ -232,6 +319,21 @@ signals:
 
     */
     void signalSpectrumReceived(void);
+    /*!
+     \brief New blocks wait in zeroSpanGetData
+
+    */
+    void signalZeroSpanReceived(void);
+    /*!
+     \brief New bursts wait in triggerGetData
+
+    */
+    void signalTriggerReceived(void);
+    /*!
+     \brief New performance counters wait in perfStatsGet
+
+    */
+    void signalPerfStatsReceived(void);
     /*!
      \brief Add brief
 
@@ -256,12 +358,37 @@ private:
     cThreads::cEvent *signalSpecIsBusy;         /*!< Add in-line comment */
     cThreads::cEvent *signalSpecNewParameter;   /*!< Add in-line comment */
     cThreads::cEvent *signalSpecTrigger;        /*!< Add in-line comment */
+    cThreads::cEvent *signalWakeUp;             /*!< Auto reset, wakes the idle driver thread on new requests */
 
-    sa1350Frame          DecoderFrame;          /*!< Add in-line comment */
+    sa1350Frame          DecoderFrames[DECODER_FRAME_BATCH]; /*!< Add in-line comment */
     int                 currentSpectrumId;      /*!< Add in-line comment */
     QList<sa1350Frame>   DecoderSpectrumBuffer; /*!< Add in-line comment */
     QList<sSpectrum>    SpectrumBuffer;         /*!< Add in-line comment */
     sSpectrumOffset     SpectrumOffset;         /*!< Add in-line comment */
+    unsigned short      streamSeq;              /*!< Sequence number of the streamed sweep being assembled */
+    unsigned short      streamLength;           /*!< Length of the streamed sweep, 0 while waiting for CMD_STREAMSWEEP */
+    unsigned short      streamReceived;         /*!< Values of the streamed sweep received so far */
+    QVector<double>     chunkData;              /*!< Sweep assembled from CMD_SWEEPCHUNK, the last one beyond streamReceived */
+    unsigned long       activeBaudRate;         /*!< UART rate of the comport and the device */
+    unsigned char       specEncoding;           /*!< SA1350Encoding of CMD_GETSPECNOINIT and CMD_STREAMDATA frames */
+    unsigned char       specFraming;            /*!< SA1350Framing of the device frames */
+    double              zeroSpanFrq;            /*!< Requested zero span frequency in MHz */
+    unsigned long       zeroSpanInterval;       /*!< Requested zero span sample interval in us */
+    unsigned long       deviceLastUs;           /*!< Last device time seen, to detect its wrap around */
+    double              deviceWrapUs;           /*!< Device time lost to wrap arounds since zero span or the trigger started */
+    QList<sZeroSpanBlock> ZeroSpanBuffer;       /*!< Received zero span blocks not yet taken */
+    double              triggerLevel;           /*!< Trigger level in dBm, see CMD_ARMTRIGGER */
+    unsigned char       triggerPre;             /*!< Sweeps sent before the trigger sweep */
+    unsigned char       triggerPost;            /*!< Sweeps sent after the trigger sweep */
+    bool                triggerReArm;           /*!< Arm again after each burst */
+    QVector<double>     triggerPointLevels;     /*!< Per-point levels in dBm, empty for triggerLevel on all points */
+    unsigned char       triggerSweepIndex;      /*!< Index in the burst of the sweep being assembled */
+    unsigned char       triggerSweepCount;      /*!< Sweeps in the burst being assembled */
+    double              triggerSweepUs;         /*!< Device time of the sweep being assembled */
+    sTriggerBurst       TriggerBurst;           /*!< Burst being assembled */
+    QList<sTriggerBurst> TriggerBuffer;         /*!< Received bursts not yet taken */
+    bool                perfStatsReset;         /*!< Clear the device counters with the next CMD_GETPERFSTATS */
+    QList<sPerfStats>   PerfStatsBuffer;        /*!< Latest received performance counters not yet taken */
     QMutex DrvAccess;                           /*!< Add in-line comment */
 
     volatile eDrvState State;                   /*!< Add in-line comment */
@@ -298,6 +425,30 @@ private:
      \return bool
     */
     bool stateRun(void);
+    /*!
+     \brief Start, run and stop zero span, part of STATE_RUN
+
+     \param Busy set when frames came in
+     \return bool true: zero span owns the device, the sweep waits
+    */
+    bool stateZeroSpan(bool &Busy);
+    /*!
+     \brief Arm, run and disarm the trigger, part of STATE_RUN
+
+     \param Busy set when frames came in
+     \return bool true: the trigger owns the device, the sweep waits
+    */
+    bool stateTrigger(bool &Busy);
+    /*!
+     \brief Send a requested CMD_GETPERFSTATS, part of STATE_RUN
+
+    */
+    void statePerfStats(void);
+    /*!
+     \brief Block until a frame arrives or a new request is posted
+
+    */
+    void waitForWork(void);
 
     // SA1350 Command Function Declaration
     /*!
@@ -313,6 +464,15 @@ private:
      \return bool
     */
     bool GetFrame(sa1350Frame *frame);
+    /*!
+     \brief Fetch all available frames, up to max, with one dll call
+
+     \param frames
+     \param max
+     \param count
+     \return bool
+    */
+    bool GetFrames(sa1350Frame *frames, unsigned short max, unsigned short &count);
     /*!
      \brief Add brief
 
@@ -445,6 +605,68 @@ private:
      \return bool
     */
     bool cmdGetSpectrum(void);
+    /*!
+     \brief Let the device push every completed sweep
+
+     \return bool
+    */
+    bool cmdStartStream(void);
+    /*!
+     \brief Let the device push each sweep in chunks while it is measured
+
+     \param Values per chunk
+     \return bool
+    */
+    bool cmdStartChunkStream(int Values);
+    /*!
+     \brief Stop the sweep stream, frames still in flight are discarded
+
+     \return bool
+    */
+    bool cmdStopStream(void);
+    /*!
+     \brief Send CMD_SYNC and wait for its ACK
+
+     \param ms
+     \return bool
+    */
+    bool cmdSync(unsigned long ms);
+    /*!
+     \brief Switch device and comport to BaudRate, confirmed by a CMD_SYNC handshake
+
+       On failure both sides are back at activeBaudRate.
+
+     \param BaudRate
+     \return bool true: the link runs at BaudRate
+    */
+    bool cmdSetBaudRate(unsigned long BaudRate);
+    /*!
+     \brief Find the rate the device runs at, trying each UART rate with CMD_SYNC
+
+       A device keeps a raised rate until it sees bad frames or an idle link,
+       so a new host may find it at any of them.
+
+     \return bool false: the device answers at no rate
+    */
+    bool cmdFindBaudRate(void);
+    /*!
+     \brief Move the link to the fastest UART rate that passes the CMD_SYNC handshake
+
+     \return bool false: the device no longer answers
+    */
+    bool cmdNegotiateBaudRate(void);
+    /*!
+     \brief Ask the device for delta packed spectrum frames, keeps ENCODING_RAW if unsupported
+
+     \return bool true: frames arrive packed
+    */
+    bool cmdSetEncoding(void);
+    /*!
+     \brief Ask the device for version 2 frames, one frame per sweep with sequence numbers, keeps FRAMING_V1 if unsupported
+
+     \return bool true: frames arrive in version 2 format
+    */
+    bool cmdSetFraming(void);
     /*!
      \brief Add brief
 
@@ -469,6 +691,39 @@ private:
      \return bool
     */
     bool cmdSetFrq(sFrqValues *Values , sFrqValues *FrqCorrected);
+    /*!
+     \brief Send the complete sweep configuration in one CMD_SETSWEEP
+
+     \param FrqData
+     \return bool
+    */
+    bool cmdSetSweep(sFrqParameterBuffer *FrqData);
+    /*!
+     \brief Send the detector mode and RSSI reads per step with CMD_SETDETECTOR
+
+     \param FrqSetting
+     \return bool
+    */
+    bool cmdSetDetector(sFrqValues *FrqSetting);
+    /*!
+     \brief Send the bins per sweep and their reduction with CMD_SETDECIMATION
+
+     \param FrqSetting
+     \return bool
+    */
+    bool cmdSetDecimation(sFrqValues *FrqSetting);
+    /*!
+     \brief Send CMD_STARTZEROSPAN for zeroSpanFrq and zeroSpanInterval
+
+     \return bool
+    */
+    bool cmdStartZeroSpan(void);
+    /*!
+     \brief Send CMD_SETTRIGGERLEVELS if needed and CMD_ARMTRIGGER
+
+     \return bool
+    */
+    bool cmdArmTrigger(void);
 
     // SA1350 SetFrq Helper Function Declaration
     /*!
@@ -527,6 +782,12 @@ private:
      \return unsigned char
     */
     unsigned char _calcFrqGain(unsigned char RefDcLevelIndex);
+    /*!
+     \brief Turn the corrected frequency grid into the grid of the bins sent with CMD_SETDECIMATION
+
+     \param FrqCorrected
+    */
+    void _calcDecimation(sFrqValues *FrqCorrected);
     /*!
      \brief Add brief
 
@@ -596,6 +857,37 @@ private:
      \param DecoderBuffer
     */
     void specSave(QList<sa1350Frame> *DecoderBuffer);
+    /*!
+     \brief Join the frames of one sweep into a spectrum
+
+     \param DecoderBuffer
+     \param Spectrum
+    */
+    void specDecode(QList<sa1350Frame> *DecoderBuffer, sSpectrum *Spectrum);
+    /*!
+     \brief Request the first spectrum after new parameters were set
+
+    */
+    void specStart(void);
+    /*!
+     \brief Assemble streamed sweeps, complete ones are passed to specSave
+
+     \param Frame
+    */
+    void specStreamFrame(sa1350Frame *Frame);
+    /*!
+     \brief Merge a CMD_SWEEPCHUNK into chunkData and pass it on as a spectrum
+
+     \param Frame
+    */
+    void specChunkFrame(sa1350Frame *Frame);
+    /*!
+     \brief Turn a spectrum frame into one signed byte per value as specSave expects
+
+     \param Frame
+     \return bool false: malformed packed frame
+    */
+    bool specUnpack(sa1350Frame *Frame);
     /*!
      \brief Add brief
 
@@ -609,6 +901,31 @@ private:
      \param Spectrum
     */
     void specOffset(sSpectrum *Spectrum);
+    /*!
+     \brief Queue a CMD_ZEROSPANDATA frame for zeroSpanGetData
+
+     \param Frame
+    */
+    void zeroSpanSave(sa1350Frame *Frame);
+    /*!
+     \brief Extend the 32 bit device time in us past its wrap around
+
+     \param Us
+     \return double
+    */
+    double deviceTime(unsigned long Us);
+    /*!
+     \brief Assemble CMD_TRIGGERSWEEP and CMD_STREAMDATA frames into bursts for triggerGetData
+
+     \param Frame
+    */
+    void triggerStreamFrame(sa1350Frame *Frame);
+    /*!
+     \brief Keep the counters of a CMD_GETPERFSTATS frame for perfStatsGet
+
+     \param Frame
+    */
+    void perfStatsSave(sa1350Frame *Frame);
     // SA1350 Firmware Updater Declaration
     /*!
      \brief Add brief
@@ -616,5 +933,71 @@ private:
      \return bool
     */
     bool FwVersionIsOk(void);
+    /*!
+     \brief Firmware supports CMD_STARTSTREAM
+
+     \return bool
+    */
+    bool FwSupportsStream(void);
+    /*!
+     \brief Firmware supports CMD_SETSWEEP
+
+     \return bool
+    */
+    bool FwSupportsSetSweep(void);
+    /*!
+     \brief Firmware supports CMD_SETBAUDRATE
+
+     \return bool
+    */
+    bool FwSupportsBaudRate(void);
+    /*!
+     \brief Firmware supports CMD_SETENCODING
+
+     \return bool
+    */
+    bool FwSupportsEncoding(void);
+    /*!
+     \brief Firmware supports CMD_SETDETECTOR
+
+     \return bool
+    */
+    bool FwSupportsDetector(void);
+    /*!
+     \brief Firmware supports CMD_SETDECIMATION
+
+     \return bool
+    */
+    bool FwSupportsDecimation(void);
+    /*!
+     \brief Firmware supports CMD_STARTZEROSPAN
+
+     \return bool
+    */
+    bool FwSupportsZeroSpan(void);
+    /*!
+     \brief Firmware supports CMD_ARMTRIGGER
+
+     \return bool
+    */
+    bool FwSupportsTrigger(void);
+    /*!
+     \brief Firmware supports CMD_STARTCHUNKSTREAM
+
+     \return bool
+    */
+    bool FwSupportsChunkStream(void);
+    /*!
+     \brief Firmware supports CMD_SETFRAMING
+
+     \return bool
+    */
+    bool FwSupportsFraming(void);
+    /*!
+     \brief Firmware supports CMD_GETPERFSTATS
+
+     \return bool
+    */
+    bool FwSupportsPerfStats(void);
 
 };
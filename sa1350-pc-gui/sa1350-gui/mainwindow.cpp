@@ -42,6 +42,8 @@
 #include "appReportCsv.h"
 
 #define GUI_VERSION		((unsigned short)(0x0103)) /*!<  GUI version number in High_byte.Low_byte format  */
+#define ZEROSPAN_VIEW_SAMPLES	(2000)                     /*!<  Samples across the time domain view at the requested interval */
+#define ZEROSPAN_MIN_INTERVAL	(10)                       /*!<  Device clock tick in us, the interval of "Max" */
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
@@ -153,6 +155,8 @@ void MainWindow::eventSA1350DeviceDisconnected(void)
     ui->tabToolBox->setCurrentIndex(0);
     actionSpectrumStart->setEnabled(false);
     actionSpectrumStop->setEnabled(false);
+    ui->cbZeroSpanOn->setChecked(false);
+    ui->cbTriggerOn->setChecked(false);
 
 }
 
@@ -325,6 +329,45 @@ void MainWindow::eventSA1350SpectrumReceived(void)
     };
 }
 
+void MainWindow::eventSA1350ZeroSpanReceived(void)
+{
+    sZeroSpanBlock block;
+
+    while(deviceCtrl->zeroSpanGetData(&block))
+        plotCtrl->SetZeroSpanData(&block);
+}
+
+void MainWindow::eventSA1350PerfStatsReceived(void)
+{
+    sPerfStats stats;
+
+    if(deviceCtrl->perfStatsGet(&stats))
+        statusbarCtrl->SetPerfStats(&stats);
+}
+
+void MainWindow::eventSA1350TriggerReceived(void)
+{
+    sTriggerBurst burst;
+    sMarkerInfo   minfo;
+    sFrqValues    FrqCorrected;
+    int steps;
+
+    while(deviceCtrl->triggerGetData(&burst))
+    {
+        deviceCtrl->spectrumGetParameter(&ActiveSpecParameter,&FrqCorrected);
+        steps = (unsigned long)((FrqCorrected.FrqSpan*(float)1000.0)/FrqCorrected.FrqStepWidth) + 1;
+        // Oldest first, so the traces end on the post-trigger sweeps
+        for(int index=0;index<burst.Sweeps.count();index++)
+        {
+            if(steps == burst.Sweeps[index].Data.size())
+                plotCtrl->SetSpectrumData(&burst.Sweeps[index]);
+        };
+        plotCtrl->MarkerUpdatePos();
+        plotCtrl->MarkerGetInfo(&minfo);
+        guiDisplayMarkerInfo(&minfo);
+    };
+}
+
 void MainWindow::eventSA1350ErrorMsg(QString Msg)
 {
     QMessageBox::warning(this, tr("SA1350 Device Driver"),Msg,QMessageBox::Ok,QMessageBox::NoButton);
@@ -569,6 +612,8 @@ void MainWindow::eventFrqStepWidthChanged(void)
 void MainWindow::eventTimeDateUpdateTick(void)
 {
     ui->txtGraphDate->setText(QDateTime::currentDateTime().toString());
+    // Counters of the last second, ignored while not connected or by older firmware
+    deviceCtrl->perfStatsRequest(true);
 }
 
 // Hardware Events
@@ -921,6 +966,9 @@ void MainWindow::eventFrqSet(void)
 
     if(guiFrqGetActualSettings(&newFrqValues))
     {
+        // New settings are for the sweep
+        ui->cbZeroSpanOn->setChecked(false);
+
         if(deviceCtrl->spectrumSetParameter(&newFrqValues))
         {
             // Switch off Trace Hold
@@ -964,6 +1012,71 @@ void MainWindow::eventFrqSpectrumStop(void)
     Status.Spectrum.flagModeContinuous = false;
 }
 
+void MainWindow::eventZeroSpanOnOff(bool On)
+{
+    sFrqValues    FrqValues;
+    sFrqValues    FrqCorrected;
+    unsigned long interval = (unsigned long)ui->sbZeroSpanIntervalValue->value();
+
+    if(!On)
+    {
+        deviceCtrl->zeroSpanStop();
+        plotCtrl->ZeroSpanOff();
+        return;
+    };
+    ui->cbTriggerOn->setChecked(false);
+
+    // Samples at the center of the active sweep
+    if(
+            Status.Spectrum.flagActiveFrqValues
+            && deviceCtrl->spectrumGetParameter(&FrqValues,&FrqCorrected)
+            && deviceCtrl->zeroSpanStart(FrqCorrected.FrqCenter,interval)
+            )
+    {
+        plotCtrl->ZeroSpanOn((double)qMax(interval,(unsigned long)ZEROSPAN_MIN_INTERVAL)*ZEROSPAN_VIEW_SAMPLES/(double)1000.0);
+    }
+    else
+    {
+        ui->cbZeroSpanOn->setChecked(false);
+        QMessageBox::warning(this, tr("Zero Span"),tr("Zero span needs a running spectrum and firmware 1.10 or newer"),QMessageBox::Ok,QMessageBox::NoButton);
+    };
+}
+
+void MainWindow::eventZeroSpanIntervalChanged(void)
+{
+    if(ui->cbZeroSpanOn->isChecked())
+        eventZeroSpanOnOff(true);
+}
+
+void MainWindow::eventTriggerOnOff(bool On)
+{
+    if(!On)
+    {
+        deviceCtrl->triggerDisarm();
+        return;
+    };
+    ui->cbZeroSpanOn->setChecked(false);
+
+    if(
+            !Status.Spectrum.flagActiveFrqValues
+            || !deviceCtrl->triggerArm((double)ui->sbTriggerLevelValue->value(),
+                                       (unsigned char)ui->sbTriggerPreValue->value(),
+                                       (unsigned char)ui->sbTriggerPostValue->value(),true)
+            )
+    {
+        ui->cbTriggerOn->setChecked(false);
+        QMessageBox::warning(this, tr("Trigger"),tr("The trigger needs a running spectrum and firmware 1.11 or newer"),QMessageBox::Ok,QMessageBox::NoButton);
+    };
+}
+
+void MainWindow::eventTriggerSettingsChanged(void)
+{
+    ui->sbTriggerPreValue->setMaximum(TRIGGER_MAX_SWEEPS - ui->sbTriggerPostValue->value());
+    ui->sbTriggerPostValue->setMaximum(TRIGGER_MAX_SWEEPS - ui->sbTriggerPreValue->value());
+    if(ui->cbTriggerOn->isChecked())
+        eventTriggerOnOff(true);
+}
+
 void MainWindow::eventFrqSave(void)
 {
     QString     strFileName;
@@ -1330,6 +1443,12 @@ void MainWindow::initGuiEvents(void)
 
     connect(ui->bttnFrqSet,SIGNAL(clicked()),this,SLOT(eventFrqSet()));
     connect(ui->bttnFrqStop,SIGNAL(clicked()),this,SLOT(eventFrqSpectrumStop()));
+    connect(ui->cbZeroSpanOn,SIGNAL(toggled(bool)),this,SLOT(eventZeroSpanOnOff(bool)));
+    connect(ui->sbZeroSpanIntervalValue,SIGNAL(editingFinished()),this,SLOT(eventZeroSpanIntervalChanged()));
+    connect(ui->cbTriggerOn,SIGNAL(toggled(bool)),this,SLOT(eventTriggerOnOff(bool)));
+    connect(ui->sbTriggerLevelValue,SIGNAL(editingFinished()),this,SLOT(eventTriggerSettingsChanged()));
+    connect(ui->sbTriggerPreValue,SIGNAL(editingFinished()),this,SLOT(eventTriggerSettingsChanged()));
+    connect(ui->sbTriggerPostValue,SIGNAL(editingFinished()),this,SLOT(eventTriggerSettingsChanged()));
 
     connect(ui->bttnFrqSettingUndo,SIGNAL(clicked()),this,SLOT(eventFrqUndo()));
     connect(ui->bttnFrqSettingSave,SIGNAL(clicked()),this,SLOT(eventFrqSave()));
@@ -1356,6 +1475,9 @@ void MainWindow::initGuiEvents(void)
     connect(deviceCtrl,SIGNAL(signalDisconnected()),this,SLOT(eventSA1350DeviceDisconnected()));
     connect(deviceCtrl,SIGNAL(signalErrorMsg(QString)),this,SLOT(eventSA1350ErrorMsg(QString)));
     connect(deviceCtrl,SIGNAL(signalSpectrumReceived()),this,SLOT(eventSA1350SpectrumReceived()));
+    connect(deviceCtrl,SIGNAL(signalZeroSpanReceived()),this,SLOT(eventSA1350ZeroSpanReceived()));
+    connect(deviceCtrl,SIGNAL(signalTriggerReceived()),this,SLOT(eventSA1350TriggerReceived()));
+    connect(deviceCtrl,SIGNAL(signalPerfStatsReceived()),this,SLOT(eventSA1350PerfStatsReceived()));
     connect(deviceCtrl,SIGNAL(signalNewParameterSet(bool,int)),this,SLOT(eventSA1350NewParameterSet(bool,int)));
     connect(deviceCtrl,SIGNAL(signalDeviceUpdateRequired(QString)),this,SLOT(eventSA1350FirmwareUpdateRequired(QString)));
 }
@@ -1578,6 +1700,14 @@ bool MainWindow::guiLoadFrqProfile(sFrqSetting *newFrqSetting)
         ui->cbRefDcLevelValue->setCurrentIndex(newFrqSetting->Values.RefDcLevelIndex);
         // Frq RBW Index
         ui->cbResolutionBandWidthInput->setCurrentIndex(newFrqSetting->Values.RBWIndex);
+        // Frq Detector and RSSI reads per step
+        ui->cbDetectorValue->setCurrentIndex(newFrqSetting->Values.DetectorIndex);
+        ui->sbDetectorDwellValue->setValue(newFrqSetting->Values.DetectorDwell);
+        // Frq Display Bins and their reduction
+        ui->sbDecimationBinsValue->setValue(newFrqSetting->Values.DecimationBins);
+        ui->cbDecimationValue->setCurrentIndex(newFrqSetting->Values.DecimationIndex);
+        // Frq Values per chunk of the sweep in progress
+        ui->sbChunkValuesValue->setValue(newFrqSetting->Values.ChunkValues);
         // Frq Sweep
         if(newFrqSetting->Values.flagModeContinuous)
         {// Continuous
@@ -2365,6 +2495,14 @@ bool MainWindow::guiFrqGetActualSettings(sFrqValues *actualFrqValues)
             actualFrqValues->FrqStepWidth    = ui->sbFrqStepwidthInput->value();
 
         };
+        // Detector and RSSI reads per step
+        actualFrqValues->DetectorIndex   = ui->cbDetectorValue->currentIndex();
+        actualFrqValues->DetectorDwell   = ui->sbDetectorDwellValue->value();
+        // Display bins, 0 for every sweep point
+        actualFrqValues->DecimationBins  = ui->sbDecimationBinsValue->value();
+        actualFrqValues->DecimationIndex = ui->cbDecimationValue->currentIndex();
+        // Values per chunk, 0 for whole sweeps
+        actualFrqValues->ChunkValues     = ui->sbChunkValuesValue->value();
         // Continuous and Single Mode
         if(ui->rbSweepModeContinuous->isChecked())
         {
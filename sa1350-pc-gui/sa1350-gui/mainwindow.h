@@ -144,6 +144,21 @@ private slots:
 
     */
     void eventSA1350SpectrumReceived(void);
+    /*!
+     \brief Move the received zero span blocks into the time domain view
+
+    */
+    void eventSA1350ZeroSpanReceived(void);
+    /*!
+     \brief Show the sweeps of the received trigger bursts
+
+    */
+    void eventSA1350TriggerReceived(void);
+    /*!
+     \brief Show the received firmware performance counters in the status bar
+
+    */
+    void eventSA1350PerfStatsReceived(void);
     /*!
      \brief Add brief
 
@@ -459,6 +474,28 @@ private slots:
 
     */
     void eventFrqSpectrumStop(void);
+    /*!
+     \brief Switch between the sweep and zero span at the center frequency
+
+     \param On
+    */
+    void eventZeroSpanOnOff(bool On);
+    /*!
+     \brief Restart a running zero span with the new sample interval
+
+    */
+    void eventZeroSpanIntervalChanged(void);
+    /*!
+     \brief Arm or disarm the threshold trigger
+
+     \param On
+    */
+    void eventTriggerOnOff(bool On);
+    /*!
+     \brief Keep Pre and Post within the device ring and re-arm with the new settings
+
+    */
+    void eventTriggerSettingsChanged(void);
     /*!
      \brief Add brief
 
@@ -0,0 +1,221 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "cPtyPort.h"
+
+using namespace std;
+
+#define PTY_WRITE_CHUNK 64 /*!< Bytes written per pacing step */
+
+/*!
+ \brief Returns the monotonic clock in seconds
+
+ \return double
+*/
+static double monotonicNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return((double)ts.tv_sec + (double)ts.tv_nsec*1e-9);
+}
+
+cPtyPort::cPtyPort()
+{
+    hMaster = -1;
+    hSlave  = -1;
+    Baud    = 0;
+    TxDue   = 0;
+}
+
+cPtyPort::~cPtyPort()
+{
+    Close();
+}
+
+bool cPtyPort::Open(std::string LinkPath, unsigned long Baud)
+{
+    struct termios tio;
+    char *name;
+
+    Close();
+    this->Baud = Baud;
+
+    hMaster = posix_openpt(O_RDWR|O_NOCTTY);
+    if(hMaster<0 || grantpt(hMaster)!=0 || unlockpt(hMaster)!=0 || (name = ptsname(hMaster))==NULL)
+    {
+        Close();
+        return(false);
+    };
+    SlaveName = name;
+
+    // Binary transparent line, like the LaunchPad's USB CDC port
+    hSlave = open(SlaveName.c_str(), O_RDWR|O_NOCTTY);
+    if(hSlave<0 || tcgetattr(hSlave, &tio)!=0)
+    {
+        Close();
+        return(false);
+    };
+    cfmakeraw(&tio);
+    tcsetattr(hSlave, TCSANOW, &tio);
+
+    if(!LinkPath.empty())
+    {
+        unlink(LinkPath.c_str());
+        if(symlink(SlaveName.c_str(), LinkPath.c_str())!=0)
+        {
+            Close();
+            return(false);
+        };
+        LinkName = LinkPath;
+    };
+
+    return(true);
+}
+
+void cPtyPort::Close(void)
+{
+    if(!LinkName.empty())
+    {
+        unlink(LinkName.c_str());
+        LinkName.clear();
+    };
+    if(hSlave>=0)
+        close(hSlave);
+    if(hMaster>=0)
+        close(hMaster);
+    hSlave  = -1;
+    hMaster = -1;
+}
+
+std::string cPtyPort::GetSlaveName(void)
+{
+    return(SlaveName);
+}
+
+bool cPtyPort::Read(std::string &Data, int ms)
+{
+    struct pollfd pfd;
+    char          buffer[256];
+    ssize_t       size;
+
+    Data.clear();
+    pfd.fd     = hMaster;
+    pfd.events = POLLIN;
+    if(poll(&pfd, 1, ms)<0)
+        return(errno==EINTR);
+    if(!(pfd.revents & POLLIN))
+        return(true);
+
+    size = read(hMaster, buffer, sizeof(buffer));
+    if(size<0)
+        return(errno==EINTR || errno==EAGAIN);
+    Data.append(buffer, size);
+
+    return(true);
+}
+
+bool cPtyPort::Write(const std::string &Data)
+{
+    size_t  offset = 0;
+    size_t  chunk;
+    ssize_t size;
+    double  now, wait;
+
+    while(offset<Data.size())
+    {
+        chunk = Data.size()-offset;
+        if(Baud)
+        {
+            // Hold each chunk until the paced line would have sent the previous one
+            if(chunk>PTY_WRITE_CHUNK)
+                chunk = PTY_WRITE_CHUNK;
+            now = monotonicNow();
+            if(TxDue<now)
+                TxDue = now;
+            wait = TxDue - now;
+            if(wait>0)
+                usleep((useconds_t)(wait*1e6));
+            TxDue += (double)chunk*10.0/(double)Baud;
+        };
+
+        size = write(hMaster, Data.data()+offset, chunk);
+        if(size<0)
+        {
+            if(errno==EINTR || errno==EAGAIN)
+                continue;
+            return(false);
+        };
+        offset += size;
+    };
+
+    return(true);
+}
+
+void cPtyPort::SetBaud(unsigned long Baud)
+{
+    this->Baud = Baud;
+}
+
+unsigned long cPtyPort::GetHostBaud(void)
+{
+    static const struct
+    {
+        speed_t       Speed; /*!< termios speed value */
+        unsigned long Bps;   /*!< Bit rate */
+    } rates[] =
+    {
+        {B9600,9600},{B19200,19200},{B38400,38400},{B57600,57600},{B115200,115200},
+        {B230400,230400},{B460800,460800},{B921600,921600}
+    };
+    struct termios tio;
+    speed_t        speed;
+    unsigned int   i;
+
+    if(hSlave<0 || tcgetattr(hSlave, &tio)!=0)
+        return(0);
+    speed = cfgetospeed(&tio);
+    for(i=0; i<sizeof(rates)/sizeof(rates[0]); i++)
+    {
+        if(rates[i].Speed==speed)
+            return(rates[i].Bps);
+    };
+
+    return(0);
+}
@@ -0,0 +1,111 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file cPtyPort.h */
+#pragma once
+#include <string>
+
+using namespace std;
+
+/*!
+ \brief Pseudo-terminal endpoint with optional UART rate pacing
+
+ \class cPtyPort cPtyPort.h "cPtyPort.h"
+*/
+class cPtyPort
+{
+public:
+    /*!
+     \brief Constructor
+
+    */
+    cPtyPort();
+    /*!
+     \brief Destructor
+
+    */
+    ~cPtyPort();
+
+    /*!
+     \brief Create the pty, optionally symlinked to LinkPath
+
+     \param LinkPath Stable name for the slave side, empty for none
+     \param Baud Paced line rate in bit/s, 0 writes as fast as the pty accepts
+     \return bool
+    */
+    bool Open(std::string LinkPath, unsigned long Baud);
+    /*!
+     \brief Remove the link and close the pty
+
+    */
+    void Close(void);
+    /*!
+     \brief Returns the slave device name the host has to open
+
+     \return std::string
+    */
+    std::string GetSlaveName(void);
+    /*!
+     \brief Wait up to ms for host bytes and read them into Data
+
+     \param Data Add param
+     \param ms Add param
+     \return bool false: pty error
+    */
+    bool Read(std::string &Data, int ms);
+    /*!
+     \brief Write Data, paced to 10 bits per byte at the configured rate
+
+     \param Data Add param
+     \return bool false: pty error
+    */
+    bool Write(const std::string &Data);
+    /*!
+     \brief Change the paced line rate, bytes already written keep their timing
+
+     \param Baud Paced line rate in bit/s, 0 writes as fast as the pty accepts
+    */
+    void SetBaud(unsigned long Baud);
+    /*!
+     \brief Returns the rate the host configured on the slave side
+
+     \return unsigned long bit/s, 0 if not a known rate
+    */
+    unsigned long GetHostBaud(void);
+
+private:
+    int           hMaster;    /*!< pty master file descriptor */
+    int           hSlave;     /*!< Kept open so the master survives host reconnects */
+    std::string   SlaveName;  /*!< Add in-line comment */
+    std::string   LinkName;   /*!< Add in-line comment */
+    unsigned long Baud;       /*!< Add in-line comment */
+    double        TxDue;      /*!< Monotonic time the paced line is free again */
+};
@@ -0,0 +1,1196 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "cSimDevice.h"
+#include "sa1350Cmd.h"
+#include "crc16.h"
+#include "specPack.h"
+#include "detector.h"
+
+using namespace std;
+
+#define FRAME_MARKER        0x2A /*!< Frame prefix and CRC seed */
+#define FRAME_HEADER_LENGTH 3    /*!< Prefix, length, command */
+#define FRAME_CRC_LENGTH    2    /*!< CRC high and low byte */
+#define FRAME_V2_MARKER     0x2B /*!< Prefix of a version 2 frame, see CMD_SETFRAMING */
+#define FRAME_V2_HEADER_LENGTH 7 /*!< Prefix, length (u16 BE), command, sequence number, sweep id (u16 BE) */
+
+/*!
+ \brief RBW table entry, see SARBW in rfSweep.c
+*/
+typedef struct sSimRbw
+{
+    double         Rbw;     /*!< Receiver Bandwidth Setting in kHz */
+    unsigned short If;      /*!< Received Intermediate Frequency in kHz */
+    unsigned char  Setting; /*!< rxBw register value */
+}sSimRbw;
+
+/*!
+ \brief Sub-1 GHz and 2.4 GHz RBW tables of rfSweep.c
+*/
+static const sSimRbw RbwTable[2][SIM_RBW_COUNT] =
+{
+    {
+        {38.9,    250, 32}, {49.0,    250, 33}, {58.9,    250, 34},
+        {77.7,    250, 35}, {98.0,    250, 36}, {117.7,   250, 37},
+        {155.4,   500, 38}, {195.9,   500, 39}, {235.5,   500, 40},
+        {310.8,  1000, 41}, {391.8,  1000, 42}, {470.9,  1000, 43},
+        {621.6,  1000, 44}, {783.6,  1000, 45}, {941.8,  1000, 46},
+        {1243.2, 1000, 47}, {1567.2, 1000, 48}, {1883.7, 1000, 49},
+        {2486.5, 1000, 50}, {3134.4, 1000, 51}, {3767.4, 1000, 52}
+    },
+    {
+        {43.5,    250, 32}, {54.9,    250, 33}, {66.0,    250, 34},
+        {87.1,    250, 35}, {109.8,   250, 36}, {131.9,   250, 37},
+        {174.2,   500, 38}, {219.6,   500, 39}, {263.9,   500, 40},
+        {348.3,  1000, 41}, {439.1,  1000, 42}, {527.8,  1000, 43},
+        {696.7,  1000, 44}, {878.2,  1000, 45}, {1055.6, 1000, 46},
+        {1393.3, 1000, 47}, {1756.4, 1000, 48}, {2111.1, 1000, 49},
+        {2786.7, 1000, 50}, {3512.9, 1000, 51}, {4222.2, 1000, 52}
+    }
+};
+
+/*!
+ \brief Band limits in MHz of rfSweep.c, indexed like CMD_SETFRANGE
+*/
+static const unsigned short BandLimits[3][2] =
+{
+    {431, 527}, {861, 1054}, {2152, 2635}
+};
+
+/*!
+ \brief Width in MHz of the EasyRF spans of rfSweep.c, indexed like CMD_SETSPANINDEX
+*/
+static const unsigned short EasySpans[] = {24, 18, 16, 12, 8, 6, 4, 2, 1};
+
+/*!
+ \brief Returns the monotonic clock in seconds
+
+ \return double
+*/
+static double monotonicNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return((double)ts.tv_sec + (double)ts.tv_nsec*1e-9);
+}
+
+/*!
+ \brief Append a big endian value of Size bytes
+
+ \param Data Add param
+ \param Value Add param
+ \param Size Add param
+*/
+static void appendBE(std::string &Data, unsigned long long Value, int Size)
+{
+    while(Size--)
+        Data.push_back((char)((Value >> (8*Size)) & 0xff));
+}
+
+cSimDevice::cSimDevice(const sSimSettings &Settings):Settings(Settings)
+{
+    memset(&Stats,0,sizeof(Stats));
+    Random    = Settings.Seed ? Settings.Seed : 1;
+    Band      = 0;
+    Span      = 0;
+    FreqStep  = 0;
+    StepCount = 0;
+    Streaming = false;
+    StreamSeq = 0;
+    BaudRate     = SIM_DEFAULT_BAUD;
+    PrevBaudRate = SIM_DEFAULT_BAUD;
+    HostBaudRate = 0;
+    SyncDue      = 0;
+    RxErrors     = 0;
+    LastFrame    = monotonicNow();
+    Encoding     = ENCODING_RAW;
+    Framing      = FRAMING_V1;
+    TxSequence   = 0;
+    TxSweepId    = 0;
+    Detector     = DETECTOR_SAMPLE;
+    Dwell        = 1;
+    DecimationBins = 0;
+    DecimationMode = DETECTOR_PEAK;
+    ZeroSpan         = false;
+    ZeroSpanInterval = 0;
+    ZeroSpanSeq      = 0;
+    Trigger          = false;
+    TriggerState     = 0;
+    TriggerLevel     = 127;
+    TriggerPre       = 0;
+    TriggerPost      = 0;
+    TriggerFlags     = 0;
+    TriggerHead      = 0;
+    TriggerFill      = 0;
+    TriggerFirst     = 0;
+    TriggerCount     = 0;
+    TriggerIndex     = 0;
+    TriggerPostLeft  = 0;
+    TriggerSeq       = 0;
+    memset(TriggerLevels,127,sizeof(TriggerLevels));
+    ChunkValues      = 0;
+    ChunkLength      = 0;
+    ChunkOffset      = 0;
+    MultiBandCount   = 0;
+    SwitchCount[0]   = 0;
+    SwitchCount[1]   = 0;
+    memset(PerfCounters,0,sizeof(PerfCounters));
+    buildFlashImage();
+}
+
+void cSimDevice::Receive(const unsigned char *Data, unsigned long Length)
+{
+    unsigned char  length;
+    unsigned short crc;
+    static const char prompt[] = "\n\fConnect SA1350 host application\r\n";
+
+    // A rate mismatch or a rate the bridge cannot pass only delivers garbage
+    if((HostBaudRate && HostBaudRate!=BaudRate) || (Settings.MaxBaud && BaudRate>Settings.MaxBaud))
+    {
+        Stats.BytesGarbled += Length;
+        rxError();
+        return;
+    };
+
+    RxBuffer.append((const char*)Data, Length);
+
+    while(RxBuffer.size() >= FRAME_HEADER_LENGTH)
+    {
+        // The firmware reads the header as one block and answers garbage with its prompt
+        if((unsigned char)RxBuffer[0] != FRAME_MARKER)
+        {
+            RxBuffer.erase(0, FRAME_HEADER_LENGTH);
+            TxBuffer.append(prompt, sizeof(prompt));
+            // At a raised rate it is a host sending at another one
+            if(BaudRate!=SIM_DEFAULT_BAUD)
+                rxError();
+            continue;
+        };
+
+        length = (unsigned char)RxBuffer[1];
+        if(RxBuffer.size() < (size_t)(FRAME_HEADER_LENGTH + length + FRAME_CRC_LENGTH))
+            break;
+
+        crc = crc16Update(FRAME_MARKER, RxBuffer.data()+1, FRAME_HEADER_LENGTH-1+length);
+        if((unsigned char)RxBuffer[FRAME_HEADER_LENGTH+length]   == (crc >> 8) &&
+           (unsigned char)RxBuffer[FRAME_HEADER_LENGTH+length+1] == (crc & 0xff))
+        {
+            Stats.Commands++;
+            RxErrors  = 0;
+            LastFrame = monotonicNow();
+            if(SyncDue)
+            {// Only CMD_SYNC confirms the new rate, anything else falls back
+                if((unsigned char)RxBuffer[2]==CMD_SYNC && length==0)
+                    sendAck(CMD_SYNC);
+                else
+                    BaudRate = PrevBaudRate;
+                SyncDue = 0;
+            }
+            else
+                processCommand((unsigned char)RxBuffer[2], (const unsigned char*)RxBuffer.data()+FRAME_HEADER_LENGTH, length);
+        }
+        else
+        {
+            Stats.CrcErrors++;
+            fprintf(stderr, "sa1350-sim: host command %u with bad CRC dropped\n", (unsigned char)RxBuffer[2]);
+            RxBuffer.erase(0, FRAME_HEADER_LENGTH + length + FRAME_CRC_LENGTH);
+            rxError();
+            continue;
+        };
+        RxBuffer.erase(0, FRAME_HEADER_LENGTH + length + FRAME_CRC_LENGTH);
+    };
+}
+
+bool cSimDevice::GetTxData(std::string &Data)
+{
+    Data.swap(TxBuffer);
+    TxBuffer.clear();
+
+    return(!Data.empty());
+}
+
+const sSimStats &cSimDevice::GetStats(void)
+{
+    return(Stats);
+}
+
+bool cSimDevice::IsStreaming(void)
+{
+    return(Streaming);
+}
+
+unsigned long cSimDevice::GetBaudRate(void)
+{
+    return(BaudRate);
+}
+
+void cSimDevice::SetHostBaudRate(unsigned long BaudRate)
+{
+    HostBaudRate = BaudRate;
+}
+
+bool cSimDevice::IsSyncPending(void)
+{
+    return(SyncDue!=0);
+}
+
+void cSimDevice::CheckSyncTimeout(void)
+{
+    if(SyncDue && monotonicNow()>=SyncDue)
+    {
+        if(Settings.Verbose)
+            fprintf(stderr, "sa1350-sim: no CMD_SYNC at %lu baud, back to %lu\n", BaudRate, PrevBaudRate);
+        BaudRate = PrevBaudRate;
+        SyncDue  = 0;
+        RxBuffer.clear();
+    };
+}
+
+void cSimDevice::CheckLinkIdle(void)
+{
+    if(!Streaming && !SyncDue && BaudRate!=SIM_DEFAULT_BAUD
+            && monotonicNow()-LastFrame>=SIM_IDLE_TIMEOUT)
+    {
+        if(Settings.Verbose)
+            fprintf(stderr, "sa1350-sim: host silent at %lu baud\n", BaudRate);
+        resetHostLink();
+    };
+}
+
+void cSimDevice::StreamSweep(void)
+{
+    unsigned char  rssi[SIM_MAX_SWEEP_LENGTH];
+    unsigned char  header[4];
+    unsigned short length;
+    unsigned long  bytesSent;
+
+    if(ZeroSpan)
+    {
+        streamZeroSpan();
+        return;
+    };
+    if(Trigger)
+    {
+        streamTrigger();
+        return;
+    };
+    if(ChunkValues)
+    {
+        streamChunk();
+        return;
+    };
+
+    length = decimateSweep(rssi, MeasureSweep(rssi));
+    StreamSeq++;
+    header[0] = (unsigned char)(StreamSeq >> 8);
+    header[1] = (unsigned char)(StreamSeq & 0xff);
+    header[2] = (unsigned char)(length >> 8);
+    header[3] = (unsigned char)(length & 0xff);
+    TxSweepId = StreamSeq;
+    sendFrame(CMD_STREAMSWEEP, header, 4);
+    bytesSent = Stats.BytesSent;
+    sendRssi(CMD_STREAMDATA, rssi, length);
+    TxSweepId = 0;
+    recordPerf(SIM_PERF_SPECTRUM_BYTES, Stats.BytesSent - bytesSent);
+    recordPerf(SIM_PERF_TX_WAIT, 0);
+    recordPerf(SIM_PERF_LOCK_WAIT, 0);
+}
+
+unsigned short cSimDevice::MeasureSweep(unsigned char *Rssi)
+{
+    // The firmware answers with the next sweep the RF task completes
+    if(Settings.RadioUs)
+        usleep(sweepLength()*Settings.RadioUs*(1.0 + SIM_DWELL_SHARE*(Dwell-1)));
+
+    return(SynthSweep(Rssi));
+}
+
+unsigned short cSimDevice::SynthSweep(unsigned char *Rssi)
+{
+    unsigned short length = sweepLength();
+    double         carrier, signal;
+    int8_t         samples[DETECTOR_MAX_DWELL];
+
+    countBandSwitches();
+
+    // Noise floor with a carrier drifting across the span from sweep to sweep
+    carrier = fmod(0.25 + 0.01*Stats.Sweeps, 1.0) * length;
+    for(unsigned short index=0; index<length; index++)
+    {
+        signal = 60.0*exp(-pow((index-carrier)/(0.01*length+1.0), 2.0));
+        for(unsigned char read=0; read<Dwell; read++)
+        {
+            samples[read] = (int8_t)(-100.0 + 6.0*nextRandom() + signal);
+            recordPerf(SIM_PERF_RSSI_READ, SIM_RSSI_READ_US);
+        };
+        recordPerf(SIM_PERF_FS_WAIT, Settings.RadioUs);
+        recordPerf(SIM_PERF_SETTLE_LOOPS, 1);
+        Rssi[index] = (unsigned char)detectorReduce(Detector, samples, Dwell);
+    };
+    // A short strong burst now and then
+    if((Stats.Sweeps % SIM_BURST_EVERY) == SIM_BURST_EVERY-1)
+    {
+        for(unsigned short index=3*length/4; index<3*length/4+3 && index<length; index++)
+            Rssi[index] = (unsigned char)(int8_t)(-20.0 + 6.0*nextRandom());
+    };
+    Stats.Sweeps++;
+
+    return(length);
+}
+
+// Private Function Definition
+
+void cSimDevice::processCommand(unsigned char Cmd, const unsigned char *Payload, unsigned char Length)
+{
+    unsigned char  data[4];
+    unsigned short maxLength = SIM_MAX_SWEEP_LENGTH;
+    unsigned char  band;
+    std::string    entry;
+
+    if(Settings.Verbose)
+        fprintf(stderr, "sa1350-sim: command %u length %u\n", Cmd, Length);
+
+    switch(Cmd)
+    {
+    case CMD_DISCONNECT:
+        MultiBandCount = 0;
+        Streaming = false;
+        ZeroSpan  = false;
+        Trigger   = false;
+        ChunkValues = 0;
+        Encoding  = ENCODING_RAW;
+        Detector  = DETECTOR_SAMPLE;
+        Dwell     = 1;
+        DecimationBins = 0;
+        Framing   = FRAMING_V1;
+        sendAck(Cmd);
+        // The next host connects at the default rate
+        BaudRate = SIM_DEFAULT_BAUD;
+        break;
+
+    case CMD_SETBAUDRATE:
+        setBaudRate(Payload, Length);
+        break;
+
+    case CMD_CONNECT:
+        MultiBandCount = 0;
+        Encoding = ENCODING_RAW;
+        Detector = DETECTOR_SAMPLE;
+        Dwell    = 1;
+        DecimationBins = 0;
+        Framing  = FRAMING_V1;
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETFRAMING:
+        // Unknown versions are ignored and not ACKed, the ACK keeps the previous format
+        if(Length!=1 || Payload[0]<FRAMING_V1 || Payload[0]>FRAMING_V2)
+            break;
+        sendAck(Cmd);
+        Framing    = Payload[0];
+        TxSequence = 0;
+        break;
+
+    case CMD_SETENCODING:
+        // Unknown encodings are ignored and not ACKed
+        if(Length!=1 || Payload[0]>ENCODING_DELTA)
+            break;
+        Encoding = Payload[0];
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETDECIMATION:
+        // Invalid settings are ignored and not ACKed
+        if(Length!=3 || ((Payload[0]<<8) | Payload[1])>SIM_DECIMATION_MAX_BINS || Payload[2]>DETECTOR_RMS)
+            break;
+        DecimationBins = (unsigned short)((Payload[0]<<8) | Payload[1]);
+        DecimationMode = Payload[2];
+        sendAck(Cmd);
+        break;
+
+    case CMD_SYNC:
+    case CMD_INITPARAMETER:
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETFSTART:
+    case CMD_SETFSTOP:
+    case CMD_SETSPANINDEX:
+    case CMD_SETRBW:
+        MultiBandCount = 0;
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETFRANGE:
+        MultiBandCount = 0;
+        if(Length>=1 && Payload[0]<=2)
+            Band = Payload[0];
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETFSTEP:
+        MultiBandCount = 0;
+        if(Length>=4)
+            FreqStep = ((unsigned long)Payload[0]<<24) | ((unsigned long)Payload[1]<<16) | ((unsigned long)Payload[2]<<8) | Payload[3];
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETSTEPCOUNT:
+        MultiBandCount = 0;
+        if(Length>=2)
+            StepCount = (unsigned short)((Payload[0]<<8) | Payload[1]);
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETSPAN:
+        MultiBandCount = 0;
+        if(Length>=2)
+            Span = (unsigned short)((Payload[0]<<8) | Payload[1]);
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETSWEEP:
+        // The firmware ignores and does not ACK a partial configuration
+        if(Length!=19)
+            break;
+        MultiBandCount = 0;
+        if(Payload[0]<=2)
+            Band = Payload[0];
+        FreqStep  = ((unsigned long)Payload[10]<<24) | ((unsigned long)Payload[11]<<16) | ((unsigned long)Payload[12]<<8) | Payload[13];
+        StepCount = (unsigned short)((Payload[14]<<8) | Payload[15]);
+        Span      = (unsigned short)((Payload[16]<<8) | Payload[17]);
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETDETECTOR:
+        // Invalid settings are ignored and not ACKed
+        if(Length!=2 || Payload[0]>DETECTOR_RMS || Payload[1]==0 || Payload[1]>DETECTOR_MAX_DWELL)
+            break;
+        Detector = Payload[0];
+        Dwell    = Payload[1];
+        sendAck(Cmd);
+        break;
+
+    case CMD_SETMULTIBAND:
+        setMultiBand(Payload, Length);
+        break;
+
+    case CMD_GETBANDSTATS:
+        sendAck(Cmd);
+        sendBandStats();
+        break;
+
+    case CMD_GETPERFSTATS:
+        getPerfStats(Payload, Length);
+        break;
+
+    case CMD_GETDEVICEVER:
+        sendAck(Cmd);
+        sendFrame(Cmd, (const unsigned char*)"1350", 4);
+        break;
+
+    case CMD_GETFWVER:
+        sendAck(Cmd);
+        data[0] = SIM_FW_MAJOR_VERSION;
+        data[1] = SIM_FW_MINOR_VERSION;
+        sendFrame(Cmd, data, 2);
+        break;
+
+    case CMD_GETRFPARAMS:
+        band = (Length>=1 && Payload[0]!=0) ? 1 : 0;
+        sendAck(Cmd);
+        data[0] = SIM_RBW_COUNT;
+        data[1] = (unsigned char)(maxLength >> 8);
+        data[2] = (unsigned char)(maxLength & 0xff);
+        sendArray(Cmd, data, 3);
+        for(int index=0; index<SIM_RBW_COUNT; index++)
+        {
+            unsigned long long bits;
+            memcpy(&bits, &RbwTable[band][index].Rbw, sizeof(bits));
+            entry.clear();
+            appendBE(entry, bits, 8);
+            appendBE(entry, RbwTable[band][index].If, 2);
+            appendBE(entry, RbwTable[band][index].Setting, 1);
+            sendArray(Cmd, (const unsigned char*)entry.data(), entry.size());
+        };
+        break;
+
+    case CMD_GETLASTERROR:
+        sendAck(Cmd);
+        data[0] = 0;
+        data[1] = 0;
+        sendFrame(Cmd, data, 2);
+        break;
+
+    case CMD_GETSPECNOINIT:
+        sendAck(Cmd);
+        sendSpectrum();
+        break;
+
+    case CMD_STARTSTREAM:
+        ZeroSpan  = false;
+        Trigger   = false;
+        ChunkValues = 0;
+        sendAck(Cmd);
+        Streaming = true;
+        break;
+
+    case CMD_STOPSTREAM:
+        Streaming = false;
+        ZeroSpan  = false;
+        Trigger   = false;
+        ChunkValues = 0;
+        sendAck(Cmd);
+        break;
+
+    case CMD_STARTCHUNKSTREAM:
+        startChunkStream(Payload, Length);
+        break;
+
+    case CMD_STARTZEROSPAN:
+        startZeroSpan(Payload, Length);
+        break;
+
+    case CMD_ARMTRIGGER:
+        armTrigger(Payload, Length);
+        break;
+
+    case CMD_SETTRIGGERLEVELS:
+        setTriggerLevels(Payload, Length);
+        break;
+
+    case SIM_CMD_FLASH_READ:
+        sendAck(Cmd);
+        flashRead(Payload, Length);
+        break;
+
+    default:
+        // Unknown commands are ignored like in processHostCommand()
+        break;
+    };
+}
+
+void cSimDevice::sendFrame(unsigned char Cmd, const unsigned char *Data, unsigned short Length)
+{
+    std::string    frame;
+    unsigned short crc;
+
+    frame.reserve(FRAME_V2_HEADER_LENGTH + Length + FRAME_CRC_LENGTH);
+    if(Framing==FRAMING_V2)
+    {
+        frame.push_back((char)FRAME_V2_MARKER);
+        frame.push_back((char)(Length >> 8));
+        frame.push_back((char)(Length & 0xff));
+        frame.push_back((char)Cmd);
+        frame.push_back((char)TxSequence++);
+        frame.push_back((char)(TxSweepId >> 8));
+        frame.push_back((char)(TxSweepId & 0xff));
+    }
+    else
+    {
+        frame.push_back((char)FRAME_MARKER);
+        frame.push_back((char)Length);
+        frame.push_back((char)Cmd);
+    };
+    frame.append((const char*)Data, Length);
+    crc = crc16Update(FRAME_MARKER, frame.data()+1, frame.size()-1);
+    if(Settings.CrcErrorRate>0 && nextRandom()<Settings.CrcErrorRate)
+    {
+        crc ^= 0x0001;
+        Stats.FramesCorrupt++;
+    };
+    frame.push_back((char)(crc >> 8));
+    frame.push_back((char)(crc & 0xff));
+    Stats.FramesSent++;
+
+    if(Settings.DropRate>0)
+    {
+        for(size_t index=0; index<frame.size(); index++)
+        {
+            if(nextRandom()<Settings.DropRate)
+                Stats.BytesDropped++;
+            else
+                TxBuffer.push_back(frame[index]);
+        };
+    }
+    else
+    {
+        TxBuffer.append(frame);
+    };
+    Stats.BytesSent += frame.size();
+}
+
+void cSimDevice::sendAck(unsigned char Cmd)
+{
+    sendFrame(Cmd, NULL, 0);
+}
+
+void cSimDevice::sendArray(unsigned char Cmd, const unsigned char *Data, unsigned long Length)
+{
+    unsigned short chunk;
+
+    while(Length)
+    {
+        chunk = (Length > 255 && Framing==FRAMING_V1) ? 255 : (unsigned short)Length;
+        sendFrame(Cmd, Data, chunk);
+        Data   += chunk;
+        Length -= chunk;
+    };
+}
+
+void cSimDevice::sendRssi(unsigned char Cmd, const unsigned char *Rssi, unsigned short Length)
+{
+    unsigned char  frame[SPECPACK_MAX_FRAME];
+    unsigned char  size;
+    unsigned short packed;
+    std::string    sweep;
+
+    if(Encoding!=ENCODING_DELTA)
+    {
+        sendArray(Cmd, Rssi, Length);
+        return;
+    };
+
+    // Same framing as sendSpectrum() in uartHostComms.c, version 2 sends the packed frames back to back
+    while(Length)
+    {
+        size = specPackFrame((const int8_t*)Rssi, Length, frame, &packed);
+        if(Framing==FRAMING_V2)
+            sweep.append((const char*)frame, size);
+        else
+            sendFrame(Cmd, frame, size);
+        Rssi   += packed;
+        Length -= packed;
+    };
+    if(Framing==FRAMING_V2)
+        sendFrame(Cmd, (const unsigned char*)sweep.data(), (unsigned short)sweep.size());
+}
+
+unsigned short cSimDevice::decimateSweep(unsigned char *Rssi, unsigned short Length)
+{
+    unsigned short factor = detectorDecimateFactor(Length, DecimationBins);
+
+    if(factor==1)
+        return(Length);
+
+    return(detectorDecimate(DecimationMode, (const int8_t*)Rssi, Length, factor, (int8_t*)Rssi));
+}
+
+void cSimDevice::sendSpectrum(void)
+{
+    unsigned char  rssi[SIM_MAX_SWEEP_LENGTH];
+    unsigned char  eof[2] = {0, 0};
+    unsigned short length = decimateSweep(rssi, MeasureSweep(rssi));
+    unsigned long  bytesSent = Stats.BytesSent;
+
+    // The firmware counts every sweep, streamed or not
+    TxSweepId = ++StreamSeq;
+    sendRssi(CMD_GETSPECNOINIT, rssi, length);
+    TxSweepId = 0;
+    recordPerf(SIM_PERF_SPECTRUM_BYTES, Stats.BytesSent - bytesSent);
+    recordPerf(SIM_PERF_TX_WAIT, 0);
+    recordPerf(SIM_PERF_LOCK_WAIT, 0);
+    // A version 2 frame holds the whole sweep
+    if(Framing==FRAMING_V1)
+        sendFrame(CMD_GETLASTERROR, eof, 2);
+}
+
+void cSimDevice::startZeroSpan(const unsigned char *Payload, unsigned char Length)
+{
+    // Like startZeroSpan() in uartHostComms.c, other lengths are not ACKed
+    if(Length!=6)
+        return;
+
+    MultiBandCount = 0;
+    ZeroSpanInterval = ((unsigned long)Payload[4] << 8) | Payload[5];
+    if(ZeroSpanInterval < SIM_ZEROSPAN_TICK_US)
+        ZeroSpanInterval = SIM_ZEROSPAN_TICK_US;
+    // The synthesizer settles once, then RX keeps running
+    if(Settings.RadioUs)
+        usleep(Settings.RadioUs);
+    sendAck(CMD_STARTZEROSPAN);
+    Trigger   = false;
+    ChunkValues = 0;
+    ZeroSpan  = true;
+    Streaming = true;
+}
+
+void cSimDevice::streamZeroSpan(void)
+{
+    unsigned char  block[10 + SIM_ZEROSPAN_BLOCK];
+    unsigned short count = SIM_ZEROSPAN_BLOCK;
+    double         startS, endS, sampleS;
+
+    if(count > SIM_ZEROSPAN_BLOCK_US/ZeroSpanInterval)
+        count = (unsigned short)(SIM_ZEROSPAN_BLOCK_US/ZeroSpanInterval);
+    if(count==0)
+        count = 1;
+
+    // A carrier keyed on for 2 ms every 5 ms over the noise floor
+    startS = monotonicNow();
+    for(unsigned short index=0; index<count; index++)
+    {
+        sampleS = startS + 1e-6*ZeroSpanInterval*index;
+        block[10+index] = (unsigned char)(int8_t)((fmod(sampleS, 0.005) < 0.002 ? -40.0 : -100.0) + 6.0*nextRandom());
+    };
+    usleep(ZeroSpanInterval*count);
+    endS = startS + 1e-6*ZeroSpanInterval*(count-1);
+
+    ZeroSpanSeq++;
+    block[0] = (unsigned char)(ZeroSpanSeq >> 8);
+    block[1] = (unsigned char)(ZeroSpanSeq & 0xff);
+    for(int index=0; index<4; index++)
+    {// Device time in us, wraps like the firmware clock
+        block[2+index] = (unsigned char)(((unsigned long long)(startS*1e6) >> (24-8*index)) & 0xff);
+        block[6+index] = (unsigned char)(((unsigned long long)(endS*1e6) >> (24-8*index)) & 0xff);
+    };
+    TxSweepId = ZeroSpanSeq;
+    sendFrame(CMD_ZEROSPANDATA, block, (unsigned short)(10 + count));
+    TxSweepId = 0;
+}
+
+void cSimDevice::armTrigger(const unsigned char *Payload, unsigned char Length)
+{
+    // Like armTrigger() in uartHostComms.c, invalid settings are not ACKed
+    if(Length!=4 || (Payload[1]+Payload[2])>=SIM_TRIGGER_RING || (Payload[3] & ~0x03))
+        return;
+
+    TriggerLevel = (signed char)Payload[0];
+    TriggerPre   = Payload[1];
+    TriggerPost  = Payload[2];
+    TriggerFlags = Payload[3];
+    TriggerHead  = 0;
+    TriggerFill  = 0;
+    TriggerState = 1;
+    sendAck(CMD_ARMTRIGGER);
+    ZeroSpan  = false;
+    Trigger   = true;
+    ChunkValues = 0;
+    Streaming = true;
+}
+
+void cSimDevice::setTriggerLevels(const unsigned char *Payload, unsigned char Length)
+{
+    unsigned short offset;
+
+    if(Length<3)
+        return;
+    offset = (unsigned short)((Payload[0]<<8) | Payload[1]);
+    if(offset+Length-2 > SIM_TRIGGER_MAX_LENGTH)
+        return;
+
+    memcpy(&TriggerLevels[offset], &Payload[2], Length-2);
+    sendAck(CMD_SETTRIGGERLEVELS);
+}
+
+void cSimDevice::streamTrigger(void)
+{
+    unsigned char  rssi[SIM_MAX_SWEEP_LENGTH];
+    unsigned char  header[SIM_TRIGGER_HDR_LENGTH];
+    unsigned short length = MeasureSweep(rssi);
+    unsigned char  slot = TriggerHead;
+    unsigned long  us;
+    bool           crossed = false;
+
+    // The RF task keeps sweeping after a one-shot burst, nothing is sent
+    if(TriggerState==0 || length>SIM_TRIGGER_MAX_LENGTH)
+        return;
+
+    memcpy(TriggerRssi[slot], rssi, length);
+    TriggerLength[slot] = length;
+    TriggerTime[slot]   = monotonicNow();
+    TriggerHead = (TriggerHead+1) % SIM_TRIGGER_RING;
+
+    if(TriggerState==2)
+    {
+        TriggerCount++;
+        TriggerPostLeft--;
+    }
+    else
+    {
+        for(unsigned short index=0; index<length && !crossed; index++)
+            crossed = (signed char)rssi[index] >= ((TriggerFlags & 0x01) ? TriggerLevels[index] : TriggerLevel);
+        if(crossed)
+        {// Fewer pre-trigger sweeps while the ring fills
+            TriggerIndex    = (TriggerFill < TriggerPre) ? TriggerFill : TriggerPre;
+            TriggerFirst    = (slot + SIM_TRIGGER_RING - TriggerIndex) % SIM_TRIGGER_RING;
+            TriggerCount    = TriggerIndex + 1;
+            TriggerPostLeft = TriggerPost;
+            TriggerState    = 2;
+        };
+    };
+    if(TriggerFill < SIM_TRIGGER_RING)
+        TriggerFill++;
+
+    if(TriggerState!=2 || TriggerPostLeft)
+        return;
+
+    TriggerSeq++;
+    for(unsigned char index=0; index<TriggerCount; index++)
+    {
+        slot   = (TriggerFirst + index) % SIM_TRIGGER_RING;
+        memcpy(rssi, TriggerRssi[slot], TriggerLength[slot]);
+        length = decimateSweep(rssi, TriggerLength[slot]);
+        us     = (unsigned long)((unsigned long long)(TriggerTime[slot]*1e6) & 0xffffffff);
+
+        header[0] = (unsigned char)(TriggerSeq >> 8);
+        header[1] = (unsigned char)(TriggerSeq & 0xff);
+        header[2] = index;
+        header[3] = TriggerCount;
+        header[4] = TriggerIndex;
+        for(int byte=0; byte<4; byte++)
+            header[5+byte] = (unsigned char)((us >> (24-8*byte)) & 0xff);
+        header[9]  = (unsigned char)(length >> 8);
+        header[10] = (unsigned char)(length & 0xff);
+        TxSweepId = TriggerSeq;
+        sendFrame(CMD_TRIGGERSWEEP, header, SIM_TRIGGER_HDR_LENGTH);
+        sendRssi(CMD_STREAMDATA, rssi, length);
+    };
+    TxSweepId = 0;
+
+    // Re-arm with an empty ring, or stay quiet until the host arms again
+    TriggerHead  = 0;
+    TriggerFill  = 0;
+    TriggerState = (TriggerFlags & 0x02) ? 1 : 0;
+}
+
+void cSimDevice::startChunkStream(const unsigned char *Payload, unsigned char Length)
+{
+    // Like startChunkStream() in uartHostComms.c, invalid sizes are not ACKed
+    if(Length!=1 || Payload[0]==0 || Payload[0]>SIM_CHUNK_MAX_VALUES)
+        return;
+
+    ZeroSpan    = false;
+    Trigger     = false;
+    sendAck(CMD_STARTCHUNKSTREAM);
+    ChunkValues = Payload[0];
+    ChunkOffset = 0;
+    Streaming   = true;
+}
+
+void cSimDevice::streamChunk(void)
+{
+    unsigned char  chunk[SIM_CHUNK_HDR_LENGTH + SIM_CHUNK_MAX_VALUES];
+    unsigned short count;
+
+    if(!ChunkOffset || ChunkLength!=sweepLength())
+    {// New sweep settings restart the sweep in progress under the same sequence number
+        if(!ChunkOffset)
+            StreamSeq++;
+        ChunkLength = SynthSweep(ChunkRssi);
+        ChunkOffset = 0;
+    };
+
+    // The firmware sends a chunk as soon as the RF task measured it
+    count = (ChunkLength-ChunkOffset < ChunkValues) ? ChunkLength-ChunkOffset : ChunkValues;
+    if(Settings.RadioUs)
+        usleep(count*Settings.RadioUs*(1.0 + SIM_DWELL_SHARE*(Dwell-1)));
+
+    chunk[0] = (unsigned char)(StreamSeq >> 8);
+    chunk[1] = (unsigned char)(StreamSeq & 0xff);
+    chunk[2] = (unsigned char)(ChunkOffset >> 8);
+    chunk[3] = (unsigned char)(ChunkOffset & 0xff);
+    chunk[4] = (unsigned char)(ChunkLength >> 8);
+    chunk[5] = (unsigned char)(ChunkLength & 0xff);
+    memcpy(&chunk[SIM_CHUNK_HDR_LENGTH], &ChunkRssi[ChunkOffset], count);
+    TxSweepId = StreamSeq;
+    sendFrame(CMD_SWEEPCHUNK, chunk, (unsigned short)(SIM_CHUNK_HDR_LENGTH + count));
+    TxSweepId = 0;
+
+    ChunkOffset += count;
+    if(ChunkOffset >= ChunkLength)
+        ChunkOffset = 0;
+}
+
+void cSimDevice::setMultiBand(const unsigned char *Payload, unsigned char Length)
+{
+    unsigned char count = Length / 4;
+    unsigned char bands[SIM_MULTIBAND_SEGMENTS];
+    unsigned char used = 0;
+    unsigned short start;
+
+    // Like setMultiBand() in uartHostComms.c, partial segments are not ACKed
+    if((Length % 4)!=0 || count>SIM_MULTIBAND_SEGMENTS)
+        return;
+    sendAck(CMD_SETMULTIBAND);
+
+    // Like cmdSetMultiBand() in rfSweep.c, invalid segments leave the sweep unchanged
+    for(unsigned char segment=0; segment<count; segment++)
+    {
+        const unsigned char *values = &Payload[4*segment];
+        start = (unsigned short)((values[1] << 8) | values[2]);
+        if(values[0]>2 || (used & (1 << values[0])) || values[3]>=sizeof(EasySpans)/sizeof(EasySpans[0]))
+            return;
+        if(start<BandLimits[values[0]][0] || start+EasySpans[values[3]]>BandLimits[values[0]][1])
+            return;
+        used |= (unsigned char)(1 << values[0]);
+        bands[segment] = values[0];
+    };
+    memcpy(MultiBands, bands, count);
+    MultiBandCount = count;
+}
+
+void cSimDevice::countBandSwitches(void)
+{
+    bool fromSub1, toSub1;
+
+    // One switch into each segment, the first one from the last segment
+    if(MultiBandCount < 2)
+        return;
+    for(unsigned char segment=0; segment<MultiBandCount; segment++)
+    {
+        fromSub1 = MultiBands[segment]!=2;
+        toSub1   = MultiBands[(segment+1) % MultiBandCount]!=2;
+        SwitchCount[fromSub1==toSub1 ? 0 : 1]++;
+    };
+}
+
+void cSimDevice::sendBandStats(void)
+{
+    std::string stats;
+    static const unsigned long switchUs[2] = {SIM_SETUP_SWITCH_US, SIM_REOPEN_SWITCH_US};
+
+    for(int way=0; way<2; way++)
+    {
+        appendBE(stats, SwitchCount[way], 4);
+        appendBE(stats, SwitchCount[way] ? switchUs[way] : 0, 4);
+        appendBE(stats, SwitchCount[way] ? switchUs[way] : 0, 4);
+        appendBE(stats, (SwitchCount[way]*switchUs[way]) & 0xFFFFFFFFUL, 4);
+    };
+    sendFrame(CMD_GETBANDSTATS, (const unsigned char*)stats.data(), (unsigned short)stats.size());
+}
+
+void cSimDevice::recordPerf(eSimPerfCounter Counter, unsigned long Value)
+{
+    sSimPerfCounter &counter = PerfCounters[Counter];
+
+    if(counter.Count==0 || Value<counter.Min)
+        counter.Min = Value;
+    if(Value>counter.Max)
+        counter.Max = Value;
+    counter.Sum += Value;
+    counter.Count++;
+}
+
+void cSimDevice::getPerfStats(const unsigned char *Payload, unsigned char Length)
+{
+    std::string stats;
+
+    // Like getPerfStats() in uartHostComms.c, other payloads are not ACKed
+    if(Length>1 || (Length==1 && Payload[0]>1))
+        return;
+    sendAck(CMD_GETPERFSTATS);
+
+    appendBE(stats, SIM_PERF_TIMESTAMP_HZ, 4);
+    for(int counter=0; counter<SIM_PERF_COUNTERS; counter++)
+    {
+        appendBE(stats, PerfCounters[counter].Count, 4);
+        appendBE(stats, PerfCounters[counter].Min, 4);
+        appendBE(stats, PerfCounters[counter].Max, 4);
+        appendBE(stats, PerfCounters[counter].Sum, 8);
+    };
+    if(Length==1 && Payload[0]==1)
+        memset(PerfCounters,0,sizeof(PerfCounters));
+    sendFrame(CMD_GETPERFSTATS, (const unsigned char*)stats.data(), (unsigned short)stats.size());
+}
+
+void cSimDevice::flashRead(const unsigned char *Payload, unsigned char Length)
+{
+    unsigned short addr, size;
+    unsigned char  data[255];
+
+    if(Length<4)
+        return;
+
+    addr = (unsigned short)((Payload[0]<<8) | Payload[1]);
+    size = (unsigned short)((Payload[2]<<8) | Payload[3]);
+    if(size > 255)
+        size = 255;
+
+    // Outside the calibration region reads as erased flash
+    for(unsigned short index=0; index<size; index++)
+    {
+        unsigned long offset = (unsigned long)addr + index - SIM_FLASH_START;
+        if(addr+index >= SIM_FLASH_START && offset < FlashImage.size())
+            data[index] = (unsigned char)FlashImage[offset];
+        else
+            data[index] = 0xff;
+    };
+    sendFrame(SIM_CMD_FLASH_READ, data, (unsigned char)size);
+}
+
+void cSimDevice::setBaudRate(const unsigned char *Payload, unsigned char Length)
+{
+    unsigned long rate;
+
+    // The firmware ignores unsupported rates and requests while streaming
+    if(Length!=4 || Streaming)
+        return;
+    rate = ((unsigned long)Payload[0]<<24) | ((unsigned long)Payload[1]<<16) | ((unsigned long)Payload[2]<<8) | Payload[3];
+    if(rate!=115200 && rate!=230400 && rate!=460800 && rate!=921600)
+        return;
+
+    sendAck(CMD_SETBAUDRATE);
+    PrevBaudRate = BaudRate;
+    BaudRate     = rate;
+    SyncDue      = monotonicNow() + SIM_SYNC_TIMEOUT;
+}
+
+void cSimDevice::rxError(void)
+{
+    RxBuffer.clear();
+    if(RxErrors < SIM_RX_ERROR_LIMIT)
+        RxErrors++;
+    if(RxErrors>=SIM_RX_ERROR_LIMIT && BaudRate!=SIM_DEFAULT_BAUD && !SyncDue)
+    {
+        if(Settings.Verbose)
+            fprintf(stderr, "sa1350-sim: %u bad frames at %lu baud\n", RxErrors, BaudRate);
+        resetHostLink();
+    };
+}
+
+void cSimDevice::resetHostLink(void)
+{
+    // As CMD_DISCONNECT without the ACK, the host is not listening at this rate
+    MultiBandCount = 0;
+    Streaming = false;
+    ZeroSpan  = false;
+    Trigger   = false;
+    ChunkValues = 0;
+    Encoding  = ENCODING_RAW;
+    Detector  = DETECTOR_SAMPLE;
+    Dwell     = 1;
+    DecimationBins = 0;
+    Framing   = FRAMING_V1;
+    BaudRate  = SIM_DEFAULT_BAUD;
+    RxErrors  = 0;
+    LastFrame = monotonicNow();
+    RxBuffer.clear();
+    Stats.LinkResets++;
+}
+
+unsigned short cSimDevice::sweepLength(void)
+{
+    unsigned long length;
+
+    if(Settings.SweepLength)
+        length = Settings.SweepLength;
+    else if(MultiBandCount)
+        length = MultiBandCount * SIM_SEGMENT_POINTS;
+    else if(Span==0)
+        length = SIM_DEFAULT_SWEEP;
+    else if(StepCount==1 || FreqStep==0)
+        length = Span + 1;
+    else
+        length = (unsigned long)((double)Span * 65536.0 / (double)FreqStep) + 1;
+
+    if(length > SIM_MAX_SWEEP_LENGTH)
+        length = SIM_MAX_SWEEP_LENGTH;
+
+    return((unsigned short)length);
+}
+
+void cSimDevice::buildFlashImage(void)
+{
+    std::string cal;
+    static const unsigned long ranges[3][3] =
+    {
+        { 431000000UL,  527000000UL, 97},
+        { 861000000UL,  1054000000UL, 194},
+        { 2152000000UL, 2635000000UL, 484}
+    };
+
+    // Calibration data in the order cmdLoadCalData() reads it
+    appendBE(cal, SIM_CALDATA_FORMATVER, 2);
+    cal.append("2017-01-01 00:00", 16);
+    appendBE(cal, 0x0100, 2);
+    appendBE(cal, 1, 1);
+    for(int index=0; index<3; index++)
+        for(int value=0; value<3; value++)
+            appendBE(cal, ranges[index][value], 4);
+    for(int index=0; index<8; index++)
+    {
+        appendBE(cal, (unsigned char)(signed char)(-10*index), 1);
+        appendBE(cal, index, 1);
+    };
+    appendBE(cal, 0x1350, 4);
+    cal.append("SA1350SIMULATOR ", 16);
+    appendBE(cal, 24000000UL, 4);
+    appendBE(cal, 10, 2);
+    cal.append(6, (char)25);
+    cal.append(6, (char)25);
+    for(int index=0; index<3*8; index++)
+    {
+        appendBE(cal, 0, 1);
+        for(int value=0; value<8; value++)
+        {
+            double coeff = (value==1) ? 1.0 : 0.0;
+            unsigned long long bits;
+            memcpy(&bits, &coeff, sizeof(bits));
+            appendBE(cal, bits, 8);
+        };
+    };
+
+    // ProgHeader is little endian, followed by the calibration data
+    FlashImage.clear();
+    FlashImage.push_back((char)(SIM_FLASH_START & 0xff));
+    FlashImage.push_back((char)(SIM_FLASH_START >> 8));
+    FlashImage.push_back((char)(cal.size() & 0xff));
+    FlashImage.push_back((char)(cal.size() >> 8));
+    FlashImage.push_back((char)SIM_PROGTYPE_CALC);
+    FlashImage.push_back((char)0);
+    FlashImage.push_back((char)(SIM_CALDATA_FORMATVER & 0xff));
+    FlashImage.push_back((char)(SIM_CALDATA_FORMATVER >> 8));
+    unsigned short crc = crc16Update(FRAME_MARKER, cal.data(), cal.size());
+    FlashImage.push_back((char)(crc & 0xff));
+    FlashImage.push_back((char)(crc >> 8));
+    FlashImage.append(cal);
+    FlashImage.resize(SIM_FLASH_END - SIM_FLASH_START + 1, (char)0xff);
+}
+
+double cSimDevice::nextRandom(void)
+{
+    // xorshift32, repeatable for a given seed
+    Random ^= (Random << 13) & 0xffffffffUL;
+    Random ^= (Random >> 17);
+    Random ^= (Random << 5) & 0xffffffffUL;
+    Random &= 0xffffffffUL;
+
+    return((double)Random / 4294967296.0);
+}
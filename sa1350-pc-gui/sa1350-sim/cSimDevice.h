@@ -0,0 +1,456 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file cSimDevice.h */
+#pragma once
+#include <string>
+
+using namespace std;
+
+#define SIM_FW_MAJOR_VERSION    1       /*!< Reported firmware version, matches SA1350_Firmware.h */
+#define SIM_FW_MINOR_VERSION    15      /*!< Reported firmware version, matches SA1350_Firmware.h */
+#define SIM_MAX_SWEEP_LENGTH    2048    /*!< Size of the firmware rssiArray */
+#define SIM_DEFAULT_SWEEP       512     /*!< Sweep length before the host set a span */
+#define SIM_RBW_COUNT           21      /*!< Entries of the firmware RBW tables */
+#define SIM_RBW_ENTRY_LENGTH    11      /*!< double RBW, u16 IF, u8 register */
+
+#define SIM_DEFAULT_BAUD        115200  /*!< UART rate after reset and CMD_DISCONNECT */
+#define SIM_SYNC_TIMEOUT        0.1     /*!< Seconds the host has to confirm a new rate with CMD_SYNC */
+#define SIM_RX_ERROR_LIMIT      3       /*!< Bad frames in a row at a raised rate before the default rate, matches UART_RX_ERROR_LIMIT */
+#define SIM_IDLE_TIMEOUT        10.0    /*!< Seconds without a valid frame at a raised rate before the default rate, matches UART_IDLE_TIMEOUT */
+#define SIM_DWELL_SHARE         0.4     /*!< Radio time of a further CMD_SETDETECTOR read, share of a point */
+#define SIM_DECIMATION_MAX_BINS 1024    /*!< Most CMD_SETDECIMATION bins, matches uartHostComms.c */
+#define SIM_ZEROSPAN_BLOCK      245     /*!< Most samples per CMD_ZEROSPANDATA, matches ZERO_SPAN_BLOCK_LENGTH */
+#define SIM_ZEROSPAN_TICK_US    10      /*!< Firmware clock tick, the fastest zero span interval */
+#define SIM_ZEROSPAN_BLOCK_US   50000   /*!< Longest block, stands in for the firmware cutting it short on a host command */
+#define SIM_TRIGGER_RING        4       /*!< Sweeps in the pre-trigger ring, matches TRIGGER_RING_LENGTH */
+#define SIM_TRIGGER_MAX_LENGTH  512     /*!< Longest sweep checked by the trigger, matches TRIGGER_MAX_LENGTH */
+#define SIM_TRIGGER_HDR_LENGTH  11      /*!< Payload of CMD_TRIGGERSWEEP */
+#define SIM_CHUNK_HDR_LENGTH    6       /*!< Payload of CMD_SWEEPCHUNK ahead of the values, matches CHUNK_HDR_LENGTH */
+#define SIM_CHUNK_MAX_VALUES    249     /*!< Most values per CMD_SWEEPCHUNK, matches CHUNK_MAX_VALUES */
+#define SIM_MULTIBAND_SEGMENTS  3       /*!< Most CMD_SETMULTIBAND segments, matches MULTIBAND_MAX_SEGMENTS */
+#define SIM_SEGMENT_POINTS      288     /*!< Points of a CMD_SETMULTIBAND segment, every EasyRF span has 288 */
+#define SIM_SETUP_SWITCH_US     150     /*!< Reported time of a band switch on the open radio */
+#define SIM_REOPEN_SWITCH_US    1500    /*!< Reported time of a band switch that reopens the radio */
+#define SIM_PERF_TIMESTAMP_HZ   1000000 /*!< Reported CMD_GETPERFSTATS timestamp frequency, times are in us */
+#define SIM_RSSI_READ_US        20      /*!< Reported time of one RSSI read */
+#define SIM_BURST_EVERY         25      /*!< Every n-th sweep carries a short strong burst to trigger on */
+#define SIM_CMD_FLASH_READ      10      /*!< Flash read, issued by drvSA1350::cmdFlashRead */
+#define SIM_FLASH_START         0xD400  /*!< First calibration data address */
+#define SIM_FLASH_END           0xEBFF  /*!< Last calibration data address */
+#define SIM_PROGTYPE_CALC       62      /*!< ProgHeader type of calibration data */
+#define SIM_CALDATA_FORMATVER   0x0110  /*!< Calibration data format version */
+
+/*!
+ \brief Simulator settings
+
+ \struct sSimSettings cSimDevice.h "cSimDevice.h"
+*/
+typedef struct sSimSettings
+{
+    unsigned short SweepLength;  /*!< Fixed sweep length, 0 follows the host span/step */
+    double         CrcErrorRate; /*!< Probability of a corrupted CRC per sent frame */
+    double         DropRate;     /*!< Probability of dropping a sent byte */
+    unsigned long  Seed;         /*!< Seed for noise and error injection */
+    unsigned long  RadioUs;      /*!< Simulated radio time per sweep point in us */
+    unsigned long  MaxBaud;      /*!< Highest rate the USB UART bridge passes, 0 for any */
+    bool           Verbose;      /*!< Log every host command */
+}sSimSettings;
+
+/*!
+ \brief Simulator counters
+
+ \struct sSimStats cSimDevice.h "cSimDevice.h"
+*/
+typedef struct sSimStats
+{
+    unsigned long Commands;      /*!< Valid host commands */
+    unsigned long CrcErrors;     /*!< Host commands with a bad CRC */
+    unsigned long Sweeps;        /*!< Sweeps sent */
+    unsigned long FramesSent;    /*!< Frames sent to the host */
+    unsigned long FramesCorrupt; /*!< Frames sent with an injected CRC error */
+    unsigned long BytesSent;     /*!< Bytes queued for the host */
+    unsigned long BytesDropped;  /*!< Bytes dropped by injection */
+    unsigned long BytesGarbled;  /*!< Host bytes lost to a baud rate mismatch */
+    unsigned long LinkResets;    /*!< Returns to the default rate for a host that lost the rate */
+}sSimStats;
+
+/*!
+ \brief CMD_GETPERFSTATS counters, matches PerfCounterId in SA1350_Firmware.h
+
+ \enum eSimPerfCounter
+*/
+enum eSimPerfCounter
+{
+    SIM_PERF_FS_WAIT = 0,    /*!< Wait for the CMD_FS of a step */
+    SIM_PERF_SETTLE_LOOPS,   /*!< RSSI settle waits per step */
+    SIM_PERF_RSSI_READ,      /*!< Time of one RSSI read */
+    SIM_PERF_SPECTRUM_BYTES, /*!< Bytes queued per sent sweep */
+    SIM_PERF_TX_WAIT,        /*!< Wait for TX queue space per sent sweep, none in the simulator */
+    SIM_PERF_LOCK_WAIT,      /*!< Wait for the sweep mutex, none in the simulator */
+    SIM_PERF_DISPLAY,        /*!< Time of one LCD frame, the simulator has no LCD */
+    SIM_PERF_COUNTERS        /*!< Number of counters */
+};
+
+/*!
+ \brief One CMD_GETPERFSTATS counter
+
+ \struct sSimPerfCounter cSimDevice.h "cSimDevice.h"
+*/
+typedef struct sSimPerfCounter
+{
+    unsigned long      Count; /*!< Values recorded */
+    unsigned long      Min;   /*!< Smallest value */
+    unsigned long      Max;   /*!< Largest value */
+    unsigned long long Sum;   /*!< Sum of all values */
+}sSimPerfCounter;
+
+/*!
+ \brief SA1350 protocol engine
+
+   Speaks the uartHostComms.c protocol on byte buffers, the transport
+   is left to the caller.
+
+ \class cSimDevice cSimDevice.h "cSimDevice.h"
+*/
+class cSimDevice
+{
+public:
+    /*!
+     \brief Constructor
+
+     \param Settings Add param
+    */
+    cSimDevice(const sSimSettings &Settings);
+
+    /*!
+     \brief Feed bytes received from the host
+
+     \param Data Add param
+     \param Length Add param
+    */
+    void Receive(const unsigned char *Data, unsigned long Length);
+    /*!
+     \brief Move the pending response bytes to Data
+
+     \param Data Add param
+     \return bool true: Data holds bytes for the host
+    */
+    bool GetTxData(std::string &Data);
+    /*!
+     \brief Returns the counters
+
+     \return const sSimStats &
+    */
+    const sSimStats &GetStats(void);
+    /*!
+     \brief Returns true between CMD_STARTSTREAM, CMD_STARTCHUNKSTREAM or CMD_STARTZEROSPAN and CMD_STOPSTREAM
+
+     \return bool
+    */
+    bool IsStreaming(void);
+    /*!
+     \brief Measure and queue the next streamed sweep, chunk or zero span block
+
+    */
+    void StreamSweep(void);
+    /*!
+     \brief Returns the UART rate of the device, changed by CMD_SETBAUDRATE
+
+     \return unsigned long bit/s
+    */
+    unsigned long GetBaudRate(void);
+    /*!
+     \brief Set the rate the host comport runs at, 0 if unknown
+
+       Host bytes are lost while it differs from the device rate.
+
+     \param BaudRate Add param
+    */
+    void SetHostBaudRate(unsigned long BaudRate);
+    /*!
+     \brief Returns true while a new rate waits for the CMD_SYNC confirmation
+
+     \return bool
+    */
+    bool IsSyncPending(void);
+    /*!
+     \brief Fall back to the previous rate once the CMD_SYNC window closed
+
+    */
+    void CheckSyncTimeout(void);
+    /*!
+     \brief Return to the default rate after SIM_IDLE_TIMEOUT without a valid frame at a raised rate
+
+       Not while streaming, like readHost() in uartHostComms.c.
+    */
+    void CheckLinkIdle(void);
+    /*!
+     \brief Fill Rssi with a synthetic sweep, taking the simulated radio time
+
+     \param Rssi Add param
+     \return unsigned short sweep length
+    */
+    unsigned short MeasureSweep(unsigned char *Rssi);
+    /*!
+     \brief Fill Rssi with a synthetic sweep without taking radio time
+
+     \param Rssi Add param
+     \return unsigned short sweep length
+    */
+    unsigned short SynthSweep(unsigned char *Rssi);
+
+private:
+    sSimSettings  Settings;       /*!< Add in-line comment */
+    sSimStats     Stats;          /*!< Add in-line comment */
+    std::string   RxBuffer;       /*!< Host bytes not yet parsed */
+    std::string   TxBuffer;       /*!< Response bytes for the host */
+    std::string   FlashImage;     /*!< Calibration data flash region */
+    unsigned long Random;         /*!< Noise and injection generator state */
+
+    unsigned char Band;           /*!< CMD_SETFRANGE */
+    unsigned short Span;          /*!< CMD_SETSPAN in MHz */
+    unsigned long FreqStep;       /*!< CMD_SETFSTEP, kHz * 65536 */
+    unsigned short StepCount;     /*!< CMD_SETSTEPCOUNT */
+    bool           Streaming;     /*!< CMD_STARTSTREAM received */
+    unsigned short StreamSeq;     /*!< Sequence number of the last streamed sweep */
+    unsigned long  BaudRate;      /*!< Device UART rate */
+    unsigned long  PrevBaudRate;  /*!< Rate restored if CMD_SYNC does not confirm BaudRate */
+    unsigned long  HostBaudRate;  /*!< Host comport rate, 0 if unknown */
+    double         SyncDue;       /*!< Monotonic end of the CMD_SYNC window, 0 if none */
+    unsigned int   RxErrors;      /*!< Bad frames in a row, see SIM_RX_ERROR_LIMIT */
+    double         LastFrame;     /*!< Monotonic time of the last valid frame or rate change */
+    unsigned char  Encoding;      /*!< CMD_SETENCODING */
+    unsigned char  Framing;       /*!< CMD_SETFRAMING */
+    unsigned char  TxSequence;    /*!< Sequence number of the next version 2 frame */
+    unsigned short TxSweepId;     /*!< Sweep id of the version 2 frames being queued, 0 outside of sweeps */
+    unsigned char  Detector;      /*!< CMD_SETDETECTOR mode */
+    unsigned char  Dwell;         /*!< CMD_SETDETECTOR reads per point */
+    unsigned short DecimationBins; /*!< CMD_SETDECIMATION bins, 0 for full resolution */
+    unsigned char  DecimationMode; /*!< CMD_SETDECIMATION reduction of a bin */
+    bool           ZeroSpan;      /*!< CMD_STARTZEROSPAN received, blocks are streamed instead of sweeps */
+    unsigned long  ZeroSpanInterval; /*!< CMD_STARTZEROSPAN sample interval in us */
+    unsigned short ZeroSpanSeq;   /*!< Sequence number of the last zero span block */
+    bool           Trigger;       /*!< CMD_ARMTRIGGER received, bursts are streamed instead of sweeps */
+    unsigned char  TriggerState;  /*!< 0 off, 1 armed, 2 collecting post-trigger sweeps */
+    signed char    TriggerLevel;  /*!< CMD_ARMTRIGGER level in dBm */
+    unsigned char  TriggerPre;    /*!< Sweeps sent before the trigger sweep */
+    unsigned char  TriggerPost;   /*!< Sweeps sent after the trigger sweep */
+    unsigned char  TriggerFlags;  /*!< CMD_ARMTRIGGER flags */
+    signed char    TriggerLevels[SIM_TRIGGER_MAX_LENGTH]; /*!< CMD_SETTRIGGERLEVELS levels */
+    unsigned char  TriggerRssi[SIM_TRIGGER_RING][SIM_TRIGGER_MAX_LENGTH]; /*!< Pre-trigger ring */
+    unsigned short TriggerLength[SIM_TRIGGER_RING]; /*!< Length of each ring sweep */
+    double         TriggerTime[SIM_TRIGGER_RING];   /*!< Monotonic time each ring sweep completed */
+    unsigned char  TriggerHead;   /*!< Ring index written next */
+    unsigned char  TriggerFill;   /*!< Valid sweeps in the ring */
+    unsigned char  TriggerFirst;  /*!< Ring index of the first burst sweep */
+    unsigned char  TriggerCount;  /*!< Sweeps of the burst so far */
+    unsigned char  TriggerIndex;  /*!< Burst index of the trigger sweep */
+    unsigned char  TriggerPostLeft; /*!< Post-trigger sweeps still to collect */
+    unsigned short TriggerSeq;    /*!< Sequence number of the last burst */
+    unsigned char  ChunkValues;   /*!< CMD_STARTCHUNKSTREAM values per chunk, 0 streams whole sweeps */
+    unsigned char  ChunkRssi[SIM_MAX_SWEEP_LENGTH]; /*!< Sweep being sent in chunks */
+    unsigned short ChunkLength;   /*!< Length of the sweep being sent in chunks */
+    unsigned short ChunkOffset;   /*!< Index of the next chunk, 0 starts a new sweep */
+    unsigned char  MultiBandCount; /*!< CMD_SETMULTIBAND segments, 0 for a single band sweep */
+    unsigned char  MultiBands[SIM_MULTIBAND_SEGMENTS]; /*!< Band of each segment in sweep order */
+    unsigned long  SwitchCount[2]; /*!< CMD_GETBANDSTATS band switches on the open radio, reopened */
+    sSimPerfCounter PerfCounters[SIM_PERF_COUNTERS]; /*!< CMD_GETPERFSTATS counters since start or their last reset */
+
+    /*!
+     \brief Dispatch one host command with valid CRC
+
+     \param Cmd Add param
+     \param Payload Add param
+     \param Length Add param
+    */
+    void processCommand(unsigned char Cmd, const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Queue one frame in the CMD_SETFRAMING format, applying the configured error injection
+
+     \param Cmd Add param
+     \param Data Add param
+     \param Length At most 255 for version 1 frames
+    */
+    void sendFrame(unsigned char Cmd, const unsigned char *Data, unsigned short Length);
+    /*!
+     \brief Queue a zero length acknowledge frame
+
+     \param Cmd Add param
+    */
+    void sendAck(unsigned char Cmd);
+    /*!
+     \brief Queue Data split into version 1 frames of at most 255 bytes, or one version 2 frame
+
+     \param Cmd Add param
+     \param Data Add param
+     \param Length Add param
+    */
+    void sendArray(unsigned char Cmd, const unsigned char *Data, unsigned long Length);
+    /*!
+     \brief Queue RSSI values as Cmd frames in the CMD_SETENCODING format
+
+     \param Cmd Add param
+     \param Rssi Add param
+     \param Length Add param
+    */
+    void sendRssi(unsigned char Cmd, const unsigned char *Rssi, unsigned short Length);
+    /*!
+     \brief Reduce a sweep in place to the CMD_SETDECIMATION bins
+
+     \param Rssi Add param
+     \param Length Add param
+     \return unsigned short number of values to send
+    */
+    unsigned short decimateSweep(unsigned char *Rssi, unsigned short Length);
+    /*!
+     \brief Queue a synthetic sweep followed by the CMD_GETLASTERROR EOF frame
+
+    */
+    void sendSpectrum(void);
+    /*!
+     \brief Tune to the CMD_STARTZEROSPAN frequency and start streaming blocks
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void startZeroSpan(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Sample a pulsed carrier at ZeroSpanInterval and queue one CMD_ZEROSPANDATA
+
+    */
+    void streamZeroSpan(void);
+    /*!
+     \brief Arm the trigger, like armTrigger() in uartHostComms.c
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void armTrigger(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Store CMD_SETTRIGGERLEVELS levels
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void setTriggerLevels(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Measure one sweep into the trigger ring and queue the burst once complete
+
+    */
+    void streamTrigger(void);
+    /*!
+     \brief Start chunked streaming, like startChunkStream() in uartHostComms.c
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void startChunkStream(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Measure and queue the next CMD_SWEEPCHUNK of the sweep in progress
+
+    */
+    void streamChunk(void);
+    /*!
+     \brief Set or end a multi-band sweep, like cmdSetMultiBand() in rfSweep.c
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void setMultiBand(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Count the band switches of one multi-band sweep
+
+    */
+    void countBandSwitches(void);
+    /*!
+     \brief Queue the CMD_GETBANDSTATS response
+
+    */
+    void sendBandStats(void);
+    /*!
+     \brief Add a value to a CMD_GETPERFSTATS counter, like perfRecord() in perfStats.c
+
+     \param Counter Add param
+     \param Value Add param
+    */
+    void recordPerf(eSimPerfCounter Counter, unsigned long Value);
+    /*!
+     \brief Answer CMD_GETPERFSTATS, optionally clearing the counters
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void getPerfStats(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Answer a CMD_FLASH_READ request from the flash image
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void flashRead(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Switch to the CMD_SETBAUDRATE rate after the ACK, like setBaudRate() in uartHostComms.c
+
+     \param Payload Add param
+     \param Length Add param
+    */
+    void setBaudRate(const unsigned char *Payload, unsigned char Length);
+    /*!
+     \brief Count a bad frame, like hostRxError() in uartHostComms.c
+
+       The rest of the host bytes is dropped. After SIM_RX_ERROR_LIMIT in a row
+       at a raised rate the device returns to the default rate.
+    */
+    void rxError(void);
+    /*!
+     \brief End the streams of the host and return to the default rate, like resetHostLink() in uartHostComms.c
+
+    */
+    void resetHostLink(void);
+    /*!
+     \brief Sweep length as computed by getSweepLength() in rfSweep.c
+
+     \return unsigned short
+    */
+    unsigned short sweepLength(void);
+    /*!
+     \brief Fill FlashImage with a ProgHeader and calibration data
+
+    */
+    void buildFlashImage(void);
+    /*!
+     \brief Returns a uniform random value in [0,1)
+
+     \return double
+    */
+    double nextRandom(void);
+};
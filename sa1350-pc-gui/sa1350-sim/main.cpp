@@ -0,0 +1,363 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file main.cpp
+ \brief SA1350 device simulator on a pseudo-terminal
+*/
+#include <getopt.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "cPtyPort.h"
+#include "cSimDevice.h"
+#include "specPack.h"
+
+using namespace std;
+
+#define SIM_POLL_MS 100 /*!< Longest wait for host bytes before checking for exit */
+#define SIM_SYNC_MS 5   /*!< Wait for host bytes while a new rate waits for CMD_SYNC */
+#define SIM_BENCH_S 0.2 /*!< Shortest timed run per encoding benchmark pass */
+#define SIM_FRAME_OVERHEAD 5 /*!< Prefix, length, command and CRC bytes per frame */
+
+static volatile sig_atomic_t flagExit = 0; /*!< Set by SIGINT/SIGTERM */
+
+/*!
+ \brief Request a clean exit
+
+ \param sig
+*/
+static void onSignal(int sig)
+{
+    (void)sig;
+    flagExit = 1;
+}
+
+/*!
+ \brief Returns monotonic seconds
+
+ \return double
+*/
+static double monotonic(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return(now.tv_sec + now.tv_nsec*1e-9);
+}
+
+/*!
+ \brief Read the dBm column of a curve saved by appReportCsv::WriteCurveCsv
+
+ \param Path
+ \param Rssi values rounded to whole dBm as the device sends them
+ \return bool
+*/
+static bool readCurveCsv(const char *Path, std::string &Rssi)
+{
+    FILE   *file = fopen(Path, "r");
+    char    line[256];
+    double  frq, dbm;
+
+    if(!file)
+        return(false);
+
+    Rssi.clear();
+    while(fgets(line, sizeof(line), file))
+    {// Header lines do not start with a number
+        if(sscanf(line, "%lf,%lf", &frq, &dbm)==2)
+        {
+            dbm = (dbm < -128.0) ? -128.0 : (dbm > 127.0) ? 127.0 : dbm;
+            Rssi.push_back((char)(signed char)lround(dbm));
+        };
+    };
+    fclose(file);
+
+    return(!Rssi.empty());
+}
+
+/*!
+ \brief Pack every sweep into CMD_STREAMDATA payloads
+
+ \param Sweeps
+ \param Frames packed payloads, cleared first
+ \return unsigned long bytes on the wire including the frame overhead
+*/
+static unsigned long packSweeps(const std::vector<std::string> &Sweeps, std::vector<std::string> &Frames)
+{
+    unsigned char  frame[SPECPACK_MAX_FRAME];
+    unsigned long  bytes = 0;
+    unsigned short length, packed;
+    unsigned char  size;
+    const int8_t   *rssi;
+
+    Frames.clear();
+    for(size_t sweep=0; sweep<Sweeps.size(); sweep++)
+    {
+        rssi   = (const int8_t*)Sweeps[sweep].data();
+        length = (unsigned short)Sweeps[sweep].size();
+        while(length)
+        {
+            size = specPackFrame(rssi, length, frame, &packed);
+            Frames.push_back(std::string((const char*)frame, size));
+            bytes  += size + SIM_FRAME_OVERHEAD;
+            rssi   += packed;
+            length -= packed;
+        };
+    };
+
+    return(bytes);
+}
+
+/*!
+ \brief Report ratio and codec speed of the CMD_SETENCODING delta format for Sweeps
+
+ \param Name
+ \param Sweeps
+ \return bool false: the packed frames do not decode to the original values
+*/
+static bool benchEncoding(const char *Name, const std::vector<std::string> &Sweeps)
+{
+    std::vector<std::string> frames;
+    std::string   original, decoded;
+    int8_t        values[SPECPACK_MAX_FRAME];
+    unsigned long rawBytes = 0, packedBytes, rounds;
+    unsigned short length;
+    double        start, encodeS, decodeS;
+
+    for(size_t sweep=0; sweep<Sweeps.size(); sweep++)
+    {
+        original += Sweeps[sweep];
+        rawBytes += Sweeps[sweep].size() + SIM_FRAME_OVERHEAD*((Sweeps[sweep].size()+254)/255);
+    };
+    if(original.empty())
+        return(true);
+
+    packedBytes = packSweeps(Sweeps, frames);
+    for(size_t frame=0; frame<frames.size(); frame++)
+    {
+        length = specUnpackFrame((const uint8_t*)frames[frame].data(), (uint8_t)frames[frame].size(), values, SPECPACK_MAX_FRAME);
+        decoded.append((const char*)values, length);
+    };
+    if(decoded!=original)
+    {
+        fprintf(stderr, "sa1350-sim: %s sweeps do not decode to the original values\n", Name);
+        return(false);
+    };
+
+    start = monotonic();
+    for(rounds=0; monotonic()-start < SIM_BENCH_S; rounds++)
+        packSweeps(Sweeps, frames);
+    encodeS = (monotonic()-start)/rounds;
+
+    start = monotonic();
+    for(rounds=0; monotonic()-start < SIM_BENCH_S; rounds++)
+    {
+        for(size_t frame=0; frame<frames.size(); frame++)
+            specUnpackFrame((const uint8_t*)frames[frame].data(), (uint8_t)frames[frame].size(), values, SPECPACK_MAX_FRAME);
+    };
+    decodeS = (monotonic()-start)/rounds;
+
+    printf("%-9s sweeps %6lu  values %9lu  bytes raw %9lu  packed %9lu  ratio %.2f  encode %6.1f  decode %6.1f Mvalues/s\n",
+           Name, (unsigned long)Sweeps.size(), (unsigned long)original.size(), rawBytes, packedBytes,
+           (double)rawBytes/packedBytes, original.size()/encodeS*1e-6, original.size()/decodeS*1e-6);
+
+    return(true);
+}
+
+/*!
+ \brief Print the command line help
+
+ \param name
+*/
+static void usage(const char *name)
+{
+    printf("Usage: %s [options] [curve.csv ...]\n"
+           "  -l, --link PATH         symlink the pty slave to PATH\n"
+           "  -n, --sweep-length N    fixed sweep length (default: follows host span/step)\n"
+           "  -b, --baud N            pace responses to N bit/s (default: unpaced),\n"
+           "                          a rate set by CMD_SETBAUDRATE replaces N\n"
+           "  -m, --max-baud N        highest rate the USB bridge passes (default: any)\n"
+           "  -r, --radio-us N        simulated radio time per sweep point in us\n"
+           "  -t, --turnaround-ms N   delay before a host command is processed\n"
+           "  -c, --crc-errors P      corrupt the CRC of a frame with probability P\n"
+           "  -d, --drop-bytes P      drop a sent byte with probability P\n"
+           "  -s, --seed N            seed for noise and error injection\n"
+           "  -v, --verbose           log every host command\n"
+           "  -e, --bench-encoding N  report the CMD_SETENCODING ratio and speed for N\n"
+           "                          synthetic sweeps and the given curve CSV files, then exit\n",
+           name);
+}
+
+/*!
+ \brief Simulator entry
+
+ \param argc
+ \param argv
+ \return int
+*/
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        {"link",         required_argument, NULL, 'l'},
+        {"sweep-length", required_argument, NULL, 'n'},
+        {"baud",         required_argument, NULL, 'b'},
+        {"max-baud",     required_argument, NULL, 'm'},
+        {"radio-us",     required_argument, NULL, 'r'},
+        {"turnaround-ms",required_argument, NULL, 't'},
+        {"crc-errors",   required_argument, NULL, 'c'},
+        {"drop-bytes",   required_argument, NULL, 'd'},
+        {"seed",         required_argument, NULL, 's'},
+        {"verbose",      no_argument,       NULL, 'v'},
+        {"bench-encoding",required_argument,NULL, 'e'},
+        {"help",         no_argument,       NULL, 'h'},
+        {NULL,           0,                 NULL, 0}
+    };
+    sSimSettings  settings;
+    std::string   link;
+    unsigned long baud = 0;
+    unsigned long turnaround = 0;
+    unsigned long lineBaud = SIM_DEFAULT_BAUD;
+    unsigned long benchSweeps = 0;
+    std::string   rx, tx;
+    cPtyPort      port;
+    int           opt;
+
+    memset(&settings, 0, sizeof(settings));
+    settings.Seed = 1;
+
+    while((opt = getopt_long(argc, argv, "l:n:b:m:r:t:c:d:s:ve:h", options, NULL))!=-1)
+    {
+        switch(opt)
+        {
+        case 'l': link                  = optarg; break;
+        case 'n': settings.SweepLength  = (unsigned short)strtoul(optarg, NULL, 0); break;
+        case 'b': baud                  = strtoul(optarg, NULL, 0); break;
+        case 'm': settings.MaxBaud      = strtoul(optarg, NULL, 0); break;
+        case 'r': settings.RadioUs      = strtoul(optarg, NULL, 0); break;
+        case 't': turnaround            = strtoul(optarg, NULL, 0); break;
+        case 'c': settings.CrcErrorRate = strtod(optarg, NULL); break;
+        case 'd': settings.DropRate     = strtod(optarg, NULL); break;
+        case 's': settings.Seed         = strtoul(optarg, NULL, 0); break;
+        case 'v': settings.Verbose      = true; break;
+        case 'e': benchSweeps           = strtoul(optarg, NULL, 0); break;
+        default:
+            usage(argv[0]);
+            return(opt=='h' ? 0 : 1);
+        };
+    };
+    if(settings.SweepLength > SIM_MAX_SWEEP_LENGTH)
+        settings.SweepLength = SIM_MAX_SWEEP_LENGTH;
+
+    if(benchSweeps || optind<argc)
+    {// Offline benchmark of the delta packed encoding, no pty
+        std::vector<std::string> sweeps;
+        unsigned char  rssi[SIM_MAX_SWEEP_LENGTH];
+        unsigned short length;
+        bool           ok;
+
+        settings.RadioUs = 0;
+        cSimDevice bench(settings);
+        for(unsigned long index=0; index<benchSweeps; index++)
+        {
+            length = bench.MeasureSweep(rssi);
+            sweeps.push_back(std::string((const char*)rssi, length));
+        };
+        ok = benchEncoding("synthetic", sweeps);
+
+        sweeps.clear();
+        for(int index=optind; index<argc; index++)
+        {
+            sweeps.push_back(std::string());
+            if(!readCurveCsv(argv[index], sweeps.back()))
+            {
+                fprintf(stderr, "sa1350-sim: no curve in %s\n", argv[index]);
+                ok = false;
+            };
+        };
+        if(!benchEncoding("recorded", sweeps))
+            ok = false;
+
+        return(ok ? 0 : 1);
+    };
+
+    if(!port.Open(link, baud))
+    {
+        perror("sa1350-sim: could not create pty");
+        return(1);
+    };
+    printf("%s\n", link.empty() ? port.GetSlaveName().c_str() : link.c_str());
+    fflush(stdout);
+
+    signal(SIGINT,  onSignal);
+    signal(SIGTERM, onSignal);
+
+    cSimDevice device(settings);
+    while(!flagExit)
+    {
+        // Like the firmware, stream sweeps while the host is silent
+        if(!port.Read(rx, device.IsStreaming() ? 0 : device.IsSyncPending() ? SIM_SYNC_MS : SIM_POLL_MS))
+            break;
+        if(!rx.empty())
+        {// USB latency and task scheduling of the real link
+            if(turnaround)
+                usleep(turnaround*1000);
+            device.SetHostBaudRate(port.GetHostBaud());
+            device.Receive((const unsigned char*)rx.data(), rx.size());
+        }
+        else if(device.IsStreaming())
+            device.StreamSweep();
+        device.CheckSyncTimeout();
+        device.CheckLinkIdle();
+        if(device.GetTxData(tx) && !port.Write(tx))
+            break;
+        // The ACK of CMD_SETBAUDRATE left at the old rate, switch after it
+        if(device.GetBaudRate()!=lineBaud)
+        {
+            lineBaud = device.GetBaudRate();
+            if(baud)
+                port.SetBaud(lineBaud==SIM_DEFAULT_BAUD ? baud : lineBaud);
+        };
+    };
+    port.Close();
+
+    const sSimStats &stats = device.GetStats();
+    fprintf(stderr, "sa1350-sim: commands %lu (crc errors %lu), sweeps %lu, frames %lu (corrupted %lu), bytes %lu (dropped %lu), host bytes garbled %lu, link resets %lu\n",
+            stats.Commands, stats.CrcErrors, stats.Sweeps, stats.FramesSent,
+            stats.FramesCorrupt, stats.BytesSent, stats.BytesDropped, stats.BytesGarbled, stats.LinkResets);
+
+    return(0);
+}
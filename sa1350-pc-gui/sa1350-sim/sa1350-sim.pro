@@ -0,0 +1,35 @@
+QT       -= core gui
+
+
+TEMPLATE  = app
+
+CONFIG    += console
+CONFIG    += warn_on
+CONFIG    += c++11
+CONFIG    -= app_bundle
+
+# pty based, Linux/macOS only
+!unix:error("sa1350-sim needs a POSIX pseudo-terminal")
+
+INCLUDEPATH += ../sa1350-dll
+INCLUDEPATH += ../../sa1350-firmware/crc16
+INCLUDEPATH += ../../sa1350-firmware/specpack
+INCLUDEPATH += ../../sa1350-firmware/detector
+
+SOURCES += \
+    ../../sa1350-firmware/crc16/crc16.c \
+    ../../sa1350-firmware/specpack/specPack.c \
+    ../../sa1350-firmware/detector/detector.c \
+    cSimDevice.cpp \
+    cPtyPort.cpp \
+    main.cpp
+
+HEADERS += \
+    ../../sa1350-firmware/crc16/crc16.h \
+    ../../sa1350-firmware/specpack/specPack.h \
+    ../../sa1350-firmware/detector/detector.h \
+    ../sa1350-dll/sa1350Cmd.h \
+    cSimDevice.h \
+    cPtyPort.h
+
+TARGET    = sa1350-sim
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file benchCrc16.c
+ *
+ *  Time per byte of the bitwise CRC16 of firmware 1.3 against crc16Update()
+ *  on frame sized blocks. Cycles are TSC cycles on x86 hosts, other hosts
+ *  report nanoseconds only. Built once per #CRC16_SLICE_BY.
+ *
+ *  Usage: benchCrc16 [megabytes]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC
+#endif
+
+#include "crc16.h"
+
+/***** Defines *****/
+
+#define HDR_PREFIX		(0x2AU)		/*!< Frame marker, seed of the CRC	*/
+#define BUFFER_SIZE		(4096U)		/*!< Data the blocks are taken from	*/
+
+/***** Variable declarations *****/
+
+/** @brief Block sizes timed: an ACK, a version 1 frame and a version 2
+ *  frame of a 2048 point sweep.
+ */
+static const size_t blockSizes[] = {5U, 258U, 2057U};
+
+/** @brief Keeps the compiler from dropping the CRC calculations.
+ */
+static volatile uint16_t crcSink;
+
+/***** Function definitions *****/
+
+/** @brief Bitwise CRC16 step of firmware 1.3, copied unchanged.
+ *
+ *  @param addb active CRC16 value.
+ *  @param u8 data byte to add.
+ */
+static void crc16AddByte(uint16_t *addb, uint8_t u8)
+{
+	*addb  = (*addb >> 8U) | (*addb << 8U);
+	*addb ^=  u8;
+	*addb ^= (*addb & 0xFFU) >> 4U;
+	*addb ^= (*addb << 8U) << 4U;
+	*addb ^= ((*addb & 0xFFU) << 4U) << 1U;
+}
+
+/** @brief Bitwise CRC16 of a block, the loop of calcCrc16().
+ */
+static uint16_t bitwiseCrc16(uint16_t crc, const void *data, size_t length)
+{
+	const uint8_t *bytes = data;
+	size_t index;
+
+	for (index = 0U; index < length; index++)
+	{
+		crc16AddByte(&crc, bytes[index]);
+	}
+
+	return crc;
+}
+
+/** @brief Seconds since an arbitrary start.
+ */
+static double monotonic(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/** @brief Read the cycle counter, 0 where there is none.
+ */
+static unsigned long long cycles(void)
+{
+#ifdef HAVE_TSC
+	return __rdtsc();
+#else
+	return 0U;
+#endif
+}
+
+/** @brief Time one CRC function over a number of bytes in blocks.
+ *
+ *  @param name printed name.
+ *  @param crcFxn function to time.
+ *  @param buffer data.
+ *  @param blockSize bytes per call.
+ *  @param totalBytes bytes to add in total.
+ *
+ *  @return nanoseconds per byte
+ */
+static double timeCrc(const char *name,
+		uint16_t (*crcFxn)(uint16_t, const void *, size_t),
+		const uint8_t *buffer, size_t blockSize, size_t totalBytes)
+{
+	size_t blocks = totalBytes / blockSize;
+	size_t block, offset = 0U;
+	unsigned long long startCycles;
+	double start, seconds, bytes;
+	uint16_t crc = HDR_PREFIX;
+
+	start = monotonic();
+	startCycles = cycles();
+	for (block = 0U; block < blocks; block++)
+	{
+		crc = crcFxn(crc, &buffer[offset], blockSize);
+		offset = (offset + 64U) % (BUFFER_SIZE - blockSize);
+	}
+	bytes = (double)blocks * blockSize;
+	seconds = monotonic() - start;
+	crcSink = crc;
+
+#ifdef HAVE_TSC
+	printf("%-14s %5u byte blocks: %6.2f ns/byte %6.2f cycles/byte %8.1f MB/s\n",
+			name, (unsigned)blockSize, seconds * 1e9 / bytes,
+			(cycles() - startCycles) / bytes, bytes / seconds / 1e6);
+#else
+	(void)startCycles;
+	printf("%-14s %5u byte blocks: %6.2f ns/byte %8.1f MB/s\n",
+			name, (unsigned)blockSize, seconds * 1e9 / bytes,
+			bytes / seconds / 1e6);
+#endif
+
+	return seconds * 1e9 / bytes;
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t buffer[BUFFER_SIZE];
+	size_t totalBytes = (size_t)((argc > 1) ? atoi(argv[1]) : 64) << 20U;
+	char name[16];
+	double bitwise, table;
+	unsigned int index;
+
+	srand(1350U);
+	for (index = 0U; index < BUFFER_SIZE; index++)
+	{
+		buffer[index] = (uint8_t)rand();
+	}
+
+	snprintf(name, sizeof(name), "slice-by-%u", (unsigned)CRC16_SLICE_BY);
+	for (index = 0U; index < sizeof(blockSizes) / sizeof(blockSizes[0U]); index++)
+	{
+		bitwise = timeCrc("bitwise", bitwiseCrc16, buffer, blockSizes[index],
+				totalBytes);
+		table = timeCrc(name, crc16Update, buffer, blockSizes[index],
+				totalBytes);
+		printf("%-14s %5u byte blocks: %.1fx faster\n", "", (unsigned)blockSizes[index],
+				bitwise / table);
+	}
+
+	return 0;
+}
@@ -0,0 +1,367 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file benchDecoder.cpp
+ \brief Frame decoder throughput, the std::string decoder of DLL 1.3 against
+ the ring buffer decoder
+
+ Both decoders get the same byte stream of 2048 point sweeps in reads of
+ DRV_READ_SIZE bytes, as the receiver thread gets them from the comport,
+ and hand every frame to a consumer. The checksums of the decoded payloads
+ must match.
+
+ Usage: benchDecoder [sweeps]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <list>
+#include <chrono>
+
+#include "cDeviceDriverTest.h"
+#include "sa1350Cmd.h"
+
+#define DRV_READ_SIZE   4096    /*!< Bytes per comport read */
+#define SWEEP_POINTS    2048    /*!< Values per sweep */
+#define SWEEP_FRAME_SIZE 255    /*!< Values per version 1 frame */
+
+/*!
+ \brief Frame of the DLL 1.3 decoder, payload on the heap
+
+ \struct sLegacyFrame
+*/
+typedef struct sLegacyFrame
+{
+    unsigned char  Cmd;     /*!< Command */
+    unsigned char  Length;  /*!< Payload length */
+    std::string    Data;    /*!< Payload */
+    unsigned short Crc;     /*!< Received Crc */
+}sLegacyFrame;
+
+/*!
+ \brief Frame decoder of DLL 1.3: byte by byte off the front of a
+ std::string, bitwise Crc, frames in a locked std::list
+
+ \class cLegacyDecoder
+*/
+class cLegacyDecoder
+{
+public:
+    cLegacyDecoder(void) : State(0), Crc(FRAME_MARKER), DataIndex(0) {}
+
+    /*!
+     \brief Append one comport read and decode it
+
+     \param Data
+     \param Length
+    */
+    void Receive(const unsigned char *Data, unsigned long Length)
+    {
+        RxFifo.append((const char*)Data, Length);
+        Decode();
+    }
+    /*!
+     \brief Take the oldest frame
+
+     \param Frame
+    */
+    bool GetFrame(sLegacyFrame *Frame)
+    {
+        bool ok = false;
+
+        FrameFifoAccess.Lock();
+        if(!FrameFifo.empty())
+        {
+            *Frame = FrameFifo.front();
+            FrameFifo.pop_front();
+            ok = true;
+        };
+        FrameFifoAccess.Unlock();
+
+        return(ok);
+    }
+
+private:
+    std::string             RxFifo;          /*!< Received bytes */
+    std::list<sLegacyFrame> FrameFifo;       /*!< Decoded frames */
+    cMutex                  FrameFifoAccess; /*!< FrameFifo lock */
+    int                     State;           /*!< Decoder state */
+    unsigned short          Crc;             /*!< Running Crc */
+    unsigned short          DataIndex;       /*!< Payload bytes received */
+    sLegacyFrame            Frame;           /*!< Frame being received */
+
+    static void crc16AddByte(unsigned short &crc, unsigned char u8)
+    {
+        crc  = (unsigned char)(crc>>8)|(crc<<8);
+        crc ^=  u8;
+        crc ^= (unsigned char)(crc & 0xff)>>4;
+        crc ^= (crc << 8) << 4;
+        crc ^= ((crc & 0xff) << 4)<< 1;
+    }
+
+    void Decode(void)
+    {
+        unsigned char u8Data;
+
+        while(!RxFifo.empty())
+        {
+            u8Data = (unsigned char)RxFifo.at(0);
+            RxFifo.erase(RxFifo.begin());
+            switch(State)
+            {
+            case 0:
+                if(u8Data==FRAME_MARKER)
+                {
+                    Crc       = FRAME_MARKER;
+                    DataIndex = 0;
+                    Frame.Data.clear();
+                    State     = 1;
+                };
+                break;
+            case 1:
+                Frame.Length = u8Data;
+                crc16AddByte(Crc,u8Data);
+                State = 2;
+                break;
+            case 2:
+                Frame.Cmd = u8Data;
+                crc16AddByte(Crc,u8Data);
+                State = (Frame.Length > 0) ? 3 : 4;
+                break;
+            case 3:
+                Frame.Data.push_back((char)u8Data);
+                crc16AddByte(Crc,u8Data);
+                if(++DataIndex == Frame.Length)
+                    State = 4;
+                break;
+            case 4:
+                Frame.Crc = (unsigned short)(u8Data<<8);
+                State = 5;
+                break;
+            case 5:
+                Frame.Crc += u8Data;
+                State = 0;
+                if(Frame.Crc == Crc)
+                {
+                    FrameFifoAccess.Lock();
+                    FrameFifo.push_back(Frame);
+                    FrameFifoAccess.Unlock();
+                };
+                break;
+            };
+        };
+    }
+};
+
+/*!
+ \brief Build the byte stream of a number of streamed sweeps
+
+ \param Stream
+ \param Sweeps
+ \param Version2 one version 2 frame per sweep instead of 255 byte frames
+*/
+static void buildStream(std::string &Stream, int Sweeps, bool Version2)
+{
+    unsigned char sweep[SWEEP_POINTS];
+    unsigned char start[4];
+    unsigned int  index;
+    unsigned int  size;
+    int           count;
+    unsigned char seq = 0;
+
+    for(count=0; count<Sweeps; count++)
+    {
+        for(index=0; index<SWEEP_POINTS; index++)
+            sweep[index] = (unsigned char)(-100 + (int)((index*7u + count*13u) % 40u));
+        start[0] = (unsigned char)(count>>8);
+        start[1] = (unsigned char)count;
+        start[2] = (unsigned char)(SWEEP_POINTS>>8);
+        start[3] = (unsigned char)SWEEP_POINTS;
+        if(Version2)
+        {
+            appendFrameV2(Stream, CMD_STREAMSWEEP, seq++, (unsigned short)count, start, sizeof(start));
+            appendFrameV2(Stream, CMD_STREAMDATA, seq++, (unsigned short)count, sweep, SWEEP_POINTS);
+            continue;
+        };
+        appendFrameV1(Stream, CMD_STREAMSWEEP, start, sizeof(start));
+        for(index=0; index<SWEEP_POINTS; index+=size)
+        {
+            size = SWEEP_POINTS-index;
+            if(size > SWEEP_FRAME_SIZE)
+                size = SWEEP_FRAME_SIZE;
+            appendFrameV1(Stream, CMD_STREAMDATA, &sweep[index], (unsigned char)size);
+        };
+    };
+}
+
+/*!
+ \brief Sum of all payload bytes, weighted by position
+
+ \param Sum
+ \param Data
+ \param Length
+*/
+static void addChecksum(unsigned long long &Sum, const unsigned char *Data, unsigned long Length)
+{
+    unsigned long index;
+
+    for(index=0; index<Length; index++)
+        Sum = Sum*31u + Data[index];
+}
+
+/*!
+ \brief Seconds since an arbitrary start
+
+*/
+static double monotonic(void)
+{
+    return(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*!
+ \brief Print one result line
+
+*/
+static void report(const char *Name, const std::string &Stream, long Frames, double Seconds)
+{
+    printf("%-28s %8.1f MB/s %10.0f frames/s (%ld frames, %.3f s)\n", Name,
+           Stream.size()/Seconds/1e6, Frames/Seconds, Frames, Seconds);
+}
+
+/*!
+ \brief Decode the stream with the DLL 1.3 decoder
+
+ \param Stream
+ \param Sum checksum of the decoded payloads
+ \param Seconds time taken
+ \return number of decoded frames
+*/
+static long runLegacy(const std::string &Stream, unsigned long long &Sum, double &Seconds)
+{
+    cLegacyDecoder decoder;
+    sLegacyFrame   frame;
+    unsigned long  offset;
+    unsigned long  size;
+    long           frames = 0;
+    double         start = monotonic();
+
+    for(offset=0; offset<Stream.size(); offset+=size)
+    {
+        size = Stream.size()-offset;
+        if(size > DRV_READ_SIZE)
+            size = DRV_READ_SIZE;
+        decoder.Receive((const unsigned char*)&Stream[offset], size);
+        while(decoder.GetFrame(&frame))
+        {
+            addChecksum(Sum, (const unsigned char*)frame.Data.data(), frame.Length);
+            frames++;
+        };
+    };
+    Seconds = monotonic()-start;
+
+    return(frames);
+}
+
+/*!
+ \brief Decode the stream with the ring buffer decoder of cDeviceDriver
+
+ \param Stream
+ \param Sum checksum of the decoded payloads
+ \param Seconds time taken
+ \return number of decoded frames
+*/
+static long runRing(const std::string &Stream, unsigned long long &Sum, double &Seconds)
+{
+    cDeviceDriver driver;
+    cRingBuffer   rxFifo(DRV_RX_BUFFER_SIZE);
+    sFrame       *frame;
+    unsigned long offset;
+    unsigned long size;
+    long          frames = 0;
+    double        start = monotonic();
+
+    for(offset=0; offset<Stream.size(); offset+=size)
+    {
+        size = Stream.size()-offset;
+        if(size > DRV_READ_SIZE)
+            size = DRV_READ_SIZE;
+        size = storeBytes(&rxFifo, (const unsigned char*)&Stream[offset], size);
+        cDeviceDriverTest::Decode(driver, &rxFifo);
+        while((frame = driver.PeekFrame()) != NULL)
+        {
+            addChecksum(Sum, frame->Data, frame->Length);
+            driver.ReleaseFrame();
+            frames++;
+        };
+    };
+    Seconds = monotonic()-start;
+
+    return(frames);
+}
+
+int main(int argc, char **argv)
+{
+    int                sweeps = (argc > 1) ? atoi(argv[1]) : 5000;
+    std::string        stream1;
+    std::string        stream2;
+    unsigned long long sumLegacy = 0;
+    unsigned long long sumRing = 0;
+    unsigned long long sumRing2 = 0;
+    long               framesLegacy, framesRing, framesRing2;
+    double             secondsLegacy, secondsRing, secondsRing2;
+
+    buildStream(stream1, sweeps, false);
+    buildStream(stream2, sweeps, true);
+    printf("%d sweeps of %d points, %.1f MB in version 1 and %.1f MB in version 2 frames, %d byte reads\n",
+           sweeps, SWEEP_POINTS, stream1.size()/1e6, stream2.size()/1e6, DRV_READ_SIZE);
+
+    framesLegacy = runLegacy(stream1, sumLegacy, secondsLegacy);
+    framesRing   = runRing(stream1, sumRing, secondsRing);
+    framesRing2  = runRing(stream2, sumRing2, secondsRing2);
+
+    report("std::string decoder, v1", stream1, framesLegacy, secondsLegacy);
+    report("ring buffer decoder, v1", stream1, framesRing, secondsRing);
+    report("ring buffer decoder, v2", stream2, framesRing2, secondsRing2);
+    printf("speedup v1 %.1fx\n", secondsLegacy/secondsRing);
+
+    if(framesLegacy != framesRing || sumLegacy != sumRing)
+    {
+        printf("FAIL: decoders disagree, %ld/%ld frames\n", framesLegacy, framesRing);
+        return(1);
+    };
+    if(framesRing2 != 2*sweeps)
+    {
+        printf("FAIL: %ld version 2 frames, expected %d\n", framesRing2, 2*sweeps);
+        return(1);
+    };
+
+    return(0);
+}
@@ -0,0 +1,309 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file benchFrameQueue.cpp
+ \brief Stress test and handoff latency of cFrameQueue against the locked
+ std::list of DLL 1.3
+
+ A producer thread publishes numbered frames, a consumer thread takes them
+ and checks that every frame arrives once, in order and unchanged. The
+ handoff latency of each frame is the time from its publication to the
+ consumer seeing it.
+
+ The stress run publishes as fast as the queue takes the frames. The
+ producer waits while cFrameQueue is full, the list grows without limit as
+ before. The paced run publishes one frame every PACED_PERIOD_NS, which is
+ the handoff latency without a backlog.
+
+ Usage: benchFrameQueue [frames]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <list>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include "cFrameQueue.h"
+#include "cMutex.h"
+
+#define FRAME_PAYLOAD   250     /*!< Payload of a version 1 spectrum frame */
+#define PACED_PERIOD_NS 20000   /*!< Frame period of the paced run */
+
+/*!
+ \brief Frame of DLL 1.3, payload on the heap
+
+ \struct sLegacyFrame
+*/
+typedef struct sLegacyFrame
+{
+    unsigned char  Cmd;     /*!< Command */
+    unsigned char  Length;  /*!< Payload length */
+    std::string    Data;    /*!< Payload */
+    unsigned short Crc;     /*!< Received Crc */
+}sLegacyFrame;
+
+/*!
+ \brief Result of one run
+
+ \struct sQueueResult
+*/
+typedef struct sQueueResult
+{
+    double        Seconds;   /*!< Time to pass all frames */
+    long          Errors;    /*!< Frames lost, repeated, out of order or changed */
+    std::vector<double> Latency; /*!< Handoff latency of every frame in us */
+}sQueueResult;
+
+/*!
+ \brief Nanoseconds since an arbitrary start
+
+*/
+static long long nowNs(void)
+{
+    return(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*!
+ \brief Wait until the publication time of frame Index in a paced run
+
+ \param Start
+ \param Index
+ \param PeriodNs 0 to publish at once
+*/
+static void waitPublish(long long Start, long Index, long long PeriodNs)
+{
+    while(PeriodNs && nowNs() < Start+Index*PeriodNs)
+        std::this_thread::yield();
+}
+
+/*!
+ \brief Fill the payload of frame number Index, the publication time in front
+
+ \param Data
+ \param Index
+*/
+static void fillPayload(unsigned char *Data, long Index)
+{
+    long long stamp = nowNs();
+    int       pos;
+
+    memcpy(Data, &Index, sizeof(Index));
+    for(pos=(int)(sizeof(Index)+sizeof(stamp)); pos<FRAME_PAYLOAD; pos++)
+        Data[pos] = (unsigned char)(Index+pos);
+    memcpy(&Data[sizeof(Index)], &stamp, sizeof(stamp));
+}
+
+/*!
+ \brief Check the payload of a received frame
+
+ \param Data
+ \param Expected frame number expected next
+ \param Latency returns the handoff latency in us
+ \return true if it is the expected frame and unchanged
+*/
+static bool checkPayload(const unsigned char *Data, long Expected, double &Latency)
+{
+    long      index;
+    long long stamp;
+    int       pos;
+
+    memcpy(&index, Data, sizeof(index));
+    memcpy(&stamp, &Data[sizeof(index)], sizeof(stamp));
+    Latency = (nowNs()-stamp)/1e3;
+    if(index != Expected)
+        return(false);
+    for(pos=(int)(sizeof(index)+sizeof(stamp)); pos<FRAME_PAYLOAD; pos++)
+    {
+        if(Data[pos] != (unsigned char)(index+pos))
+            return(false);
+    };
+
+    return(true);
+}
+
+/*!
+ \brief Pass frames through cFrameQueue
+
+ \param Frames
+ \param PeriodNs frame period, 0 for the stress run
+ \param Result
+*/
+static void runQueue(long Frames, long long PeriodNs, sQueueResult &Result)
+{
+    cFrameQueue queue(256);
+    long long   start = nowNs();
+
+    std::thread producer([&]()
+    {
+        sFrame *frame;
+        long    index;
+
+        for(index=0; index<Frames; index++)
+        {
+            waitPublish(start, index, PeriodNs);
+            while((frame = queue.Alloc()) == NULL)
+                std::this_thread::yield();
+            frame->Cmd    = 35;
+            frame->Length = FRAME_PAYLOAD;
+            fillPayload(frame->Data, index);
+            queue.Push();
+        };
+    });
+
+    sFrame *frame;
+    double  latency;
+    long    index;
+
+    for(index=0; index<Frames; index++)
+    {
+        while((frame = queue.Front()) == NULL)
+            std::this_thread::yield();
+        if(frame->Length != FRAME_PAYLOAD || !checkPayload(frame->Data, index, latency))
+            Result.Errors++;
+        Result.Latency.push_back(latency);
+        queue.Pop();
+    };
+    producer.join();
+    Result.Seconds = (nowNs()-start)/1e9;
+}
+
+/*!
+ \brief Pass frames through a std::list locked with cMutex, as DLL 1.3 did
+
+ \param Frames
+ \param PeriodNs frame period, 0 for the stress run
+ \param Result
+*/
+static void runList(long Frames, long long PeriodNs, sQueueResult &Result)
+{
+    std::list<sLegacyFrame> list;
+    cMutex                  access;
+    long long               start = nowNs();
+
+    std::thread producer([&]()
+    {
+        sLegacyFrame  frame;
+        unsigned char data[FRAME_PAYLOAD];
+        long          index;
+
+        for(index=0; index<Frames; index++)
+        {
+            waitPublish(start, index, PeriodNs);
+            frame.Cmd    = 35;
+            frame.Length = FRAME_PAYLOAD;
+            fillPayload(data, index);
+            frame.Data.assign((const char*)data, FRAME_PAYLOAD);
+            access.Lock();
+            list.push_back(frame);
+            access.Unlock();
+        };
+    });
+
+    sLegacyFrame frame;
+    bool         got;
+    double       latency;
+    long         index;
+
+    for(index=0; index<Frames; index++)
+    {
+        do
+        {
+            access.Lock();
+            got = !list.empty();
+            if(got)
+            {
+                frame = list.front();
+                list.pop_front();
+            };
+            access.Unlock();
+            if(!got)
+                std::this_thread::yield();
+        }while(!got);
+        if(frame.Length != FRAME_PAYLOAD || !checkPayload((const unsigned char*)frame.Data.data(), index, latency))
+            Result.Errors++;
+        Result.Latency.push_back(latency);
+    };
+    producer.join();
+    Result.Seconds = (nowNs()-start)/1e9;
+}
+
+/*!
+ \brief Print one result line
+
+*/
+static void report(const char *Name, long Frames, sQueueResult &Result)
+{
+    std::vector<double> &lat = Result.Latency;
+
+    std::sort(lat.begin(), lat.end());
+    printf("%-24s %10.0f frames/s  latency p50 %8.1f us  p99 %8.1f us  max %9.1f us  errors %ld\n",
+           Name, Frames/Result.Seconds, lat[lat.size()/2], lat[lat.size()*99/100], lat.back(), Result.Errors);
+}
+
+int main(int argc, char **argv)
+{
+    long         frames = (argc > 1) ? atol(argv[1]) : 2000000;
+    long         paced  = frames/20;
+    sQueueResult result[4];
+    int          run;
+    long         errors = 0;
+
+    printf("%ld frames of %d bytes, %u hardware threads\n", frames, FRAME_PAYLOAD, std::thread::hardware_concurrency());
+    for(run=0; run<4; run++)
+    {
+        result[run].Seconds = 0;
+        result[run].Errors  = 0;
+        result[run].Latency.reserve((run < 2) ? frames : paced);
+    };
+
+    runList(frames, 0, result[0]);
+    runQueue(frames, 0, result[1]);
+    runList(paced, PACED_PERIOD_NS, result[2]);
+    runQueue(paced, PACED_PERIOD_NS, result[3]);
+    report("stress std::list+cMutex", frames, result[0]);
+    report("stress cFrameQueue", frames, result[1]);
+    report("paced  std::list+cMutex", paced, result[2]);
+    report("paced  cFrameQueue", paced, result[3]);
+
+    for(run=0; run<4; run++)
+        errors += result[run].Errors;
+    if(errors)
+    {
+        printf("FAIL: frames lost, repeated or changed\n");
+        return(1);
+    };
+
+    return(0);
+}
@@ -0,0 +1,200 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file benchGetFrames.cpp
+ \brief Sweeps per second of the GUI driver loop against sa1350-sim, one
+ sa1350GetFrame per pass against sa1350GetFrames
+
+ The loop of drvSA1350::run is replayed on the DLL: send CMD_GETSPECNOINIT,
+ wait for its ACK, take the sweep frames until the closing CMD_GETLASTERROR.
+ The simulator sends fixed length sweeps, unpaced unless a line rate is
+ given, so the host loop is the limit. Three loops are timed:
+
+ - per frame: one sa1350GetFrame and a 1 ms sleep per pass, the loop before
+   DECODER_FRAME_BATCH
+ - batched: up to DECODER_FRAME_BATCH frames per sa1350GetFrames, the 1 ms
+   sleep only on an empty pass
+ - batched, wait: as batched, an empty pass waits in sa1350WaitForFrame
+
+ Every sweep must add up to its length.
+
+ Usage: benchGetFrames [seconds per loop] [bit/s]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "simLink.h"
+
+#define DECODER_FRAME_BATCH 32      /*!< Frames per sa1350GetFrames, as drvSA1350.h */
+#define DRV_IDLE_WAIT_MS    20      /*!< Frame wait of an empty pass, as drvSA1350.h */
+#define SWEEP_POINTS        2048    /*!< Values per sweep */
+
+/*!
+ \brief Host loop variants
+
+ \enum eLoop
+*/
+typedef enum eLoop
+{
+    LOOP_FRAME,     /*!< sa1350GetFrame and a 1 ms sleep per pass */
+    LOOP_BATCH,     /*!< sa1350GetFrames, 1 ms sleep when empty */
+    LOOP_WAIT       /*!< sa1350GetFrames, sa1350WaitForFrame when empty */
+}eLoop;
+
+/*!
+ \brief Run one host loop for the given time
+
+ \param Loop
+ \param Seconds time to run, returns the time taken
+ \param Frames number of frames taken
+ \return long number of complete sweeps, -1 on a short sweep or a missing ACK
+*/
+static long runLoop(eLoop Loop, double &Seconds, long &Frames)
+{
+    static SA1350Frame frames[DECODER_FRAME_BATCH];
+    unsigned short     count;
+    unsigned short     index;
+    unsigned long      received = 0;
+    bool               busy = false;
+    long               sweeps = 0;
+    double             start = monotonic();
+    double             stop = start+Seconds;
+
+    Frames = 0;
+    while(busy || monotonic() < stop)
+    {
+        count = 0;
+        if(!busy)
+        {// cmdGetSpectrum
+            if(!cSimLink::Command(CMD_GETSPECNOINIT, NULL, 0, 1000))
+            {
+                printf("FAIL: no ACK of CMD_GETSPECNOINIT\n");
+                return(-1);
+            };
+            received = 0;
+            busy = true;
+        }
+        else if(Loop==LOOP_FRAME)
+        {
+            if(sa1350IsFrameAvailable() && sa1350GetFrame(&frames[0]))
+                count = 1;
+        }
+        else
+            sa1350GetFrames(frames, DECODER_FRAME_BATCH, count);
+
+        for(index=0; index<count; index++)
+        {
+            Frames++;
+            if(frames[index].Cmd==CMD_GETSPECNOINIT)
+                received += frames[index].Length;
+            else if(frames[index].Cmd==CMD_GETLASTERROR && frames[index].Length==2)
+            {
+                if(received!=SWEEP_POINTS)
+                {
+                    printf("FAIL: sweep of %lu values, expected %d\n", received, SWEEP_POINTS);
+                    return(-1);
+                };
+                sweeps++;
+                busy = false;
+            };
+        };
+
+        // End of the drvSA1350::run pass
+        if(Loop==LOOP_FRAME)
+            usleep(1000);
+        else if(count==0)
+        {
+            if(Loop==LOOP_BATCH || !busy)
+                usleep(1000);
+            else
+                sa1350WaitForFrame(DRV_IDLE_WAIT_MS);
+        };
+    };
+    Seconds = monotonic()-start;
+
+    return(sweeps);
+}
+
+/*!
+ \brief Print one result line
+
+*/
+static void report(const char *Name, long Sweeps, long Frames, double Seconds)
+{
+    printf("%-24s %8.1f sweeps/s %9.0f frames/s (%ld sweeps, %.3f s)\n", Name,
+           Sweeps/Seconds, Frames/Seconds, Sweeps, Seconds);
+}
+
+int main(int argc, char **argv)
+{
+    static const char *names[] = {"per frame", "batched", "batched, wait"};
+    double             seconds[3];
+    double             rate[3];
+    long               sweeps[3];
+    long               frames[3];
+    std::vector<std::string> args = {"-n", std::to_string(SWEEP_POINTS)};
+    unsigned long      baud = (argc > 2) ? strtoul(argv[2], NULL, 0) : 0;
+    cSimLink           sim;
+    int                loop;
+
+    if(baud)
+    {
+        args.push_back("-b");
+        args.push_back(std::to_string(baud));
+    };
+    if(!sim.Start(argv[0], args))
+        return(1);
+    if(baud)
+        printf("%d point sweeps from sa1350-sim at %lu bit/s, batches of %d frames\n",
+               SWEEP_POINTS, baud, DECODER_FRAME_BATCH);
+    else
+        printf("%d point sweeps from sa1350-sim, unpaced, batches of %d frames\n",
+               SWEEP_POINTS, DECODER_FRAME_BATCH);
+
+    for(loop=LOOP_FRAME; loop<=LOOP_WAIT; loop++)
+    {
+        seconds[loop] = (argc > 1) ? atof(argv[1]) : 2.0;
+        sweeps[loop] = runLoop((eLoop)loop, seconds[loop], frames[loop]);
+        if(sweeps[loop] <= 0)
+        {
+            if(sweeps[loop]==0)
+                printf("FAIL: no sweep in %.1f s\n", seconds[loop]);
+            return(1);
+        };
+        rate[loop] = sweeps[loop]/seconds[loop];
+        report(names[loop], sweeps[loop], frames[loop], seconds[loop]);
+    };
+    printf("speedup batched %.1fx, batched with wait %.1fx\n",
+           rate[LOOP_BATCH]/rate[LOOP_FRAME], rate[LOOP_WAIT]/rate[LOOP_FRAME]);
+
+    return(0);
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file benchHandoff.c
+ *
+ *  Runs the RF and UART tasks of the firmware on the mocks of mockTi.h and
+ *  streams sweeps to a host for a while. Reports the sweeps sent and
+ *  measured per second, the share of time the RF core tuned and the UART
+ *  sent, and how much of the tuning happened while the UART was sending.
+ *  Fails when no sweep arrives or the RF task never measured while the UART
+ *  task sent, that is when the two tasks take turns.
+ *
+ *  Usage: benchHandoff [seconds] [CMD_FS microseconds] [baud rate]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mockTi.h"
+#include "SA1350_Firmware.h"
+
+/***** Defines *****/
+
+#define CMD_CONNECT			(1U)
+#define CMD_SYNC			(7U)
+#define CMD_SETBAUDRATE		(8U)
+#define CMD_STARTSTREAM		(32U)
+#define CMD_STREAMSWEEP		(34U)
+
+#define REPLY_TIMEOUT_MS	(2000)	/*!< Wait for an ACK or a sweep		*/
+
+/***** Function definitions *****/
+
+/** @brief Send a command and wait for its ACK, skipping other frames.
+ *
+ *  @return 0 on ACK, -1 on timeout
+ */
+static int command(uint8_t cmd, const uint8_t *payload, uint8_t length)
+{
+	uint8_t frame[MOCK_FRAME_MAX];
+
+	mockHostSend(cmd, payload, length);
+
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if ((frame[1U] == 0U) && (frame[2U] == cmd))
+		{
+			return 0;
+		}
+	}
+
+	fprintf(stderr, "FAIL: no ACK of command %u\n", cmd);
+	return -1;
+}
+
+int main(int argc, char **argv)
+{
+	double seconds = (argc > 1) ? atof(argv[1]) : 2.0;
+	uint32_t baudRate = (argc > 3) ? (uint32_t)atol(argv[3]) : 115200U;
+	uint8_t baudPayload[4U];
+	uint8_t frame[MOCK_FRAME_MAX];
+	MockRfStats rfStart = {0};
+	MockUartStats uartStart = {0};
+	long long start = 0, end = 0, elapsedNs;
+	long sent = 0;
+	uint16_t firstSeq = 0U, lastSeq = 0U, points = 0U;
+	double rfBusy, uartBusy, overlap;
+
+	if (argc > 2)
+	{
+		mockRfTiming.fsUs = (uint32_t)atol(argv[2]);
+	}
+
+	mockUartInit();
+	RfTask_init();
+	UartTask_init();
+
+	if (command(CMD_CONNECT, NULL, 0U) != 0)
+	{
+		return 1;
+	}
+	if (baudRate != 115200U)
+	{
+		baudPayload[0U] = (uint8_t)(baudRate >> 24U);
+		baudPayload[1U] = (uint8_t)(baudRate >> 16U);
+		baudPayload[2U] = (uint8_t)(baudRate >> 8U);
+		baudPayload[3U] = (uint8_t)baudRate;
+		if ((command(CMD_SETBAUDRATE, baudPayload, 4U) != 0)
+				|| (command(CMD_SYNC, NULL, 0U) != 0))
+		{
+			return 1;
+		}
+	}
+	if (command(CMD_STARTSTREAM, NULL, 0U) != 0)
+	{
+		return 1;
+	}
+
+	/* Count from the first sweep on, the stream has settled */
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if (frame[2U] != CMD_STREAMSWEEP)
+		{
+			continue;
+		}
+
+		lastSeq = ((uint16_t)frame[3U] << 8U) | frame[4U];
+		points = ((uint16_t)frame[5U] << 8U) | frame[6U];
+
+		if (start == 0)
+		{
+			start = mockNowNs();
+			end = start + (long long)(seconds * 1e9);
+			firstSeq = lastSeq;
+			rfStart = mockRfStats;
+			uartStart = mockUartStats;
+			continue;
+		}
+
+		sent++;
+		if (mockNowNs() >= end)
+		{
+			break;
+		}
+	}
+
+	if (sent == 0)
+	{
+		fprintf(stderr, "FAIL: no streamed sweeps\n");
+		return 1;
+	}
+
+	elapsedNs = mockNowNs() - start;
+	rfBusy = (double)(mockRfStats.fsNs - rfStart.fsNs);
+	uartBusy = (double)(mockUartStats.sendNs - uartStart.sendNs);
+	overlap = (double)(mockRfStats.overlapNs - rfStart.overlapNs);
+
+	printf("%u points, CMD_FS %u us, %u bit/s\n",
+			points, mockRfTiming.fsUs, baudRate);
+	printf("  %.1f sweeps/s sent, %.1f sweeps/s measured, %ld not sent\n",
+			sent * 1e9 / elapsedNs,
+			(uint16_t)(lastSeq - firstSeq) * 1e9 / elapsedNs,
+			(long)(uint16_t)(lastSeq - firstSeq) - sent);
+	printf("  CMD_FS busy %.0f%%, UART busy %.0f%%, "
+			"CMD_FS while the UART sends %.0f%%\n",
+			100.0 * rfBusy / elapsedNs, 100.0 * uartBusy / elapsedNs,
+			(rfBusy > 0.0) ? 100.0 * overlap / rfBusy : 0.0);
+	printf("  %ld UART writes, %ld while busy\n",
+			mockUartStats.writes - uartStart.writes,
+			mockUartStats.busyWrites - uartStart.busyWrites);
+
+	if (overlap <= 0.0)
+	{
+		fprintf(stderr, "FAIL: the RF task never measured while the UART sent\n");
+		return 1;
+	}
+
+	return 0;
+}
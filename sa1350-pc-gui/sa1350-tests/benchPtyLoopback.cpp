@@ -0,0 +1,342 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file benchPtyLoopback.cpp
+ \brief Throughput of the POSIX DLL backend over a pty loopback, against a
+ plain termios read loop on the same pty
+
+ A writer thread streams numbered 250 byte version 1 frames into the pty
+ master as fast as the pty takes them. The DLL connects to the slave and the
+ frames are taken with sa1350GetFrames. For the comparison the same stream
+ is read from the raw slave with poll and read and the frames are cut out
+ and checked in the reading thread, the least a host can do per byte.
+
+ Every frame is checked for its command, length, sequence number, payload
+ and, in the read loop, its Crc. A lost or corrupted frame fails the bench,
+ so does the DLL below LOOP_PARITY_MIN percent of the read loop.
+
+ Usage: benchPtyLoopback [frames]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <atomic>
+
+#include "cDeviceDriverTest.h"
+#include "sa1350.h"
+#include "sa1350Cmd.h"
+// After cDriver.h, termios.h redefines the B* names of BaudRateType
+#include <termios.h>
+
+#define LOOP_PAYLOAD    250     /*!< Payload bytes per frame */
+#define LOOP_FRAME_SIZE (FRAME_HEADER_LENGTH + LOOP_PAYLOAD + FRAME_CRC_LENGTH) /*!< Bytes per frame on the pty */
+#define LOOP_BATCH      32      /*!< Frames per sa1350GetFrames, as DECODER_FRAME_BATCH */
+#define LOOP_WAIT_MS    1000    /*!< Longest gap between two frames before the rest counts as lost */
+#define LOOP_PARITY_MIN 25      /*!< Lowest DLL throughput in percent of the read loop, well below the run to run spread */
+
+/*!
+ \brief Seconds since an arbitrary start
+
+*/
+static double monotonic(void)
+{
+    return(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*!
+ \brief Payload of frame Sequence, the sequence number big endian and a
+ pattern that differs from frame to frame
+
+ \param Sequence
+ \param Data LOOP_PAYLOAD bytes
+*/
+static void fillPayload(unsigned long Sequence, unsigned char *Data)
+{
+    int index;
+
+    Data[0] = (unsigned char)(Sequence >> 24);
+    Data[1] = (unsigned char)(Sequence >> 16);
+    Data[2] = (unsigned char)(Sequence >> 8);
+    Data[3] = (unsigned char)Sequence;
+    for(index=4; index<LOOP_PAYLOAD; index++)
+        Data[index] = (unsigned char)(Sequence*7 + index);
+}
+
+/*!
+ \brief Check one received frame against frame Sequence
+
+ \return bool true if command, length and payload match
+*/
+static bool checkFrame(unsigned long Sequence, unsigned char Cmd, unsigned short Length, const unsigned char *Data)
+{
+    unsigned char expected[LOOP_PAYLOAD];
+
+    fillPayload(Sequence, expected);
+    if(Cmd==CMD_GETSPECNOINIT && Length==LOOP_PAYLOAD && memcmp(Data, expected, LOOP_PAYLOAD)==0)
+        return(true);
+    printf("FAIL: frame %lu lost or corrupted, got cmd %u, %u bytes, sequence %lu\n", Sequence, Cmd, Length,
+           ((unsigned long)Data[0] << 24) | ((unsigned long)Data[1] << 16) | ((unsigned long)Data[2] << 8) | Data[3]);
+    return(false);
+}
+
+/*!
+ \brief Open a pty pair, the master in raw mode
+
+ \param Slave name of the slave
+ \return int master, -1 on error
+*/
+static int openPty(std::string &Slave)
+{
+    struct termios tio;
+    int            master;
+
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if(master < 0 || grantpt(master) || unlockpt(master) || tcgetattr(master, &tio))
+    {
+        perror("FAIL: pty");
+        return(-1);
+    };
+    cfmakeraw(&tio);
+    tcsetattr(master, TCSANOW, &tio);
+    Slave = ptsname(master);
+
+    return(master);
+}
+
+/*!
+ \brief Writer thread, the stream into the pty master
+
+ The master is non-blocking, so a reader that gave up does not leave the
+ writer stuck in a full pty.
+
+ \param Master
+ \param Stream all frames back to back
+ \param Stop set by the reader when it is done
+*/
+static void writeStream(int Master, const std::string *Stream, const std::atomic<bool> *Stop)
+{
+    struct pollfd pfd = {Master, POLLOUT, 0};
+    size_t        offset = 0;
+    ssize_t       size;
+
+    fcntl(Master, F_SETFL, fcntl(Master, F_GETFL) | O_NONBLOCK);
+    while(offset < Stream->size() && !*Stop)
+    {
+        size = write(Master, Stream->data()+offset, Stream->size()-offset);
+        if(size > 0)
+            offset += size;
+        else if(size < 0 && errno != EAGAIN)
+            return;
+        else
+            poll(&pfd, 1, 100);
+    };
+}
+
+/*!
+ \brief Take the frames with the DLL
+
+ \param Stream
+ \param Frames
+ \param Seconds time from the first written byte to the last frame
+ \return long frames received in order, -1 on an error
+*/
+static long runDll(const std::string &Stream, long Frames, double &Seconds)
+{
+    static SA1350Frame frames[LOOP_BATCH];
+    std::atomic<bool>  stop(false);
+    std::string        slave;
+    unsigned short     count;
+    unsigned short     index;
+    long               received = 0;
+    double             start;
+    int                master;
+
+    master = openPty(slave);
+    if(master < 0)
+        return(-1);
+    if(!sa1350Init() || !sa1350Connect(slave.c_str()))
+    {
+        printf("FAIL: could not connect to %s\n", slave.c_str());
+        close(master);
+        return(-1);
+    };
+
+    start = monotonic();
+    std::thread writer(writeStream, master, &Stream, &stop);
+    while(received < Frames && sa1350WaitForFrame(LOOP_WAIT_MS))
+    {
+        sa1350GetFrames(frames, LOOP_BATCH, count);
+        for(index=0; index<count && received>=0; index++)
+        {
+            if(frames[index].Lost || !checkFrame(received, frames[index].Cmd, frames[index].Length, frames[index].Data))
+                received = -1;
+            else
+                received++;
+        };
+        if(received < 0)
+            break;
+    };
+    Seconds = monotonic()-start;
+    stop = true;
+    writer.join();
+
+    sa1350Disconnect();
+    sa1350DeInit();
+    close(master);
+
+    return(received);
+}
+
+/*!
+ \brief Take the frames with poll and read on the raw slave
+
+ \param Stream
+ \param Frames
+ \param Seconds time from the first written byte to the last frame
+ \return long frames received in order, -1 on an error
+*/
+static long runRaw(const std::string &Stream, long Frames, double &Seconds)
+{
+    static unsigned char buffer[4096 + LOOP_FRAME_SIZE];
+    std::atomic<bool>    stop(false);
+    struct termios       tio;
+    struct pollfd        pfd;
+    std::string          slave;
+    unsigned short       crc;
+    size_t               fill = 0;
+    size_t               offset;
+    ssize_t              size;
+    long                 received = 0;
+    double               start;
+    int                  master;
+
+    master = openPty(slave);
+    if(master < 0)
+        return(-1);
+    pfd.fd = open(slave.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if(pfd.fd < 0 || tcgetattr(pfd.fd, &tio))
+    {
+        printf("FAIL: could not open %s\n", slave.c_str());
+        close(master);
+        return(-1);
+    };
+    cfmakeraw(&tio);
+    tcsetattr(pfd.fd, TCSANOW, &tio);
+    pfd.events = POLLIN;
+
+    start = monotonic();
+    std::thread writer(writeStream, master, &Stream, &stop);
+    while(received >= 0 && received < Frames && poll(&pfd, 1, LOOP_WAIT_MS) > 0)
+    {
+        size = read(pfd.fd, &buffer[fill], 4096);
+        if(size <= 0)
+            continue;
+        fill += size;
+        for(offset=0; offset+LOOP_FRAME_SIZE <= fill; offset+=LOOP_FRAME_SIZE)
+        {
+            crc = crc16Update(FRAME_MARKER, &buffer[offset+1], FRAME_HEADER_LENGTH-1+LOOP_PAYLOAD);
+            if(buffer[offset]!=FRAME_MARKER || buffer[offset+1]!=LOOP_PAYLOAD ||
+               buffer[offset+LOOP_FRAME_SIZE-2]!=(crc >> 8) || buffer[offset+LOOP_FRAME_SIZE-1]!=(crc & 0xFF) ||
+               !checkFrame(received, buffer[offset+2], LOOP_PAYLOAD, &buffer[offset+FRAME_HEADER_LENGTH]))
+            {
+                received = -1;
+                break;
+            };
+            received++;
+        };
+        memmove(buffer, &buffer[offset], fill-offset);
+        fill -= offset;
+    };
+    Seconds = monotonic()-start;
+    stop = true;
+    writer.join();
+
+    close(pfd.fd);
+    close(master);
+
+    return(received);
+}
+
+/*!
+ \brief Print one result line
+
+*/
+static void report(const char *Name, long Frames, double Seconds)
+{
+    printf("%-20s %10.0f frames/s %8.2f MB/s (%ld frames, %.3f s)\n", Name,
+           Frames/Seconds, Frames*(double)LOOP_FRAME_SIZE/Seconds/1e6, Frames, Seconds);
+}
+
+int main(int argc, char **argv)
+{
+    long          frames = (argc > 1) ? atol(argv[1]) : 100000;
+    unsigned char payload[LOOP_PAYLOAD];
+    std::string   stream;
+    long          receivedDll, receivedRaw;
+    double        secondsDll, secondsRaw;
+    long          sequence;
+
+    for(sequence=0; sequence<frames; sequence++)
+    {
+        fillPayload(sequence, payload);
+        appendFrameV1(stream, CMD_GETSPECNOINIT, payload, LOOP_PAYLOAD);
+    };
+    printf("%ld frames of %d bytes over a pty, %.1f MB\n", frames, LOOP_FRAME_SIZE, stream.size()/1e6);
+
+    receivedRaw = runRaw(stream, frames, secondsRaw);
+    if(receivedRaw < 0)
+        return(1);
+    receivedDll = runDll(stream, frames, secondsDll);
+    if(receivedDll < 0)
+        return(1);
+    report("termios read loop", receivedRaw, secondsRaw);
+    report("DLL", receivedDll, secondsDll);
+    if(receivedRaw != frames || receivedDll != frames)
+    {
+        printf("FAIL: no frame for %d ms, read loop after %ld and DLL after %ld of %ld frames\n",
+               LOOP_WAIT_MS, receivedRaw, receivedDll, frames);
+        return(1);
+    };
+    printf("DLL at %.0f %% of the read loop\n", 100.0*secondsRaw/secondsDll);
+    if(100.0*secondsRaw/secondsDll < LOOP_PARITY_MIN)
+    {
+        printf("FAIL: DLL below %d %% of the read loop\n", LOOP_PARITY_MIN);
+        return(1);
+    };
+
+    return(0);
+}
@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file benchSpecPack.c
+ *
+ *  Compression ratio and codec speed of the CMD_SETENCODING delta format of
+ *  specPack.c, over synthetic sweeps and over curves exported by the GUI.
+ *  Every sweep is first checked to decode to its values, as version 1
+ *  frames with specUnpackFrame() and as one version 2 payload with
+ *  specUnpackFrames(). The ratio counts wire bytes with the frame overhead.
+ *
+ *  Usage: benchSpecPack [curve.csv ...]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "specPack.h"
+
+/***** Defines *****/
+
+#define FRAME_OVERHEAD	(5U)		/*!< Marker, length, command and CRC	*/
+#define MAX_SWEEP		(2048U)		/*!< Longest sweep the firmware sends	*/
+#define MAX_SWEEPS		(256U)		/*!< Sweeps of one benchmark set		*/
+#define MAX_FRAMES		(MAX_SWEEPS * ((MAX_SWEEP / 16U) + 1U))	/*!< Frames of a set */
+#define BENCH_SECONDS	(0.2)		/*!< Shortest timed run per pass		*/
+#define SYNTH_SWEEPS	(200U)		/*!< Sweeps per synthetic set			*/
+
+/***** Structures *****/
+
+/** @brief Sweeps of one benchmark set and their packed frames.
+ */
+typedef struct SweepSet {
+	const char *name;				/*!< Printed name					*/
+	uint16_t sweeps;				/*!< Number of sweeps				*/
+	uint16_t length[MAX_SWEEPS];	/*!< Values per sweep				*/
+	int8_t values[MAX_SWEEPS][MAX_SWEEP];	/*!< RSSI in dBm			*/
+	uint32_t frames;				/*!< Packed frames of all sweeps	*/
+	uint8_t frameLength[MAX_FRAMES];	/*!< Payload bytes per frame	*/
+	uint8_t frame[MAX_FRAMES][SPECPACK_MAX_FRAME];	/*!< Payloads		*/
+} SweepSet;
+
+/***** Variable declarations *****/
+
+static SweepSet sweepSet;
+
+/** @brief Keeps the compiler from dropping the decoded values.
+ */
+static volatile int8_t valueSink;
+
+/***** Function definitions *****/
+
+/** @brief Seconds since an arbitrary start.
+ */
+static double monotonic(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/** @brief Gaussian noise of a standard deviation, sum of uniform values.
+ */
+static double noise(double sigma)
+{
+	double sum = 0.0;
+	unsigned int index;
+
+	for (index = 0U; index < 12U; index++)
+	{
+		sum += (double)rand() / RAND_MAX;
+	}
+
+	return (sum - 6.0) * sigma;
+}
+
+/** @brief Synthetic sweeps: a noise floor around -100 dBm with a few
+ *  carriers of 10 to 60 dB, each a few points wide.
+ *
+ *  @param set filled with the sweeps.
+ *  @param name printed name.
+ *  @param sigma standard deviation of the noise in dB.
+ */
+static void synthSweeps(SweepSet *set, const char *name, double sigma)
+{
+	uint16_t sweep, index, carrier, centre;
+	double dbm, level;
+
+	set->name = name;
+	set->sweeps = SYNTH_SWEEPS;
+	for (sweep = 0U; sweep < SYNTH_SWEEPS; sweep++)
+	{
+		set->length[sweep] = MAX_SWEEP;
+		for (index = 0U; index < MAX_SWEEP; index++)
+		{
+			set->values[sweep][index] = (int8_t)lround(-100.0 + noise(sigma));
+		}
+		for (carrier = 0U; carrier < 4U; carrier++)
+		{
+			centre = (uint16_t)(rand() % MAX_SWEEP);
+			level = 10.0 + (rand() % 50);
+			for (index = (centre > 8U) ? centre - 8U : 0U;
+					(index < centre + 8U) && (index < MAX_SWEEP); index++)
+			{
+				dbm = -100.0 + level - 6.0 * abs((int)index - (int)centre)
+						+ noise(sigma / 2.0);
+				if (dbm > set->values[sweep][index])
+				{
+					set->values[sweep][index] = (int8_t)lround(dbm);
+				}
+			}
+		}
+	}
+}
+
+/** @brief Sweeps at the limits of the format: every delta width, the
+ *  largest jumps, frame and group boundaries and a single value.
+ *
+ *  @param set filled with the sweeps.
+ */
+static void edgeSweeps(SweepSet *set)
+{
+	static const uint16_t lengths[] = {1U, 2U, 32U, 33U, 254U, 255U, 256U,
+			511U, 1000U, MAX_SWEEP};
+	uint16_t sweep = 0U, index, width, value;
+	int8_t half;
+
+	set->name = "edge";
+	for (index = 0U; index < sizeof(lengths) / sizeof(lengths[0U]); index++)
+	{
+		for (width = 0U; width <= 8U; width++)
+		{
+			/* Deltas of -half and +half, the widest zigzag value of
+			 * width bits, up to -128 which wraps to itself */
+			half = (int8_t)(-((1 << width) >> 1));
+			set->length[sweep] = lengths[index];
+			for (value = 0U; value < lengths[index]; value++)
+			{
+				set->values[sweep][value] = ((value & 1U) != 0U) ? half : 0;
+			}
+			sweep++;
+		}
+		set->length[sweep] = lengths[index];
+		for (value = 0U; value < lengths[index]; value++)
+		{
+			set->values[sweep][value] = (int8_t)rand();
+		}
+		sweep++;
+	}
+	set->sweeps = sweep;
+}
+
+/** @brief Read the dBm column of a curve exported by the GUI, one
+ *  "frequency,dBm" pair per line.
+ *
+ *  @param set sweep added to.
+ *  @param path CSV file.
+ *
+ *  @return 0 if the file holds no curve
+ */
+static int readCurveCsv(SweepSet *set, const char *path)
+{
+	FILE *file = fopen(path, "r");
+	char line[128];
+	double frequency, dbm;
+	uint16_t *length;
+
+	if ((file == NULL) || (set->sweeps >= MAX_SWEEPS))
+	{
+		if (file != NULL)
+		{
+			fclose(file);
+		}
+		return 0;
+	}
+
+	length = &set->length[set->sweeps];
+	*length = 0U;
+	while ((fgets(line, sizeof(line), file) != NULL) && (*length < MAX_SWEEP))
+	{
+		if (sscanf(line, "%lf,%lf", &frequency, &dbm) == 2)
+		{
+			dbm = (dbm < -128.0) ? -128.0 : (dbm > 127.0) ? 127.0 : dbm;
+			set->values[set->sweeps][(*length)++] = (int8_t)lround(dbm);
+		}
+	}
+	fclose(file);
+
+	if (*length == 0U)
+	{
+		return 0;
+	}
+	set->sweeps++;
+	return 1;
+}
+
+/** @brief Pack every sweep of a set into frame payloads.
+ *
+ *  @param set sweeps, returns their frames.
+ *
+ *  @return wire bytes of the packed sweeps with the frame overhead
+ */
+static unsigned long packSweeps(SweepSet *set)
+{
+	unsigned long bytes = 0U;
+	uint16_t sweep, index, packed;
+
+	set->frames = 0U;
+	for (sweep = 0U; sweep < set->sweeps; sweep++)
+	{
+		for (index = 0U; index < set->length[sweep]; index += packed)
+		{
+			set->frameLength[set->frames] = specPackFrame(
+					&set->values[sweep][index], set->length[sweep] - index,
+					set->frame[set->frames], &packed);
+			bytes += set->frameLength[set->frames] + FRAME_OVERHEAD;
+			set->frames++;
+		}
+	}
+
+	return bytes;
+}
+
+/** @brief Check that the frames of a set decode to its sweeps, frame by
+ *  frame and as version 2 payloads of a whole sweep.
+ *
+ *  @param set packed sweeps.
+ *
+ *  @return number of sweeps that do not decode to their values
+ */
+static unsigned int checkRoundTrip(const SweepSet *set)
+{
+	static uint8_t payload[MAX_SWEEP * 2U];
+	int8_t decoded[MAX_SWEEP];
+	uint32_t frame = 0U;
+	uint16_t sweep, total, count, payloadLength;
+	unsigned int errors = 0U;
+
+	for (sweep = 0U; sweep < set->sweeps; sweep++)
+	{
+		total = 0U;
+		payloadLength = 0U;
+		while ((total < set->length[sweep]) && (frame < set->frames))
+		{
+			count = specUnpackFrame(set->frame[frame], set->frameLength[frame],
+					&decoded[total], MAX_SWEEP - total);
+			if (count == 0U)
+			{
+				break;
+			}
+			total += count;
+			memcpy(&payload[payloadLength], set->frame[frame],
+					set->frameLength[frame]);
+			payloadLength += set->frameLength[frame];
+			frame++;
+		}
+		if ((total != set->length[sweep])
+				|| (memcmp(decoded, set->values[sweep], total) != 0))
+		{
+			printf("%s sweep %u: frames decode to %u values of %u%s\n",
+					set->name, sweep, total, set->length[sweep],
+					(total == set->length[sweep]) ? ", not the sent ones" : "");
+			errors++;
+			continue;
+		}
+
+		memset(decoded, 0, sizeof(decoded));
+		total = specUnpackFrames(payload, payloadLength, decoded, MAX_SWEEP);
+		if ((total != set->length[sweep])
+				|| (memcmp(decoded, set->values[sweep], total) != 0))
+		{
+			printf("%s sweep %u: payload decodes to %u values of %u%s\n",
+					set->name, sweep, total, set->length[sweep],
+					(total == set->length[sweep]) ? ", not the sent ones" : "");
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+/** @brief Report ratio and codec speed of a set after its round trip.
+ *
+ *  @param set sweeps, packed on return.
+ *
+ *  @return number of sweeps that do not decode to their values
+ */
+static unsigned int benchSet(SweepSet *set)
+{
+	int8_t decoded[SPECPACK_MAX_FRAME];
+	unsigned long rawBytes = 0U, packedBytes, values = 0U, rounds;
+	double start, encodeS, decodeS;
+	unsigned int errors;
+	uint32_t frame;
+	uint16_t sweep;
+
+	for (sweep = 0U; sweep < set->sweeps; sweep++)
+	{
+		values += set->length[sweep];
+		rawBytes += set->length[sweep] + FRAME_OVERHEAD
+				* ((set->length[sweep] + SPECPACK_MAX_FRAME - 1U) / SPECPACK_MAX_FRAME);
+	}
+
+	packedBytes = packSweeps(set);
+	errors = checkRoundTrip(set);
+
+	start = monotonic();
+	for (rounds = 0U; (monotonic() - start) < BENCH_SECONDS; rounds++)
+	{
+		packSweeps(set);
+	}
+	encodeS = (monotonic() - start) / rounds;
+
+	start = monotonic();
+	for (rounds = 0U; (monotonic() - start) < BENCH_SECONDS; rounds++)
+	{
+		for (frame = 0U; frame < set->frames; frame++)
+		{
+			specUnpackFrame(set->frame[frame], set->frameLength[frame],
+					decoded, SPECPACK_MAX_FRAME);
+		}
+		valueSink = decoded[0U];
+	}
+	decodeS = (monotonic() - start) / rounds;
+
+	printf("%-10s sweeps %4u values %8lu bytes raw %8lu packed %8lu ratio %5.2f"
+			" encode %6.1f decode %6.1f Mvalues/s %5.2f ns/value\n",
+			set->name, set->sweeps, values, rawBytes, packedBytes,
+			(double)rawBytes / packedBytes, values / encodeS * 1e-6,
+			values / decodeS * 1e-6, decodeS * 1e9 / values);
+
+	return errors;
+}
+
+int main(int argc, char **argv)
+{
+	static const struct {
+		const char *name;
+		double sigma;
+	} floors[] = {{"noise 1dB", 1.0}, {"noise 2dB", 2.0}, {"noise 6dB", 6.0},
+			{"noise 13dB", 13.0}};
+	unsigned int errors = 0U, index;
+
+	srand(1350U);
+	for (index = 0U; index < sizeof(floors) / sizeof(floors[0U]); index++)
+	{
+		synthSweeps(&sweepSet, floors[index].name, floors[index].sigma);
+		errors += benchSet(&sweepSet);
+	}
+
+	edgeSweeps(&sweepSet);
+	errors += benchSet(&sweepSet);
+
+	if (argc > 1)
+	{
+		sweepSet.name = "recorded";
+		sweepSet.sweeps = 0U;
+		for (index = 1U; index < (unsigned int)argc; index++)
+		{
+			if (!readCurveCsv(&sweepSet, argv[index]))
+			{
+				printf("no curve in %s\n", argv[index]);
+				errors++;
+			}
+		}
+		if (sweepSet.sweeps > 0U)
+		{
+			errors += benchSet(&sweepSet);
+		}
+	}
+
+	if (errors != 0U)
+	{
+		fprintf(stderr, "FAIL: %u sweeps\n", errors);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file benchTxOverlap.c
+ *
+ *  Runs the RF and UART tasks of the firmware on the mocks of mockTi.h and
+ *  streams sweeps to a host, with the UART in callback mode on a stub
+ *  driver that drains the bytes from its own thread. Reports how long the
+ *  UART task spent in UART_write() and waiting for TX queue space against
+ *  the time the UART sent, and how long the RF task waited for the sweep
+ *  lock. Fails when UART_write() blocks for the bytes it sends, or when
+ *  the UART task still waits for a sweep while the last TX queue of it
+ *  drains, that is when the task is not free while the hardware sends.
+ *
+ *  Usage: benchTxOverlap [seconds] [baud rate]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mockTi.h"
+#include "SA1350_Firmware.h"
+
+/***** Defines *****/
+
+#define CMD_CONNECT			(1U)
+#define CMD_SYNC			(7U)
+#define CMD_SETBAUDRATE		(8U)
+#define CMD_SETSWEEP		(28U)
+#define CMD_STARTSTREAM		(32U)
+#define CMD_STREAMSWEEP		(34U)
+
+#define REPLY_TIMEOUT_MS	(2000)	/*!< Wait for an ACK or a sweep		*/
+
+/** @brief UART_TX_QUEUE_SIZE of uartHostComms.c. */
+#define TX_QUEUE_SIZE		(512U)
+
+/***** Variable definitions *****/
+
+/** @brief #CMD_SETSWEEP payload of the expert span: 915.5 - 934.5 MHz in
+ *  10 kHz steps, 1900 points, so that a sweep is several TX queues long.
+ */
+static const uint8_t expertSweep[19U] = {
+	0x01U, 0x03U, 0x93U, 0x85U, 0x67U, 0x03U, 0xA6U, 0x84U, 0x87U, 0x26U,
+	0x00U, 0x00U, 0x02U, 0x8FU, 0x00U, 0x64U, 0x00U, 0x13U, 0x09U
+};
+
+/***** Function definitions *****/
+
+/** @brief Send a command and wait for its ACK, skipping other frames.
+ *
+ *  @return 0 on ACK, -1 on timeout
+ */
+static int command(uint8_t cmd, const uint8_t *payload, uint8_t length)
+{
+	uint8_t frame[MOCK_FRAME_MAX];
+
+	mockHostSend(cmd, payload, length);
+
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if ((frame[1U] == 0U) && (frame[2U] == cmd))
+		{
+			return 0;
+		}
+	}
+
+	fprintf(stderr, "FAIL: no ACK of command %u\n", cmd);
+	return -1;
+}
+
+int main(int argc, char **argv)
+{
+	double seconds = (argc > 1) ? atof(argv[1]) : 2.0;
+	uint32_t baudRate = (argc > 2) ? (uint32_t)atol(argv[2]) : 115200U;
+	uint8_t baudPayload[4U];
+	uint8_t frame[MOCK_FRAME_MAX];
+	MockUartStats uartStart = {0};
+	PerfCounter bytes, txWait, lockWait;
+	long long start = 0, end = 0, elapsedNs;
+	long sent = 0;
+	double freq, sendUs, waitUs, drainUs, writeShare;
+	int failed = 0;
+
+	mockUartInit();
+	RfTask_init();
+	UartTask_init();
+
+	if (command(CMD_CONNECT, NULL, 0U) != 0)
+	{
+		return 1;
+	}
+	if (baudRate != 115200U)
+	{
+		baudPayload[0U] = (uint8_t)(baudRate >> 24U);
+		baudPayload[1U] = (uint8_t)(baudRate >> 16U);
+		baudPayload[2U] = (uint8_t)(baudRate >> 8U);
+		baudPayload[3U] = (uint8_t)baudRate;
+		if ((command(CMD_SETBAUDRATE, baudPayload, 4U) != 0)
+				|| (command(CMD_SYNC, NULL, 0U) != 0))
+		{
+			return 1;
+		}
+	}
+	if ((command(CMD_SETSWEEP, expertSweep, sizeof(expertSweep)) != 0)
+			|| (command(CMD_STARTSTREAM, NULL, 0U) != 0))
+	{
+		return 1;
+	}
+
+	/* Count from the first sweep on, the stream has settled */
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if (frame[2U] != CMD_STREAMSWEEP)
+		{
+			continue;
+		}
+
+		if (start == 0)
+		{
+			start = mockNowNs();
+			end = start + (long long)(seconds * 1e9);
+			uartStart = mockUartStats;
+			getPerfCounter(PERF_SPECTRUM_BYTES, &bytes, TRUE);
+			getPerfCounter(PERF_SPECTRUM_TX_WAIT, &txWait, TRUE);
+			getPerfCounter(PERF_SWEEP_LOCK_WAIT, &lockWait, TRUE);
+			continue;
+		}
+
+		sent++;
+		if (mockNowNs() >= end)
+		{
+			break;
+		}
+	}
+
+	getPerfCounter(PERF_SPECTRUM_BYTES, &bytes, FALSE);
+	getPerfCounter(PERF_SPECTRUM_TX_WAIT, &txWait, FALSE);
+	getPerfCounter(PERF_SWEEP_LOCK_WAIT, &lockWait, FALSE);
+
+	if ((sent == 0) || (bytes.count == 0U) || (txWait.count == 0U))
+	{
+		fprintf(stderr, "FAIL: no streamed sweeps\n");
+		return 1;
+	}
+
+	elapsedNs = mockNowNs() - start;
+	freq = (double)getPerfFreq();
+	sendUs = (double)bytes.sum / bytes.count * 10.0 * 1e6 / baudRate;
+	waitUs = (double)txWait.sum / txWait.count * 1e6 / freq;
+	drainUs = TX_QUEUE_SIZE * 10.0 * 1e6 / baudRate;
+	writeShare = (double)(mockUartStats.writeNs - uartStart.writeNs)
+			/ (double)(mockUartStats.sendNs - uartStart.sendNs);
+
+	printf("%u bit/s, %ld sweeps of %.0f bytes in %.1f s\n",
+			baudRate, sent, (double)bytes.sum / bytes.count,
+			elapsedNs / 1e9);
+	printf("  UART busy %.0f%%, %ld UART_write() calls took %.2f%% of "
+			"the send time\n",
+			100.0 * (mockUartStats.sendNs - uartStart.sendNs) / elapsedNs,
+			mockUartStats.writes - uartStart.writes, 100.0 * writeShare);
+	printf("  per sweep: %.1f ms to send, UART task waited %.1f ms for "
+			"queue space, free for %.1f ms\n",
+			sendUs / 1000.0, waitUs / 1000.0, (sendUs - waitUs) / 1000.0);
+	printf("  RF task sweep lock wait: %.1f us mean, %.1f us max\n",
+			(lockWait.count != 0U) ?
+					(double)lockWait.sum / lockWait.count * 1e6 / freq : 0.0,
+			lockWait.max * 1e6 / freq);
+
+	if (writeShare > 0.01)
+	{
+		fprintf(stderr, "FAIL: UART_write() blocks while the bytes are sent\n");
+		failed = 1;
+	}
+	if ((sendUs - waitUs) < drainUs / 2.0)
+	{
+		fprintf(stderr, "FAIL: the UART task waits while the TX queue drains, "
+				"free for %.1f of %.1f ms\n",
+				(sendUs - waitUs) / 1000.0, drainUs / 1000.0);
+		failed = 1;
+	}
+
+	return failed;
+}
@@ -0,0 +1,192 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file benchWakeup.cpp
+ \brief Idle CPU and command round trip of the DLL receive thread and the
+ GUI driver loop against sa1350-sim
+
+ Built twice. benchWakeup runs the event driven code: the receive thread
+ blocks on the comport for up to DRV_RX_WAIT_MS, the idle driver loop
+ waits on its wake-up event and the ACK is waited for in
+ sa1350WaitForFrame. benchWakeupPoll builds the DLL with DRV_RX_WAIT_MS 0
+ and runs the loops they replaced: the receive thread sleeps 1 ms after an
+ empty read, the driver loop sleeps 1 ms every pass and the ACK is looked
+ for once per 1 ms tick.
+
+ - idle: CPU time and context switches of the whole process, the receive
+   thread and the driver loop, while connected without a sweep
+ - CMD_SYNC: time from sa1350SendCmd to the ACK in the driver loop
+
+ Usage: benchWakeup [idle seconds] [round trips]
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <algorithm>
+
+#include "simLink.h"
+#include "cDeviceDriver.h"
+#include "cEvent.h"
+
+#define DRV_IDLE_WAIT_MS    20      /*!< Wake-up event wait of the idle driver loop, as drvSA1350.h */
+#define DECODER_FRAME_BATCH 32      /*!< Frames per sa1350GetFrames, as drvSA1350.h */
+
+/*!
+ \brief CPU seconds of the process
+
+ \param Switches voluntary and involuntary context switches
+*/
+static double cpuSeconds(long &Switches)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+    Switches = usage.ru_nvcsw + usage.ru_nivcsw;
+
+    return(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec)/1e6);
+}
+
+/*!
+ \brief Run the idle driver loop, nothing is sent and no frame is expected
+
+ \param Seconds
+ \return long frames taken, the device sends none unasked
+*/
+static long runIdle(double Seconds)
+{
+    static SA1350Frame frames[DECODER_FRAME_BATCH];
+    cEvent             wakeUp(false);
+    unsigned short     count;
+    long               taken = 0;
+    double             stop = monotonic()+Seconds;
+
+    while(monotonic() < stop)
+    {
+#if DRV_RX_WAIT_MS
+        sa1350GetFrames(frames, DECODER_FRAME_BATCH, count);
+        if(count==0)
+            wakeUp.CheckSignal(DRV_IDLE_WAIT_MS);
+#else
+        count = (sa1350IsFrameAvailable() && sa1350GetFrame(&frames[0])) ? 1 : 0;
+        usleep(1000);
+#endif
+        taken += count;
+    };
+
+    return(taken);
+}
+
+/*!
+ \brief Send a command and wait for its ACK
+
+ \param Cmd
+ \param TimeoutMs
+ \return bool true if the ACK came in time
+*/
+static bool command(unsigned char Cmd, unsigned long TimeoutMs)
+{
+#if DRV_RX_WAIT_MS
+    return(cSimLink::Command(Cmd, NULL, 0, TimeoutMs));
+#else
+    // cmdWaitForConfirmation before sa1350WaitForFrame, one look per tick
+    SA1350Frame frame;
+    bool        done = false;
+
+    if(!sa1350SendCmd(Cmd, NULL, 0))
+        return(false);
+    do
+    {
+        if(sa1350IsFrameAvailable())
+            if(sa1350GetFrame(&frame))
+                if(frame.Cmd==Cmd && frame.Length==0)
+                    done = true;
+        if(TimeoutMs==0 && !done)
+            return(false);
+        usleep(1000);
+        TimeoutMs--;
+    }while(!done);
+
+    return(true);
+#endif
+}
+
+int main(int argc, char **argv)
+{
+    double              idleSeconds = (argc > 1) ? atof(argv[1]) : 2.0;
+    int                 trips = (argc > 2) ? atoi(argv[2]) : 500;
+    std::vector<double> rtt;
+    cSimLink            sim;
+    long                switches0, switches1;
+    double              cpu0, cpu1, start, seconds;
+    long                taken;
+    int                 index;
+
+    if(!sim.Start(argv[0], {}))
+        return(1);
+#if DRV_RX_WAIT_MS
+    printf("event driven: comport wait %d ms, idle wait %d ms\n", DRV_RX_WAIT_MS, DRV_IDLE_WAIT_MS);
+#else
+    printf("1 ms polling: receive thread and driver loop\n");
+#endif
+
+    // Let the receive thread settle after the connect
+    usleep(100000);
+    cpu0 = cpuSeconds(switches0);
+    start = monotonic();
+    taken = runIdle(idleSeconds);
+    seconds = monotonic()-start;
+    cpu1 = cpuSeconds(switches1);
+    printf("idle      CPU %6.2f %%  %8.0f context switches/s (%.3f s)\n",
+           100.0*(cpu1-cpu0)/seconds, (switches1-switches0)/seconds, seconds);
+    if(taken)
+    {
+        printf("FAIL: %ld frames while idle\n", taken);
+        return(1);
+    };
+
+    for(index=0; index<trips; index++)
+    {
+        start = monotonic();
+        if(!command(CMD_SYNC, 1000))
+        {
+            printf("FAIL: no ACK of CMD_SYNC %d\n", index);
+            return(1);
+        };
+        rtt.push_back((monotonic()-start)*1e6);
+    };
+    std::sort(rtt.begin(), rtt.end());
+    printf("CMD_SYNC  p50 %8.1f us  p99 %8.1f us  max %8.1f us (%d round trips)\n",
+           rtt[rtt.size()/2], rtt[rtt.size()*99/100], rtt.back(), trips);
+
+    return(0);
+}
@@ -0,0 +1,143 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file cDeviceDriverTest.h */
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+#include "cDeviceDriver.h"
+
+/*!
+ \brief Access to the frame decoder of cDeviceDriver for the host tests
+
+ The decoder normally runs in the receiver thread on the bytes of the
+ comport. The tests store the bytes in their own ring buffer and run the
+ decoder on it, the driver is never opened.
+
+ \class cDeviceDriverTest cDeviceDriverTest.h "cDeviceDriverTest.h"
+*/
+class cDeviceDriverTest
+{
+public:
+    /*!
+     \brief Decode all complete frames stored in the ring buffer
+
+     \param Driver
+     \param RxFifo
+    */
+    static bool Decode(cDeviceDriver &Driver, cRingBuffer *RxFifo)
+    {
+        return(Driver.FrameDecoder(RxFifo));
+    }
+    /*!
+     \brief Restart the version 2 sequence check as opening the comport does
+
+     \param Driver
+    */
+    static void Restart(cDeviceDriver &Driver)
+    {
+        Driver.rxSequence = -1;
+    }
+};
+
+/*!
+ \brief Append a version 1 frame to a byte stream
+
+ \param Stream
+ \param Cmd
+ \param Data
+ \param Length at most FRAME_V1_DATA_SIZE
+*/
+static inline void appendFrameV1(std::string &Stream, unsigned char Cmd, const unsigned char *Data, unsigned char Length)
+{
+    unsigned char  header[FRAME_HEADER_LENGTH] = {FRAME_MARKER, Length, Cmd};
+    unsigned short crc;
+
+    crc = crc16Update(FRAME_MARKER, &header[1], FRAME_HEADER_LENGTH-1);
+    crc = crc16Update(crc, Data, Length);
+    Stream.append((const char*)header, FRAME_HEADER_LENGTH);
+    Stream.append((const char*)Data, Length);
+    Stream.push_back((char)(crc>>8));
+    Stream.push_back((char)(crc&0xFF));
+}
+
+/*!
+ \brief Append a version 2 frame to a byte stream
+
+ \param Stream
+ \param Cmd
+ \param Seq
+ \param SweepId
+ \param Data
+ \param Length at most FRAME_DATA_SIZE
+*/
+static inline void appendFrameV2(std::string &Stream, unsigned char Cmd, unsigned char Seq, unsigned short SweepId, const unsigned char *Data, unsigned short Length)
+{
+    unsigned char  header[FRAME_V2_HEADER_LENGTH] = {FRAME_V2_MARKER, (unsigned char)(Length>>8), (unsigned char)(Length&0xFF),
+                                                     Cmd, Seq, (unsigned char)(SweepId>>8), (unsigned char)(SweepId&0xFF)};
+    unsigned short crc;
+
+    crc = crc16Update(FRAME_MARKER, &header[1], FRAME_V2_HEADER_LENGTH-1);
+    crc = crc16Update(crc, Data, Length);
+    Stream.append((const char*)header, FRAME_V2_HEADER_LENGTH);
+    Stream.append((const char*)Data, Length);
+    Stream.push_back((char)(crc>>8));
+    Stream.push_back((char)(crc&0xFF));
+}
+
+/*!
+ \brief Store bytes in the ring buffer as the receiver thread does
+
+ \param RxFifo
+ \param Data
+ \param Length
+ \return bytes stored, less than Length if the buffer is full
+*/
+static inline unsigned long storeBytes(cRingBuffer *RxFifo, const unsigned char *Data, unsigned long Length)
+{
+    unsigned long  stored = 0;
+    unsigned long  span;
+    unsigned char *dst;
+
+    while(stored < Length && RxFifo->Free() > 0)
+    {
+        dst = RxFifo->WriteSpan(span);
+        if(span > Length-stored)
+            span = Length-stored;
+        memcpy(dst, &Data[stored], span);
+        RxFifo->Commit(span);
+        stored += span;
+    };
+
+    return(stored);
+}
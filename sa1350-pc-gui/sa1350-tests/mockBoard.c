@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file mockBoard.c
+ *
+ *  Pins, chip information and power of the board, and the calls the RF and
+ *  UART tasks make into the display and button tasks, which the host tests
+ *  do not run.
+ */
+#include "mockTi.h"
+
+/***** Variable declarations *****/
+
+static PIN_State pinState;
+
+/***** Function definitions *****/
+
+int Power_setConstraint(unsigned constraint)
+{
+	(void)constraint;
+	return 0;
+}
+
+int Power_releaseConstraint(unsigned constraint)
+{
+	(void)constraint;
+	return 0;
+}
+
+ChipType_t ChipInfo_GetChipType(void)
+{
+	return CHIP_TYPE_CC1350;
+}
+
+PIN_Handle PIN_open(PIN_State *state, const PIN_Config *pinList)
+{
+	(void)pinList;
+	return (state != NULL) ? state : &pinState;
+}
+
+int PIN_setOutputValue(PIN_Handle handle, PIN_Id pinId, uint32_t val)
+{
+	(void)handle;
+	(void)pinId;
+	(void)val;
+	return 0;
+}
+
+uint32_t PIN_getInputValue(PIN_Id pinId)
+{
+	(void)pinId;
+	return 1U;
+}
+
+/** @brief Display task: a new sweep to draw. */
+void setDisplayUpdate(void)
+{
+}
+
+/** @brief Button task: the host takes over. */
+void lockButton(void)
+{
+}
+
+/** @brief Button task: the host released the board. */
+void unlockButton(void)
+{
+}
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file mockRf.c
+ *
+ *  RF driver with a simulated RF core. A core thread runs the posted
+ *  commands in order and follows the chain of each one by pNextOp and its
+ *  condition, with the timing of #mockRfTiming:
+ *
+ *  - CMD_FS tunes the synthesizer after fsUs. Outside the band of the LO
+ *    divider of the running setup it counts a band error.
+ *  - CMD_RX_TEST receives rxStartUs after it starts, its RSSI is valid
+ *    settleUs later. It ends when cancelled or at its TRIG_REL_START end
+ *    time, 4 ticks per microsecond as the RF core timer. RF_getRssi()
+ *    returns #RF_GET_RSSI_ERROR_VAL outside RX and 0 while not valid.
+ *    After an end at the end time, reads until the next RF_cancelCmd()
+ *    come from a reader that missed its step and count as late.
+ *  - CMD_PROP_RADIO_DIV_SETUP takes setupUs and selects the LO divider.
+ *
+ *  The callback of a command gets RF_EventCmdDone after each operation of
+ *  its chain if asked for, and RF_EventLastCmdDone, RF_EventCmdCancelled
+ *  or RF_EventCmdAborted at its end.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "mockTi.h"
+
+/***** Defines *****/
+
+#define RF_QUEUE_LENGTH		(8U)		/*!< Commands the driver queues		*/
+#define RF_HANDLE_MASK		(0x7FFF)	/*!< Handles are never negative		*/
+#define RAT_TICKS_PER_US	(4U)		/*!< RF core timer					*/
+
+/***** Structures *****/
+
+/** @brief A command posted to the RF core.
+ */
+typedef struct MockRfCmd {
+	RF_Op        *op;			/*!< First operation of the chain		*/
+	RF_Callback   callback;
+	RF_EventMask  mask;			/*!< Events for the callback			*/
+	long          sequence;		/*!< Posting order						*/
+	int           cancelled;
+} MockRfCmd;
+
+/***** Variable declarations *****/
+
+MockRfTiming mockRfTiming = {100U, 60U, 41U, 0U, 0U};
+MockRfStats mockRfStats;
+int8_t (*mockRfRssi)(uint16_t frequency, uint16_t fractFreq);
+void (*mockRfTrace)(const rfc_radioOp_t *op, RF_CmdHandle cmd);
+
+/* Commands of smartrf_settings.c, with the command numbers the core runs */
+RF_Mode RF_propSub1;
+RF_Mode RF_prop2_4;
+rfc_CMD_PROP_RADIO_DIV_SETUP_t RF_cmdPropRadioDivSetup = {
+	.commandNo = CMD_PROP_RADIO_DIV_SETUP, .rxBw = 0x20U, .centerFreq = 915U,
+	.loDivider = 5U
+};
+rfc_CMD_FS_t RF_cmdFs = {.commandNo = CMD_FS, .frequency = 902U};
+rfc_CMD_RX_TEST_t RF_cmdRxTest = {
+	.commandNo = CMD_RX_TEST, .endTrigger = {.triggerType = TRIG_REL_START}
+};
+
+static RF_Object rfObject;
+static pthread_mutex_t rfLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t rfChanged = PTHREAD_COND_INITIALIZER;
+static MockRfCmd rfQueue[RF_QUEUE_LENGTH];
+static long queueHead = 0;		/*!< Sequence of the command running	*/
+static long queueTail = 0;		/*!< Sequence of the next command		*/
+static int coreRunning = 0;
+
+/* Radio state, changed under #rfLock */
+static uint8_t loDivider = 0U;
+static uint16_t synthFrequency = 0U;
+static uint16_t synthFractFreq = 0U;
+static int synthTuned = 0;		/*!< CMD_FS ran since the last setup	*/
+static int receiving = 0;
+static long long rssiValidNs = 0;
+static long long rxEndNs = 0;
+static int rxTimedOut = 0;		/*!< CMD_RX_TEST ended before its cancel	*/
+static long rxTimedOutSequence = 0;	/*!< Command of that CMD_RX_TEST		*/
+static uint16_t rxFrequency = 0U;
+static uint16_t rxFractFreq = 0U;
+static unsigned noiseSeed = 1350U;
+
+/***** Function definitions *****/
+
+/** @brief LO divider of the band a frequency in MHz lies in. */
+static uint8_t loDividerOf(uint16_t frequency)
+{
+	return (frequency < 700U) ? 10U : ((frequency < 1500U) ? 5U : 2U);
+}
+
+/** @brief Noise around -100 dBm, the default of #mockRfRssi. */
+static int8_t noiseRssi(uint16_t frequency, uint16_t fractFreq)
+{
+	(void)frequency;
+	(void)fractFreq;
+	noiseSeed = noiseSeed * 1103515245U + 12345U;
+	return (int8_t)(-100 + (int)((noiseSeed >> 16U) % 8U));
+}
+
+/** @brief Handle of the command with a posting sequence. */
+static RF_CmdHandle handleOf(long sequence)
+{
+	return (RF_CmdHandle)(sequence & RF_HANDLE_MASK);
+}
+
+/** @brief Posting sequence of a handle, the latest one with that handle. */
+static long sequenceOf(RF_CmdHandle cmd)
+{
+	return (queueTail - 1) - (((queueTail - 1) - cmd) & RF_HANDLE_MASK);
+}
+
+/** @brief Call back with #rfLock released, as from the RF interrupt. */
+static void callBack(const MockRfCmd *cmd, RF_EventMask events)
+{
+	if ((cmd->callback != NULL) && ((events & cmd->mask) != 0U))
+	{
+		pthread_mutex_unlock(&rfLock);
+		cmd->callback(&rfObject, handleOf(cmd->sequence), events);
+		pthread_mutex_lock(&rfLock);
+	}
+}
+
+/** @brief Wait on #rfLock until a deadline or a change. */
+static void waitUntil(long long deadlineNs)
+{
+	struct timespec deadline;
+	long long ns;
+
+	clock_gettime(CLOCK_REALTIME, &deadline);
+	ns = deadline.tv_nsec + (deadlineNs - mockNowNs());
+	if (ns > 2000000000LL)
+	{
+		ns = 2000000000LL;
+	}
+	deadline.tv_sec += (time_t)(ns / 1000000000LL);
+	deadline.tv_nsec = (long)(ns % 1000000000LL);
+	pthread_cond_timedwait(&rfChanged, &rfLock, &deadline);
+}
+
+/** @brief Run CMD_FS with #rfLock released. */
+static void runFs(rfc_CMD_FS_t *fs)
+{
+	long long start = mockNowNs();
+	int overlap = mockUartSending();
+
+	pthread_mutex_unlock(&rfLock);
+	mockSleepUs(mockRfTiming.fsUs);
+	pthread_mutex_lock(&rfLock);
+
+	if (overlap || mockUartSending())
+	{
+		MOCK_ADD(mockRfStats.overlapNs, mockNowNs() - start);
+	}
+	MOCK_ADD(mockRfStats.fsNs, mockNowNs() - start);
+	MOCK_ADD(mockRfStats.fsRuns, 1);
+	if (loDividerOf(fs->frequency) != loDivider)
+	{
+		MOCK_ADD(mockRfStats.bandErrors, 1);
+	}
+	synthFrequency = fs->frequency;
+	synthFractFreq = fs->fractFreq;
+	synthTuned = 1;
+}
+
+/** @brief End an operation the run left active, with #rfLock held. The
+ *  RF task polls the status without the lock, so a CMD_FS ends after the
+ *  next operation of its chain started. Otherwise the RF task could see
+ *  the synthesizer done and the receiver not yet started whenever this
+ *  thread is preempted in between.
+ */
+static void endOp(rfc_radioOp_t *op)
+{
+	if (op->status == ACTIVE)
+	{
+		__atomic_store_n(&op->status, DONE_OK, __ATOMIC_RELEASE);
+	}
+}
+
+/** @brief Start an operation with #rfLock held. An operation of a chain
+ *  starts in the same hold of the lock as the previous one ends, so the
+ *  RF task sees no gap between them when this thread runs late.
+ */
+static void startOp(rfc_radioOp_t *op, MockRfCmd *cmd)
+{
+	rfc_CMD_RX_TEST_t *rx = (rfc_CMD_RX_TEST_t *)op;
+	long long start = mockNowNs();
+
+	op->status = ACTIVE;
+	if (mockRfTrace != NULL)
+	{
+		mockRfTrace(op, handleOf(cmd->sequence));
+	}
+
+	if (op->commandNo != CMD_RX_TEST)
+	{
+		return;
+	}
+
+	if (!synthTuned)
+	{
+		MOCK_ADD(mockRfStats.chainErrors, 1);
+	}
+	MOCK_ADD(mockRfStats.rxRuns, 1);
+
+	receiving = 1;
+	rxFrequency = synthFrequency;
+	rxFractFreq = synthFractFreq;
+	rssiValidNs = start
+			+ (long long)(mockRfTiming.rxStartUs + mockRfTiming.settleUs) * 1000LL;
+	rxEndNs = INT64_MAX;
+	if (rx->endTrigger.triggerType == TRIG_REL_START)
+	{
+		rxEndNs = start + (long long)rx->endTime * 1000LL / RAT_TICKS_PER_US;
+	}
+}
+
+/** @brief Run CMD_RX_TEST until its end time or a cancel of its command. */
+static void runRxTest(rfc_CMD_RX_TEST_t *rx, MockRfCmd *cmd)
+{
+	while (!cmd->cancelled && (mockNowNs() < rxEndNs))
+	{
+		waitUntil(rxEndNs);
+	}
+
+	receiving = 0;
+	rx->status = cmd->cancelled ? DONE_ABORT : DONE_OK;
+	if (!cmd->cancelled)
+	{
+		MOCK_ADD(mockRfStats.rxTimeouts, 1);
+		rxTimedOut = 1;
+		rxTimedOutSequence = cmd->sequence;
+	}
+}
+
+/** @brief The RF core, runs one command and its chain after the other. */
+static void *rfCore(void *arg)
+{
+	MockRfCmd *cmd, done;
+	rfc_radioOp_t *op, *next;
+	RF_EventMask events;
+
+	(void)arg;
+	pthread_mutex_lock(&rfLock);
+	while (1)
+	{
+		while (queueHead == queueTail)
+		{
+			pthread_cond_wait(&rfChanged, &rfLock);
+		}
+		cmd = &rfQueue[queueHead % RF_QUEUE_LENGTH];
+		op = (rfc_radioOp_t *)cmd->op;
+		events = RF_EventLastCmdDone;
+
+		if (cmd->cancelled)
+		{
+			/* Cancelled before it started */
+			events = RF_EventCmdCancelled;
+			op = NULL;
+		}
+		else
+		{
+			startOp(op, cmd);
+		}
+
+		while (op != NULL)
+		{
+			switch (op->commandNo)
+			{
+			case CMD_FS:
+				runFs((rfc_CMD_FS_t *)op);
+				break;
+			case CMD_RX_TEST:
+				runRxTest((rfc_CMD_RX_TEST_t *)op, cmd);
+				break;
+			case CMD_PROP_RADIO_DIV_SETUP:
+				pthread_mutex_unlock(&rfLock);
+				mockSleepUs(mockRfTiming.setupUs);
+				pthread_mutex_lock(&rfLock);
+				loDivider = ((rfc_CMD_PROP_RADIO_DIV_SETUP_t *)op)->loDivider;
+				synthTuned = 0;
+				MOCK_ADD(mockRfStats.setups, 1);
+				op->status = DONE_OK;
+				break;
+			default:
+				MOCK_ADD(mockRfStats.chainErrors, 1);
+				op->status = DONE_OK;
+				break;
+			}
+
+			if (op->status == DONE_ABORT)
+			{
+				events = RF_EventCmdAborted;
+				break;
+			}
+
+			next = op->pNextOp;
+			if ((next == NULL) || (op->condition.rule == COND_NEVER))
+			{
+				endOp(op);
+				break;
+			}
+			if (cmd->cancelled)
+			{
+				endOp(op);
+				events = RF_EventCmdCancelled;
+				break;
+			}
+			startOp(next, cmd);
+			endOp(op);
+			callBack(cmd, RF_EventCmdDone);
+			op = next;
+		}
+
+		/* The slot is free for the next post once the command is done */
+		done = *cmd;
+		queueHead++;
+		pthread_cond_broadcast(&rfChanged);
+		callBack(&done, events | ((events == RF_EventLastCmdDone)
+				? RF_EventCmdDone : 0U));
+	}
+
+	return NULL;
+}
+
+void RF_Params_init(RF_Params *params)
+{
+	memset(params, 0, sizeof(*params));
+}
+
+RF_Handle RF_open(RF_Object *obj, RF_Mode *mode, RF_RadioSetup *setup,
+		RF_Params *params)
+{
+	pthread_t thread;
+
+	(void)obj;
+	(void)mode;
+	(void)params;
+	mockSleepUs(mockRfTiming.openUs);
+
+	pthread_mutex_lock(&rfLock);
+	if (!coreRunning)
+	{
+		if (mockRfRssi == NULL)
+		{
+			mockRfRssi = noiseRssi;
+		}
+		pthread_create(&thread, NULL, rfCore, NULL);
+		pthread_detach(thread);
+		coreRunning = 1;
+	}
+	loDivider = setup->prop.loDivider;
+	synthTuned = 0;
+	MOCK_ADD(mockRfStats.opens, 1);
+	pthread_mutex_unlock(&rfLock);
+
+	return &rfObject;
+}
+
+void RF_close(RF_Handle h)
+{
+	(void)h;
+	pthread_mutex_lock(&rfLock);
+	while (queueHead != queueTail)
+	{
+		pthread_cond_wait(&rfChanged, &rfLock);
+	}
+	pthread_mutex_unlock(&rfLock);
+}
+
+RF_CmdHandle RF_postCmd(RF_Handle h, RF_Op *op, RF_Priority pri,
+		RF_Callback cb, RF_EventMask bmEvent)
+{
+	MockRfCmd *cmd;
+	rfc_radioOp_t *chainOp;
+	RF_CmdHandle handle;
+
+	(void)h;
+	(void)pri;
+	pthread_mutex_lock(&rfLock);
+	if ((queueTail - queueHead) >= (long)RF_QUEUE_LENGTH)
+	{
+		pthread_mutex_unlock(&rfLock);
+		return RF_ALLOC_ERROR;
+	}
+
+	for (chainOp = (rfc_radioOp_t *)op; chainOp != NULL;
+			chainOp = chainOp->pNextOp)
+	{
+		chainOp->status = IDLE;
+	}
+	((rfc_radioOp_t *)op)->status = PENDING;
+
+	cmd = &rfQueue[queueTail % RF_QUEUE_LENGTH];
+	cmd->op = op;
+	cmd->callback = cb;
+	cmd->mask = bmEvent | RF_EventLastCmdDone | RF_EventCmdCancelled
+			| RF_EventCmdAborted;
+	cmd->sequence = queueTail;
+	cmd->cancelled = 0;
+	handle = handleOf(queueTail);
+	queueTail++;
+	pthread_cond_broadcast(&rfChanged);
+	pthread_mutex_unlock(&rfLock);
+
+	return handle;
+}
+
+RF_EventMask RF_pendCmd(RF_Handle h, RF_CmdHandle ch, RF_EventMask bmEvent)
+{
+	long sequence;
+
+	(void)h;
+	(void)bmEvent;
+	if (ch < 0)
+	{
+		return 0U;
+	}
+
+	pthread_mutex_lock(&rfLock);
+	sequence = sequenceOf(ch);
+	while (queueHead <= sequence)
+	{
+		pthread_cond_wait(&rfChanged, &rfLock);
+	}
+	pthread_mutex_unlock(&rfLock);
+
+	return RF_EventLastCmdDone;
+}
+
+RF_EventMask RF_runCmd(RF_Handle h, RF_Op *op, RF_Priority pri,
+		RF_Callback cb, RF_EventMask bmEvent)
+{
+	return RF_pendCmd(h, RF_postCmd(h, op, pri, cb, bmEvent), bmEvent);
+}
+
+RF_Stat RF_cancelCmd(RF_Handle h, RF_CmdHandle ch, uint8_t mode)
+{
+	long sequence;
+
+	(void)h;
+	(void)mode;
+	if (ch < 0)
+	{
+		return RF_StatError;
+	}
+
+	pthread_mutex_lock(&rfLock);
+	sequence = sequenceOf(ch);
+	if (sequence >= queueHead)
+	{
+		rfQueue[sequence % RF_QUEUE_LENGTH].cancelled = 1;
+		pthread_cond_broadcast(&rfChanged);
+	}
+	/* Reads stay late until the reader cancels the step that ended, not
+	 * an earlier one it was behind on */
+	if (sequence >= rxTimedOutSequence)
+	{
+		rxTimedOut = 0;
+	}
+	pthread_mutex_unlock(&rfLock);
+
+	return RF_StatSuccess;
+}
+
+RF_Stat RF_flushCmd(RF_Handle h, RF_CmdHandle ch, uint8_t mode)
+{
+	long sequence;
+
+	(void)h;
+	(void)ch;
+	(void)mode;
+	pthread_mutex_lock(&rfLock);
+	for (sequence = queueHead; sequence < queueTail; sequence++)
+	{
+		rfQueue[sequence % RF_QUEUE_LENGTH].cancelled = 1;
+	}
+	pthread_cond_broadcast(&rfChanged);
+	pthread_mutex_unlock(&rfLock);
+
+	return RF_StatSuccess;
+}
+
+RF_Stat RF_control(RF_Handle h, int8_t ctrl, void *args)
+{
+	(void)h;
+	(void)ctrl;
+	(void)args;
+	return RF_StatSuccess;
+}
+
+int8_t RF_getRssi(RF_Handle h)
+{
+	int8_t rssi;
+
+	(void)h;
+	MOCK_ADD(mockRfStats.rssiReads, 1);
+	pthread_mutex_lock(&rfLock);
+	if (rxTimedOut)
+	{
+		/* The reader missed its step, the value belongs to no step */
+		MOCK_ADD(mockRfStats.lateReads, 1);
+		rssi = RF_GET_RSSI_ERROR_VAL;
+	}
+	else if (!receiving)
+	{
+		MOCK_ADD(mockRfStats.idleReads, 1);
+		rssi = RF_GET_RSSI_ERROR_VAL;
+	}
+	else if (mockNowNs() < rssiValidNs)
+	{
+		MOCK_ADD(mockRfStats.earlyReads, 1);
+		rssi = 0;
+	}
+	else
+	{
+		rssi = mockRfRssi(rxFrequency, rxFractFreq);
+	}
+	pthread_mutex_unlock(&rfLock);
+
+	return rssi;
+}
@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file mockRtos.c
+ *
+ *  TI-RTOS kernel on POSIX threads: tasks, clock ticks, semaphores,
+ *  mailboxes, gates, events and the timestamp. Hwi_disable() takes a lock
+ *  that the mock drivers also hold while they call back, like interrupts
+ *  that are masked.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/prctl.h>
+
+#include "mockTi.h"
+
+/***** Defines *****/
+
+#define TIMESTAMP_HZ	(48000000U)	/*!< CPU clock the timestamp counts	*/
+
+/***** Structures *****/
+
+/** @brief Host object behind a Semaphore, Mailbox or Event handle.
+ */
+typedef struct MockWaitObject {
+	pthread_mutex_t lock;
+	pthread_cond_t  changed;
+	int             count;		/*!< Semaphore count or posted events	*/
+	int             maxCount;	/*!< 1 for a binary semaphore			*/
+	size_t          msgSize;	/*!< Mailbox message size				*/
+	unsigned        msgSlots;	/*!< Mailbox messages					*/
+	unsigned        msgHead;	/*!< Next mailbox message to pend		*/
+	uint8_t        *messages;	/*!< Mailbox messages					*/
+} MockWaitObject;
+
+/** @brief Task function and its arguments for the task thread.
+ */
+typedef struct MockTask {
+	Task_FuncPtr fxn;
+	UArg         arg0;
+	UArg         arg1;
+} MockTask;
+
+/***** Variable declarations *****/
+
+uint32_t Clock_tickPeriod = 10U;
+
+static pthread_mutex_t hwiLock;
+static pthread_once_t hwiOnce = PTHREAD_ONCE_INIT;
+
+/***** Function definitions *****/
+
+/** @brief Let sleeps end on time. Linux adds up to 50 us of timer slack to
+ *  every sleep, more than a sweep step waits. Threads created later keep
+ *  the slack of this one.
+ */
+__attribute__((constructor)) static void exactTimers(void)
+{
+	prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+}
+
+long long mockNowNs(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+void mockSleepUs(uint32_t us)
+{
+	struct timespec delay;
+
+	delay.tv_sec = us / 1000000U;
+	delay.tv_nsec = (long)(us % 1000000U) * 1000L;
+	while (nanosleep(&delay, &delay) != 0)
+	{
+	}
+}
+
+/** @brief Create a recursive mutex, gates and Hwi_disable() nest. */
+static void initRecursive(pthread_mutex_t *mutex)
+{
+	pthread_mutexattr_t attr;
+
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(mutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+}
+
+static MockWaitObject *newWaitObject(void)
+{
+	MockWaitObject *object = calloc(1U, sizeof(MockWaitObject));
+
+	pthread_mutex_init(&object->lock, NULL);
+	pthread_cond_init(&object->changed, NULL);
+	return object;
+}
+
+/** @brief Wait for a change of the object until the timeout in ticks, from
+ *  the deadline computed by the caller.
+ *
+ *  @return 0 once the deadline passed
+ */
+static int waitChange(MockWaitObject *object, UInt timeout,
+		const struct timespec *deadline)
+{
+	if (timeout == BIOS_NO_WAIT)
+	{
+		return 0;
+	}
+	if (timeout == BIOS_WAIT_FOREVER)
+	{
+		pthread_cond_wait(&object->changed, &object->lock);
+		return 1;
+	}
+
+	return pthread_cond_timedwait(&object->changed, &object->lock, deadline)
+			!= ETIMEDOUT;
+}
+
+static void deadlineOf(UInt timeout, struct timespec *deadline)
+{
+	long long ns = (long long)timeout * Clock_tickPeriod * 1000LL;
+
+	clock_gettime(CLOCK_REALTIME, deadline);
+	ns += deadline->tv_nsec;
+	deadline->tv_sec += (time_t)(ns / 1000000000LL);
+	deadline->tv_nsec = (long)(ns % 1000000000LL);
+}
+
+void System_abort(const char *str)
+{
+	fprintf(stderr, "System_abort: %s", str);
+	abort();
+}
+
+void System_printf(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	vprintf(fmt, args);
+	va_end(args);
+}
+
+uint32_t Timestamp_get32(void)
+{
+	return (uint32_t)(mockNowNs() * (TIMESTAMP_HZ / 1000000U) / 1000LL);
+}
+
+void Timestamp_getFreq(Types_FreqHz *freq)
+{
+	freq->hi = 0U;
+	freq->lo = TIMESTAMP_HZ;
+}
+
+uint32_t Clock_getTicks(void)
+{
+	return (uint32_t)(mockNowNs() / (1000LL * Clock_tickPeriod));
+}
+
+static void *taskThread(void *arg)
+{
+	MockTask *task = arg;
+
+	task->fxn(task->arg0, task->arg1);
+	return NULL;
+}
+
+void Task_Params_init(Task_Params *params)
+{
+	memset(params, 0, sizeof(*params));
+}
+
+void Task_construct(Task_Struct *task, Task_FuncPtr fxn, Task_Params *params,
+		Error_Block *eb)
+{
+	MockTask *object = calloc(1U, sizeof(MockTask));
+	pthread_t thread;
+
+	(void)eb;
+	object->fxn = fxn;
+	object->arg0 = params->arg0;
+	object->arg1 = params->arg1;
+	task->object = object;
+	pthread_create(&thread, NULL, taskThread, object);
+	pthread_detach(thread);
+}
+
+void Task_sleep(UInt ticks)
+{
+	mockSleepUs(ticks * Clock_tickPeriod);
+}
+
+void Task_yield(void)
+{
+	sched_yield();
+}
+
+void Task_exit(void)
+{
+	pthread_exit(NULL);
+}
+
+void Semaphore_Params_init(Semaphore_Params *params)
+{
+	params->mode = Semaphore_Mode_COUNTING;
+}
+
+void Semaphore_construct(Semaphore_Struct *sem, int count,
+		Semaphore_Params *params)
+{
+	MockWaitObject *object = newWaitObject();
+
+	object->count = count;
+	object->maxCount = (params && (params->mode == Semaphore_Mode_BINARY))
+			? 1 : INT32_MAX;
+	sem->object = object;
+}
+
+Semaphore_Handle Semaphore_handle(Semaphore_Struct *sem)
+{
+	return (Semaphore_Handle)sem->object;
+}
+
+Bool Semaphore_pend(Semaphore_Handle handle, UInt timeout)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+	struct timespec deadline;
+	Bool taken = FALSE;
+
+	deadlineOf(timeout, &deadline);
+	pthread_mutex_lock(&object->lock);
+	while ((object->count == 0) && waitChange(object, timeout, &deadline))
+	{
+	}
+	if (object->count > 0)
+	{
+		object->count--;
+		taken = TRUE;
+	}
+	pthread_mutex_unlock(&object->lock);
+
+	return taken;
+}
+
+void Semaphore_post(Semaphore_Handle handle)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+
+	pthread_mutex_lock(&object->lock);
+	if (object->count < object->maxCount)
+	{
+		object->count++;
+	}
+	pthread_cond_broadcast(&object->changed);
+	pthread_mutex_unlock(&object->lock);
+}
+
+int Semaphore_getCount(Semaphore_Handle handle)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+	int count;
+
+	pthread_mutex_lock(&object->lock);
+	count = object->count;
+	pthread_mutex_unlock(&object->lock);
+
+	return count;
+}
+
+void Semaphore_reset(Semaphore_Handle handle, int count)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+
+	pthread_mutex_lock(&object->lock);
+	object->count = count;
+	pthread_mutex_unlock(&object->lock);
+}
+
+void Mailbox_Params_init(Mailbox_Params *params)
+{
+	(void)params;
+}
+
+void Mailbox_construct(Mailbox_Struct *mbx, size_t msgSize, UInt numMsgs,
+		Mailbox_Params *params, Error_Block *eb)
+{
+	MockWaitObject *object = newWaitObject();
+
+	(void)params;
+	(void)eb;
+	object->msgSize = msgSize;
+	object->msgSlots = numMsgs;
+	object->messages = calloc(numMsgs, msgSize);
+	mbx->object = object;
+}
+
+Mailbox_Handle Mailbox_handle(Mailbox_Struct *mbx)
+{
+	return (Mailbox_Handle)mbx->object;
+}
+
+Bool Mailbox_pend(Mailbox_Handle handle, void *msg, UInt timeout)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+	struct timespec deadline;
+	Bool taken = FALSE;
+
+	deadlineOf(timeout, &deadline);
+	pthread_mutex_lock(&object->lock);
+	while ((object->count == 0) && waitChange(object, timeout, &deadline))
+	{
+	}
+	if (object->count > 0)
+	{
+		memcpy(msg, &object->messages[object->msgHead * object->msgSize],
+				object->msgSize);
+		object->msgHead = (object->msgHead + 1U) % object->msgSlots;
+		object->count--;
+		taken = TRUE;
+		pthread_cond_broadcast(&object->changed);
+	}
+	pthread_mutex_unlock(&object->lock);
+
+	return taken;
+}
+
+Bool Mailbox_post(Mailbox_Handle handle, void *msg, UInt timeout)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+	struct timespec deadline;
+	Bool posted = FALSE;
+	unsigned slot;
+
+	deadlineOf(timeout, &deadline);
+	pthread_mutex_lock(&object->lock);
+	while (((unsigned)object->count == object->msgSlots)
+			&& waitChange(object, timeout, &deadline))
+	{
+	}
+	if ((unsigned)object->count < object->msgSlots)
+	{
+		slot = (object->msgHead + (unsigned)object->count) % object->msgSlots;
+		memcpy(&object->messages[slot * object->msgSize], msg,
+				object->msgSize);
+		object->count++;
+		posted = TRUE;
+		pthread_cond_broadcast(&object->changed);
+	}
+	pthread_mutex_unlock(&object->lock);
+
+	return posted;
+}
+
+Int Mailbox_getNumPendingMsgs(Mailbox_Handle handle)
+{
+	return Semaphore_getCount((Semaphore_Handle)handle);
+}
+
+void Event_Params_init(Event_Params *params)
+{
+	(void)params;
+}
+
+void Event_construct(Event_Struct *event, Event_Params *params)
+{
+	(void)params;
+	event->object = newWaitObject();
+}
+
+Event_Handle Event_handle(Event_Struct *event)
+{
+	return (Event_Handle)event->object;
+}
+
+Event_Handle Event_create(Event_Params *params, Error_Block *eb)
+{
+	(void)params;
+	(void)eb;
+	return (Event_Handle)newWaitObject();
+}
+
+UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask, UInt timeout)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+	struct timespec deadline;
+	UInt events;
+
+	(void)andMask;
+	deadlineOf(timeout, &deadline);
+	pthread_mutex_lock(&object->lock);
+	while (((object->count & orMask) == 0U)
+			&& waitChange(object, timeout, &deadline))
+	{
+	}
+	events = object->count & orMask;
+	object->count &= ~events;
+	pthread_mutex_unlock(&object->lock);
+
+	return events;
+}
+
+void Event_post(Event_Handle handle, UInt eventMask)
+{
+	MockWaitObject *object = (MockWaitObject *)handle;
+
+	pthread_mutex_lock(&object->lock);
+	object->count |= eventMask;
+	pthread_cond_broadcast(&object->changed);
+	pthread_mutex_unlock(&object->lock);
+}
+
+void GateMutex_Params_init(GateMutex_Params *params)
+{
+	(void)params;
+}
+
+void GateMutex_construct(GateMutex_Struct *gate, GateMutex_Params *params)
+{
+	pthread_mutex_t *mutex = malloc(sizeof(pthread_mutex_t));
+
+	(void)params;
+	initRecursive(mutex);
+	gate->object = mutex;
+}
+
+GateMutex_Handle GateMutex_handle(GateMutex_Struct *gate)
+{
+	return (GateMutex_Handle)gate->object;
+}
+
+IArg GateMutex_enter(GateMutex_Handle handle)
+{
+	pthread_mutex_lock((pthread_mutex_t *)handle);
+	return 0;
+}
+
+void GateMutex_leave(GateMutex_Handle handle, IArg key)
+{
+	(void)key;
+	pthread_mutex_unlock((pthread_mutex_t *)handle);
+}
+
+void GateMutexPri_Params_init(GateMutexPri_Params *params)
+{
+	(void)params;
+}
+
+void GateMutexPri_construct(GateMutexPri_Struct *gate,
+		GateMutexPri_Params *params)
+{
+	GateMutex_construct((GateMutex_Struct *)gate, (GateMutex_Params *)params);
+}
+
+GateMutexPri_Handle GateMutexPri_handle(GateMutexPri_Struct *gate)
+{
+	return (GateMutexPri_Handle)gate->object;
+}
+
+IArg GateMutexPri_enter(GateMutexPri_Handle handle)
+{
+	return GateMutex_enter((GateMutex_Handle)handle);
+}
+
+void GateMutexPri_leave(GateMutexPri_Handle handle, IArg key)
+{
+	GateMutex_leave((GateMutex_Handle)handle, key);
+}
+
+static void initHwiLock(void)
+{
+	initRecursive(&hwiLock);
+}
+
+UInt Hwi_disable(void)
+{
+	pthread_once(&hwiOnce, initHwiLock);
+	pthread_mutex_lock(&hwiLock);
+	return 1U;
+}
+
+void Hwi_restore(UInt key)
+{
+	(void)key;
+	pthread_mutex_unlock(&hwiLock);
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file mockTi.h
+ *
+ *  Host stand-ins of TI-RTOS, the UART and the RF core for running the
+ *  firmware tasks in host tests. Tasks are POSIX threads, the UART is a pipe
+ *  pair paced at the configured rate, the RF core is a thread that runs
+ *  posted radio operations and their chains with the timing of
+ *  #mockRfTiming.
+ *
+ *  The threads run in parallel instead of by priority, so the mocks show
+ *  whether the tasks wait on each other, not how the target schedules them.
+ */
+#ifndef MOCK_TI_H_
+#define MOCK_TI_H_
+
+#include "tiStub.h"
+
+/***** Defines *****/
+
+/** @brief Add to a counter shared by the mock threads. */
+#define MOCK_ADD(counter, value) \
+	__atomic_add_fetch(&(counter), (value), __ATOMIC_RELAXED)
+
+/** @brief Largest version 1 frame: marker, length, command, 255 payload
+ *  bytes and the CRC.
+ */
+#define MOCK_FRAME_MAX	(260U)
+
+/***** Structures *****/
+
+/** @brief Timing of the simulated RF core in microseconds.
+ */
+typedef struct MockRfTiming {
+	uint32_t fsUs;			/*!< CMD_FS from start to done			*/
+	uint32_t rxStartUs;		/*!< CMD_RX_TEST from start to receiving	*/
+	uint32_t settleUs;		/*!< RSSI valid after receiving starts	*/
+	uint32_t setupUs;		/*!< CMD_PROP_RADIO_DIV_SETUP			*/
+	uint32_t openUs;		/*!< RF_open() with its radio setup		*/
+} MockRfTiming;
+
+/** @brief Counters of the simulated RF core.
+ */
+typedef struct MockRfStats {
+	long      fsRuns;		/*!< CMD_FS run to the end				*/
+	long      rxRuns;		/*!< CMD_RX_TEST started				*/
+	long      rssiReads;	/*!< RF_getRssi() calls					*/
+	long      earlyReads;	/*!< Reads before the RSSI was valid	*/
+	long      idleReads;	/*!< Reads while not receiving			*/
+	long      lateReads;	/*!< Reads after CMD_RX_TEST ended at its
+							 *   end time, before the reader cancelled it */
+	long      rxTimeouts;	/*!< CMD_RX_TEST ended at its end time	*/
+	long      chainErrors;	/*!< CMD_RX_TEST before a CMD_FS tuned the
+							 *   radio setup, or an unknown command	*/
+	long      bandErrors;	/*!< CMD_FS outside the band of the setup */
+	long      setups;		/*!< CMD_PROP_RADIO_DIV_SETUP run		*/
+	long      opens;		/*!< RF_open() calls					*/
+	long long fsNs;			/*!< Time spent in CMD_FS				*/
+	long long overlapNs;	/*!< CMD_FS time while the UART was sending */
+} MockRfStats;
+
+/** @brief Counters of the simulated UART.
+ */
+typedef struct MockUartStats {
+	long      writes;		/*!< UART_write() calls					*/
+	long      busyWrites;	/*!< UART_write() while a write was sending */
+	long      bytes;		/*!< Bytes sent to the host				*/
+	long      opens;		/*!< UART_open() calls					*/
+	long      rxErrors;		/*!< UART_read() failed with a framing
+							 *   error or break						*/
+	long long sendNs;		/*!< Time the UART was sending			*/
+	long long writeNs;		/*!< Time callers spent in UART_write()	*/
+	uint32_t  baudRate;		/*!< Rate of the last UART_open()		*/
+} MockUartStats;
+
+/***** Variable declarations *****/
+
+extern MockRfTiming mockRfTiming;
+extern MockRfStats mockRfStats;
+extern MockUartStats mockUartStats;
+
+/** @brief RSSI the RF core measures at a synthesizer frequency, noise
+ *  around -100 dBm unless a test sets its own.
+ */
+extern int8_t (*mockRfRssi)(uint16_t frequency, uint16_t fractFreq);
+
+/** @brief Called by the RF core for every radio operation it starts, with
+ *  the handle of the command the operation belongs to. NULL for none.
+ */
+extern void (*mockRfTrace)(const rfc_radioOp_t *op, RF_CmdHandle cmd);
+
+/***** Function declarations *****/
+
+/** @brief Nanoseconds since an arbitrary start. */
+long long mockNowNs(void);
+
+/** @brief Sleep for a number of microseconds. */
+void mockSleepUs(uint32_t us);
+
+/** @brief Create the UART pipes, before the UART task starts. */
+void mockUartInit(void);
+
+/** @brief Bytes the host sends to the firmware. */
+void mockUartHostWrite(const void *data, size_t size);
+
+/** @brief Bytes the firmware sent to the host, waits up to timeoutMs for
+ *  the first one.
+ *
+ *  @return number of bytes read, 0 on timeout
+ */
+size_t mockUartHostRead(void *data, size_t size, int timeoutMs);
+
+/** @brief Send a version 1 frame with its CRC to the firmware as the host.
+ */
+void mockHostSend(uint8_t command, const uint8_t *payload, uint8_t length);
+
+/** @brief Next version 1 frame with a valid CRC from the firmware, bytes
+ *  that do not start one are skipped.
+ *
+ *  @param frame #MOCK_FRAME_MAX bytes for the frame.
+ *  @param timeoutMs time to wait for the whole frame.
+ *
+ *  @return size of the frame, 0 on timeout
+ */
+size_t mockHostFrame(uint8_t *frame, int timeoutMs);
+
+/** @brief Rate the host sends and receives at, 0 to follow the UART. */
+void mockUartHostBaud(uint32_t baudRate);
+
+/** @brief Send a break, the next UART_read() fails. */
+void mockUartHostBreak(void);
+
+/** @brief Non-zero while the UART is sending. */
+int mockUartSending(void);
+
+#endif /* MOCK_TI_H_ */
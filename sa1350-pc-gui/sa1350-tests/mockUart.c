@@ -0,0 +1,422 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file mockUart.c
+ *
+ *  UART driver on a pipe pair. Writes take the time the bytes need at the
+ *  rate of UART_open(), 10 bits per byte. In callback mode a driver thread
+ *  sends the bytes and calls the write callback with Hwi_disable() held,
+ *  the caller of UART_write() returns at once as on the target.
+ *
+ *  The host may send at another rate than the UART runs at, see
+ *  mockUartHostBaud(). UART_read() then drops the bytes and fails with a
+ *  framing error, and the host reads the bytes of the UART inverted.
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+
+#include "crc16/crc16.h"
+#include "mockTi.h"
+
+/***** Defines *****/
+
+#define HDR_PREFIX		(0x2AU)		/*!< Frame marker, seed of the CRC	*/
+
+/***** Structures *****/
+
+/** @brief The one UART of the board.
+ */
+struct UART_Config {
+	UART_Params     params;
+	pthread_mutex_t lock;
+	pthread_cond_t  changed;
+	const void     *txBuffer;	/*!< Write handed to the driver thread	*/
+	size_t          txSize;
+	int             sending;	/*!< Bytes are on the line				*/
+};
+
+/***** Variable declarations *****/
+
+MockUartStats mockUartStats;
+
+static struct UART_Config uart0 = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.changed = PTHREAD_COND_INITIALIZER
+};
+
+static int hostToDevice[2] = {-1, -1};
+static int deviceToHost[2] = {-1, -1};
+static pthread_t txThread;
+static int txThreadRunning = 0;
+static uint32_t hostBaudRate = 0U;	/*!< 0 for the rate of the UART		*/
+static int hostBreaks = 0;			/*!< Breaks not yet read			*/
+
+/* Bytes from the firmware not yet returned by mockHostFrame() */
+static uint8_t hostRx[1024];
+static size_t hostRxCount = 0U;
+
+/***** Function definitions *****/
+
+void mockUartInit(void)
+{
+	if ((pipe(hostToDevice) != 0) || (pipe(deviceToHost) != 0))
+	{
+		perror("pipe");
+		exit(1);
+	}
+}
+
+void mockUartHostWrite(const void *data, size_t size)
+{
+	if (write(hostToDevice[1], data, size) != (ssize_t)size)
+	{
+		perror("host write");
+		exit(1);
+	}
+}
+
+size_t mockUartHostRead(void *data, size_t size, int timeoutMs)
+{
+	struct pollfd ready = {deviceToHost[0], POLLIN, 0};
+	ssize_t count;
+
+	if (poll(&ready, 1, timeoutMs) <= 0)
+	{
+		return 0U;
+	}
+	count = read(deviceToHost[0], data, size);
+
+	return (count > 0) ? (size_t)count : 0U;
+}
+
+void mockHostSend(uint8_t command, const uint8_t *payload, uint8_t length)
+{
+	uint8_t frame[MOCK_FRAME_MAX];
+	uint16_t crc;
+
+	frame[0U] = HDR_PREFIX;
+	frame[1U] = length;
+	frame[2U] = command;
+	if (length != 0U)
+	{
+		memcpy(&frame[3U], payload, length);
+	}
+	crc = crc16Update(HDR_PREFIX, &frame[1U], length + 2U);
+	frame[length + 3U] = (uint8_t)(crc >> 8U);
+	frame[length + 4U] = (uint8_t)crc;
+
+	mockUartHostWrite(frame, length + 5U);
+}
+
+size_t mockHostFrame(uint8_t *frame, int timeoutMs)
+{
+	long long deadline = mockNowNs() + timeoutMs * 1000000LL;
+	size_t start = 0U;
+	size_t size, received;
+	uint16_t crc;
+	int waitMs;
+
+	while (1)
+	{
+		/* Resynchronise on the next marker */
+		while ((start < hostRxCount) && (hostRx[start] != HDR_PREFIX))
+		{
+			start++;
+		}
+		memmove(hostRx, &hostRx[start], hostRxCount - start);
+		hostRxCount -= start;
+		start = 0U;
+
+		if (hostRxCount >= 5U)
+		{
+			size = hostRx[1U] + 5U;
+			if (hostRxCount >= size)
+			{
+				crc = crc16Update(HDR_PREFIX, &hostRx[1U], size - 3U);
+				if (crc == (((uint16_t)hostRx[size - 2U] << 8U) | hostRx[size - 1U]))
+				{
+					memcpy(frame, hostRx, size);
+					memmove(hostRx, &hostRx[size], hostRxCount - size);
+					hostRxCount -= size;
+					return size;
+				}
+				start = 1U;
+				continue;
+			}
+		}
+
+		waitMs = (int)((deadline - mockNowNs()) / 1000000LL);
+		if (waitMs <= 0)
+		{
+			return 0U;
+		}
+		received = mockUartHostRead(&hostRx[hostRxCount],
+				sizeof(hostRx) - hostRxCount, waitMs);
+		if (received == 0U)
+		{
+			return 0U;
+		}
+		hostRxCount += received;
+	}
+}
+
+void mockUartHostBaud(uint32_t baudRate)
+{
+	__atomic_store_n(&hostBaudRate, baudRate, __ATOMIC_RELAXED);
+}
+
+void mockUartHostBreak(void)
+{
+	__atomic_add_fetch(&hostBreaks, 1, __ATOMIC_RELAXED);
+}
+
+/** @brief The host sends and receives at another rate than the UART. */
+static int rateMismatch(UART_Handle handle)
+{
+	uint32_t baudRate = __atomic_load_n(&hostBaudRate, __ATOMIC_RELAXED);
+
+	return (baudRate != 0U) && (baudRate != handle->params.baudRate);
+}
+
+int mockUartSending(void)
+{
+	return __atomic_load_n(&uart0.sending, __ATOMIC_RELAXED);
+}
+
+/** @brief Put bytes on the line at the UART rate.
+ */
+static void sendBytes(UART_Handle handle, const void *buffer, size_t size)
+{
+	long long start = mockNowNs();
+	uint8_t garbled[64];
+	const uint8_t *bytes = buffer;
+	size_t offset, count, index;
+
+	__atomic_store_n(&handle->sending, 1, __ATOMIC_RELAXED);
+	mockSleepUs((uint32_t)(size * 10U * 1000000ULL / handle->params.baudRate));
+	for (offset = 0U; offset < size; offset += count)
+	{
+		count = size - offset;
+		if (count > sizeof(garbled))
+		{
+			count = sizeof(garbled);
+		}
+		memcpy(garbled, &bytes[offset], count);
+		if (rateMismatch(handle))
+		{
+			for (index = 0U; index < count; index++)
+			{
+				garbled[index] ^= 0xFFU;
+			}
+		}
+		if (write(deviceToHost[1], garbled, count) != (ssize_t)count)
+		{
+			perror("device write");
+			exit(1);
+		}
+	}
+	__atomic_store_n(&handle->sending, 0, __ATOMIC_RELAXED);
+
+	MOCK_ADD(mockUartStats.bytes, (long)size);
+	MOCK_ADD(mockUartStats.sendNs, mockNowNs() - start);
+}
+
+/** @brief Driver thread of callback mode, the TX interrupt of the target.
+ */
+static void *txDriver(void *arg)
+{
+	UART_Handle handle = arg;
+	const void *buffer;
+	size_t size;
+	UInt key;
+
+	while (1)
+	{
+		pthread_mutex_lock(&handle->lock);
+		while (handle->txBuffer == NULL)
+		{
+			pthread_cond_wait(&handle->changed, &handle->lock);
+		}
+		buffer = handle->txBuffer;
+		size = handle->txSize;
+		pthread_mutex_unlock(&handle->lock);
+
+		sendBytes(handle, buffer, size);
+
+		/* The write ends before the callback, which may start the next one */
+		key = Hwi_disable();
+		pthread_mutex_lock(&handle->lock);
+		handle->txBuffer = NULL;
+		pthread_mutex_unlock(&handle->lock);
+		handle->params.writeCallback(handle, (void *)buffer, size);
+		Hwi_restore(key);
+	}
+
+	return NULL;
+}
+
+void UART_init(void)
+{
+}
+
+void UART_Params_init(UART_Params *params)
+{
+	memset(params, 0, sizeof(*params));
+	params->readMode = UART_MODE_BLOCKING;
+	params->writeMode = UART_MODE_BLOCKING;
+	params->readTimeout = UART_WAIT_FOREVER;
+	params->writeTimeout = UART_WAIT_FOREVER;
+	params->readReturnMode = UART_RETURN_FULL;
+	params->readEcho = UART_ECHO_ON;
+	params->baudRate = 115200U;
+}
+
+UART_Handle UART_open(unsigned index, UART_Params *params)
+{
+	(void)index;
+	uart0.params = *params;
+	mockUartStats.baudRate = params->baudRate;
+	MOCK_ADD(mockUartStats.opens, 1);
+
+	if ((params->writeMode == UART_MODE_CALLBACK) && !txThreadRunning)
+	{
+		pthread_create(&txThread, NULL, txDriver, &uart0);
+		txThreadRunning = 1;
+	}
+
+	return &uart0;
+}
+
+void UART_close(UART_Handle handle)
+{
+	/* A write in progress is cut off, as UART_close() does */
+	pthread_mutex_lock(&handle->lock);
+	handle->txBuffer = NULL;
+	pthread_mutex_unlock(&handle->lock);
+}
+
+int_fast32_t UART_read(UART_Handle handle, void *buffer, size_t size)
+{
+	uint8_t *bytes = buffer;
+	size_t count = 0U;
+	long long deadline = 0;
+	int timeoutMs = -1;
+	struct pollfd ready = {hostToDevice[0], POLLIN, 0};
+	ssize_t received;
+
+	if (handle->params.readTimeout != UART_WAIT_FOREVER)
+	{
+		deadline = mockNowNs() + (long long)handle->params.readTimeout
+				* Clock_tickPeriod * 1000LL;
+	}
+
+	while (count < size)
+	{
+		if (__atomic_load_n(&hostBreaks, __ATOMIC_RELAXED) > 0)
+		{
+			__atomic_sub_fetch(&hostBreaks, 1, __ATOMIC_RELAXED);
+			MOCK_ADD(mockUartStats.rxErrors, 1);
+			return UART_ERROR;
+		}
+		if (deadline != 0)
+		{
+			timeoutMs = (int)((deadline - mockNowNs() + 999999LL) / 1000000LL);
+			if (timeoutMs <= 0)
+			{
+				break;
+			}
+		}
+		if (poll(&ready, 1, timeoutMs) <= 0)
+		{
+			break;
+		}
+		received = read(hostToDevice[0], &bytes[count], size - count);
+		if (received <= 0)
+		{
+			break;
+		}
+		if (rateMismatch(handle))
+		{
+			MOCK_ADD(mockUartStats.rxErrors, 1);
+			return UART_ERROR;
+		}
+		count += (size_t)received;
+		if (handle->params.readReturnMode == UART_RETURN_PARTIAL)
+		{
+			break;
+		}
+	}
+
+	return (int_fast32_t)count;
+}
+
+int_fast32_t UART_write(UART_Handle handle, const void *buffer, size_t size)
+{
+	long long start = mockNowNs();
+
+	MOCK_ADD(mockUartStats.writes, 1);
+
+	if (handle->params.writeMode != UART_MODE_CALLBACK)
+	{
+		sendBytes(handle, buffer, size);
+		MOCK_ADD(mockUartStats.writeNs, mockNowNs() - start);
+		return (int_fast32_t)size;
+	}
+
+	pthread_mutex_lock(&handle->lock);
+	if (handle->txBuffer != NULL)
+	{
+		pthread_mutex_unlock(&handle->lock);
+		MOCK_ADD(mockUartStats.busyWrites, 1);
+		return UART_ERROR;
+	}
+	handle->txBuffer = buffer;
+	handle->txSize = size;
+	pthread_cond_broadcast(&handle->changed);
+	pthread_mutex_unlock(&handle->lock);
+	MOCK_ADD(mockUartStats.writeNs, mockNowNs() - start);
+
+	return 0;
+}
+
+void UART_readCancel(UART_Handle handle)
+{
+	(void)handle;
+}
+
+void UART_writeCancel(UART_Handle handle)
+{
+	(void)handle;
+}
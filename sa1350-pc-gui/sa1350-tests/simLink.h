@@ -0,0 +1,182 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file simLink.h */
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include "sa1350.h"
+#include "sa1350Cmd.h"
+
+/*!
+ \brief Seconds since an arbitrary start
+
+*/
+static double monotonic(void)
+{
+    return(std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*!
+ \brief The DLL connected to sa1350-sim, for the benchmarks of the host loop
+
+ Starts the simulator next to the benchmark binary, reads the name of its
+ pty slave from the first line of its output and connects the DLL to it.
+ The simulator statistics on stderr are discarded.
+
+ \class cSimLink simLink.h "simLink.h"
+*/
+class cSimLink
+{
+public:
+    cSimLink(void) : Pid(-1) {}
+    ~cSimLink(void) { Stop(); }
+
+    /*!
+     \brief Start the simulator and connect the DLL
+
+     \param Argv0 argv[0] of the benchmark, the simulator is in its directory
+     \param Args simulator options
+     \return bool true if the DLL is connected
+    */
+    bool Start(const char *Argv0, const std::vector<std::string> &Args)
+    {
+        std::string               path(Argv0);
+        std::vector<char*>        argv;
+        posix_spawn_file_actions_t actions;
+        char                      name[256];
+        FILE                     *out;
+        int                       pipeFd[2];
+        size_t                    index;
+
+        path = path.substr(0, path.find_last_of('/')+1) + "sa1350-sim";
+        argv.push_back((char*)path.c_str());
+        for(index=0; index<Args.size(); index++)
+            argv.push_back((char*)Args[index].c_str());
+        argv.push_back(NULL);
+
+        if(pipe(pipeFd))
+            return(false);
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, pipeFd[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addclose(&actions, pipeFd[0]);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+        if(posix_spawn(&Pid, path.c_str(), &actions, NULL, &argv[0], NULL))
+            Pid = -1;
+        posix_spawn_file_actions_destroy(&actions);
+        close(pipeFd[1]);
+        if(Pid < 0)
+        {
+            close(pipeFd[0]);
+            printf("FAIL: could not start %s\n", path.c_str());
+            return(false);
+        };
+
+        // The slave name, the pipe stays open until the simulator exits
+        out = fdopen(pipeFd[0], "r");
+        if(!out || !fgets(name, sizeof(name), out))
+        {
+            printf("FAIL: no pty from %s\n", path.c_str());
+            return(false);
+        };
+        name[strcspn(name, "\n")] = 0;
+        Output = out;
+
+        if(!sa1350Init() || !sa1350Connect(name))
+        {
+            printf("FAIL: could not connect to %s\n", name);
+            return(false);
+        };
+
+        return(Command(CMD_CONNECT, NULL, 0, 1000));
+    }
+
+    /*!
+     \brief Disconnect the DLL and stop the simulator
+
+    */
+    void Stop(void)
+    {
+        if(Pid < 0)
+            return;
+        sa1350Disconnect();
+        sa1350DeInit();
+        kill(Pid, SIGTERM);
+        waitpid(Pid, NULL, 0);
+        fclose(Output);
+        Pid = -1;
+    }
+
+    /*!
+     \brief Send a command and wait for its ACK, as drvSA1350::cmdSetX
+
+     \param Cmd
+     \param Data
+     \param Size
+     \param TimeoutMs
+     \return bool true if the ACK came in time
+    */
+    static bool Command(unsigned char Cmd, unsigned char *Data, unsigned short Size, unsigned long TimeoutMs)
+    {
+        SA1350Frame frame;
+        double      deadline = monotonic()+TimeoutMs/1000.0;
+        double      remaining;
+
+        if(!sa1350SendCmd(Cmd, Data, Size))
+            return(false);
+        while(true)
+        {
+            while(sa1350GetFrame(&frame))
+            {
+                if(frame.Cmd==Cmd && frame.Length==0)
+                    return(true);
+            };
+            remaining = deadline-monotonic();
+            if(remaining <= 0)
+                return(false);
+            sa1350WaitForFrame((unsigned long)(remaining*1000)+1);
+        };
+    }
+
+private:
+    pid_t Pid;      /*!< Simulator process */
+    FILE *Output;   /*!< Simulator stdout */
+};
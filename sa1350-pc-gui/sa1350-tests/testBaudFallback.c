@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file testBaudFallback.c
+ *
+ *  A host that loses the raised UART rate finds the SA1350 at 115200 again.
+ *  Runs the UART and RF tasks on the mocks of mockTi.h, raises the rate
+ *  with #CMD_SETBAUDRATE and then sends at 115200, breaks, frames with a
+ *  bad CRC or nothing at all. Each time the SA1350 has to return to 115200
+ *  and ACK a #CMD_SYNC there. Built with a 200 ms #UART_IDLE_TIMEOUT.
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "crc16/crc16.h"
+#include "mockTi.h"
+#include "SA1350_Firmware.h"
+
+/***** Defines *****/
+
+#define CMD_CONNECT			(1U)
+#define CMD_SYNC			(7U)
+#define CMD_SETBAUDRATE		(8U)
+#define HDR_PREFIX			(0x2AU)
+
+#define DEFAULT_BAUD		(115200U)
+#define RAISED_BAUD			(921600U)
+#define REPLY_TIMEOUT_MS	(50)	/*!< Wait for an ACK				*/
+#define SYNC_ATTEMPTS		(8)		/*!< SYNCs before the host gives up	*/
+
+/***** Function definitions *****/
+
+/** @brief Send a command and wait for its ACK, skipping other frames.
+ *
+ *  @return 0 on ACK, -1 on timeout
+ */
+static int command(uint8_t cmd, const uint8_t *payload, uint8_t length)
+{
+	uint8_t frame[MOCK_FRAME_MAX];
+
+	mockHostSend(cmd, payload, length);
+
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if ((frame[1U] == 0U) && (frame[2U] == cmd))
+		{
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+/** @brief Connect at 115200 and raise the rate as the host does.
+ *
+ *  @return 0 once the SA1350 runs at #RAISED_BAUD
+ */
+static int raiseRate(void)
+{
+	uint8_t baudPayload[4U] = {
+		(uint8_t)(RAISED_BAUD >> 24U), (uint8_t)(RAISED_BAUD >> 16U),
+		(uint8_t)(RAISED_BAUD >> 8U), (uint8_t)RAISED_BAUD
+	};
+
+	mockUartHostBaud(DEFAULT_BAUD);
+	if ((command(CMD_CONNECT, NULL, 0U) != 0)
+			|| (command(CMD_SETBAUDRATE, baudPayload, sizeof(baudPayload)) != 0))
+	{
+		return -1;
+	}
+
+	mockUartHostBaud(RAISED_BAUD);
+	if ((command(CMD_SYNC, NULL, 0U) != 0)
+			|| (mockUartStats.baudRate != RAISED_BAUD))
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+/** @brief The host looks for the SA1350 at 115200 with #CMD_SYNC.
+ *
+ *  @return number of SYNCs sent until one was ACKed, -1 if none was
+ */
+static int findDefaultRate(void)
+{
+	int attempt;
+
+	mockUartHostBaud(DEFAULT_BAUD);
+	for (attempt = 1; attempt <= SYNC_ATTEMPTS; attempt++)
+	{
+		if (command(CMD_SYNC, NULL, 0U) == 0)
+		{
+			return (mockUartStats.baudRate == DEFAULT_BAUD) ? attempt : -1;
+		}
+	}
+
+	return -1;
+}
+
+/** @brief Send frames with a bad CRC at the raised rate.
+ */
+static void sendBadCrc(int frames)
+{
+	uint8_t frame[5U] = {HDR_PREFIX, 0U, CMD_SYNC, 0U, 0U};
+	uint16_t crc = crc16Update(HDR_PREFIX, &frame[1U], 2U) ^ 0x0101U;
+	int index;
+
+	frame[3U] = (uint8_t)(crc >> 8U);
+	frame[4U] = (uint8_t)crc;
+	for (index = 0; index < frames; index++)
+	{
+		mockUartHostWrite(frame, sizeof(frame));
+		mockSleepUs(20000U);
+	}
+}
+
+/** @brief Check one way of losing the raised rate.
+ *
+ *  @param name printed name.
+ *  @param lose what the host does at the raised rate, NULL to send
+ *  nothing.
+ *
+ *  @return 0 on success
+ */
+static int checkFallback(const char *name, void (*lose)(void))
+{
+	long rxErrors;
+	int attempts;
+
+	if (raiseRate() != 0)
+	{
+		fprintf(stderr, "FAIL: %s: rate not raised\n", name);
+		return 1;
+	}
+
+	rxErrors = mockUartStats.rxErrors;
+	if (lose != NULL)
+	{
+		lose();
+	}
+	attempts = findDefaultRate();
+
+	printf("%s: back at %u bit/s after %d SYNCs, %ld receive errors\n",
+			name, mockUartStats.baudRate, attempts,
+			mockUartStats.rxErrors - rxErrors);
+	if (attempts < 0)
+	{
+		fprintf(stderr, "FAIL: %s: no ACK at %u bit/s\n", name, DEFAULT_BAUD);
+		return 1;
+	}
+
+	return 0;
+}
+
+/** @brief Three breaks on the line. */
+static void sendBreaks(void)
+{
+	int index;
+
+	for (index = 0; index < 3; index++)
+	{
+		mockUartHostBreak();
+		mockSleepUs(20000U);
+	}
+}
+
+/** @brief Three frames with a bad CRC. */
+static void sendCrcErrors(void)
+{
+	sendBadCrc(3);
+}
+
+/** @brief Nothing for twice the idle timeout. */
+static void stayIdle(void)
+{
+	mockSleepUs(400000U);
+}
+
+int main(void)
+{
+	int failures = 0;
+
+	mockUartInit();
+	RfTask_init();
+	UartTask_init();
+
+	/* Host restarted at 115200 and sends there */
+	failures += checkFallback("wrong rate", NULL);
+	failures += checkFallback("breaks", sendBreaks);
+	failures += checkFallback("bad CRC", sendCrcErrors);
+	failures += checkFallback("idle", stayIdle);
+
+	if (failures != 0)
+	{
+		fprintf(stderr, "FAIL: %d checks\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file testCrc16.c
+ *
+ *  Checks the table driven crc16UpdateByte() and crc16Update() against the
+ *  bitwise crc16AddByte() and calcCrc16() of firmware 1.3 and DLL 1.3,
+ *  which they replaced. Built once per #CRC16_SLICE_BY.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crc16.h"
+
+/***** Defines *****/
+
+#define HDR_PREFIX		(0x2AU)		/*!< Frame marker, seed of the CRC	*/
+#define MAX_TEST_LENGTH	(3000U)		/*!< Longest random block			*/
+#define RANDOM_BLOCKS	(20000U)	/*!< Random blocks checked			*/
+
+/***** Function definitions *****/
+
+/** @brief Bitwise CRC16 step of firmware 1.3, copied unchanged.
+ *
+ *  @param addb active CRC16 value.
+ *  @param u8 data byte to add.
+ */
+static void crc16AddByte(uint16_t *addb, uint8_t u8)
+{
+	*addb  = (*addb >> 8U) | (*addb << 8U);
+	*addb ^=  u8;
+	*addb ^= (*addb & 0xFFU) >> 4U;
+	*addb ^= (*addb << 8U) << 4U;
+	*addb ^= ((*addb & 0xFFU) << 4U) << 1U;
+}
+
+/** @brief Frame CRC of firmware 1.3, copied unchanged apart from the
+ *  length type. The marker at bytes[0] is the seed and not added.
+ *
+ *  @param data frame from the marker up to the CRC.
+ *  @param dataLength number of bytes.
+ *
+ *  @return frame CRC
+ */
+static uint16_t calcCrc16(void *data, uint16_t dataLength)
+{
+	uint16_t crcIndex;
+	uint16_t crc = HDR_PREFIX;
+	uint8_t *bytes = data;
+
+	for (crcIndex = 1U; crcIndex < dataLength; crcIndex++)
+	{
+		crc16AddByte(&crc, bytes[crcIndex]);
+	}
+
+	return crc;
+}
+
+/** @brief Bitwise CRC16 of a block with any seed.
+ *
+ *  @param crc seed.
+ *  @param data bytes to add.
+ *  @param length number of bytes.
+ *
+ *  @return CRC16 value
+ */
+static uint16_t bitwiseCrc16(uint16_t crc, const uint8_t *data, size_t length)
+{
+	size_t index;
+
+	for (index = 0U; index < length; index++)
+	{
+		crc16AddByte(&crc, data[index]);
+	}
+
+	return crc;
+}
+
+/** @brief Every seed with every byte through crc16UpdateByte().
+ *
+ *  @return number of mismatches
+ */
+static unsigned long testAllBytes(void)
+{
+	unsigned long errors = 0U;
+	uint32_t seed;
+	uint16_t data;
+	uint16_t expected;
+
+	for (seed = 0U; seed <= 0xFFFFU; seed++)
+	{
+		for (data = 0U; data <= 0xFFU; data++)
+		{
+			expected = (uint16_t)seed;
+			crc16AddByte(&expected, (uint8_t)data);
+			if (crc16UpdateByte((uint16_t)seed, (uint8_t)data) != expected)
+			{
+				errors++;
+			}
+		}
+	}
+
+	return errors;
+}
+
+/** @brief Random blocks of 0 to #MAX_TEST_LENGTH bytes at every alignment,
+ *  in one piece and split at a random point.
+ *
+ *  @return number of mismatches
+ */
+static unsigned long testRandomBlocks(void)
+{
+	static uint8_t buffer[MAX_TEST_LENGTH + 8U];
+	unsigned long errors = 0U;
+	unsigned int block;
+	size_t index, offset, length, split;
+	uint16_t seed, expected, crc;
+
+	srand(1350U);
+	for (block = 0U; block < RANDOM_BLOCKS; block++)
+	{
+		offset = block % 8U;
+		length = (block < 64U) ? block : (size_t)rand() % (MAX_TEST_LENGTH + 1U);
+		split = (length == 0U) ? 0U : (size_t)rand() % (length + 1U);
+		seed = (block & 1U) ? (uint16_t)rand() : HDR_PREFIX;
+		for (index = 0U; index < length; index++)
+		{
+			buffer[offset + index] = (uint8_t)rand();
+		}
+
+		expected = bitwiseCrc16(seed, &buffer[offset], length);
+		crc = crc16Update(seed, &buffer[offset], length);
+		if (crc != expected)
+		{
+			if (errors++ < 5U)
+			{
+				printf("length %u offset %u: 0x%04X, expected 0x%04X\n",
+						(unsigned)length, (unsigned)offset, crc, expected);
+			}
+		}
+		crc = crc16Update(seed, &buffer[offset], split);
+		crc = crc16Update(crc, &buffer[offset + split], length - split);
+		if (crc != expected)
+		{
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+/** @brief Frames as the firmware sends them: calcCrc16() over the frame
+ *  against crc16Update() from the byte after the marker.
+ *
+ *  @return number of mismatches
+ */
+static unsigned long testFrames(void)
+{
+	/* CMD_CONNECT frame without payload and its CRC */
+	static const uint8_t connectCmd[] = {HDR_PREFIX, 0x00U, 0x01U, 0x95U, 0x09U};
+	uint8_t frame[3U + 255U + 2U];
+	unsigned long errors = 0U;
+	unsigned int length;
+	uint16_t crc;
+
+	crc = crc16Update(HDR_PREFIX, &connectCmd[1U], 2U);
+	if ((crc != calcCrc16((void *)connectCmd, 3U))
+			|| (crc != (uint16_t)((connectCmd[3U] << 8U) | connectCmd[4U])))
+	{
+		printf("CMD_CONNECT: 0x%04X, expected 0x9509\n", crc);
+		errors++;
+	}
+
+	for (length = 0U; length <= 255U; length++)
+	{
+		frame[0U] = HDR_PREFIX;
+		frame[1U] = (uint8_t)length;
+		frame[2U] = (uint8_t)(length * 7U);
+		memset(&frame[3U], (int)length, length);
+		if (crc16Update(HDR_PREFIX, &frame[1U], length + 2U)
+				!= calcCrc16(frame, (uint16_t)(length + 3U)))
+		{
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+int main(void)
+{
+	unsigned long bytes, blocks, frames;
+
+	bytes = testAllBytes();
+	blocks = testRandomBlocks();
+	frames = testFrames();
+
+	printf("slice-by-%u: %lu byte, %lu block and %lu frame mismatches\n",
+			(unsigned)CRC16_SLICE_BY, bytes, blocks, frames);
+
+	return ((bytes + blocks + frames) == 0U) ? 0 : 1;
+}
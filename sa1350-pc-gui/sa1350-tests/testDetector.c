@@ -0,0 +1,311 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file testDetector.c
+ *
+ *  Checks detectorReduce() of every detector mode against a floating point
+ *  reference, for one read per step and for #DETECTOR_MAX_DWELL reads, the
+ *  dwell counts between and the RSSI extremes, and detectorDecimate() against
+ *  detectorReduce() of its bins.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "detector.h"
+
+/***** Defines *****/
+
+#define RANDOM_STEPS	(20000U)	/*!< Random read sets per mode and dwell */
+#define SWEEP_LENGTH	(2048U)		/*!< Longest sweep decimated			*/
+
+/** @brief Reference RMS values this close to a half dB are ties, which
+ *  detector.c rounds down and the reference up.
+ */
+#define RMS_TIE_DB		(0.001)
+
+/***** Variable declarations *****/
+
+static const char *const modeNames[] = {"sample", "peak", "average", "RMS"};
+
+/***** Function definitions *****/
+
+/** @brief Reference value of a detector mode in floating point.
+ *
+ *  @param mode detector mode.
+ *  @param samples RSSI reads.
+ *  @param count number of reads.
+ *  @param unrounded returns the value before rounding to a dB.
+ *
+ *  @return value rounded to the nearest dB
+ */
+static int referenceReduce(uint8_t mode, const int8_t *samples, uint16_t count,
+		double *unrounded)
+{
+	double value = samples[count - 1U], sum = 0.0;
+	uint16_t index;
+
+	switch (mode)
+	{
+		case DETECTOR_PEAK:
+			for (index = 0U; index < count; index++)
+			{
+				value = (samples[index] > value) ? samples[index] : value;
+			}
+			break;
+		case DETECTOR_AVERAGE:
+			for (index = 0U; index < count; index++)
+			{
+				sum += samples[index];
+			}
+			value = sum / count;
+			break;
+		case DETECTOR_RMS:
+			for (index = 0U; index < count; index++)
+			{
+				sum += pow(10.0, samples[index] / 10.0);
+			}
+			value = 10.0 * log10(sum / count);
+			break;
+		default:
+			break;
+	}
+
+	*unrounded = value;
+	return (int)floor(value + 0.5);
+}
+
+/** @brief Check one set of reads in every mode.
+ *
+ *  @param samples RSSI reads.
+ *  @param count number of reads.
+ *  @param errors mismatches per mode, incremented.
+ */
+static void checkReads(const int8_t *samples, uint16_t count,
+		unsigned long *errors)
+{
+	double unrounded, fraction;
+	int expected, value;
+	uint8_t mode;
+
+	for (mode = DETECTOR_SAMPLE; mode <= DETECTOR_RMS; mode++)
+	{
+		expected = referenceReduce(mode, samples, count, &unrounded);
+		value = detectorReduce(mode, samples, count);
+		if (value == expected)
+		{
+			continue;
+		}
+
+		fraction = unrounded - floor(unrounded);
+		if ((mode == DETECTOR_RMS) && (abs(value - expected) == 1)
+				&& (fabs(fraction - 0.5) < RMS_TIE_DB))
+		{
+			continue;
+		}
+
+		if (errors[mode] < 5U)
+		{
+			printf("%s of %u reads from %d: %d, expected %d (%.3f)\n",
+					modeNames[mode], count, samples[0U], value, expected,
+					unrounded);
+		}
+		errors[mode]++;
+	}
+}
+
+/** @brief Single reads, the classic one read per step, every mode returns
+ *  the read itself.
+ */
+static void checkDwellOne(unsigned long *errors)
+{
+	int8_t sample;
+	int value;
+
+	for (value = -128; value <= 127; value++)
+	{
+		sample = (int8_t)value;
+		checkReads(&sample, 1U, errors);
+	}
+}
+
+/** @brief Reads at the RSSI extremes and in the order that tells sample
+ *  apart from peak, for every dwell count.
+ */
+static void checkExtremes(unsigned long *errors)
+{
+	int8_t samples[DETECTOR_MAX_DWELL];
+	uint16_t count, index;
+
+	for (count = 1U; count <= DETECTOR_MAX_DWELL; count++)
+	{
+		memset(samples, -128, sizeof(samples));
+		checkReads(samples, count, errors);
+		memset(samples, 127, sizeof(samples));
+		checkReads(samples, count, errors);
+
+		/* A burst in the first read only and in the last read only */
+		for (index = 0U; index < count; index++)
+		{
+			samples[index] = (int8_t)-100;
+		}
+		samples[0U] = (int8_t)-20;
+		checkReads(samples, count, errors);
+		samples[0U] = (int8_t)-100;
+		samples[count - 1U] = (int8_t)-20;
+		checkReads(samples, count, errors);
+
+		/* Further below the peak than the RMS table reaches */
+		for (index = 0U; index < count; index++)
+		{
+			samples[index] = (int8_t)(((index & 1U) != 0U) ? 127 : -128);
+		}
+		checkReads(samples, count, errors);
+	}
+}
+
+/** @brief Random reads around a noise floor, some with a burst, for one
+ *  read per step, #DETECTOR_MAX_DWELL reads and the counts between.
+ */
+static void checkRandom(unsigned long *errors)
+{
+	int8_t samples[DETECTOR_MAX_DWELL];
+	uint16_t count, index;
+	unsigned long step;
+	int floorDbm, spread;
+
+	for (count = 1U; count <= DETECTOR_MAX_DWELL; count++)
+	{
+		for (step = 0U; step < RANDOM_STEPS; step++)
+		{
+			floorDbm = -120 + (rand() % 100);
+			spread = 1 + (rand() % 40);
+			for (index = 0U; index < count; index++)
+			{
+				samples[index] = (int8_t)(floorDbm + (rand() % spread));
+			}
+			if ((rand() % 4) == 0)
+			{
+				samples[rand() % count] = (int8_t)(floorDbm + 40);
+			}
+			checkReads(samples, count, errors);
+		}
+	}
+}
+
+/** @brief Decimation against detectorReduce() of its bins, including the
+ *  short last bin and decimation in place.
+ *
+ *  @return number of mismatches
+ */
+static unsigned long checkDecimate(void)
+{
+	static const uint16_t binCounts[] = {0U, 1U, 100U, 288U, 320U, 2047U,
+			SWEEP_LENGTH, 4000U};
+	int8_t rssi[SWEEP_LENGTH], bins[SWEEP_LENGTH], inPlace[SWEEP_LENGTH];
+	uint16_t length, index, factor, binCount, bin, points;
+	unsigned long errors = 0U;
+	uint8_t mode;
+
+	for (index = 0U; index < SWEEP_LENGTH; index++)
+	{
+		rssi[index] = (int8_t)(-110 + (rand() % 30));
+	}
+
+	for (length = 1U; length <= SWEEP_LENGTH; length += 97U)
+	{
+		for (index = 0U; index < sizeof(binCounts) / sizeof(binCounts[0U]); index++)
+		{
+			factor = detectorDecimateFactor(length, binCounts[index]);
+			if ((factor == 0U) || ((binCounts[index] > 0U)
+					&& (((length + factor - 1U) / factor) > binCounts[index])))
+			{
+				printf("factor %u for %u points in %u bins\n", factor, length,
+						binCounts[index]);
+				errors++;
+				continue;
+			}
+
+			for (mode = DETECTOR_SAMPLE; mode <= DETECTOR_RMS; mode++)
+			{
+				binCount = detectorDecimate(mode, rssi, length, factor, bins);
+				memcpy(inPlace, rssi, length);
+				if ((binCount != ((length + factor - 1U) / factor))
+						|| (detectorDecimate(mode, inPlace, length, factor,
+								inPlace) != binCount)
+						|| (memcmp(bins, inPlace, binCount) != 0))
+				{
+					printf("%s decimation of %u points by %u\n",
+							modeNames[mode], length, factor);
+					errors++;
+					continue;
+				}
+				for (bin = 0U; bin < binCount; bin++)
+				{
+					points = length - (bin * factor);
+					points = (points < factor) ? points : factor;
+					if (bins[bin] != detectorReduce(mode, &rssi[bin * factor],
+							points))
+					{
+						errors++;
+					}
+				}
+			}
+		}
+	}
+
+	return errors;
+}
+
+int main(void)
+{
+	unsigned long errors[DETECTOR_RMS + 1U] = {0U};
+	unsigned long decimate, total = 0U;
+	uint8_t mode;
+
+	srand(1350U);
+	checkDwellOne(errors);
+	checkExtremes(errors);
+	checkRandom(errors);
+	decimate = checkDecimate();
+
+	for (mode = DETECTOR_SAMPLE; mode <= DETECTOR_RMS; mode++)
+	{
+		printf("%-8s dwell 1 - %u: %lu mismatches\n", modeNames[mode],
+				(unsigned)DETECTOR_MAX_DWELL, errors[mode]);
+		total += errors[mode];
+	}
+	printf("decimation: %lu mismatches\n", decimate);
+
+	return ((total + decimate) == 0U) ? 0 : 1;
+}
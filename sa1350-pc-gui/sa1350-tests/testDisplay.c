@@ -0,0 +1,515 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file testDisplay.c
+ *
+ *  Draws sweeps with drawSweep() and drawGrid() of display.c on a grlib
+ *  stand-in that keeps the pixels of the Sharp96 LCD, frame by frame as the
+ *  display task does. Every frame must match, pixel for pixel, the frame of
+ *  the renderer that cleared the plot and drew every column and the whole
+ *  grid each time, and only the plot may be drawn on. Nothing is drawn
+ *  before the first sweep. Reports the pixels
+ *  written, flushes and time per frame of both renderers.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mockTi.h"
+#include "display.c"
+
+/***** Defines *****/
+
+#define LCD_SIZE		(96)		/*!< Sharp96 rows and columns			*/
+#define NOISE_FRAMES	(200U)		/*!< Frames of each noisy sweep case	*/
+
+/***** Structures *****/
+
+/** @brief Pixels and counters behind one grlib context.
+ */
+typedef struct TestLcd {
+	uint8_t   pixels[LCD_SIZE][LCD_SIZE];	/*!< 1 black, 0 white		*/
+	uint8_t   color;				/*!< Foreground color			*/
+	long      written;				/*!< Pixels written				*/
+	long      outside;				/*!< Pixels written off the plot	*/
+	long      flushes;				/*!< Graphics_flushBuffer() calls	*/
+	long long ns;					/*!< Time spent drawing			*/
+} TestLcd;
+
+/** @brief Totals of one case.
+ */
+typedef struct TestTotals {
+	long      frames;				/*!< Frames drawn				*/
+	long      written[2];			/*!< Pixels, display.c and reference */
+	long      flushes[2];			/*!< Flushes, display.c and reference */
+	long long ns[2];				/*!< Time, display.c and reference	*/
+} TestTotals;
+
+/***** Variable declarations *****/
+
+static Graphics_Context lcdContext, refContext;
+static TestLcd lcd, ref;
+
+/** @brief The latest sweep, as lockSweepData() returns it. */
+static SweepBuffer testSweep;
+
+static int failures = 0;
+
+/***** Function definitions *****/
+
+/** @brief LCD behind a grlib context. */
+static TestLcd *contextLcd(const Graphics_Context *context)
+{
+	return (context == &lcdContext) ? &lcd : &ref;
+}
+
+/** @brief Write one pixel in the foreground color, clipped to the LCD. */
+static void setPixel(TestLcd *target, int32_t x, int32_t y)
+{
+	if ((x < 0) || (x >= LCD_SIZE) || (y < 0) || (y >= LCD_SIZE))
+	{
+		return;
+	}
+	if ((x >= PLOT_COL_COUNT) || (y < PLOT_V_ORIGIN)
+			|| (y > PLOT_V_ORIGIN + PLOT_ROW_COUNT))
+	{
+		target->outside++;
+	}
+	target->pixels[y][x] = target->color;
+	target->written++;
+}
+
+void Graphics_drawImage(const Graphics_Context *context, const tImage *image,
+		int16_t x, int16_t y)
+{
+	(void)context;
+	(void)image;
+	(void)x;
+	(void)y;
+}
+
+void Graphics_drawPixel(const Graphics_Context *context, int32_t x, int32_t y)
+{
+	setPixel(contextLcd(context), x, y);
+}
+
+void Graphics_drawLineH(const Graphics_Context *context, int32_t x1,
+		int32_t x2, int32_t y)
+{
+	int32_t x;
+
+	for (x = (x1 < x2) ? x1 : x2; x <= ((x1 < x2) ? x2 : x1); x++)
+	{
+		setPixel(contextLcd(context), x, y);
+	}
+}
+
+void Graphics_drawLineV(const Graphics_Context *context, int32_t x,
+		int32_t y1, int32_t y2)
+{
+	int32_t y;
+
+	for (y = (y1 < y2) ? y1 : y2; y <= ((y1 < y2) ? y2 : y1); y++)
+	{
+		setPixel(contextLcd(context), x, y);
+	}
+}
+
+void Graphics_fillRectangle(const Graphics_Context *context,
+		const Graphics_Rectangle *rect)
+{
+	int32_t y;
+
+	for (y = rect->yMin; y <= rect->yMax; y++)
+	{
+		Graphics_drawLineH(context, rect->xMin, rect->xMax, y);
+	}
+}
+
+void Graphics_setForegroundColor(const Graphics_Context *context,
+		int32_t value)
+{
+	contextLcd(context)->color = (value == GRAPHICS_COLOR_BLACK) ? 1U : 0U;
+}
+
+void Graphics_flushBuffer(const Graphics_Context *context)
+{
+	contextLcd(context)->flushes++;
+}
+
+void Display_Params_init(Display_Params *params)
+{
+	params->lineClearMode = 0;
+}
+
+Display_Handle Display_open(uint32_t id, Display_Params *params)
+{
+	(void)id;
+	(void)params;
+	return NULL;
+}
+
+void Display_clear(Display_Handle handle)
+{
+	(void)handle;
+}
+
+void Display_doPrintf(Display_Handle handle, uint8_t line, uint8_t column,
+		const char *fmt, ...)
+{
+	(void)handle;
+	(void)line;
+	(void)column;
+	(void)fmt;
+}
+
+void *DisplayExt_getGraphicsContext(Display_Handle handle)
+{
+	(void)handle;
+	return NULL;
+}
+
+ChipType_t ChipInfo_GetChipType(void)
+{
+	return CHIP_TYPE_CC1350;
+}
+
+const tImage splashImage;
+
+const SweepBuffer *lockSweepData(void)
+{
+	testSweep.readers++;
+	return &testSweep;
+}
+
+void unlockSweepData(const SweepBuffer *sweep)
+{
+	testSweep.readers--;
+	(void)sweep;
+}
+
+uint16_t getStartFreq(void)
+{
+	return 0U;
+}
+
+uint16_t getStartFracFreq(void)
+{
+	return 0U;
+}
+
+uint16_t getEndFreq(void)
+{
+	return 0U;
+}
+
+uint16_t getEndFracFreq(void)
+{
+	return 0U;
+}
+
+uint16_t getSweepLength(void)
+{
+	return testSweep.length;
+}
+
+void getNewSweep(void)
+{
+}
+
+_Bool waitNewSweep(uint32_t timeout)
+{
+	(void)timeout;
+	return FALSE;
+}
+
+const char *getButtonModeString(void)
+{
+	return "EZ";
+}
+
+void perfRecord(PerfCounterId id, uint32_t value)
+{
+	(void)id;
+	(void)value;
+}
+
+/** @brief One frame of the display task before the dirty column renderer:
+ *  clear the plot, draw every column and the whole grid, flush.
+ */
+static void drawReference(uint16_t binRssis)
+{
+	static const Graphics_Rectangle clearSpace = { PLOT_H_ORIGIN,
+			PLOT_V_ORIGIN, PLOT_COL_COUNT, PLOT_ROW_COUNT + PLOT_V_ORIGIN };
+	uint16_t dispBin, freqBin, freqStartIndex, freqBinCount, colIndex;
+	uint16_t rowIndex, rssiLength = testSweep.length;
+	int16_t scaleAvg;
+	int8_t scale;
+
+	Graphics_setForegroundColor(&refContext, GRAPHICS_COLOR_WHITE);
+	Graphics_fillRectangle(&refContext, &clearSpace);
+	Graphics_setForegroundColor(&refContext, GRAPHICS_COLOR_BLACK);
+
+	for (dispBin = 0U; (rssiLength != 0U) && (dispBin < PLOT_COL_COUNT);
+			dispBin++)
+	{
+		scaleAvg = 0;
+		freqStartIndex = ((dispBin * (rssiLength - 1U)) / PLOT_COL_COUNT);
+		freqBinCount = binRssis;
+		if (freqStartIndex + freqBinCount > rssiLength)
+		{
+			freqBinCount = rssiLength - freqStartIndex;
+		}
+		for (freqBin = 0U; freqBin < freqBinCount; freqBin++)
+		{
+			scaleAvg += testSweep.rssi[freqStartIndex + freqBin];
+		}
+		scaleAvg /= freqBinCount;
+
+		if (scaleAvg < DISP_MIN_RSSI)
+		{
+			scale = DISP_MIN_RSSI;
+		}
+		else if (scaleAvg > DISP_MAX_RSSI)
+		{
+			scale = DISP_MAX_RSSI;
+		}
+		else
+		{
+			scale = (int8_t)scaleAvg;
+		}
+
+		scale = scale - DISP_MIN_RSSI;
+		Graphics_drawLineV(&refContext, dispBin,
+				PLOT_ROW_COUNT + PLOT_V_ORIGIN - scale,
+				PLOT_ROW_COUNT + PLOT_V_ORIGIN);
+	}
+
+	for (rowIndex = PLOT_V_ORIGIN + GRID_BORDER;
+			rowIndex <= PLOT_V_ORIGIN + PLOT_ROW_COUNT - GRID_BORDER;
+			rowIndex += GRID_V_GAP)
+	{
+		for (colIndex = GRID_BORDER;
+				colIndex <= PLOT_COL_COUNT - GRID_BORDER - GRID_LNE_LENGTH;
+				colIndex += GRID_H_GAP)
+		{
+			Graphics_drawLineH(&refContext, colIndex,
+					colIndex + GRID_LNE_LENGTH, rowIndex);
+		}
+	}
+
+	Graphics_flushBuffer(&refContext);
+}
+
+/** @brief Draw the sweep in testSweep with both renderers as one frame of
+ *  the display task and compare the LCDs.
+ *
+ *  @param name case printed on a mismatch.
+ *  @param binRssis RSSI values per column, from the sweep length of the
+ *  parameters, not of the sweep.
+ *  @param stale the parameters changed, every column is drawn again.
+ *  @param totals counters of the case.
+ */
+static void drawFrame(const char *name, uint16_t binRssis, _Bool stale,
+		TestTotals *totals)
+{
+	long written[2] = {lcd.written, ref.written};
+	long flushes[2] = {lcd.flushes, ref.flushes};
+	long long start;
+	int row, col, differ = 0;
+
+	start = mockNowNs();
+	if (stale)
+	{
+		memset(plotHeights, PLOT_COL_STALE, sizeof(plotHeights));
+	}
+	if (drawSweep(&lcdContext, binRssis) > 0U)
+	{
+		Graphics_flushBuffer(&lcdContext);
+	}
+	totals->ns[0] += mockNowNs() - start;
+
+	start = mockNowNs();
+	drawReference(binRssis);
+	totals->ns[1] += mockNowNs() - start;
+
+	/* Before the first sweep display.c leaves the plot blank, the reference
+	 * draws the grid
+	 */
+	if (testSweep.length == 0U)
+	{
+		differ = (int)(lcd.written - written[0] + lcd.flushes - flushes[0]);
+	}
+	for (row = PLOT_V_ORIGIN; (testSweep.length != 0U)
+			&& (row <= PLOT_V_ORIGIN + PLOT_ROW_COUNT); row++)
+	{
+		for (col = 0; col < PLOT_COL_COUNT; col++)
+		{
+			differ += (lcd.pixels[row][col] != ref.pixels[row][col]);
+		}
+	}
+	if ((differ != 0) && (failures < 20))
+	{
+		printf("%s: frame %ld differs in %d pixels\n", name, totals->frames,
+				differ);
+	}
+	if ((lcd.outside != 0) || (testSweep.readers != 0U))
+	{
+		printf("%s: frame %ld drew %ld pixels off the plot, %u readers left\n",
+				name, totals->frames, lcd.outside, testSweep.readers);
+		lcd.outside = 0;
+		testSweep.readers = 0U;
+		differ++;
+	}
+	failures += (differ != 0);
+
+	totals->frames++;
+	totals->written[0] += lcd.written - written[0];
+	totals->written[1] += ref.written - written[1];
+	totals->flushes[0] += lcd.flushes - flushes[0];
+	totals->flushes[1] += ref.flushes - flushes[1];
+}
+
+/** @brief Print the counters of a case and clear them. */
+static void report(const char *name, TestTotals *totals)
+{
+	printf("%-22s %4ld frames, pixels %5.0f vs %5.0f, flushes %3ld vs %3ld,"
+			" %5.1f vs %5.1f us per frame\n", name, totals->frames,
+			(double)totals->written[0] / totals->frames,
+			(double)totals->written[1] / totals->frames,
+			totals->flushes[0], totals->flushes[1],
+			totals->ns[0] / 1e3 / totals->frames,
+			totals->ns[1] / 1e3 / totals->frames);
+	memset(totals, 0, sizeof(*totals));
+}
+
+/** @brief Fill testSweep with noise around a level and a carrier. */
+static void noiseSweep(uint16_t length, int level, int spread,
+		uint16_t carrier)
+{
+	uint16_t index;
+	int value;
+
+	testSweep.length = length;
+	for (index = 0U; index < length; index++)
+	{
+		value = level + (rand() % (2 * spread + 1)) - spread;
+		if ((index >= carrier) && (index < carrier + length / 40U + 1U))
+		{
+			value += 50;
+		}
+		testSweep.rssi[index] = (int8_t)value;
+	}
+}
+
+/** @brief Columns per sweep as the display task computes them. */
+static uint16_t binsOf(uint16_t length)
+{
+	return (uint16_t)ceilf((float)length / PLOT_COL_COUNT);
+}
+
+int main(void)
+{
+	static const uint16_t lengths[] = {1U, 2U, 95U, 96U, 97U, 288U, 1900U,
+			MAX_SWEEP_LENGTH};
+	static const int8_t extremes[] = {-128, -127, -57, -56, -55, 0, 127};
+	TestTotals totals = {0};
+	uint16_t index, frame, bins;
+
+	srand(1350);
+
+	/* The LCD is cleared before the first sweep, the display task starts
+	 * with a parameter update
+	 */
+	testSweep.length = 0U;
+	drawFrame("no sweep", 1U, TRUE, &totals);
+	report("no sweep", &totals);
+
+	for (frame = 0U; frame < NOISE_FRAMES; frame++)
+	{
+		noiseSweep(288U, -100, 8, (uint16_t)(frame % 288U));
+		drawFrame("noise 288", binsOf(288U), frame == 0U, &totals);
+	}
+	report("noise 288, 16 dB", &totals);
+
+	for (frame = 0U; frame < NOISE_FRAMES; frame++)
+	{
+		noiseSweep(288U, -100, 1, 100U);
+		drawFrame("quiet 288", binsOf(288U), FALSE, &totals);
+	}
+	report("quiet 288, 2 dB", &totals);
+
+	for (frame = 0U; frame < NOISE_FRAMES; frame++)
+	{
+		drawFrame("static 288", binsOf(288U), FALSE, &totals);
+	}
+	report("static 288", &totals);
+
+	/* A span change: the first sweeps may still be of the old span */
+	bins = binsOf(1900U);
+	drawFrame("span change", bins, TRUE, &totals);
+	for (frame = 0U; frame < NOISE_FRAMES; frame++)
+	{
+		noiseSweep((frame < 2U) ? 288U : 1900U, -95, 8,
+				(uint16_t)(frame * 9U));
+		drawFrame("span change", bins, FALSE, &totals);
+	}
+	report("span change 288->1900", &totals);
+
+	for (index = 0U; index < sizeof(lengths) / sizeof(lengths[0]); index++)
+	{
+		for (frame = 0U; frame < 20U; frame++)
+		{
+			noiseSweep(lengths[index], -90, 30, frame);
+			drawFrame("lengths", binsOf(lengths[index]), frame == 0U,
+					&totals);
+		}
+	}
+	report("lengths 1 - 2048", &totals);
+
+	for (frame = 0U; frame < 50U; frame++)
+	{
+		testSweep.length = 288U;
+		for (index = 0U; index < 288U; index++)
+		{
+			testSweep.rssi[index] =
+					extremes[(index / 3U + frame) % sizeof(extremes)];
+		}
+		drawFrame("extremes", binsOf(288U), FALSE, &totals);
+	}
+	report("RSSI extremes", &totals);
+
+	printf("%d failures\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
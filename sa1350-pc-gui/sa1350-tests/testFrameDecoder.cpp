@@ -0,0 +1,437 @@
+/* --COPYRIGHT--,BSD
+ * Copyright (c) 2011, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ * --/COPYRIGHT--*/
+/*! \file testFrameDecoder.cpp
+ \brief Recovery of the frame decoder of cDeviceDriver from damaged streams
+
+ Every case stores a byte stream of numbered version 1 and version 2 frames
+ in a ring buffer, in reads of a given size, and runs the decoder after each
+ read. Each decoded frame must be one that was sent, unchanged, and every
+ frame whose bytes were not damaged must be decoded, in order, once idle
+ bytes followed the stream. Damage is a flipped bit, a lost or inserted
+ byte or a marker byte in the payload.
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "cDeviceDriverTest.h"
+#include "sa1350Cmd.h"
+
+#define FUZZ_ROUNDS     200     /*!< Random damaged streams */
+#define FUZZ_FRAMES     60      /*!< Frames per random stream */
+
+/*!
+ \brief A frame as it was sent, its place in the stream and whether it was damaged
+
+ \struct sSentFrame
+*/
+typedef struct sSentFrame
+{
+    unsigned char  Cmd;       /*!< Command */
+    unsigned char  Seq;       /*!< Version 2 sequence number */
+    unsigned short SweepId;   /*!< Version 2 sweep id, 0 for version 1 */
+    bool           V2;        /*!< Version 2 frame */
+    std::string    Payload;   /*!< Payload, starts with the frame number */
+    unsigned long  Start;     /*!< Offset of the marker in the stream */
+    unsigned long  End;       /*!< Offset after the Crc */
+    bool           Damaged;   /*!< Some byte of the frame was changed */
+}sSentFrame;
+
+/*!
+ \brief Build a stream of numbered frames
+
+ \param Stream bytes, cleared first
+ \param Frames frames sent, cleared first
+ \param Count number of frames
+ \param V2 version 2 frames, else version 1
+ \param MaxLength longest payload, at least 2
+*/
+static void buildStream(std::string &Stream, std::vector<sSentFrame> &Frames, unsigned int Count, bool V2, unsigned short MaxLength)
+{
+    static const unsigned char cmds[] = {CMD_STREAMDATA, CMD_STREAMSWEEP, CMD_GETSPECNOINIT, CMD_GETLASTERROR, CMD_GETPERFSTATS};
+    sSentFrame     frame;
+    unsigned int   index;
+    unsigned short length;
+
+    Stream.clear();
+    Frames.clear();
+    for(index=0; index<Count; index++)
+    {
+        length = (unsigned short)(2 + rand() % (MaxLength-1));
+        frame.Cmd     = cmds[rand() % sizeof(cmds)];
+        frame.Seq     = (unsigned char)index;
+        frame.SweepId = V2 ? (unsigned short)(index/4) : 0;
+        frame.V2      = V2;
+        frame.Payload.assign(length, 0);
+        frame.Payload[0] = (char)(index>>8);
+        frame.Payload[1] = (char)index;
+        for(unsigned short i=2; i<length; i++)
+        {// Every 8th byte a marker, as RSSI values of -43 and -42 dBm are
+            frame.Payload[i] = (rand() % 8) ? (char)rand() : (char)(FRAME_MARKER + rand() % 2);
+        };
+        frame.Start   = Stream.size();
+        if(V2)
+            appendFrameV2(Stream, frame.Cmd, frame.Seq, frame.SweepId, (const unsigned char*)frame.Payload.data(), length);
+        else
+            appendFrameV1(Stream, frame.Cmd, (const unsigned char*)frame.Payload.data(), (unsigned char)length);
+        frame.End     = Stream.size();
+        frame.Damaged = false;
+        Frames.push_back(frame);
+    };
+}
+
+/*!
+ \brief Mark the frames holding the byte at Offset as damaged
+
+*/
+static void markDamaged(std::vector<sSentFrame> &Frames, unsigned long Offset)
+{
+    for(size_t index=0; index<Frames.size(); index++)
+    {
+        if(Offset >= Frames[index].Start && Offset < Frames[index].End)
+            Frames[index].Damaged = true;
+    };
+}
+
+/*!
+ \brief Decode a stream and check the frames against the sent ones
+
+ \param Name case printed on a failure
+ \param Stream bytes as received
+ \param Frames frames sent, Damaged ones may be missing
+ \param ReadSize bytes per ring buffer write
+ \param CrcErrors returns true if the decoder signalled a Crc error
+ \return number of failures
+*/
+static int checkDecode(const char *Name, const std::string &Stream, const std::vector<sSentFrame> &Frames,
+                       unsigned long ReadSize, bool *CrcErrors = NULL)
+{
+    cDeviceDriver  driver;
+    cRingBuffer    rxFifo(DRV_RX_BUFFER_SIZE);
+    sFrame        *frame;
+    std::string    received;
+    unsigned long  offset;
+    unsigned long  size;
+    unsigned int   number;
+    size_t         next = 0;
+    int            failures = 0;
+
+    // A damaged header may claim more bytes than the stream has left, the
+    // decoder then waits for them. On the link the next frames deliver them,
+    // here idle bytes do, so the frames behind it are decoded late, not lost
+    received = Stream;
+    received.append(FRAME_V2_HEADER_LENGTH+FRAME_DATA_SIZE+FRAME_CRC_LENGTH, '\0');
+    cDeviceDriverTest::Restart(driver);
+    for(offset=0; offset<received.size(); offset+=size)
+    {
+        size = received.size()-offset;
+        if(size > ReadSize)
+            size = ReadSize;
+        size = storeBytes(&rxFifo, (const unsigned char*)&received[offset], size);
+        cDeviceDriverTest::Decode(driver, &rxFifo);
+        while((frame = driver.PeekFrame()) != NULL)
+        {
+            number = (frame->Length >= 2) ? (unsigned int)((frame->Data[0]<<8) | frame->Data[1]) : ~0U;
+            if(number >= Frames.size() || number < next
+                    || frame->Cmd != Frames[number].Cmd
+                    || frame->Length != Frames[number].Payload.size()
+                    || memcmp(frame->Data, Frames[number].Payload.data(), frame->Length) != 0
+                    || frame->SweepId != Frames[number].SweepId)
+            {
+                printf("%s: frame %u decoded wrong or out of order\n", Name, number);
+                failures++;
+            }
+            else
+            {
+                for(; next<number; next++)
+                {
+                    if(!Frames[next].Damaged)
+                    {
+                        printf("%s: intact frame %u lost\n", Name, (unsigned int)next);
+                        failures++;
+                    };
+                };
+                next = number+1;
+            };
+            driver.ReleaseFrame();
+        };
+    };
+    for(; next<Frames.size(); next++)
+    {
+        if(!Frames[next].Damaged)
+        {
+            printf("%s: intact frame %u lost\n", Name, (unsigned int)next);
+            failures++;
+        };
+    };
+    if(CrcErrors)
+        *CrcErrors = driver.HasFrameCrcError();
+
+    return(failures);
+}
+
+/*!
+ \brief Clean streams in reads of 1 byte to a whole stream, with markers in the payloads
+
+*/
+static int testClean(void)
+{
+    static const unsigned long readSizes[] = {1, 7, 300, 4096, DRV_RX_BUFFER_SIZE};
+    std::vector<sSentFrame> frames;
+    std::string stream;
+    bool        crcErrors;
+    int         failures = 0;
+
+    for(int v2=0; v2<2; v2++)
+    {
+        buildStream(stream, frames, 100, v2 != 0, v2 ? 600 : FRAME_V1_DATA_SIZE);
+        for(size_t index=0; index<sizeof(readSizes)/sizeof(readSizes[0]); index++)
+        {
+            failures += checkDecode(v2 ? "clean v2" : "clean v1", stream, frames, readSizes[index], &crcErrors);
+            if(crcErrors)
+            {
+                printf("clean v%d: Crc error in %lu byte reads\n", v2+1, readSizes[index]);
+                failures++;
+            };
+        };
+    };
+
+    return(failures);
+}
+
+/*!
+ \brief A flipped payload bit drops that frame only and signals a Crc error
+
+*/
+static int testBadCrc(void)
+{
+    std::vector<sSentFrame> frames;
+    std::string stream;
+    bool        crcErrors;
+    int         failures = 0;
+
+    for(int v2=0; v2<2; v2++)
+    {
+        buildStream(stream, frames, 20, v2 != 0, 200);
+        stream[frames[5].End-3] ^= 0x10;
+        frames[5].Damaged = true;
+        failures += checkDecode("bad Crc", stream, frames, 4096, &crcErrors);
+        if(!crcErrors)
+        {
+            printf("bad Crc v%d: no Crc error signalled\n", v2+1);
+            failures++;
+        };
+    };
+
+    return(failures);
+}
+
+/*!
+ \brief A header whose length grew or whose tail was lost must not swallow the frames behind it
+
+*/
+static int testBadLength(void)
+{
+    std::vector<sSentFrame> frames;
+    std::string stream;
+    int         failures = 0;
+
+    // Version 1: the length byte of a short frame now claims 250 bytes
+    buildStream(stream, frames, 30, false, 20);
+    stream[frames[3].Start+1] = (char)250;
+    frames[3].Damaged = true;
+    failures += checkDecode("grown length v1", stream, frames, 4096);
+
+    // Version 2: the high length byte now claims 1 KB more
+    buildStream(stream, frames, 30, true, 40);
+    stream[frames[3].Start+1] ^= 0x04;
+    frames[3].Damaged = true;
+    failures += checkDecode("grown length v2", stream, frames, 4096);
+
+    // The last 10 bytes of a frame were lost on the line
+    for(int v2=0; v2<2; v2++)
+    {
+        buildStream(stream, frames, 30, v2 != 0, 60);
+        stream.erase(frames[4].End-10, 10);
+        frames[4].Damaged = true;
+        for(size_t index=5; index<frames.size(); index++)
+        {
+            frames[index].Start -= 10;
+            frames[index].End   -= 10;
+        };
+        failures += checkDecode("lost tail", stream, frames, 4096);
+    };
+
+    return(failures);
+}
+
+/*!
+ \brief Headers that start no frame are dropped at once, without waiting for their length
+
+*/
+static int testBadHeader(void)
+{
+    cDeviceDriver  driver;
+    cRingBuffer    rxFifo(DRV_RX_BUFFER_SIZE);
+    std::string    stream;
+    unsigned char  payload[4] = {0, 1, 2, 3};
+    sFrame        *frame;
+    int            failures = 0;
+
+    // Unknown command, then a version 2 length above FRAME_DATA_SIZE
+    stream.push_back((char)FRAME_MARKER);
+    stream.push_back((char)200);
+    stream.push_back((char)(FRAME_CMD_MAX+1));
+    stream.push_back((char)FRAME_V2_MARKER);
+    stream.push_back((char)((FRAME_DATA_SIZE+1)>>8));
+    stream.push_back((char)((FRAME_DATA_SIZE+1)&0xFF));
+    stream.push_back((char)CMD_STREAMDATA);
+    stream.append(4, 0);
+    appendFrameV1(stream, CMD_STREAMDATA, payload, sizeof(payload));
+
+    cDeviceDriverTest::Restart(driver);
+    storeBytes(&rxFifo, (const unsigned char*)stream.data(), stream.size());
+    cDeviceDriverTest::Decode(driver, &rxFifo);
+    frame = driver.PeekFrame();
+    if(!frame || frame->Cmd != CMD_STREAMDATA || frame->Length != sizeof(payload) || rxFifo.Size() != 0)
+    {
+        printf("bad header: frame behind it %s, %lu bytes left\n", frame ? "wrong" : "not decoded", rxFifo.Size());
+        failures++;
+    };
+
+    return(failures);
+}
+
+/*!
+ \brief Random bit flips, lost and inserted bytes, marker bytes and garbage between frames
+
+*/
+static int testFuzz(void)
+{
+    std::vector<sSentFrame> frames;
+    std::string    stream;
+    unsigned long  offset;
+    int            failures = 0;
+    int            damage;
+    unsigned int   round;
+
+    for(round=0; round<FUZZ_ROUNDS && failures<10; round++)
+    {
+        buildStream(stream, frames, FUZZ_FRAMES, (round & 1) != 0, (round & 1) ? 700 : FRAME_V1_DATA_SIZE);
+        for(damage=0; damage<5; damage++)
+        {
+            offset = (unsigned long)rand() % stream.size();
+            markDamaged(frames, offset);
+            switch(rand() % 4)
+            {
+            case 0:
+                stream[offset] ^= (char)(1 << (rand() % 8));
+                break;
+            case 1:
+                stream[offset] = (char)(FRAME_MARKER + rand() % 2);
+                break;
+            case 2:
+                stream.erase(offset, 1);
+                for(size_t index=0; index<frames.size(); index++)
+                {
+                    if(frames[index].Start > offset) frames[index].Start--;
+                    if(frames[index].End > offset)   frames[index].End--;
+                };
+                break;
+            default:
+                stream.insert(offset, 1, (char)(FRAME_MARKER + rand() % 2));
+                for(size_t index=0; index<frames.size(); index++)
+                {// A byte in front of the marker damages no frame
+                    if(frames[index].Start >= offset) frames[index].Start++;
+                    if(frames[index].End > offset)    frames[index].End++;
+                };
+                break;
+            };
+        };
+        failures += checkDecode((round & 1) ? "fuzz v2" : "fuzz v1", stream, frames, 1 + rand() % 5000);
+    };
+
+    return(failures);
+}
+
+/*!
+ \brief A gap in the version 2 sequence numbers is counted in sFrame::Lost
+
+*/
+static int testSequence(void)
+{
+    cDeviceDriver  driver;
+    cRingBuffer    rxFifo(DRV_RX_BUFFER_SIZE);
+    std::string    stream;
+    unsigned char  payload[2] = {0, 0};
+    static const unsigned char seqs[] = {10, 11, 14, 15, 0};
+    static const unsigned char lost[] = { 0,  0,  2,  0, 240};
+    sFrame        *frame;
+    int            failures = 0;
+
+    for(size_t index=0; index<sizeof(seqs); index++)
+        appendFrameV2(stream, CMD_STREAMDATA, seqs[index], 1, payload, sizeof(payload));
+
+    cDeviceDriverTest::Restart(driver);
+    storeBytes(&rxFifo, (const unsigned char*)stream.data(), stream.size());
+    cDeviceDriverTest::Decode(driver, &rxFifo);
+    for(size_t index=0; index<sizeof(seqs); index++)
+    {
+        frame = driver.PeekFrame();
+        if(!frame || frame->Lost != lost[index])
+        {
+            printf("sequence: frame %u lost %d, expected %u\n", (unsigned int)index, frame ? frame->Lost : -1, lost[index]);
+            failures++;
+        };
+        if(frame)
+            driver.ReleaseFrame();
+    };
+
+    return(failures);
+}
+
+int main(void)
+{
+    int failures = 0;
+    int result;
+
+    srand(1350);
+    printf("clean streams: %d failures\n",          result = testClean());     failures += result;
+    printf("bad Crc: %d failures\n",                result = testBadCrc());    failures += result;
+    printf("bad length, lost tail: %d failures\n",  result = testBadLength()); failures += result;
+    printf("bad header: %d failures\n",             result = testBadHeader()); failures += result;
+    printf("sequence gaps: %d failures\n",          result = testSequence());  failures += result;
+    printf("%d damaged streams: %d failures\n", FUZZ_ROUNDS, result = testFuzz()); failures += result;
+
+    return((failures == 0) ? 0 : 1);
+}
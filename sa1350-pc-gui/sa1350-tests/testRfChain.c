@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file testRfChain.c
+ *
+ *  Checks the chained sweep steps of rfSweep.c on the mock RF core. The RF
+ *  and UART tasks run while the host sets every span of sa1350SpanParams in
+ *  every band with #CMD_SETSWEEP, and every operation the RF core starts is
+ *  traced. For two sweeps of each span the trace must show one chain per
+ *  step, posted in order and alternating between the two step slots: a
+ *  CMD_FS on the frequency of the step that stops the chain unless it
+ *  locked, then the CMD_RX_TEST of the same slot that ends the chain at the
+ *  #SweepPlan rxEndTime. No RSSI read may come before the RSSI settled or
+ *  outside RX and no CMD_RX_TEST may run before a CMD_FS.
+ *
+ *  A loaded host may hold up the mock RF core for longer than
+ *  #RF_STEP_TIMEOUT, after which the RF task cancels the chain during its
+ *  CMD_FS, as on the target. Such steps are reported, not failed.
+ */
+#include <stdio.h>
+
+#include "mockTi.h"
+#include "rfSweep.c"
+
+/***** Defines *****/
+
+#define CMD_CONNECT			(1U)
+#define CMD_SETSWEEP		(28U)
+
+#define REPLY_TIMEOUT_MS	(2000)	/*!< Wait for an ACK				*/
+#define TRACE_TIMEOUT_MS	(20000)	/*!< Wait for the traced sweeps		*/
+#define SETTLE_MS			(20)	/*!< Old chains end after a new sweep	*/
+#define TRACE_LENGTH		(8192U)	/*!< Operations recorded per span	*/
+#define CHECK_SWEEPS		(2U)	/*!< Sweeps checked per span		*/
+#define MAX_REPORTS			(5)		/*!< Mismatches printed per span	*/
+
+/***** Structures *****/
+
+/** @brief A radio operation as the RF core started it.
+ */
+typedef struct TraceOp {
+	const rfc_radioOp_t *op;
+	const rfc_radioOp_t *nextOp;
+	RF_CmdHandle cmd;
+	uint16_t commandNo;
+	uint8_t rule;			/*!< condition.rule						*/
+	uint16_t frequency;		/*!< CMD_FS only						*/
+	uint16_t fractFreq;
+	uint8_t triggerType;	/*!< CMD_RX_TEST endTrigger only		*/
+	uint32_t endTime;
+	long long startNs;		/*!< mockNowNs() at the start			*/
+} TraceOp;
+
+/***** Variable declarations *****/
+
+static TraceOp trace[TRACE_LENGTH];
+static unsigned traceCount = 0U;
+
+static int failures = 0;
+static long chains = 0, timeouts = 0;
+
+/***** Function definitions *****/
+
+/** @brief Record every operation the RF core starts.
+ */
+static void traceOp(const rfc_radioOp_t *op, RF_CmdHandle cmd)
+{
+	unsigned index = __atomic_fetch_add(&traceCount, 1U, __ATOMIC_RELAXED);
+	TraceOp *entry;
+
+	if (index >= TRACE_LENGTH)
+	{
+		return;
+	}
+
+	entry = &trace[index];
+	entry->op = op;
+	entry->startNs = mockNowNs();
+	entry->nextOp = op->pNextOp;
+	entry->cmd = cmd;
+	entry->commandNo = op->commandNo;
+	entry->rule = op->condition.rule;
+	if (op->commandNo == CMD_FS)
+	{
+		entry->frequency = ((const rfc_CMD_FS_t *)op)->frequency;
+		entry->fractFreq = ((const rfc_CMD_FS_t *)op)->fractFreq;
+	}
+	else if (op->commandNo == CMD_RX_TEST)
+	{
+		entry->triggerType = ((const rfc_CMD_RX_TEST_t *)op)->endTrigger.triggerType;
+		entry->endTime = ((const rfc_CMD_RX_TEST_t *)op)->endTime;
+	}
+}
+
+/** @brief Send a command and wait for its ACK, skipping other frames.
+ *
+ *  @return 0 on ACK, -1 on timeout
+ */
+static int command(uint8_t cmd, const uint8_t *payload, uint8_t length)
+{
+	uint8_t frame[MOCK_FRAME_MAX];
+
+	mockHostSend(cmd, payload, length);
+
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if ((frame[1U] == 0U) && (frame[2U] == cmd))
+		{
+			return 0;
+		}
+	}
+
+	fprintf(stderr, "FAIL: no ACK of command %u\n", cmd);
+	return -1;
+}
+
+/** @brief Print a mismatch of a span, up to #MAX_REPORTS of them.
+ */
+static void report(const char *name, int *reports, long step, const char *what)
+{
+	if ((*reports)++ < MAX_REPORTS)
+	{
+		fprintf(stderr, "FAIL: %s: step %ld: %s\n", name, step, what);
+	}
+}
+
+/** @brief Check the chains of #CHECK_SWEEPS sweeps in the trace.
+ *
+ *  @param name printed name of the span.
+ *  @param startFreq first synthesizer frequency of a sweep in MHz.
+ *  @param fractStep fractional frequency added per step, 0 for 1 MHz.
+ *  @param numSteps steps per MHz of an EasyRF span, 0 for expert sweeps,
+ *  whose steps carry into the next MHz on overflow.
+ *  @param length steps per sweep.
+ */
+static void checkChains(const char *name, uint16_t startFreq,
+		uint16_t fractStep, uint16_t numSteps, uint16_t length)
+{
+	unsigned count = __atomic_load_n(&traceCount, __ATOMIC_RELAXED);
+	unsigned first, index;
+	uint32_t expected;
+	uint16_t frequency, fractFreq;
+	uint8_t slot;
+	long step;
+	int reports = 0;
+	const TraceOp *fs, *rx, *prev;
+
+	if (count > TRACE_LENGTH)
+	{
+		count = TRACE_LENGTH;
+	}
+
+	/* The first chain of a sweep, the RF task may be part way into one */
+	for (first = 0U; first < count; first++)
+	{
+		if ((trace[first].commandNo == CMD_FS)
+				&& (trace[first].frequency == startFreq)
+				&& (trace[first].fractFreq == 0U))
+		{
+			break;
+		}
+	}
+	if ((count - first) < (2U * CHECK_SWEEPS * length))
+	{
+		fprintf(stderr, "FAIL: %s: %u of %u operations traced\n", name,
+				count - first, 2U * CHECK_SWEEPS * length);
+		failures++;
+		return;
+	}
+
+	slot = (trace[first].op == (const rfc_radioOp_t *)&stepFs[1U]) ? 1U : 0U;
+	index = first;
+	prev = NULL;
+	for (step = 0; step < (long)(CHECK_SWEEPS * length); step++)
+	{
+		if ((index + 1U) >= count)
+		{
+			report(name, &reports, step, "trace ended");
+			break;
+		}
+		fs = &trace[index];
+		rx = &trace[index + 1U];
+
+		if (numSteps != 0U)
+		{
+			frequency = startFreq + (step % length) / numSteps;
+			fractFreq = (uint16_t)(((step % length) % numSteps) * fractStep);
+		}
+		else
+		{
+			expected = ((uint32_t)startFreq << 16U) + (uint32_t)(step % length)
+					* ((fractStep != 0U) ? fractStep : (UINT16_MAX + 1U));
+			frequency = (uint16_t)(expected >> 16U);
+			fractFreq = (uint16_t)expected;
+		}
+
+		if ((fs->commandNo != CMD_FS)
+				|| (fs->op != (const rfc_radioOp_t *)&stepFs[slot]))
+		{
+			report(name, &reports, step, "chain does not start with the "
+					"CMD_FS of its slot");
+		}
+		else if ((fs->frequency != frequency) || (fs->fractFreq != fractFreq))
+		{
+			report(name, &reports, step, "CMD_FS out of order");
+		}
+		if ((fs->nextOp != (const rfc_radioOp_t *)&stepRx[slot])
+				|| (fs->rule != COND_STOP_ON_FALSE))
+		{
+			report(name, &reports, step, "CMD_FS not chained to its "
+					"CMD_RX_TEST");
+		}
+		if ((prev != NULL)
+				&& (fs->cmd != (RF_CmdHandle)((prev->cmd + 1) & 0x7FFF)))
+		{
+			report(name, &reports, step, "chain not posted right after the "
+					"previous one");
+		}
+		prev = fs;
+
+		/* Cancelled during its CMD_FS by the RF task after a timeout */
+		if ((rx->cmd != fs->cmd) && ((rx->startNs - fs->startNs)
+				> (long long)RF_STEP_TIMEOUT * Clock_tickPeriod * 1000LL))
+		{
+			timeouts++;
+			index += 1U;
+			slot ^= 1U;
+			continue;
+		}
+
+		if ((rx->commandNo != CMD_RX_TEST)
+				|| (rx->op != (const rfc_radioOp_t *)&stepRx[slot])
+				|| (rx->cmd != fs->cmd))
+		{
+			report(name, &reports, step, "CMD_RX_TEST of the chain did not "
+					"follow its CMD_FS");
+		}
+		if ((rx->nextOp != NULL) || (rx->rule != COND_NEVER)
+				|| (rx->triggerType != TRIG_REL_START)
+				|| (rx->endTime != sweepPlan.rxEndTime))
+		{
+			report(name, &reports, step, "CMD_RX_TEST does not end the "
+					"chain at the step end time");
+		}
+
+		index += 2U;
+		slot ^= 1U;
+	}
+
+	failures += (reports != 0);
+	chains += CHECK_SWEEPS * length;
+}
+
+/** @brief Set a sweep with #CMD_SETSWEEP and check its chains once the RF
+ *  task runs it.
+ *
+ *  @param band band of the sweep, #SET_400M_BAND to #SET_2400M_BAND.
+ *  @param startFreq start of the sweep in MHz.
+ *  @param spanIndex index into sa1350SpanParams.
+ *  @param span width of an expert sweep in MHz.
+ *  @param freqStep step width of an expert sweep, 0 for 1 MHz.
+ */
+static void checkSpan(uint8_t band, uint16_t startFreq, uint8_t spanIndex,
+		uint16_t span, uint16_t freqStep)
+{
+	uint8_t payload[SWEEP_CONFIG_LENGTH] = {0};
+	MockRfStats start;
+	long long deadlineNs;
+	uint16_t length, numSteps = 0U;
+	char name[64];
+
+	if (spanIndex != EXPERTSPANINDEX)
+	{
+		span = sa1350SpanParams[spanIndex].spanSpan;
+		freqStep = sa1350SpanParams[spanIndex].spanFreqStep;
+		numSteps = sa1350SpanParams[spanIndex].spanNumSteps;
+	}
+	snprintf(name, sizeof(name), "band %u span %u (%u MHz, step %u)", band,
+			spanIndex, span, freqStep);
+
+	payload[0U] = band;
+	payload[1U] = (uint8_t)(startFreq >> 8U);
+	payload[2U] = (uint8_t)startFreq;
+	payload[5U] = (uint8_t)((startFreq + span) >> 8U);
+	payload[6U] = (uint8_t)(startFreq + span);
+	payload[9U] = sa1350SpanParams[MINEZSPANINDEX].spanRBW;
+	payload[12U] = (uint8_t)(freqStep >> 8U);
+	payload[13U] = (uint8_t)freqStep;
+	payload[15U] = (freqStep == 0U) ? 1U : 0U;
+	payload[16U] = (uint8_t)(span >> 8U);
+	payload[17U] = (uint8_t)span;
+	payload[18U] = spanIndex;
+	if (command(CMD_SETSWEEP, payload, sizeof(payload)) != 0)
+	{
+		failures++;
+		return;
+	}
+
+	/* Trace from the first sweep with the new setting */
+	while (Mailbox_getNumPendingMsgs(rfMailbox) > 0)
+	{
+		mockSleepUs(1000U);
+	}
+	mockSleepUs(SETTLE_MS * 1000U);
+	start = mockRfStats;
+	__atomic_store_n(&traceCount, 0U, __ATOMIC_RELAXED);
+
+	length = sweepPlan.length;
+	deadlineNs = mockNowNs() + TRACE_TIMEOUT_MS * 1000000LL;
+	while ((__atomic_load_n(&traceCount, __ATOMIC_RELAXED)
+			< 2U * (CHECK_SWEEPS + 1U) * length + 2U)
+			&& (mockNowNs() < deadlineNs))
+	{
+		mockSleepUs(1000U);
+	}
+	mockRfTrace = NULL;
+
+	checkChains(name, startFreq, freqStep, numSteps, length);
+
+	if ((mockRfStats.earlyReads != start.earlyReads)
+			|| (mockRfStats.idleReads != start.idleReads)
+			|| (mockRfStats.chainErrors != start.chainErrors)
+			|| (mockRfStats.bandErrors != start.bandErrors))
+	{
+		fprintf(stderr, "FAIL: %s: %ld early, %ld idle reads, %ld chain and "
+				"%ld band errors\n", name,
+				mockRfStats.earlyReads - start.earlyReads,
+				mockRfStats.idleReads - start.idleReads,
+				mockRfStats.chainErrors - start.chainErrors,
+				mockRfStats.bandErrors - start.bandErrors);
+		failures++;
+	}
+
+	mockRfTrace = traceOp;
+}
+
+int main(void)
+{
+	static const uint16_t starts[] = {STARTFREQ_400, STARTFREQ_900,
+			STARTFREQ_2400};
+	uint8_t band, spanIndex;
+
+	mockRfTrace = traceOp;
+
+	mockUartInit();
+	RfTask_init();
+	UartTask_init();
+
+	if (command(CMD_CONNECT, NULL, 0U) != 0)
+	{
+		return 1;
+	}
+
+	for (band = SET_400M_BAND; band <= SET_2400M_BAND; band++)
+	{
+		for (spanIndex = MINEZSPANINDEX; spanIndex <= MAXEZSPANINDEX;
+				spanIndex++)
+		{
+			checkSpan(band, starts[band], spanIndex, 0U, 0U);
+		}
+		checkSpan(band, starts[band], EXPERTSPANINDEX, 2U, 1000U);
+		checkSpan(band, starts[band], EXPERTSPANINDEX, 19U, 0U);
+	}
+
+	printf("%ld chains of %u spans in 3 bands, %ld cancelled after the step "
+			"timeout, %d failures\n", chains, (unsigned)(EXPERTSPANINDEX + 1U),
+			timeouts, failures);
+
+	return (failures == 0) ? 0 : 1;
+}
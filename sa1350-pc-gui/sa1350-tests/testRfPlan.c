@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file testRfPlan.c
+ *
+ *  Checks the synthesizer steps of the #SweepPlan of rfSweep.c against the
+ *  arithmetic the RF task used before the plan: fracFreqStepIndex() on every
+ *  EasyRF step, the carry of the expert step width on overflow, the sweep
+ *  length of getSweepLength() and the 2.4 GHz RSSI offset by the frequency
+ *  of each step. Sweeps are configured the way the firmware does it, with the
+ *  band and span buttons, whose span changes run remapFracFreqs(), and with
+ *  the #CMD_SETSWEEP payloads of the host. Every span of sa1350SpanParams is
+ *  checked in every band at every start step of a MHz and, from the host,
+ *  between the steps. Expert sweeps cover the full step width range.
+ */
+#include <stdio.h>
+
+#include "mockTi.h"
+#include "rfSweep.c"
+
+/***** Defines *****/
+
+#define REF_OFFSET_2400		(20)	/*!< RSSI offset at 2.4 GHz before the plan */
+#define MAX_REPORTS			(20)	/*!< Mismatches printed					*/
+
+/***** Variable declarations *****/
+
+static long sweeps = 0, steps = 0;
+static int failures = 0;
+
+/***** Function definitions *****/
+
+/** @brief Sweep length as getSweepLength() computed it for a single band.
+ */
+static uint16_t referenceLength(void)
+{
+	if (!getCommandMode())
+	{
+		return getSpan() * getNumSteps();
+	}
+	if (getNumSteps() == 1U)
+	{
+		return getSpan() + 1U;
+	}
+
+	return (uint16_t)((double)((uint32_t)getSpan() * (uint32_t)(UINT16_MAX + 1U))
+			/ (double)getFreqStep()) + 1;
+}
+
+/** @brief One step of updateSweepFreq() before the plan.
+ */
+static void referenceStep(uint16_t *frequency, uint16_t *fractFreq)
+{
+	if (getSpanIndex() != EXPERTSPANINDEX)
+	{
+		if ((*fractFreq / getFreqStep()) == (getNumSteps() - 1U))
+		{
+			*fractFreq = 0U;
+			(*frequency)++;
+		}
+		else
+		{
+			*fractFreq += getFreqStep();
+		}
+	}
+	else
+	{
+		*fractFreq += getFreqStep();
+		if ((*fractFreq < getFreqStep()) || (getFreqStep() == 0U))
+		{
+			(*frequency)++;
+		}
+	}
+}
+
+/** @brief Start a sweep with the current parameters as the RF task does and
+ *  compare every step of the plan with the reference.
+ *
+ *  @param name configuration printed on a mismatch.
+ */
+static void checkSweep(const char *name)
+{
+	uint16_t frequency = getStartFreq(), fractFreq = getStartFracFreq();
+	uint16_t index, length;
+	int8_t offset;
+
+	startSweepSegment(0U);
+	sweeps++;
+
+	length = referenceLength();
+	if (sweepPlan.length != length)
+	{
+		if (failures++ < MAX_REPORTS)
+		{
+			printf("%s: %u steps planned, %u before\n", name,
+					sweepPlan.length, length);
+		}
+		return;
+	}
+
+	for (index = 0U; (index < length) && (index < MAX_SWEEP_LENGTH); index++)
+	{
+		offset = (frequency >= MINFREQ_2400) ? REF_OFFSET_2400 : 0;
+		if ((RF_cmdFs.frequency != frequency)
+				|| (RF_cmdFs.fractFreq != fractFreq)
+				|| (sweepPlan.rssiOffset != offset))
+		{
+			if (failures++ < MAX_REPORTS)
+			{
+				printf("%s: step %u at %u MHz + %u, RSSI offset %d, "
+						"before %u MHz + %u, offset %d\n", name, index,
+						RF_cmdFs.frequency, RF_cmdFs.fractFreq,
+						sweepPlan.rssiOffset, frequency, fractFreq, offset);
+			}
+			return;
+		}
+		updateSweepFreq(&RF_cmdFs);
+		referenceStep(&frequency, &fractFreq);
+		steps++;
+	}
+}
+
+/** @brief Check a span at every start step of a MHz, moving the sweep up
+ *  and back down with the frequency buttons.
+ */
+static void checkPositions(const char *name)
+{
+	uint16_t shift, shifts = getNumSteps() + 2U;
+
+	for (shift = 0U; shift < shifts; shift++)
+	{
+		checkSweep(name);
+		increaseFreq();
+	}
+	for (shift = 0U; shift < shifts; shift++)
+	{
+		decreaseFreq();
+		checkSweep(name);
+	}
+}
+
+/** @brief Walk through every EasyRF span of a band with the span buttons.
+ *  Zooming in keeps the centre, zooming out from an unaligned start maps the
+ *  fractional frequencies into the wider span with remapFracFreqs().
+ */
+static void checkSpans(SABand band, const char *bandName)
+{
+	char name[64];
+	uint8_t spanIndex;
+
+	setBand(band);
+	updateRadioRF();
+
+	do
+	{
+		spanIndex = getSpanIndex();
+		snprintf(name, sizeof(name), "%s span %u in", bandName, spanIndex);
+		checkPositions(name);
+		decreaseSpan();
+	} while (getSpanIndex() != spanIndex);
+
+	do
+	{
+		spanIndex = getSpanIndex();
+		increaseFreq();
+		increaseFreq();
+		increaseFreq();
+		increaseSpan();
+		snprintf(name, sizeof(name), "%s span %u out", bandName,
+				getSpanIndex());
+		checkPositions(name);
+	} while (getSpanIndex() != spanIndex);
+
+	if (spanIndex != MINEZSPANINDEX)
+	{
+		printf("%s: zoomed out to span %u only\n", bandName, spanIndex);
+		failures++;
+	}
+}
+
+/** @brief Configure a sweep with a #CMD_SETSWEEP payload as the host does.
+ *  The step width and count only apply to the expert span.
+ */
+static void setSweep(uint8_t band, uint16_t startFreq, uint16_t fractFreq,
+		uint16_t span, uint16_t freqStep, uint16_t numSteps,
+		uint8_t spanIndex)
+{
+	uint8_t payload[SWEEP_CONFIG_LENGTH] = {0};
+
+	payload[0U] = band;
+	payload[1U] = (uint8_t)(startFreq >> 8U);
+	payload[2U] = (uint8_t)startFreq;
+	payload[3U] = (uint8_t)(fractFreq >> 8U);
+	payload[4U] = (uint8_t)fractFreq;
+	payload[5U] = (uint8_t)((startFreq + span) >> 8U);
+	payload[6U] = (uint8_t)(startFreq + span);
+	payload[7U] = (uint8_t)(fractFreq >> 8U);
+	payload[8U] = (uint8_t)fractFreq;
+	payload[9U] = sa1350SpanParams[MINEZSPANINDEX].spanRBW;
+	payload[12U] = (uint8_t)(freqStep >> 8U);
+	payload[13U] = (uint8_t)freqStep;
+	payload[14U] = (uint8_t)(numSteps >> 8U);
+	payload[15U] = (uint8_t)numSteps;
+	payload[16U] = (uint8_t)(span >> 8U);
+	payload[17U] = (uint8_t)span;
+	payload[18U] = spanIndex;
+	cmdSetSweep(payload);
+}
+
+/** @brief Check every EasyRF span of a band set by the host, from every
+ *  start step of a MHz and from start fractions between the steps.
+ */
+static void checkHostSpans(uint8_t band, uint16_t startFreq)
+{
+	char name[64];
+	uint8_t spanIndex, offset;
+	uint16_t step, freqStep, offsets[4U];
+
+	for (spanIndex = MINEZSPANINDEX; spanIndex <= MAXEZSPANINDEX; spanIndex++)
+	{
+		freqStep = sa1350SpanParams[spanIndex].spanFreqStep;
+		offsets[0U] = 0U;
+		offsets[1U] = 1U;
+		offsets[2U] = freqStep / 2U;
+		offsets[3U] = freqStep - 1U;
+
+		for (step = 0U; step < sa1350SpanParams[spanIndex].spanNumSteps;
+				step++)
+		{
+			for (offset = 0U; offset < 4U; offset++)
+			{
+				setSweep(band, startFreq, step * freqStep + offsets[offset],
+						sa1350SpanParams[spanIndex].spanSpan, 0U, 0U,
+						spanIndex);
+				snprintf(name, sizeof(name), "host %u MHz + %u span %u",
+						startFreq, step * freqStep + offsets[offset],
+						spanIndex);
+				checkSweep(name);
+			}
+		}
+	}
+}
+
+/** @brief Configure an expert sweep as the host does and check it.
+ */
+static void checkExpert(uint8_t band, uint16_t startFreq, uint16_t span,
+		uint16_t freqStep, uint16_t numSteps)
+{
+	char name[64];
+
+	setSweep(band, startFreq, 0U, span, freqStep, numSteps, EXPERTSPANINDEX);
+
+	snprintf(name, sizeof(name), "expert %u MHz + %u MHz step %u", startFreq,
+			span, freqStep);
+	checkSweep(name);
+}
+
+int main(void)
+{
+	static const uint16_t starts[] = {STARTFREQ_400, STARTFREQ_900,
+			STARTFREQ_2400};
+	static const uint16_t spans[] = {1U, 2U, 19U};
+	uint8_t band, spanIndex;
+	uint32_t freqStep;
+
+	memset(&mockRfTiming, 0, sizeof(mockRfTiming));
+
+	RfMailbox_init();
+	RfGateMutex_init();
+	RfSemaphore_init();
+	openRadio();
+
+	checkSpans(BAND_400M, "400 MHz");
+	checkSpans(BAND_900M, "900 MHz");
+	checkSpans(BAND_2400M, "2.4 GHz");
+	printf("EasyRF: %ld sweeps, %ld steps\n", sweeps, steps);
+
+	sweeps = 0;
+	steps = 0;
+	setCommandMode(TRUE);
+	for (band = SET_400M_BAND; band <= SET_2400M_BAND; band++)
+	{
+		checkHostSpans(band, starts[band]);
+	}
+	printf("host EasyRF: %ld sweeps, %ld steps\n", sweeps, steps);
+
+	sweeps = 0;
+	steps = 0;
+	for (band = SET_400M_BAND; band <= SET_2400M_BAND; band++)
+	{
+		for (spanIndex = 0U; spanIndex < sizeof(spans) / sizeof(spans[0]);
+				spanIndex++)
+		{
+			/* 1 MHz steps, then every step width with at most 65535 steps */
+			checkExpert(band, starts[band], spans[spanIndex], 0U, 1U);
+			for (freqStep = spans[spanIndex] + 1U; freqStep <= UINT16_MAX;
+					freqStep += (freqStep < 4096U) ? 1U : 7U)
+			{
+				checkExpert(band, starts[band], spans[spanIndex],
+						(uint16_t)freqStep, 0U);
+			}
+		}
+	}
+	printf("expert: %ld sweeps, %ld steps\n", sweeps, steps);
+
+	printf("%d failures\n", failures);
+
+	return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file testRfStep.c
+ *
+ *  Per step timing of the sweep engine on the mock RF core. The RF and UART
+ *  tasks stream sweeps while the mock returns an RSSI that depends on the
+ *  synthesizer frequency. Checks that every value of a streamed sweep is
+ *  the RSSI of its own step, that no read came before the RSSI settled or
+ *  outside RX, and that every CMD_RX_TEST followed a CMD_FS. Reports the
+ *  steps per second against the time the mock RF core needs per step.
+ *
+ *  A loaded host may run the RF task so late that CMD_RX_TEST ends at its
+ *  end time, as on the target when the RF task is held up. Such steps read
+ *  #RF_GET_RSSI_ERROR_VAL and are reported, not failed.
+ *
+ *  Usage: testRfStep [sweeps]
+ */
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "mockTi.h"
+#include "SA1350_Firmware.h"
+
+/***** Defines *****/
+
+#define CMD_CONNECT			(1U)
+#define CMD_SETDETECTOR		(29U)
+#define CMD_STARTSTREAM		(32U)
+#define CMD_STOPSTREAM		(33U)
+#define CMD_STREAMSWEEP		(34U)
+#define CMD_STREAMDATA		(35U)
+
+#define DETECTOR_PEAK		(1U)	/*!< Mode of #CMD_SETDETECTOR		*/
+#define REPLY_TIMEOUT_MS	(2000)	/*!< Wait for an ACK or a sweep		*/
+#define TRACE_LENGTH		(65536U)	/*!< CMD_FS recorded per run	*/
+
+/***** Structures *****/
+
+/** @brief Synthesizer frequency of one CMD_FS.
+ */
+typedef struct TraceStep {
+	uint16_t frequency;
+	uint16_t fractFreq;
+} TraceStep;
+
+/***** Variable declarations *****/
+
+static TraceStep trace[TRACE_LENGTH];
+static unsigned traceCount = 0U;
+
+static int8_t sweep[MAX_SWEEP_LENGTH];
+
+/***** Function definitions *****/
+
+/** @brief RSSI of the mock: a different value for each step of a span.
+ */
+static int8_t stepRssi(uint16_t frequency, uint16_t fractFreq)
+{
+	return (int8_t)(-30 - (int)((frequency * 16U + (fractFreq >> 12U)) % 90U));
+}
+
+/** @brief Record the frequency of every CMD_FS the RF core runs.
+ */
+static void traceFs(const rfc_radioOp_t *op, RF_CmdHandle cmd)
+{
+	const rfc_CMD_FS_t *cmdFs = (const rfc_CMD_FS_t *)op;
+	unsigned index;
+
+	(void)cmd;
+	if (op->commandNo != CMD_FS)
+	{
+		return;
+	}
+
+	index = __atomic_fetch_add(&traceCount, 1U, __ATOMIC_RELAXED);
+	if (index < TRACE_LENGTH)
+	{
+		trace[index].frequency = cmdFs->frequency;
+		trace[index].fractFreq = cmdFs->fractFreq;
+	}
+}
+
+/** @brief Send a command and wait for its ACK, skipping other frames.
+ *
+ *  @return 0 on ACK, -1 on timeout
+ */
+static int command(uint8_t cmd, const uint8_t *payload, uint8_t length)
+{
+	uint8_t frame[MOCK_FRAME_MAX];
+
+	mockHostSend(cmd, payload, length);
+
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if ((frame[1U] == 0U) && (frame[2U] == cmd))
+		{
+			return 0;
+		}
+	}
+
+	fprintf(stderr, "FAIL: no ACK of command %u\n", cmd);
+	return -1;
+}
+
+/** @brief Receive the next streamed sweep.
+ *
+ *  @return number of values, 0 on timeout
+ */
+static uint16_t receiveSweep(void)
+{
+	uint8_t frame[MOCK_FRAME_MAX];
+	uint16_t points = 0U, received = 0U;
+
+	while (mockHostFrame(frame, REPLY_TIMEOUT_MS) != 0U)
+	{
+		if (frame[2U] == CMD_STREAMSWEEP)
+		{
+			points = ((uint16_t)frame[5U] << 8U) | frame[6U];
+			received = 0U;
+		}
+		else if ((frame[2U] == CMD_STREAMDATA) && (points != 0U)
+				&& (received + frame[1U] <= points))
+		{
+			memcpy(&sweep[received], &frame[3U], frame[1U]);
+			received += frame[1U];
+			if (received == points)
+			{
+				return points;
+			}
+		}
+	}
+
+	return 0U;
+}
+
+/** @brief Find a complete sweep in the trace: a run of CMD_FS that starts
+ *  where the frequency drops and has as many steps as the sweep.
+ *
+ *  @return index of its first step, -1 if there is none
+ */
+static long tracedSweep(uint16_t points)
+{
+	unsigned count = traceCount < TRACE_LENGTH ? traceCount : TRACE_LENGTH;
+	unsigned start = 0U, index;
+
+	for (index = 1U; index < count; index++)
+	{
+		if ((trace[index].frequency < trace[index - 1U].frequency)
+				|| ((trace[index].frequency == trace[index - 1U].frequency)
+						&& (trace[index].fractFreq < trace[index - 1U].fractFreq)))
+		{
+			if ((start != 0U) && (index - start == points))
+			{
+				return start;
+			}
+			start = index;
+		}
+	}
+
+	return -1;
+}
+
+/** @brief Stream sweeps and check them against the trace.
+ *
+ *  @param name printed name of the detector setting.
+ *  @param sweeps sweeps to receive.
+ *  @param dwell RSSI reads per step.
+ *
+ *  @return number of failures
+ */
+static int checkSteps(const char *name, int sweeps, uint8_t dwell)
+{
+	MockRfStats start = mockRfStats;
+	long long startNs;
+	double seconds, stepsPerSecond, stepUs;
+	uint16_t points = 0U, index;
+	long first;
+	int sweepIndex, mismatches = 0, missed = 0, failures = 0;
+
+	__atomic_store_n(&traceCount, 0U, __ATOMIC_RELAXED);
+	if (command(CMD_STARTSTREAM, NULL, 0U) != 0)
+	{
+		return 1;
+	}
+
+	startNs = mockNowNs();
+	for (sweepIndex = 0; sweepIndex < sweeps; sweepIndex++)
+	{
+		points = receiveSweep();
+		if (points == 0U)
+		{
+			fprintf(stderr, "FAIL: %s: no streamed sweep\n", name);
+			return 1;
+		}
+	}
+	seconds = (mockNowNs() - startNs) * 1e-9;
+
+	if (command(CMD_STOPSTREAM, NULL, 0U) != 0)
+	{
+		return 1;
+	}
+
+	first = tracedSweep(points);
+	if (first < 0)
+	{
+		fprintf(stderr, "FAIL: %s: no complete sweep of %u steps traced\n",
+				name, points);
+		return 1;
+	}
+	for (index = 0U; index < points; index++)
+	{
+		if (sweep[index] == stepRssi(trace[first + index].frequency,
+				trace[first + index].fractFreq))
+		{
+			continue;
+		}
+		if ((sweep[index] == (int8_t)RF_GET_RSSI_ERROR_VAL)
+				&& (mockRfStats.rxTimeouts != start.rxTimeouts))
+		{
+			missed++;
+		}
+		else
+		{
+			mismatches++;
+		}
+	}
+
+	stepsPerSecond = (mockRfStats.fsRuns - start.fsRuns) / seconds;
+	stepUs = mockRfTiming.fsUs + mockRfTiming.rxStartUs + mockRfTiming.settleUs;
+	printf("%s: %u points, %.0f steps/s, %.0f us per step, RF core %.0f us "
+			"+ %u dwell reads\n", name, points, stepsPerSecond,
+			1e6 / stepsPerSecond, stepUs, dwell - 1U);
+	printf("  %d values not of their step, %ld early, %ld idle reads, "
+			"%ld chain and %ld band errors\n", mismatches,
+			mockRfStats.earlyReads - start.earlyReads,
+			mockRfStats.idleReads - start.idleReads,
+			mockRfStats.chainErrors - start.chainErrors,
+			mockRfStats.bandErrors - start.bandErrors);
+	printf("  %ld steps ended before the RF task read them, %ld late reads, "
+			"%d values missed\n", mockRfStats.rxTimeouts - start.rxTimeouts,
+			mockRfStats.lateReads - start.lateReads, missed);
+
+	failures += (mismatches != 0);
+	failures += (mockRfStats.earlyReads != start.earlyReads);
+	failures += (mockRfStats.idleReads != start.idleReads);
+	failures += (mockRfStats.chainErrors != start.chainErrors);
+	failures += (mockRfStats.bandErrors != start.bandErrors);
+
+	return failures;
+}
+
+int main(int argc, char **argv)
+{
+	int sweeps = (argc > 1) ? atoi(argv[1]) : 3;
+	uint8_t detector[2U] = {DETECTOR_PEAK, 4U};
+	int failures = 0;
+
+	mockRfRssi = stepRssi;
+	mockRfTrace = traceFs;
+
+	mockUartInit();
+	RfTask_init();
+	UartTask_init();
+
+	if (command(CMD_CONNECT, NULL, 0U) != 0)
+	{
+		return 1;
+	}
+	failures += checkSteps("sample", sweeps, 1U);
+
+	if (command(CMD_SETDETECTOR, detector, sizeof(detector)) != 0)
+	{
+		return 1;
+	}
+	failures += checkSteps("peak of 4", sweeps, detector[1U]);
+
+	if (failures != 0)
+	{
+		fprintf(stderr, "FAIL: %d checks\n", failures);
+		return 1;
+	}
+
+	return 0;
+}
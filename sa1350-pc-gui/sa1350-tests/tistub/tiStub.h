@@ -0,0 +1,487 @@
+/*
+ * Copyright (c) 2016, Texas Instruments Incorporated
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * *  Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * *  Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * *  Neither the name of Texas Instruments Incorporated nor the names of
+ *    its contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ * OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ * OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*!
+ *  @file tiStub.h
+ *
+ *  Declarations of the TI-RTOS kernel, the TI drivers and grlib as far as
+ *  the firmware uses them, so the firmware sources build for the host. The
+ *  Makefile generates the TI header paths the firmware includes, each one
+ *  includes this file. The functions are implemented by mockRtos.c,
+ *  mockUart.c, mockRf.c and mockBoard.c, or by a test itself.
+ *
+ *  Only the members the firmware touches are declared, values of constants
+ *  match the TI headers where the firmware depends on them.
+ */
+#ifndef TI_STUB_H_
+#define TI_STUB_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Generated driverlib paths of smartrf_settings.h end up here */
+#define DeviceFamily_constructPath(x) "tiStub.h"
+
+/***** xdc *****/
+
+typedef intptr_t	IArg;
+typedef uintptr_t	UArg;
+typedef char		Char;
+typedef unsigned	UInt;
+typedef int			Int;
+typedef bool		Bool;
+
+#ifndef TRUE
+#define TRUE		1
+#define FALSE		0
+#endif
+
+typedef struct Error_Block { int unused; } Error_Block;
+typedef struct Types_FreqHz { uint32_t hi; uint32_t lo; } Types_FreqHz;
+
+void System_abort(const char *str);
+void System_printf(const char *fmt, ...);
+uint32_t Timestamp_get32(void);
+void Timestamp_getFreq(Types_FreqHz *freq);
+
+/***** SYS/BIOS *****/
+
+#define BIOS_WAIT_FOREVER	(~0U)
+#define BIOS_NO_WAIT		(0U)
+
+void BIOS_start(void);
+
+/* Kernel objects keep a pointer to the host object in their struct */
+typedef struct Task_Struct { void *object; } Task_Struct;
+typedef struct Task_Params {
+	size_t stackSize;
+	int    priority;
+	void  *stack;
+	UArg   arg0;
+	UArg   arg1;
+} Task_Params;
+typedef void (*Task_FuncPtr)(UArg arg0, UArg arg1);
+
+void Task_Params_init(Task_Params *params);
+void Task_construct(Task_Struct *task, Task_FuncPtr fxn, Task_Params *params,
+		Error_Block *eb);
+void Task_sleep(UInt ticks);
+void Task_yield(void);
+void Task_exit(void);
+
+extern uint32_t Clock_tickPeriod;
+
+typedef struct Clock_Struct { void *object; } Clock_Struct;
+typedef struct Clock_Object *Clock_Handle;
+typedef struct Clock_Params { UInt period; Bool startFlag; UArg arg; } Clock_Params;
+typedef void (*Clock_FuncPtr)(UArg arg);
+
+uint32_t Clock_getTicks(void);
+void Clock_Params_init(Clock_Params *params);
+void Clock_construct(Clock_Struct *clock, Clock_FuncPtr fxn, UInt timeout,
+		Clock_Params *params);
+Clock_Handle Clock_handle(Clock_Struct *clock);
+void Clock_start(Clock_Handle handle);
+void Clock_stop(Clock_Handle handle);
+void Clock_setTimeout(Clock_Handle handle, UInt timeout);
+
+typedef struct Semaphore_Struct { void *object; } Semaphore_Struct;
+typedef struct Semaphore_Object *Semaphore_Handle;
+typedef struct Semaphore_Params { int mode; } Semaphore_Params;
+
+#define Semaphore_Mode_COUNTING	(0)
+#define Semaphore_Mode_BINARY	(1)
+
+void Semaphore_Params_init(Semaphore_Params *params);
+void Semaphore_construct(Semaphore_Struct *sem, int count,
+		Semaphore_Params *params);
+Semaphore_Handle Semaphore_handle(Semaphore_Struct *sem);
+Bool Semaphore_pend(Semaphore_Handle handle, UInt timeout);
+void Semaphore_post(Semaphore_Handle handle);
+int Semaphore_getCount(Semaphore_Handle handle);
+void Semaphore_reset(Semaphore_Handle handle, int count);
+
+typedef struct Event_Struct { void *object; } Event_Struct;
+typedef struct Event_Object *Event_Handle;
+typedef struct Event_Params { int unused; } Event_Params;
+
+#define Event_Id_NONE	(0U)
+#define Event_Id_00		(0x01U)
+#define Event_Id_01		(0x02U)
+#define Event_Id_02		(0x04U)
+#define Event_Id_03		(0x08U)
+
+void Event_Params_init(Event_Params *params);
+void Event_construct(Event_Struct *event, Event_Params *params);
+Event_Handle Event_handle(Event_Struct *event);
+Event_Handle Event_create(Event_Params *params, Error_Block *eb);
+UInt Event_pend(Event_Handle handle, UInt andMask, UInt orMask, UInt timeout);
+void Event_post(Event_Handle handle, UInt eventMask);
+
+typedef struct Mailbox_Struct { void *object; } Mailbox_Struct;
+typedef struct Mailbox_Object *Mailbox_Handle;
+typedef struct Mailbox_Params { int unused; } Mailbox_Params;
+
+void Mailbox_Params_init(Mailbox_Params *params);
+void Mailbox_construct(Mailbox_Struct *mbx, size_t msgSize, UInt numMsgs,
+		Mailbox_Params *params, Error_Block *eb);
+Mailbox_Handle Mailbox_handle(Mailbox_Struct *mbx);
+Bool Mailbox_pend(Mailbox_Handle handle, void *msg, UInt timeout);
+Bool Mailbox_post(Mailbox_Handle handle, void *msg, UInt timeout);
+Int Mailbox_getNumPendingMsgs(Mailbox_Handle handle);
+
+typedef struct GateMutex_Struct { void *object; } GateMutex_Struct;
+typedef struct GateMutex_Object *GateMutex_Handle;
+typedef struct GateMutex_Params { int unused; } GateMutex_Params;
+
+void GateMutex_Params_init(GateMutex_Params *params);
+void GateMutex_construct(GateMutex_Struct *gate, GateMutex_Params *params);
+GateMutex_Handle GateMutex_handle(GateMutex_Struct *gate);
+IArg GateMutex_enter(GateMutex_Handle handle);
+void GateMutex_leave(GateMutex_Handle handle, IArg key);
+
+typedef struct GateMutexPri_Struct { void *object; } GateMutexPri_Struct;
+typedef struct GateMutexPri_Object *GateMutexPri_Handle;
+typedef struct GateMutexPri_Params { int unused; } GateMutexPri_Params;
+
+void GateMutexPri_Params_init(GateMutexPri_Params *params);
+void GateMutexPri_construct(GateMutexPri_Struct *gate,
+		GateMutexPri_Params *params);
+GateMutexPri_Handle GateMutexPri_handle(GateMutexPri_Struct *gate);
+IArg GateMutexPri_enter(GateMutexPri_Handle handle);
+void GateMutexPri_leave(GateMutexPri_Handle handle, IArg key);
+
+UInt Hwi_disable(void);
+void Hwi_restore(UInt key);
+
+/***** Drivers *****/
+
+int Power_setConstraint(unsigned constraint);
+int Power_releaseConstraint(unsigned constraint);
+
+#define CHIP_TYPE_CC1350	(1)
+typedef int ChipType_t;
+ChipType_t ChipInfo_GetChipType(void);
+
+typedef uint32_t PIN_Config;
+typedef uint32_t PIN_Id;
+typedef struct PIN_State { int unused; } PIN_State;
+typedef PIN_State *PIN_Handle;
+typedef void (*PIN_IntCb)(PIN_Handle handle, PIN_Id pinId);
+
+#define PIN_TERMINATE		(0xFEU)
+#define PIN_GPIO_OUTPUT_EN	(0U)
+#define PIN_GPIO_LOW		(0U)
+#define PIN_GPIO_HIGH		(0U)
+#define PIN_PUSHPULL		(0U)
+#define PIN_DRVSTR_MAX		(0U)
+#define PIN_INPUT_EN		(0U)
+#define PIN_PULLUP			(0U)
+#define PIN_HYSTERESIS		(0U)
+#define PIN_IRQ_NEGEDGE		(0U)
+#define PIN_IRQ_DIS			(0U)
+
+PIN_Handle PIN_open(PIN_State *state, const PIN_Config *pinList);
+int PIN_setOutputValue(PIN_Handle handle, PIN_Id pinId, uint32_t val);
+uint32_t PIN_getInputValue(PIN_Id pinId);
+uint32_t PIN_getPortInputValue(PIN_Handle handle);
+uint32_t PIN_getPortMask(PIN_Handle handle);
+int PIN_registerIntCb(PIN_Handle handle, PIN_IntCb cb);
+int PIN_setConfig(PIN_Handle handle, uint32_t bmMask, PIN_Config pinCfg);
+
+#define IOID_0	(0U)
+#define IOID_1	(1U)
+#define IOID_2	(2U)
+#define IOID_3	(3U)
+#define IOID_4	(4U)
+#define IOID_5	(5U)
+#define IOID_6	(6U)
+#define IOID_7	(7U)
+#define IOID_8	(8U)
+#define IOID_9	(9U)
+#define IOID_10	(10U)
+#define IOID_11	(11U)
+#define IOID_12	(12U)
+#define IOID_13	(13U)
+#define IOID_14	(14U)
+#define IOID_15	(15U)
+#define IOID_16	(16U)
+#define IOID_17	(17U)
+#define IOID_18	(18U)
+#define IOID_19	(19U)
+#define IOID_20	(20U)
+#define IOID_21	(21U)
+#define IOID_22	(22U)
+#define IOID_23	(23U)
+#define IOID_24	(24U)
+#define IOID_25	(25U)
+#define IOID_26	(26U)
+#define IOID_27	(27U)
+#define IOID_28	(28U)
+#define IOID_29	(29U)
+#define IOID_30	(30U)
+#define IOID_31	(31U)
+
+/* UART, readTimeout and writeTimeout in clock ticks */
+typedef struct UART_Config *UART_Handle;
+typedef void (*UART_Callback)(UART_Handle handle, void *buf, size_t count);
+typedef enum UART_Mode { UART_MODE_BLOCKING, UART_MODE_CALLBACK } UART_Mode;
+typedef enum UART_DataMode { UART_DATA_BINARY, UART_DATA_TEXT } UART_DataMode;
+typedef enum UART_ReturnMode { UART_RETURN_PARTIAL, UART_RETURN_FULL } UART_ReturnMode;
+typedef enum UART_Echo { UART_ECHO_OFF, UART_ECHO_ON } UART_Echo;
+typedef struct UART_Params {
+	UART_Mode       readMode;
+	UART_Mode       writeMode;
+	uint32_t        readTimeout;
+	uint32_t        writeTimeout;
+	UART_Callback   readCallback;
+	UART_Callback   writeCallback;
+	UART_ReturnMode readReturnMode;
+	UART_DataMode   readDataMode;
+	UART_DataMode   writeDataMode;
+	UART_Echo       readEcho;
+	uint32_t        baudRate;
+	int             dataLength;
+	int             stopBits;
+	int             parityType;
+	void           *custom;
+} UART_Params;
+
+#define UART_WAIT_FOREVER	(~0U)
+#define UART_ERROR			(-1)
+#define UART_STATUS_SUCCESS	(0)
+
+void UART_init(void);
+void UART_Params_init(UART_Params *params);
+UART_Handle UART_open(unsigned index, UART_Params *params);
+void UART_close(UART_Handle handle);
+int_fast32_t UART_read(UART_Handle handle, void *buffer, size_t size);
+int_fast32_t UART_write(UART_Handle handle, const void *buffer, size_t size);
+void UART_readCancel(UART_Handle handle);
+void UART_writeCancel(UART_Handle handle);
+
+/***** RF driver and RF core commands *****/
+
+typedef struct RF_Object { int unused; } RF_Object;
+typedef RF_Object *RF_Handle;
+typedef int16_t RF_CmdHandle;
+typedef uint64_t RF_EventMask;
+typedef struct RF_Op RF_Op;
+typedef struct RF_Mode { int unused; } RF_Mode;
+typedef struct RF_Params { uint32_t nInactivityTimeout; } RF_Params;
+typedef void (*RF_Callback)(RF_Handle h, RF_CmdHandle ch, RF_EventMask e);
+typedef enum RF_Priority {
+	RF_PriorityNormal, RF_PriorityHigh, RF_PriorityHighest
+} RF_Priority;
+typedef enum RF_Stat { RF_StatSuccess = 0, RF_StatError = 0x80 } RF_Stat;
+
+#define RF_GET_RSSI_ERROR_VAL		(-128)
+#define RF_ALLOC_ERROR				((RF_CmdHandle)-2)
+#define RF_CTRL_UPDATE_SETUP_CMD	(1)
+
+#define RF_EventCmdDone			((RF_EventMask)1U << 0U)
+#define RF_EventLastCmdDone		((RF_EventMask)1U << 1U)
+#define RF_EventLastFGCmdDone	((RF_EventMask)1U << 2U)
+#define RF_EventCmdCancelled	((RF_EventMask)1U << 3U)
+#define RF_EventCmdAborted		((RF_EventMask)1U << 4U)
+#define RF_EventCmdStopped		((RF_EventMask)1U << 5U)
+
+/* Radio operation status, CMD_FS and CMD_RX_TEST end with DONE_OK */
+#define IDLE		(0x0000U)
+#define PENDING		(0x0001U)
+#define ACTIVE		(0x0002U)
+#define SKIPPED		(0x0003U)
+#define DONE_OK		(0x0400U)
+#define DONE_STOPPED	(0x0404U)
+#define DONE_ABORT	(0x0405U)
+
+#define TRIG_NOW		(0U)
+#define TRIG_NEVER		(1U)
+#define TRIG_ABSTIME	(2U)
+#define TRIG_REL_START	(4U)
+
+#define COND_ALWAYS			(0U)
+#define COND_NEVER			(1U)
+#define COND_STOP_ON_FALSE	(2U)
+
+#define CMD_FS					(0x0803U)
+#define CMD_RX_TEST				(0x0807U)
+#define CMD_PROP_RADIO_DIV_SETUP	(0x3807U)
+
+typedef struct rfc_radioOp_s rfc_radioOp_t;
+
+typedef struct rfc_trigger_s {
+	uint8_t triggerType:4;
+	uint8_t bEnaCmd:1;
+	uint8_t triggerNo:2;
+	uint8_t pastTrig:1;
+} rfc_trigger_t;
+
+typedef struct rfc_condition_s {
+	uint8_t rule:4;
+	uint8_t nSkip:4;
+} rfc_condition_t;
+
+/* Header every radio operation starts with */
+struct rfc_radioOp_s {
+	uint16_t        commandNo;
+	uint16_t        status;
+	rfc_radioOp_t  *pNextOp;
+	uint32_t        startTime;
+	rfc_trigger_t   startTrigger;
+	rfc_condition_t condition;
+};
+
+typedef struct rfc_CMD_FS_s {
+	uint16_t        commandNo;
+	uint16_t        status;
+	rfc_radioOp_t  *pNextOp;
+	uint32_t        startTime;
+	rfc_trigger_t   startTrigger;
+	rfc_condition_t condition;
+	uint16_t        frequency;
+	uint16_t        fractFreq;
+	struct {
+		uint8_t bTxMode:1;
+		uint8_t refFreq:6;
+	} synthConf;
+} rfc_CMD_FS_t;
+
+typedef struct rfc_CMD_RX_TEST_s {
+	uint16_t        commandNo;
+	uint16_t        status;
+	rfc_radioOp_t  *pNextOp;
+	uint32_t        startTime;
+	rfc_trigger_t   startTrigger;
+	rfc_condition_t condition;
+	struct {
+		uint8_t bEnaFifo:1;
+		uint8_t bFsOff:1;
+		uint8_t bNoSync:1;
+	} config;
+	rfc_trigger_t   endTrigger;
+	uint32_t        syncWord;
+	uint32_t        endTime;
+} rfc_CMD_RX_TEST_t;
+
+typedef struct rfc_CMD_PROP_RADIO_DIV_SETUP_s {
+	uint16_t        commandNo;
+	uint16_t        status;
+	rfc_radioOp_t  *pNextOp;
+	uint32_t        startTime;
+	rfc_trigger_t   startTrigger;
+	rfc_condition_t condition;
+	uint8_t         rxBw;
+	uint16_t        txPower;
+	uint32_t       *pRegOverride;
+	uint16_t        centerFreq;
+	uint16_t        intFreq;
+	uint8_t         loDivider;
+} rfc_CMD_PROP_RADIO_DIV_SETUP_t;
+
+typedef union RF_RadioSetup {
+	rfc_radioOp_t                  common;
+	rfc_CMD_PROP_RADIO_DIV_SETUP_t prop;
+} RF_RadioSetup;
+
+void RF_Params_init(RF_Params *params);
+RF_Handle RF_open(RF_Object *obj, RF_Mode *mode, RF_RadioSetup *setup,
+		RF_Params *params);
+void RF_close(RF_Handle h);
+RF_CmdHandle RF_postCmd(RF_Handle h, RF_Op *op, RF_Priority pri,
+		RF_Callback cb, RF_EventMask bmEvent);
+RF_EventMask RF_pendCmd(RF_Handle h, RF_CmdHandle ch, RF_EventMask bmEvent);
+RF_EventMask RF_runCmd(RF_Handle h, RF_Op *op, RF_Priority pri,
+		RF_Callback cb, RF_EventMask bmEvent);
+RF_Stat RF_cancelCmd(RF_Handle h, RF_CmdHandle ch, uint8_t mode);
+RF_Stat RF_flushCmd(RF_Handle h, RF_CmdHandle ch, uint8_t mode);
+RF_Stat RF_control(RF_Handle h, int8_t ctrl, void *args);
+int8_t RF_getRssi(RF_Handle h);
+
+/***** Display and grlib *****/
+
+typedef struct Graphics_Context { int unused; } Graphics_Context;
+typedef struct Graphics_Image { int unused; } Graphics_Image;
+typedef Graphics_Image tImage;
+typedef struct Graphics_Rectangle {
+	int16_t xMin;
+	int16_t yMin;
+	int16_t xMax;
+	int16_t yMax;
+} Graphics_Rectangle;
+
+#define GRAPHICS_COLOR_BLACK	(0x00000000)
+#define GRAPHICS_COLOR_WHITE	(0x00FFFFFF)
+
+void Graphics_drawImage(const Graphics_Context *context, const tImage *image,
+		int16_t x, int16_t y);
+void Graphics_drawPixel(const Graphics_Context *context, int32_t x, int32_t y);
+void Graphics_drawLineH(const Graphics_Context *context, int32_t x1,
+		int32_t x2, int32_t y);
+void Graphics_drawLineV(const Graphics_Context *context, int32_t x,
+		int32_t y1, int32_t y2);
+void Graphics_fillRectangle(const Graphics_Context *context,
+		const Graphics_Rectangle *rect);
+void Graphics_setForegroundColor(const Graphics_Context *context,
+		int32_t value);
+void Graphics_flushBuffer(const Graphics_Context *context);
+
+typedef struct Display_Config *Display_Handle;
+typedef struct Display_Params { int lineClearMode; } Display_Params;
+
+#define Display_Type_LCD	(0x01U)
+#define Display_Type_UART	(0x02U)
+#define DISPLAY_CLEAR_BOTH	(3)
+
+void Display_Params_init(Display_Params *params);
+Display_Handle Display_open(uint32_t id, Display_Params *params);
+void Display_clear(Display_Handle handle);
+void Display_doPrintf(Display_Handle handle, uint8_t line, uint8_t column,
+		const char *fmt, ...);
+void *DisplayExt_getGraphicsContext(Display_Handle handle);
+
+#define Display_print0(h, l, c, f) \
+	Display_doPrintf(h, l, c, f)
+#define Display_print1(h, l, c, f, a0) \
+	Display_doPrintf(h, l, c, f, a0)
+#define Display_print2(h, l, c, f, a0, a1) \
+	Display_doPrintf(h, l, c, f, a0, a1)
+#define Display_print3(h, l, c, f, a0, a1, a2) \
+	Display_doPrintf(h, l, c, f, a0, a1, a2)
+#define Display_print4(h, l, c, f, a0, a1, a2, a3) \
+	Display_doPrintf(h, l, c, f, a0, a1, a2, a3)
+#define Display_print5(h, l, c, f, a0, a1, a2, a3, a4) \
+	Display_doPrintf(h, l, c, f, a0, a1, a2, a3, a4)
+
+#endif /* TI_STUB_H_ */